@@ -25,6 +25,9 @@ void SelectSink(std::string sink_id);
 /// Enable/Disable stretching.
 void EnableStretching(bool enable);
 
+/// Enable/Disable generation of audio frames on a dedicated thread.
+void EnableAudioThread(bool enable);
+
 /// Shutdown Audio Core
 void Shutdown();
 
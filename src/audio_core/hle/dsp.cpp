@@ -3,13 +3,20 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <atomic>
+#include <cstring>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include "audio_core/hle/dsp.h"
 #include "audio_core/hle/mixers.h"
 #include "audio_core/hle/pipe.h"
 #include "audio_core/hle/source.h"
 #include "audio_core/sink.h"
 #include "audio_core/time_stretch.h"
+#include "common/logging/log.h"
+#include "common/thread.h"
+#include "core/movie.h"
 
 namespace DSP {
 namespace HLE {
@@ -54,10 +61,7 @@ static std::array<Source, num_sources> sources = {
 };
 static Mixers mixers;
 
-static StereoFrame16 GenerateCurrentFrame() {
-    SharedMemory& read = ReadRegion();
-    SharedMemory& write = WriteRegion();
-
+static StereoFrame16 GenerateCurrentFrame(SharedMemory& read, SharedMemory& write) {
     std::array<QuadFrame32, 3> intermediate_mixes = {};
 
     // Generate intermediate mixes
@@ -90,6 +94,8 @@ static StereoFrame16 GenerateCurrentFrame() {
 static bool perform_time_stretching = true;
 static std::unique_ptr<AudioCore::Sink> sink;
 static AudioCore::TimeStretcher time_stretcher;
+/// Guards the sink and time stretcher, which may be used by the audio thread.
+static std::mutex output_mutex;
 
 static void FlushResidualStretcherAudio() {
     time_stretcher.Flush();
@@ -102,6 +108,7 @@ static void FlushResidualStretcherAudio() {
 }
 
 static void OutputCurrentFrame(const StereoFrame16& frame) {
+    std::lock_guard<std::mutex> lock(output_mutex);
     if (perform_time_stretching) {
         time_stretcher.AddSamples(&frame[0][0], frame.size());
         std::vector<s16> stretched_samples = time_stretcher.Process(sink->SamplesInQueue());
@@ -119,6 +126,7 @@ static void OutputCurrentFrame(const StereoFrame16& frame) {
 }
 
 void EnableStretching(bool enable) {
+    std::lock_guard<std::mutex> lock(output_mutex);
     if (perform_time_stretching == enable)
         return;
 
@@ -128,9 +136,105 @@ void EnableStretching(bool enable) {
     perform_time_stretching = enable;
 }
 
+// Audio thread
+//
+// When enabled, frame generation (source decoding, mixing, time-stretching and sink output) is
+// performed on a dedicated thread. Each tick, the emulation thread publishes the results of the
+// previous frame into the current write region, then snapshots both regions and hands them to the
+// audio thread. This introduces exactly one frame of latency with respect to the application. The
+// synchronous path is always used while a movie is being recorded or played back so that input
+// replay remains deterministic.
+
+static std::atomic<bool> audio_thread_enabled{false};
+static std::atomic<bool> audio_thread_running{false};
+static std::thread audio_thread;
+static Common::Event frame_requested;
+static Common::Event frame_completed;
+/// Whether a frame has been handed to the audio thread but not yet published.
+static bool frame_pending = false;
+
+static SharedMemory frame_read_snapshot;
+static SharedMemory frame_write_snapshot;
+
+static void AudioThreadLoop() {
+    Common::SetCurrentThreadName("AudioCore");
+    while (true) {
+        frame_requested.Wait();
+        if (!audio_thread_running)
+            break;
+
+        StereoFrame16 current_frame =
+            GenerateCurrentFrame(frame_read_snapshot, frame_write_snapshot);
+        OutputCurrentFrame(current_frame);
+
+        frame_completed.Set();
+    }
+}
+
+/// Copies the DSP-controlled structures of a completed frame into the given region.
+static void PublishFrame(SharedMemory& write) {
+    std::memcpy(&write.dsp_status, &frame_write_snapshot.dsp_status, sizeof(DspStatus));
+    std::memcpy(&write.final_samples, &frame_write_snapshot.final_samples,
+                sizeof(FinalMixSamples));
+    std::memcpy(&write.source_statuses, &frame_write_snapshot.source_statuses,
+                sizeof(SourceStatus));
+    std::memcpy(&write.intermediate_mix_samples, &frame_write_snapshot.intermediate_mix_samples,
+                sizeof(IntermediateMixSamples));
+}
+
+/// Waits for the frame currently being generated on the audio thread (if any) and publishes it.
+static void FinishPendingFrame() {
+    if (!frame_pending)
+        return;
+
+    frame_completed.Wait();
+    PublishFrame(WriteRegion());
+    frame_pending = false;
+}
+
+static void StartAudioThread() {
+    frame_requested.Reset();
+    frame_completed.Reset();
+    audio_thread_running = true;
+    audio_thread = std::thread(AudioThreadLoop);
+    LOG_INFO(Audio_DSP, "Audio thread started");
+}
+
+static void StopAudioThread() {
+    if (!audio_thread.joinable())
+        return;
+
+    FinishPendingFrame();
+    audio_thread_running = false;
+    frame_requested.Set();
+    audio_thread.join();
+    LOG_INFO(Audio_DSP, "Audio thread stopped");
+}
+
+static void TickOnAudioThread() {
+    FinishPendingFrame();
+
+    SharedMemory& read = ReadRegion();
+    std::memcpy(&frame_read_snapshot, &read, sizeof(SharedMemory));
+    std::memcpy(&frame_write_snapshot, &WriteRegion(), sizeof(SharedMemory));
+
+    // The DSP consumes all dirty flags each audio frame. The audio thread only sees the snapshot,
+    // so clear them in the application-visible region now.
+    for (auto& config : read.source_configurations.config) {
+        config.dirty_raw = 0;
+        config.buffers_dirty = 0;
+    }
+    read.dsp_configuration.dirty_raw = 0;
+
+    frame_pending = true;
+    frame_requested.Set();
+}
+
 // Public Interface
 
 void Init() {
+    StopAudioThread();
+
     DSP::HLE::ResetPipes();
 
     for (auto& source : sources) {
@@ -146,27 +250,46 @@ void Init() {
 }
 
 void Shutdown() {
+    StopAudioThread();
+
+    std::lock_guard<std::mutex> lock(output_mutex);
     if (perform_time_stretching) {
         FlushResidualStretcherAudio();
     }
 }
 
 bool Tick() {
-    StereoFrame16 current_frame = {};
-
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
     // shared memory region)
-    current_frame = GenerateCurrentFrame();
 
+    const bool use_audio_thread =
+        audio_thread_enabled && !Movie::IsPlayingInput() && !Movie::IsRecordingInput();
+
+    if (use_audio_thread) {
+        if (!audio_thread.joinable()) {
+            StartAudioThread();
+        }
+        TickOnAudioThread();
+        return true;
+    }
+
+    StopAudioThread();
+
+    StereoFrame16 current_frame = GenerateCurrentFrame(ReadRegion(), WriteRegion());
     OutputCurrentFrame(current_frame);
 
     return true;
 }
 
 void SetSink(std::unique_ptr<AudioCore::Sink> sink_) {
+    std::lock_guard<std::mutex> lock(output_mutex);
     sink = std::move(sink_);
     time_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
 }
 
+void EnableAudioThread(bool enable) {
+    audio_thread_enabled = enable;
+}
+
 } // namespace HLE
 } // namespace DSP
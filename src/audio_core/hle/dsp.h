@@ -591,5 +591,14 @@ void SetSink(std::unique_ptr<AudioCore::Sink> sink);
  */
 void EnableStretching(bool enable);
 
+/**
+ * Enables/Disables generation of audio frames on a dedicated thread.
+ * When enabled, frames are generated concurrently with emulation and their results become visible
+ * to the application one audio frame later. Frames are always generated synchronously while a
+ * movie is being recorded or played back.
+ * @param enable true to enable, false to disable.
+ */
+void EnableAudioThread(bool enable);
+
 } // namespace HLE
 } // namespace DSP
@@ -0,0 +1,40 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <random>
+#include <vector>
+#include "audio_core/codec.h"
+#include "bench/bench.h"
+
+namespace Bench {
+
+/// Samples in one DSP buffer of a typical streamed sound.
+constexpr size_t SAMPLE_COUNT = 0x4000;
+
+void RegisterAudioCodecBenchmarks(Runner& runner) {
+    runner.Add("Codec/DecodeADPCM", [](State& state) {
+        std::mt19937 rng(0);
+        // 8 byte frames of one header byte and 14 samples. Keep the scale index in range.
+        std::vector<u8> data(SAMPLE_COUNT / 14 * 8 + 8);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<u8>(rng());
+            if (i % 8 == 0) {
+                data[i] &= 0x7F;
+            }
+        }
+        const std::array<s16, 16> coeffs = {{0x0400, 0x0000, 0x0800, -0x0400, 0x0700, -0x0300,
+                                             0x0600, -0x0200, 0x0500, -0x0100, 0x0300, 0x0100,
+                                             0x0200, 0x0200, 0x0100, 0x0300}};
+        state.SetItemsPerIteration(SAMPLE_COUNT);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            Codec::ADPCMState adpcm_state{};
+            const auto samples = Codec::DecodeADPCM(data.data(), SAMPLE_COUNT, coeffs, adpcm_state);
+            DoNotOptimize(samples.front());
+        }
+    });
+}
+
+} // namespace Bench
@@ -0,0 +1,138 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <fmt/format.h>
+#include "bench/bench.h"
+#include "common/scm_rev.h"
+
+namespace Bench {
+
+using Clock = std::chrono::steady_clock;
+
+/// Upper bound on iterations per repetition, so that an empty benchmark still terminates quickly.
+constexpr u64 MAX_ITERATIONS = 1000000000;
+
+static double RunTimed(const BenchmarkFunction& function, State& state) {
+    const auto start = Clock::now();
+    function(state);
+    // Ends a pause left open by the benchmark, which covers the destructors of its locals
+    state.ResumeTiming();
+    const auto end = Clock::now();
+    return std::chrono::duration<double, std::nano>(end - start - state.GetPausedTime()).count();
+}
+
+/// Finds an iteration count for which a single repetition lasts at least min_time.
+static u64 CalibrateIterations(const BenchmarkFunction& function,
+                               std::chrono::milliseconds min_time) {
+    const double target_ns = std::chrono::duration<double, std::nano>(min_time).count();
+
+    u64 iterations = 1;
+    while (iterations < MAX_ITERATIONS) {
+        State state(iterations);
+        const double elapsed_ns = RunTimed(function, state);
+        if (elapsed_ns >= target_ns) {
+            break;
+        }
+
+        // Extrapolate from the last run, but grow by at least 2x and at most 10x per step so that
+        // a noisy first measurement can't overshoot by orders of magnitude.
+        const double per_iteration = std::max(elapsed_ns, 1.0) / iterations;
+        const double estimate = target_ns * 1.2 / per_iteration;
+        const u64 next = static_cast<u64>(estimate);
+        iterations = std::min(std::max(next, iterations * 2), iterations * 10);
+    }
+    return std::min(iterations, MAX_ITERATIONS);
+}
+
+void Runner::Add(std::string name, BenchmarkFunction function) {
+    benchmarks.push_back({std::move(name), std::move(function)});
+}
+
+std::vector<Result> Runner::Run(const Options& options) const {
+    std::vector<Result> results;
+
+    for (const auto& benchmark : benchmarks) {
+        if (benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        const u64 iterations = CalibrateIterations(benchmark.function, options.min_time);
+        const unsigned repetitions = std::max(options.repetitions, 1u);
+
+        std::vector<double> per_iteration_ns;
+        per_iteration_ns.reserve(repetitions);
+        u64 bytes_per_iteration = 0;
+        u64 items_per_iteration = 0;
+        for (unsigned repetition = 0; repetition < repetitions; ++repetition) {
+            State state(iterations);
+            per_iteration_ns.push_back(RunTimed(benchmark.function, state) / iterations);
+            bytes_per_iteration = state.GetBytesPerIteration();
+            items_per_iteration = state.GetItemsPerIteration();
+        }
+
+        std::sort(per_iteration_ns.begin(), per_iteration_ns.end());
+
+        Result result;
+        result.name = benchmark.name;
+        result.iterations = iterations;
+        result.repetitions = repetitions;
+        result.median_ns = per_iteration_ns[per_iteration_ns.size() / 2];
+        result.min_ns = per_iteration_ns.front();
+        result.bytes_per_second = bytes_per_iteration * 1e9 / result.median_ns;
+        result.items_per_second = items_per_iteration * 1e9 / result.median_ns;
+
+        std::fprintf(stderr, "%-56s %14.1f ns %14.1f ns (min) %10llu iterations\n",
+                     result.name.c_str(), result.median_ns, result.min_ns,
+                     static_cast<unsigned long long>(result.iterations));
+        results.push_back(std::move(result));
+    }
+
+    return results;
+}
+
+std::vector<std::string> Runner::GetNames() const {
+    std::vector<std::string> names;
+    names.reserve(benchmarks.size());
+    for (const auto& benchmark : benchmarks) {
+        names.push_back(benchmark.name);
+    }
+    return names;
+}
+
+static std::string EscapeJSON(const std::string& str) {
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string FormatJSON(const std::vector<Result>& results) {
+    std::string json = fmt::format("{{\n  \"revision\": \"{}\",\n  \"branch\": \"{}\",\n"
+                                   "  \"description\": \"{}\",\n  \"benchmarks\": [",
+                                   EscapeJSON(Common::g_scm_rev), EscapeJSON(Common::g_scm_branch),
+                                   EscapeJSON(Common::g_scm_desc));
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        json += fmt::format("{}\n    {{\"name\": \"{}\", \"iterations\": {}, \"repetitions\": {}, "
+                            "\"median_ns\": {:.3f}, \"min_ns\": {:.3f}, "
+                            "\"bytes_per_second\": {:.0f}, \"items_per_second\": {:.0f}}}",
+                            i == 0 ? "" : ",", EscapeJSON(result.name), result.iterations,
+                            result.repetitions, result.median_ns, result.min_ns,
+                            result.bytes_per_second, result.items_per_second);
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+void UseCharPointer(const volatile char*) {}
+
+} // namespace Bench
@@ -0,0 +1,154 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Bench {
+
+/// Passed to every benchmark. The benchmark must execute its measured operation Iterations() times.
+class State {
+public:
+    explicit State(u64 iterations) : iterations(iterations) {}
+
+    u64 Iterations() const {
+        return iterations;
+    }
+
+    /// Sets the number of bytes processed by one iteration, used to report throughput.
+    void SetBytesPerIteration(u64 bytes) {
+        bytes_per_iteration = bytes;
+    }
+
+    /// Sets the number of items (vertices, texels, events...) processed by one iteration.
+    void SetItemsPerIteration(u64 items) {
+        items_per_iteration = items;
+    }
+
+    u64 GetBytesPerIteration() const {
+        return bytes_per_iteration;
+    }
+
+    u64 GetItemsPerIteration() const {
+        return items_per_iteration;
+    }
+
+    /// Stops the clock for setup or teardown work, until the next ResumeTiming.
+    void PauseTiming() {
+        if (!paused) {
+            paused = true;
+            pause_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    /// Restarts the clock stopped by PauseTiming. Does nothing if it is running.
+    void ResumeTiming() {
+        if (paused) {
+            paused = false;
+            paused_time += std::chrono::steady_clock::now() - pause_start;
+        }
+    }
+
+    /// Total time the clock was stopped for.
+    std::chrono::steady_clock::duration GetPausedTime() const {
+        return paused_time;
+    }
+
+private:
+    u64 iterations;
+    u64 bytes_per_iteration = 0;
+    u64 items_per_iteration = 0;
+    bool paused = false;
+    std::chrono::steady_clock::time_point pause_start;
+    std::chrono::steady_clock::duration paused_time{};
+};
+
+using BenchmarkFunction = std::function<void(State&)>;
+
+struct Result {
+    std::string name;
+    u64 iterations;          ///< Iterations per repetition
+    unsigned repetitions;    ///< Number of timed repetitions
+    double median_ns;        ///< Median time per iteration across repetitions
+    double min_ns;           ///< Fastest time per iteration across repetitions
+    double bytes_per_second; ///< Based on the median, 0 if the benchmark reports no byte count
+    double items_per_second; ///< Based on the median, 0 if the benchmark reports no item count
+};
+
+struct Options {
+    /// Only benchmarks whose name contains this string are run.
+    std::string filter;
+    /// Minimum duration of a single timed repetition.
+    std::chrono::milliseconds min_time{100};
+    /// Number of timed repetitions, the median of which is reported.
+    unsigned repetitions = 5;
+};
+
+class Runner {
+public:
+    /**
+     * Registers a benchmark.
+     * @param name Unique name, conventionally "Subsystem/Function/Variant"
+     * @param function Benchmark body, see State
+     */
+    void Add(std::string name, BenchmarkFunction function);
+
+    /// Runs all registered benchmarks matching the options, in registration order.
+    std::vector<Result> Run(const Options& options) const;
+
+    /// Returns the names of all registered benchmarks.
+    std::vector<std::string> GetNames() const;
+
+private:
+    struct Benchmark {
+        std::string name;
+        BenchmarkFunction function;
+    };
+
+    std::vector<Benchmark> benchmarks;
+};
+
+/// Formats benchmark results as a JSON document, including the revision they were produced with.
+std::string FormatJSON(const std::vector<Result>& results);
+
+void UseCharPointer(const volatile char* pointer);
+
+/// Prevents the compiler from optimizing away the computation of a value.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+#endif
+}
+
+// Each benchmark source file provides one of these.
+void RegisterAudioCodecBenchmarks(Runner& runner);
+void RegisterCoreTimingBenchmarks(Runner& runner);
+void RegisterCROHelperBenchmarks(Runner& runner);
+void RegisterFramebufferBenchmarks(Runner& runner);
+void RegisterGPUBenchmarks(Runner& runner);
+void RegisterHandleTableBenchmarks(Runner& runner);
+void RegisterHashBenchmarks(Runner& runner);
+void RegisterLightingBenchmarks(Runner& runner);
+void RegisterLZSSBenchmarks(Runner& runner);
+void RegisterMemoryBenchmarks(Runner& runner);
+void RegisterMortonBenchmarks(Runner& runner);
+void RegisterProcTexBenchmarks(Runner& runner);
+void RegisterRomFSReaderBenchmarks(Runner& runner);
+void RegisterRoomBenchmarks(Runner& runner);
+void RegisterRoomMemberBenchmarks(Runner& runner);
+void RegisterShaderBenchmarks(Runner& runner);
+void RegisterShaderGenBenchmarks(Runner& runner);
+void RegisterTextureBenchmarks(Runner& runner);
+void RegisterVertexLoaderBenchmarks(Runner& runner);
+void RegisterY2RBenchmarks(Runner& runner);
+
+} // namespace Bench
@@ -0,0 +1,30 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+#include "bench/bench.h"
+#include "common/hash.h"
+
+namespace Bench {
+
+void RegisterHashBenchmarks(Runner& runner) {
+    // Sizes of a shader config key, a shader program and a large texture respectively.
+    for (size_t size : {size_t{64}, size_t{0x4000}, size_t{0x100000}}) {
+        runner.Add("Hash/ComputeHash64/" + std::to_string(size), [size](State& state) {
+            std::mt19937 rng(size);
+            std::vector<u8> data(size);
+            for (auto& byte : data) {
+                byte = static_cast<u8>(rng());
+            }
+            state.SetBytesPerIteration(size);
+
+            for (u64 i = 0; i < state.Iterations(); ++i) {
+                DoNotOptimize(Common::ComputeHash64(data.data(), data.size()));
+            }
+        });
+    }
+}
+
+} // namespace Bench
@@ -0,0 +1,97 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench/bench.h"
+#include "core/core_timing.h"
+
+namespace Bench {
+
+constexpr int EVENTS_PER_ITERATION = 64;
+constexpr int INSTANCE_COUNT = 4;
+
+/// Count of fired events of one instance, on its own cache line so that the threads don't share it
+struct alignas(64) FiredCount {
+    u64 count = 0;
+};
+
+/// Schedules a batch of events and fires them one slice at a time, as the CPU loop would.
+static void RunSlices(CoreTiming::Timing& timing, int event_type) {
+    for (int j = 0; j < EVENTS_PER_ITERATION; ++j) {
+        timing.ScheduleEvent(100 + j * 100, event_type, j);
+    }
+    for (int j = 0; j < EVENTS_PER_ITERATION; ++j) {
+        timing.AddTicks(100);
+        timing.Advance();
+    }
+}
+
+void RegisterCoreTimingBenchmarks(Runner& runner) {
+    runner.Add("CoreTiming/ScheduleEvent", [](State& state) {
+        CoreTiming::Init();
+        const int event_type = CoreTiming::RegisterEvent("bench", [](u64, int) {});
+        state.SetItemsPerIteration(EVENTS_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            // Interleaved deadlines so that insertion doesn't always hit the end of the queue.
+            for (int j = 0; j < EVENTS_PER_ITERATION; ++j) {
+                const s64 cycles = 1000 + ((j * 37) % EVENTS_PER_ITERATION) * 100;
+                CoreTiming::ScheduleEvent(cycles, event_type, j);
+            }
+            CoreTiming::RemoveEvent(event_type);
+        }
+
+        CoreTiming::Shutdown();
+    });
+
+    runner.Add("CoreTiming/Advance", [](State& state) {
+        CoreTiming::Init();
+        u64 fired = 0;
+        const int event_type =
+            CoreTiming::RegisterEvent("bench", [&fired](u64, int) { ++fired; });
+        state.SetItemsPerIteration(EVENTS_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            RunSlices(CoreTiming::GetTiming(), event_type);
+        }
+        DoNotOptimize(fired);
+
+        CoreTiming::Shutdown();
+    });
+
+    // Independent Timing instances advanced on their own threads. Only the event queues run in
+    // parallel here, the rest of the core can't. Compare against INSTANCE_COUNT times
+    // CoreTiming/Advance to see how well they scale.
+    runner.Add("CoreTiming/Instances", [](State& state) {
+        std::vector<std::unique_ptr<CoreTiming::Timing>> instances;
+        std::array<FiredCount, INSTANCE_COUNT> fired;
+        std::vector<int> event_types;
+        for (int n = 0; n < INSTANCE_COUNT; ++n) {
+            instances.push_back(std::make_unique<CoreTiming::Timing>());
+            u64& count = fired[n].count;
+            event_types.push_back(
+                instances[n]->RegisterEvent("bench", [&count](u64, int) { ++count; }));
+        }
+        state.SetItemsPerIteration(EVENTS_PER_ITERATION * INSTANCE_COUNT);
+
+        const u64 iterations = state.Iterations();
+        std::vector<std::thread> threads;
+        for (int n = 0; n < INSTANCE_COUNT; ++n) {
+            threads.emplace_back([&, n] {
+                for (u64 i = 0; i < iterations; ++i) {
+                    RunSlices(*instances[n], event_types[n]);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        DoNotOptimize(fired);
+    });
+}
+
+} // namespace Bench
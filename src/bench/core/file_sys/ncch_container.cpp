@@ -0,0 +1,76 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "bench/bench.h"
+#include "core/file_sys/ncch_container.h"
+
+namespace Bench {
+
+/// Size of the decompressed data, about the size of a small game's .code section.
+constexpr u32 DECOMPRESSED_SIZE = 0x100000;
+
+/**
+ * Builds a valid ExeFS LZSS stream that decompresses to DECOMPRESSED_SIZE bytes. The stream is read
+ * backwards: groups of a control byte followed by eight tokens, each either a literal byte or a
+ * little endian (length, distance) pair, followed by an 8 byte footer.
+ */
+static std::vector<u8> BuildCompressedStream() {
+    std::mt19937 rng(0);
+    // Tokens in the order the decompressor consumes them, i.e. reversed.
+    std::vector<u8> reversed;
+    u32 produced = 0;
+
+    while (produced < DECOMPRESSED_SIZE) {
+        const size_t control_index = reversed.size();
+        reversed.push_back(0);
+        u8 control = 0;
+
+        for (int token = 0; token < 8 && produced < DECOMPRESSED_SIZE; ++token) {
+            const u32 remaining = DECOMPRESSED_SIZE - produced;
+            // Roughly 3:1 back-references to literals, similar to typical code sections.
+            if (produced >= 18 && remaining >= 3 && rng() % 4 != 0) {
+                const u32 length = std::min<u32>(3 + rng() % 16, remaining);
+                const u32 distance = rng() % std::min<u32>(0x1000, produced - 2);
+                const u16 pair = static_cast<u16>(((length - 3) << 12) | distance);
+                reversed.push_back(static_cast<u8>(pair >> 8));
+                reversed.push_back(static_cast<u8>(pair));
+                control |= 0x80 >> token;
+                produced += length;
+            } else {
+                reversed.push_back(static_cast<u8>(rng()));
+                produced += 1;
+            }
+        }
+        reversed[control_index] = control;
+    }
+
+    std::vector<u8> stream(reversed.rbegin(), reversed.rend());
+    const u32 compressed_size = static_cast<u32>(stream.size() + 8);
+    const u32 buffer_top_and_bottom = (8u << 24) | compressed_size;
+    const u32 extra_size = DECOMPRESSED_SIZE - compressed_size;
+    stream.resize(compressed_size);
+    std::memcpy(&stream[compressed_size - 8], &buffer_top_and_bottom, sizeof(u32));
+    std::memcpy(&stream[compressed_size - 4], &extra_size, sizeof(u32));
+    return stream;
+}
+
+void RegisterLZSSBenchmarks(Runner& runner) {
+    runner.Add("FileSys/LZSS_Decompress", [](State& state) {
+        const std::vector<u8> compressed = BuildCompressedStream();
+        std::vector<u8> decompressed(DECOMPRESSED_SIZE);
+        state.SetBytesPerIteration(DECOMPRESSED_SIZE);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(FileSys::LZSS_Decompress(compressed.data(),
+                                                   static_cast<u32>(compressed.size()),
+                                                   decompressed.data(), DECOMPRESSED_SIZE));
+        }
+    });
+}
+
+} // namespace Bench
@@ -0,0 +1,90 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "common/file_util.h"
+#include "core/file_sys/romfs_reader.h"
+#include "core/hw/aes/ctr.h"
+
+namespace Bench {
+
+/// Size of the data decrypted per iteration, and of the RomFS read by the reader benchmarks.
+constexpr size_t DATA_SIZE = 0x100000;
+/// Size of the reads of the reader benchmarks, a typical small file or file table lookup.
+constexpr size_t READ_SIZE = 0x200;
+constexpr size_t READS_PER_ITERATION = 256;
+
+static std::vector<u8> RandomData(size_t size) {
+    std::mt19937 rng(0);
+    std::vector<u8> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<u8>(rng());
+    }
+    return data;
+}
+
+/// Writes a RomFS of DATA_SIZE random bytes to the cache directory, removed on destruction.
+struct RomFSFixture {
+    RomFSFixture() : path(FileUtil::GetUserPath(D_CACHE_IDX) + "bench_romfs.bin") {
+        FileUtil::CreateFullPath(path);
+        const std::vector<u8> data = RandomData(DATA_SIZE);
+        FileUtil::IOFile(path, "wb").WriteBytes(data.data(), data.size());
+    }
+    ~RomFSFixture() {
+        FileUtil::Delete(path);
+    }
+
+    std::string path;
+};
+
+static void AddReaderBenchmark(Runner& runner, const char* name, bool encrypted) {
+    runner.Add(std::string("FileSys/RomFSReader/") + name, [encrypted](State& state) {
+        RomFSFixture fixture;
+        FileUtil::IOFile file(fixture.path, "rb");
+        std::unique_ptr<FileSys::RomFSReader> reader;
+        if (encrypted) {
+            reader = std::make_unique<FileSys::RomFSReader>(std::move(file), 0, DATA_SIZE,
+                                                            HW::AES::AESKey{},
+                                                            HW::AES::AESCounter{}, 0x1000);
+        } else {
+            reader = std::make_unique<FileSys::RomFSReader>(std::move(file), 0, DATA_SIZE);
+        }
+        std::mt19937 rng(0);
+        // Reads cluster around a few areas, like lookups in the file tables of the RomFS
+        std::vector<u64> offsets(READS_PER_ITERATION);
+        for (auto& offset : offsets) {
+            offset = (rng() % 16) * 0x10000 + rng() % 0x2000;
+        }
+        std::vector<u8> buffer(READ_SIZE);
+        state.SetBytesPerIteration(READ_SIZE * READS_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (u64 offset : offsets) {
+                DoNotOptimize(reader->ReadFile(offset, READ_SIZE, buffer.data()));
+            }
+        }
+    });
+}
+
+void RegisterRomFSReaderBenchmarks(Runner& runner) {
+    runner.Add("FileSys/AES_CTR_Decrypt", [](State& state) {
+        std::vector<u8> data = RandomData(DATA_SIZE);
+        HW::AES::CTRCipher cipher({}, {});
+        state.SetBytesPerIteration(DATA_SIZE);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            cipher.Process(data.data(), data.size(), 0);
+            DoNotOptimize(data[0]);
+        }
+    });
+
+    AddReaderBenchmark(runner, "Plain", false);
+    AddReaderBenchmark(runner, "Encrypted", true);
+}
+
+} // namespace Bench
@@ -0,0 +1,48 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include "bench/bench.h"
+#include "core/hle/kernel/event.h"
+#include "core/hle/kernel/handle_table.h"
+
+namespace Bench {
+
+constexpr size_t HANDLES_PER_ITERATION = 256;
+
+void RegisterHandleTableBenchmarks(Runner& runner) {
+    runner.Add("HandleTable/CreateClose", [](State& state) {
+        Kernel::HandleTable handle_table;
+        auto event = Kernel::Event::Create(Kernel::ResetType::OneShot, "bench");
+        std::vector<Kernel::Handle> handles(HANDLES_PER_ITERATION);
+        state.SetItemsPerIteration(HANDLES_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (auto& handle : handles) {
+                handle = handle_table.Create(event).Unwrap();
+            }
+            for (auto handle : handles) {
+                handle_table.Close(handle);
+            }
+        }
+    });
+
+    runner.Add("HandleTable/GetGeneric", [](State& state) {
+        Kernel::HandleTable handle_table;
+        auto event = Kernel::Event::Create(Kernel::ResetType::OneShot, "bench");
+        std::vector<Kernel::Handle> handles(HANDLES_PER_ITERATION);
+        for (auto& handle : handles) {
+            handle = handle_table.Create(event).Unwrap();
+        }
+        state.SetItemsPerIteration(HANDLES_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (auto handle : handles) {
+                DoNotOptimize(handle_table.GetGeneric(handle).get());
+            }
+        }
+    });
+}
+
+} // namespace Bench
@@ -0,0 +1,368 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "bench/core/process_environment.h"
+#include "core/hle/service/ldr_ro/cro_helper.h"
+
+namespace Bench {
+
+using Service::LDR::CROHelper;
+
+/// Named symbols exported by the CRS and imported by the CRO
+constexpr u32 NUM_SYMBOLS = 1024;
+/// Size of the relocation batch of each imported symbol
+constexpr u32 RELOCS_PER_SYMBOL = 4;
+constexpr u32 NUM_EXTERNAL = NUM_SYMBOLS * RELOCS_PER_SYMBOL;
+constexpr u32 NUM_INTERNAL = 4096;
+/// Size reserved for each of the CRS and the CRO
+constexpr u32 MODULE_SIZE = 0x40000;
+constexpr u32 CODE_OFFSET = 0x1000;
+constexpr u32 CODE_SIZE = (NUM_EXTERNAL + NUM_INTERNAL) * 4;
+
+/// Index of the u32 fields of the CRO header that the modules use, after the 0x80 byte hash
+enum HeaderField : u32 {
+    FileSize = 4,
+    CodeOffset = 12,
+    CodeSize,
+    DataOffset,
+    DataSize,
+    ModuleNameOffset,
+    ModuleNameSize,
+    SegmentTableOffset,
+    SegmentNum,
+    ExportNamedSymbolTableOffset,
+    ExportNamedSymbolNum,
+    ExportIndexedSymbolTableOffset,
+    ExportIndexedSymbolNum,
+    ExportStringsOffset,
+    ExportStringsSize,
+    ExportTreeTableOffset,
+    ExportTreeNum,
+    ImportModuleTableOffset,
+    ImportModuleNum,
+    ExternalRelocationTableOffset,
+    ExternalRelocationNum,
+    ImportNamedSymbolTableOffset,
+    ImportNamedSymbolNum,
+    ImportIndexedSymbolTableOffset,
+    ImportIndexedSymbolNum,
+    ImportAnonymousSymbolTableOffset,
+    ImportAnonymousSymbolNum,
+    ImportStringsOffset,
+    ImportStringsSize,
+    StaticAnonymousSymbolTableOffset,
+    StaticAnonymousSymbolNum,
+    InternalRelocationTableOffset,
+    InternalRelocationNum,
+    StaticRelocationTableOffset,
+    StaticRelocationNum,
+};
+
+/**
+ * Writes a module image with a single code segment. Tables are laid out in the order the RO
+ * service verifies, and each one is added, possibly empty, through the builder in that order.
+ */
+class ModuleBuilder {
+public:
+    ModuleBuilder() : image(MODULE_SIZE) {
+        Set(0, 0x304F5243); // "CRO0"
+        Set(FileSize, MODULE_SIZE);
+        Set(CodeOffset, CODE_OFFSET);
+        Set(CodeSize, CODE_SIZE);
+        cursor = CODE_OFFSET + CODE_SIZE;
+    }
+
+    void Set(u32 field, u32 value) {
+        std::memcpy(&image[0x80 + field * 4], &value, sizeof(value));
+    }
+
+    /// Starts the table whose offset and size (or entry number) are the given fields.
+    void BeginTable(u32 offset_field) {
+        table_field = offset_field;
+        table_begin = cursor;
+        table_entries = 0;
+    }
+
+    void Append(const void* data, u32 size) {
+        std::memcpy(&image[cursor], data, size);
+        cursor += size;
+    }
+
+    void AppendEntry(std::initializer_list<u32> words) {
+        for (u32 word : words) {
+            Append(&word, sizeof(word));
+        }
+        ++table_entries;
+    }
+
+    void AppendString(const std::string& string) {
+        Append(string.c_str(), static_cast<u32>(string.size() + 1));
+    }
+
+    /// Ends the current table, whose size is its byte size for strings or its entry number.
+    void EndTable(bool is_string_table = false) {
+        Set(table_field, table_begin);
+        Set(table_field + 1, is_string_table ? cursor - table_begin : table_entries);
+    }
+
+    void AddEmptyTable(u32 offset_field) {
+        BeginTable(offset_field);
+        EndTable();
+    }
+
+    u32 Cursor() const {
+        return cursor;
+    }
+
+    std::vector<u8> image;
+
+private:
+    u32 cursor;
+    u32 table_field = 0;
+    u32 table_begin = 0;
+    u32 table_entries = 0;
+};
+
+static std::string SymbolName(u32 index) {
+    return "nn::bench::Symbol" + std::to_string(index);
+}
+
+/// Bit of the name tested by the export tree at the given bit address, 0 past its end.
+static bool NameBit(const std::string& name, u32 bit_address) {
+    const u32 byte = bit_address >> 3;
+    return byte < name.size() && ((name[byte] >> (bit_address & 7)) & 1);
+}
+
+using ExportTreeNode = std::array<u16, 4>; // test bit, left child, right child, export index
+
+/**
+ * Appends the export tree nodes telling the given symbols apart, each node testing the first bit
+ * which differs among its symbols. Returns the child value pointing to the subtree.
+ */
+static u16 BuildExportTree(std::vector<ExportTreeNode>& nodes, const std::vector<u32>& symbols) {
+    const u16 index = static_cast<u16>(nodes.size());
+    if (symbols.size() == 1) {
+        nodes.push_back({0, 0, 0, static_cast<u16>(symbols[0])});
+        return index | 0x8000; // is_end
+    }
+
+    const std::string first = SymbolName(symbols[0]);
+    u32 bit = 0;
+    for (;; ++bit) {
+        bool differs = false;
+        for (u32 symbol : symbols) {
+            differs |= NameBit(SymbolName(symbol), bit) != NameBit(first, bit);
+        }
+        if (differs)
+            break;
+    }
+
+    std::vector<u32> left, right;
+    for (u32 symbol : symbols) {
+        (NameBit(SymbolName(symbol), bit) ? right : left).push_back(symbol);
+    }
+
+    nodes.push_back({static_cast<u16>(bit), 0, 0, 0});
+    const u16 left_child = BuildExportTree(nodes, left);
+    const u16 right_child = BuildExportTree(nodes, right);
+    nodes[index][1] = left_child;
+    nodes[index][2] = right_child;
+    return index;
+}
+
+static u32 CodeTag(u32 offset) {
+    return offset << 4; // segment 0
+}
+
+static u32 RelocationWord(u8 type, u8 second, u8 third) {
+    return type | (second << 8) | (third << 16);
+}
+
+/// The static module, exporting NUM_SYMBOLS named symbols. Its segment table holds addresses.
+static std::vector<u8> BuildCRS(VAddr address) {
+    ModuleBuilder builder;
+
+    builder.BeginTable(ModuleNameOffset);
+    builder.AppendString("crs");
+    builder.EndTable(true);
+
+    builder.BeginTable(SegmentTableOffset);
+    builder.AppendEntry({address + CODE_OFFSET, CODE_SIZE, 0});
+    builder.EndTable();
+
+    // The first node only holds the root, as its left child
+    std::vector<u32> symbols(NUM_SYMBOLS);
+    for (u32 i = 0; i < NUM_SYMBOLS; ++i) {
+        symbols[i] = i;
+    }
+    std::vector<ExportTreeNode> tree(1, ExportTreeNode{});
+    const u16 root = BuildExportTree(tree, symbols);
+    tree[0][1] = root;
+
+    const u32 strings_begin =
+        builder.Cursor() + NUM_SYMBOLS * 8 + static_cast<u32>(tree.size()) * 8;
+    u32 string_offset = strings_begin;
+    builder.BeginTable(ExportNamedSymbolTableOffset);
+    for (u32 i = 0; i < NUM_SYMBOLS; ++i) {
+        builder.AppendEntry({string_offset, CodeTag(i * 4)});
+        string_offset += static_cast<u32>(SymbolName(i).size() + 1);
+    }
+    builder.EndTable();
+
+    builder.BeginTable(ExportTreeTableOffset);
+    for (const auto& node : tree) {
+        builder.AppendEntry({node[0] | static_cast<u32>(node[1]) << 16,
+                             node[2] | static_cast<u32>(node[3]) << 16});
+    }
+    builder.EndTable();
+
+    builder.AddEmptyTable(ExportIndexedSymbolTableOffset);
+
+    builder.BeginTable(ExportStringsOffset);
+    for (u32 i = 0; i < NUM_SYMBOLS; ++i) {
+        builder.AppendString(SymbolName(i));
+    }
+    builder.EndTable(true);
+
+    builder.AddEmptyTable(ImportModuleTableOffset);
+
+    // The external relocation table needs at least a finished batch
+    builder.BeginTable(ExternalRelocationTableOffset);
+    builder.AppendEntry({CodeTag(0), RelocationWord(0, 1, 0), 0});
+    builder.EndTable();
+
+    for (u32 field : {ImportNamedSymbolTableOffset, ImportIndexedSymbolTableOffset,
+                      ImportAnonymousSymbolTableOffset, ImportStringsOffset,
+                      StaticAnonymousSymbolTableOffset, InternalRelocationTableOffset,
+                      StaticRelocationTableOffset, DataOffset}) {
+        builder.AddEmptyTable(field);
+    }
+    return builder.image;
+}
+
+/**
+ * The loaded module, importing each symbol of the CRS with a batch of RELOCS_PER_SYMBOL
+ * relocations, and with NUM_INTERNAL internal relocations.
+ */
+static std::vector<u8> BuildCRO() {
+    ModuleBuilder builder;
+
+    builder.BeginTable(ModuleNameOffset);
+    builder.AppendString("bench");
+    builder.EndTable(true);
+
+    builder.BeginTable(SegmentTableOffset);
+    builder.AppendEntry({CODE_OFFSET, CODE_SIZE, 0});
+    builder.EndTable();
+
+    for (u32 field : {ExportNamedSymbolTableOffset, ExportTreeTableOffset,
+                      ExportIndexedSymbolTableOffset, ExportStringsOffset,
+                      ImportModuleTableOffset}) {
+        builder.AddEmptyTable(field);
+    }
+
+    const u32 external_relocations = builder.Cursor();
+    builder.BeginTable(ExternalRelocationTableOffset);
+    for (u32 i = 0; i < NUM_EXTERNAL; ++i) {
+        const bool batch_end = i % RELOCS_PER_SYMBOL == RELOCS_PER_SYMBOL - 1;
+        builder.AppendEntry({CodeTag(i * 4), RelocationWord(2, batch_end, 0), i});
+    }
+    builder.EndTable();
+
+    const u32 strings_begin = builder.Cursor() + NUM_SYMBOLS * 8;
+    u32 string_offset = strings_begin;
+    builder.BeginTable(ImportNamedSymbolTableOffset);
+    for (u32 i = 0; i < NUM_SYMBOLS; ++i) {
+        builder.AppendEntry({string_offset, external_relocations + i * RELOCS_PER_SYMBOL * 12});
+        string_offset += static_cast<u32>(SymbolName(i).size() + 1);
+    }
+    builder.EndTable();
+
+    builder.AddEmptyTable(ImportIndexedSymbolTableOffset);
+    builder.AddEmptyTable(ImportAnonymousSymbolTableOffset);
+
+    builder.BeginTable(ImportStringsOffset);
+    for (u32 i = 0; i < NUM_SYMBOLS; ++i) {
+        builder.AppendString(SymbolName(i));
+    }
+    builder.EndTable(true);
+
+    builder.AddEmptyTable(StaticAnonymousSymbolTableOffset);
+
+    builder.BeginTable(InternalRelocationTableOffset);
+    for (u32 i = 0; i < NUM_INTERNAL; ++i) {
+        builder.AppendEntry({CodeTag((NUM_EXTERNAL + i) * 4), RelocationWord(2, 0, 0), i * 4});
+    }
+    builder.EndTable();
+
+    builder.AddEmptyTable(StaticRelocationTableOffset);
+    builder.AddEmptyTable(DataOffset);
+    return builder.image;
+}
+
+/// A process with the CRS mapped and initialized, and room for the CRO right after it.
+struct CROFixture {
+    CROFixture() : env(MODULE_SIZE * 2), cro_image(BuildCRO()) {
+        crs_address = env.GetBaseAddress();
+        cro_address = crs_address + MODULE_SIZE;
+
+        const std::vector<u8> crs_image = BuildCRS(crs_address);
+        std::memcpy(env.GetData(), crs_image.data(), MODULE_SIZE);
+        CROHelper crs(crs_address);
+        crs.InitCRS();
+        crs.Rebase(0, MODULE_SIZE, 0, 0, 0, 0, true);
+    }
+
+    /// Restores the CRO to its state before loading.
+    void ResetCRO() {
+        std::memcpy(env.GetData() + MODULE_SIZE, cro_image.data(), MODULE_SIZE);
+    }
+
+    ResultCode RebaseCRO() {
+        return CROHelper(cro_address).Rebase(crs_address, MODULE_SIZE, 0, 0, 0, 0, false);
+    }
+
+    ProcessEnvironment env;
+    std::vector<u8> cro_image;
+    VAddr crs_address;
+    VAddr cro_address;
+};
+
+void RegisterCROHelperBenchmarks(Runner& runner) {
+    // Rebasing resets every external relocation and applies every internal one
+    runner.Add("LDR/CRO/Rebase", [](State& state) {
+        CROFixture fixture;
+        CROHelper::ClearExportIndices();
+        state.SetItemsPerIteration(NUM_EXTERNAL + NUM_INTERNAL);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            fixture.ResetCRO();
+            DoNotOptimize(fixture.RebaseCRO().raw);
+        }
+    });
+
+    // Linking looks up every imported symbol in the CRS and applies its relocation batch,
+    // unlinking resets the batches
+    runner.Add("LDR/CRO/LinkUnlink", [](State& state) {
+        CROFixture fixture;
+        CROHelper::ClearExportIndices();
+        fixture.ResetCRO();
+        fixture.RebaseCRO();
+        state.SetItemsPerIteration(NUM_SYMBOLS);
+
+        CROHelper cro(fixture.cro_address);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            DoNotOptimize(cro.Link(fixture.crs_address, false).raw);
+            DoNotOptimize(cro.Unlink(fixture.crs_address).raw);
+        }
+    });
+}
+
+} // namespace Bench
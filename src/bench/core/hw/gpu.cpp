@@ -0,0 +1,52 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "core/hw/gpu.h"
+
+namespace Bench {
+
+using GPU::Regs;
+
+/**
+ * Transfers a tiled RGBA8 render target to a linear RGB8 framebuffer, as games do to present each
+ * screen.
+ */
+static void AddDisplayTransferBenchmark(Runner& runner, u32 width, u32 height) {
+    const std::string size = std::to_string(width) + "x" + std::to_string(height);
+    runner.Add("GPU/DisplayTransfer/" + size, [=](State& state) {
+        std::vector<u8> src(width * height * Regs::BytesPerPixel(Regs::PixelFormat::RGBA8));
+        std::vector<u8> dst(width * height * Regs::BytesPerPixel(Regs::PixelFormat::RGB8));
+        std::mt19937 rng(0);
+        for (auto& byte : src) {
+            byte = static_cast<u8>(rng());
+        }
+
+        Regs::DisplayTransferConfig config{};
+        config.input_width.Assign(width);
+        config.input_height.Assign(height);
+        config.output_width.Assign(width);
+        config.output_height.Assign(height);
+        config.input_format.Assign(Regs::PixelFormat::RGBA8);
+        config.output_format.Assign(Regs::PixelFormat::RGB8);
+        state.SetItemsPerIteration(width * height);
+        state.SetBytesPerIteration(src.size());
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            GPU::SoftwareDisplayTransfer(config, src.data(), dst.data());
+            DoNotOptimize(dst[0]);
+        }
+    });
+}
+
+void RegisterGPUBenchmarks(Runner& runner) {
+    // Top and bottom screen
+    AddDisplayTransferBenchmark(runner, 400, 240);
+    AddDisplayTransferBenchmark(runner, 320, 240);
+}
+
+} // namespace Bench
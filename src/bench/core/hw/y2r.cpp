@@ -0,0 +1,66 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include "bench/bench.h"
+#include "bench/core/process_environment.h"
+#include "core/hle/service/y2r_u.h"
+#include "core/hw/y2r.h"
+
+namespace Bench {
+
+using namespace Service::Y2R;
+
+/// Size of a camera frame, the most common conversion source.
+constexpr u16 FRAME_WIDTH = 400;
+constexpr u16 FRAME_HEIGHT = 240;
+
+static void AddConversionBenchmark(Runner& runner, const char* name, InputFormat input_format,
+                                   OutputFormat output_format, BlockAlignment block_alignment,
+                                   u32 output_bytes_per_pixel) {
+    runner.Add(std::string("Y2R/PerformConversion/") + name, [=](State& state) {
+        ProcessEnvironment env(0x100000);
+        std::mt19937 rng(0);
+        for (u32 i = 0; i < 0x100000; ++i) {
+            env.GetData()[i] = static_cast<u8>(rng());
+        }
+
+        const u32 luma_size = FRAME_WIDTH * FRAME_HEIGHT;
+        const u32 chroma_size =
+            input_format == InputFormat::YUV420_Indiv8 ? luma_size / 4 : luma_size / 2;
+        const VAddr base = env.GetBaseAddress();
+
+        ConversionConfiguration config{};
+        config.input_format = input_format;
+        config.output_format = output_format;
+        config.rotation = Rotation::None;
+        config.block_alignment = block_alignment;
+        config.SetInputLineWidth(FRAME_WIDTH);
+        config.SetInputLines(FRAME_HEIGHT);
+        config.SetStandardCoefficient(StandardCoefficient::ITU_Rec601);
+        config.alpha = 0xFF;
+        config.src_Y = {base, luma_size, FRAME_WIDTH, 0};
+        config.src_U = {base + luma_size, chroma_size, FRAME_WIDTH, 0};
+        config.src_V = {base + luma_size + chroma_size, chroma_size, FRAME_WIDTH, 0};
+        config.dst = {base + luma_size + 2 * chroma_size, luma_size * output_bytes_per_pixel,
+                      static_cast<u16>(FRAME_WIDTH * output_bytes_per_pixel), 0};
+        state.SetItemsPerIteration(luma_size);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            // The conversion advances the buffer addresses, so start from a fresh copy each time.
+            ConversionConfiguration cvt = config;
+            HW::Y2R::PerformConversion(cvt);
+        }
+        DoNotOptimize(env.GetData()[config.dst.address - base]);
+    });
+}
+
+void RegisterY2RBenchmarks(Runner& runner) {
+    AddConversionBenchmark(runner, "YUV422_RGBA8_Linear", InputFormat::YUV422_Indiv8,
+                           OutputFormat::RGBA8, BlockAlignment::Linear, 4);
+    AddConversionBenchmark(runner, "YUV420_RGB565_Block8x8", InputFormat::YUV420_Indiv8,
+                           OutputFormat::RGB565, BlockAlignment::Block8x8, 2);
+}
+
+} // namespace Bench
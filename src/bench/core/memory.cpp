@@ -0,0 +1,123 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+#include "bench/bench.h"
+#include "bench/core/process_environment.h"
+#include "core/hle/kernel/memory.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+
+namespace Bench {
+
+constexpr u32 MEMORY_SIZE = 0x100000;
+constexpr u32 ACCESSES_PER_ITERATION = 4096;
+
+/// Strided word accesses that touch a different page every few accesses.
+static u32 AccessOffset(u32 index) {
+    return (index * 0x104) & (MEMORY_SIZE - 4);
+}
+
+void RegisterMemoryBenchmarks(Runner& runner) {
+    runner.Add("Memory/Read32", [](State& state) {
+        ProcessEnvironment env(MEMORY_SIZE);
+        const VAddr base = env.GetBaseAddress();
+        state.SetItemsPerIteration(ACCESSES_PER_ITERATION);
+        state.SetBytesPerIteration(ACCESSES_PER_ITERATION * sizeof(u32));
+
+        u32 sum = 0;
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (u32 j = 0; j < ACCESSES_PER_ITERATION; ++j) {
+                sum += Memory::Read32(base + AccessOffset(j));
+            }
+        }
+        DoNotOptimize(sum);
+    });
+
+    runner.Add("Memory/Write32", [](State& state) {
+        ProcessEnvironment env(MEMORY_SIZE);
+        const VAddr base = env.GetBaseAddress();
+        state.SetItemsPerIteration(ACCESSES_PER_ITERATION);
+        state.SetBytesPerIteration(ACCESSES_PER_ITERATION * sizeof(u32));
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (u32 j = 0; j < ACCESSES_PER_ITERATION; ++j) {
+                Memory::Write32(base + AccessOffset(j), j);
+            }
+        }
+        DoNotOptimize(env.GetData()[0]);
+    });
+
+    // Physical translations done by the GPU for each vertex buffer, texture and render target
+    runner.Add("Memory/GetPhysicalPointer/VRAM", [](State& state) {
+        Memory::InitPhysicalMemory();
+        state.SetItemsPerIteration(ACCESSES_PER_ITERATION);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (u32 j = 0; j < ACCESSES_PER_ITERATION; ++j) {
+                DoNotOptimize(Memory::GetPhysicalPointer(Memory::VRAM_PADDR + AccessOffset(j)));
+            }
+        }
+        Memory::ShutdownPhysicalMemory();
+    });
+
+    runner.Add("Memory/GetPhysicalPointer/FCRAM", [](State& state) {
+        Kernel::MemoryInit(0);
+        // Addresses in the BASE region, the last one searched
+        const PAddr base = Memory::FCRAM_PADDR_END - MEMORY_SIZE;
+        state.SetItemsPerIteration(ACCESSES_PER_ITERATION);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (u32 j = 0; j < ACCESSES_PER_ITERATION; ++j) {
+                DoNotOptimize(Memory::GetPhysicalPointer(base + AccessOffset(j)));
+            }
+        }
+        Kernel::MemoryShutdown();
+    });
+
+    // Random accesses all over the APPLICATION region mapped as linear heap, where the number of
+    // host TLB entries needed to cover FCRAM matters
+    runner.Add("Memory/Read32/LinearHeapRandom", [](State& state) {
+        constexpr u32 HEAP_SIZE = 0x4000000;
+        ProcessEnvironment env(Memory::PAGE_SIZE);
+        Kernel::MemoryInit(0);
+        Memory::MapMemoryRegion(*Memory::GetCurrentPageTable(), Memory::LINEAR_HEAP_VADDR,
+                                HEAP_SIZE, Memory::GetFCRAMPointer(0));
+
+        std::mt19937 rng(0);
+        std::vector<u32> offsets(ACCESSES_PER_ITERATION);
+        for (auto& offset : offsets) {
+            offset = (rng() % HEAP_SIZE) & ~3u;
+        }
+        state.SetItemsPerIteration(ACCESSES_PER_ITERATION);
+        state.SetBytesPerIteration(ACCESSES_PER_ITERATION * sizeof(u32));
+
+        u32 sum = 0;
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (u32 offset : offsets) {
+                sum += Memory::Read32(Memory::LINEAR_HEAP_VADDR + offset);
+            }
+        }
+        DoNotOptimize(sum);
+
+        Memory::UnmapRegion(*Memory::GetCurrentPageTable(), Memory::LINEAR_HEAP_VADDR, HEAP_SIZE);
+        Kernel::MemoryShutdown();
+    });
+
+    for (u32 size : {0x40u, 0x1000u, 0x10000u}) {
+        runner.Add("Memory/ReadBlock/" + std::to_string(size), [size](State& state) {
+            ProcessEnvironment env(MEMORY_SIZE);
+            // Start in the middle of a page so that every block crosses page boundaries.
+            const VAddr source = env.GetBaseAddress() + 0x800;
+            std::vector<u8> buffer(size);
+            state.SetBytesPerIteration(size);
+
+            for (u64 i = 0; i < state.Iterations(); ++i) {
+                Memory::ReadBlock(source, buffer.data(), size);
+                DoNotOptimize(buffer[0]);
+            }
+        });
+    }
+}
+
+} // namespace Bench
@@ -0,0 +1,36 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "bench/core/process_environment.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+
+namespace Bench {
+
+ProcessEnvironment::ProcessEnvironment(u32 size) : memory(size) {
+    process = Kernel::Process::Create(Kernel::CodeSet::Create("", 0));
+    Memory::PageTable& page_table = process->vm_manager.page_table;
+
+    page_table.pointers.fill(nullptr);
+    page_table.attributes.fill(Memory::PageType::Unmapped);
+    page_table.cached_res_count.fill(0);
+
+    Memory::MapMemoryRegion(page_table, Memory::HEAP_VADDR, size, memory.data());
+
+    Kernel::g_current_process = process;
+    Memory::SetCurrentPageTable(&page_table);
+}
+
+ProcessEnvironment::~ProcessEnvironment() {
+    Memory::UnmapRegion(process->vm_manager.page_table, Memory::HEAP_VADDR,
+                        static_cast<u32>(memory.size()));
+    Memory::SetCurrentPageTable(nullptr);
+    Kernel::g_current_process = nullptr;
+}
+
+VAddr ProcessEnvironment::GetBaseAddress() const {
+    return Memory::HEAP_VADDR;
+}
+
+} // namespace Bench
@@ -0,0 +1,33 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+#include "common/common_types.h"
+#include "core/hle/kernel/process.h"
+
+namespace Bench {
+
+/**
+ * Creates an empty process with a block of host memory mapped at HEAP_VADDR and makes it the
+ * current process, so that the Memory functions used by HLE code operate on that block.
+ */
+class ProcessEnvironment {
+public:
+    explicit ProcessEnvironment(u32 size);
+    ~ProcessEnvironment();
+
+    VAddr GetBaseAddress() const;
+
+    u8* GetData() {
+        return memory.data();
+    }
+
+private:
+    Kernel::SharedPtr<Kernel::Process> process;
+    std::vector<u8> memory;
+};
+
+} // namespace Bench
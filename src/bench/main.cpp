@@ -0,0 +1,103 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "bench/bench.h"
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+
+static void PrintHelp(const char* argv0) {
+    std::printf("Usage: %s [options]\n"
+                "  --filter=STRING      Only run benchmarks whose name contains STRING\n"
+                "  --min-time=MS        Minimum duration of one repetition (default: 100)\n"
+                "  --repetitions=N      Repetitions, the median is reported (default: 5)\n"
+                "  --out=FILE           Write JSON results to FILE instead of stdout\n"
+                "  --list               List the available benchmarks and exit\n"
+                "  -h, --help           Display this help and exit\n",
+                argv0);
+}
+
+/// Returns the value of an option of the form "--name=value", or nullptr if arg is not that option.
+static const char* GetOptionValue(const char* arg, const char* name) {
+    const size_t length = std::strlen(name);
+    if (std::strncmp(arg, name, length) == 0 && arg[length] == '=') {
+        return arg + length + 1;
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    Bench::Options options;
+    std::string out_path;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* value;
+        if ((value = GetOptionValue(argv[i], "--filter"))) {
+            options.filter = value;
+        } else if ((value = GetOptionValue(argv[i], "--min-time"))) {
+            options.min_time = std::chrono::milliseconds(std::strtoul(value, nullptr, 10));
+        } else if ((value = GetOptionValue(argv[i], "--repetitions"))) {
+            options.repetitions = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        } else if ((value = GetOptionValue(argv[i], "--out"))) {
+            out_path = value;
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            list = true;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            PrintHelp(argv[0]);
+            return 0;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            PrintHelp(argv[0]);
+            return 1;
+        }
+    }
+
+    // Benchmarks exercise error paths too, keep the log from dominating the measurements.
+    Log::Filter log_filter(Log::Level::Critical);
+    Log::SetFilter(&log_filter);
+
+    Bench::Runner runner;
+    Bench::RegisterAudioCodecBenchmarks(runner);
+    Bench::RegisterCoreTimingBenchmarks(runner);
+    Bench::RegisterCROHelperBenchmarks(runner);
+    Bench::RegisterFramebufferBenchmarks(runner);
+    Bench::RegisterGPUBenchmarks(runner);
+    Bench::RegisterHandleTableBenchmarks(runner);
+    Bench::RegisterHashBenchmarks(runner);
+    Bench::RegisterLightingBenchmarks(runner);
+    Bench::RegisterLZSSBenchmarks(runner);
+    Bench::RegisterMemoryBenchmarks(runner);
+    Bench::RegisterMortonBenchmarks(runner);
+    Bench::RegisterProcTexBenchmarks(runner);
+    Bench::RegisterRomFSReaderBenchmarks(runner);
+    Bench::RegisterRoomBenchmarks(runner);
+    Bench::RegisterRoomMemberBenchmarks(runner);
+    Bench::RegisterShaderBenchmarks(runner);
+    Bench::RegisterShaderGenBenchmarks(runner);
+    Bench::RegisterTextureBenchmarks(runner);
+    Bench::RegisterVertexLoaderBenchmarks(runner);
+    Bench::RegisterY2RBenchmarks(runner);
+
+    if (list) {
+        for (const auto& name : runner.GetNames()) {
+            std::printf("%s\n", name.c_str());
+        }
+        return 0;
+    }
+
+    const std::string json = Bench::FormatJSON(runner.Run(options));
+    if (out_path.empty()) {
+        std::fputs(json.c_str(), stdout);
+    } else if (!FileUtil::WriteStringToFile(true, json, out_path.c_str())) {
+        std::fprintf(stderr, "Failed to write results to %s\n", out_path.c_str());
+        return 1;
+    }
+
+    return 0;
+}
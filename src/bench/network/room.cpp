@@ -0,0 +1,137 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/bench.h"
+#include "common/assert.h"
+#include "network/network.h"
+
+namespace Bench {
+
+using Network::MacAddress;
+using Network::RoomMember;
+using Network::WifiPacket;
+
+constexpr u16 BENCH_ROOM_PORT = 24874;
+constexpr unsigned NUM_MEMBERS = 8;
+constexpr unsigned FRAMES_PER_MEMBER = 64;
+constexpr size_t FRAME_SIZE = 64;
+/// How long to wait for frames before giving up on them, they are sent unreliably
+constexpr std::chrono::milliseconds RECEIVE_TIMEOUT{1000};
+
+/// A room on the loopback interface with several joined members, all counting received frames.
+class LoadedRoom {
+public:
+    LoadedRoom() {
+        Network::Init();
+        room = Network::GetRoom().lock();
+        room->Create("bench", "127.0.0.1", BENCH_ROOM_PORT);
+
+        for (unsigned i = 0; i < NUM_MEMBERS; ++i) {
+            auto member = std::make_unique<RoomMember>();
+            member->Join("member" + std::to_string(i), "127.0.0.1", BENCH_ROOM_PORT);
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (member->GetState() == RoomMember::State::Joining &&
+                   std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ASSERT_MSG(member->GetState() == RoomMember::State::Joined,
+                       "member%u could not join the room", i);
+            handles.push_back(member->BindOnWifiPacketReceived([this](const WifiPacket&) {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++received;
+                received_cv.notify_one();
+            }));
+            members.push_back(std::move(member));
+        }
+    }
+
+    ~LoadedRoom() {
+        // The members have to be gone before ENet is shut down
+        for (unsigned i = 0; i < NUM_MEMBERS; ++i) {
+            members[i]->Unbind(handles[i]);
+            members[i]->Leave();
+        }
+        members.clear();
+        room.reset();
+        Network::Shutdown();
+    }
+
+    /**
+     * Has every member send frames to the next member, or to everyone if broadcast is set, and
+     * waits until the given number of frames arrived. Lost frames fail the run, as the measured
+     * time would then include the receive timeout.
+     */
+    void Exchange(bool broadcast, unsigned expected_frames) {
+        std::unique_lock<std::mutex> lock(mutex);
+        received = 0;
+        lock.unlock();
+
+        WifiPacket frame;
+        frame.type = WifiPacket::PacketType::Data;
+        frame.channel = 1;
+        frame.data.resize(FRAME_SIZE);
+        for (unsigned frame_index = 0; frame_index < FRAMES_PER_MEMBER; ++frame_index) {
+            for (unsigned i = 0; i < NUM_MEMBERS; ++i) {
+                frame.transmitter_address = members[i]->GetMacAddress();
+                frame.destination_address =
+                    broadcast ? Network::BroadcastMac
+                              : members[(i + 1) % NUM_MEMBERS]->GetMacAddress();
+                members[i]->SendWifiPacket(frame);
+            }
+        }
+
+        lock.lock();
+        const bool all_received = received_cv.wait_for(
+            lock, RECEIVE_TIMEOUT, [this, expected_frames] { return received >= expected_frames; });
+        ASSERT_MSG(all_received, "Only %u of %u frames were forwarded", received, expected_frames);
+    }
+
+private:
+    std::shared_ptr<Network::Room> room;
+    std::vector<std::unique_ptr<RoomMember>> members;
+    std::vector<RoomMember::CallbackHandle<WifiPacket>> handles;
+
+    std::mutex mutex;
+    std::condition_variable received_cv;
+    unsigned received = 0;
+};
+
+void RegisterRoomBenchmarks(Runner& runner) {
+    // Frames forwarded by the room per second, from every member to its neighbour and from every
+    // member to all others. Joining and leaving the room are not measured.
+    runner.Add("Room/Forward/Unicast", [](State& state) {
+        state.PauseTiming();
+        LoadedRoom loaded_room;
+        state.ResumeTiming();
+        const unsigned frames = NUM_MEMBERS * FRAMES_PER_MEMBER;
+        state.SetItemsPerIteration(frames);
+        state.SetBytesPerIteration(frames * FRAME_SIZE);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            loaded_room.Exchange(false, frames);
+        }
+        state.PauseTiming();
+    });
+
+    runner.Add("Room/Forward/Broadcast", [](State& state) {
+        state.PauseTiming();
+        LoadedRoom loaded_room;
+        state.ResumeTiming();
+        const unsigned frames = NUM_MEMBERS * FRAMES_PER_MEMBER * (NUM_MEMBERS - 1);
+        state.SetItemsPerIteration(frames);
+        state.SetBytesPerIteration(frames * FRAME_SIZE);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            loaded_room.Exchange(true, frames);
+        }
+        state.PauseTiming();
+    });
+}
+
+} // namespace Bench
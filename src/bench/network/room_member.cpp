@@ -0,0 +1,139 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "bench/bench.h"
+#include "common/assert.h"
+#include "network/network.h"
+
+namespace Bench {
+
+using Network::RoomMember;
+using Network::WifiPacket;
+
+constexpr u16 BENCH_ROOM_PORT = 24873;
+constexpr unsigned FRAMES_PER_BURST = 256;
+constexpr size_t FRAME_SIZE = 64;
+/// How long to wait for frames before giving up on them, they are sent unreliably
+constexpr std::chrono::milliseconds RECEIVE_TIMEOUT{1000};
+
+/// A room on the loopback interface with two joined members, and counters of received frames.
+class LoopbackRoom {
+public:
+    LoopbackRoom() {
+        Network::Init();
+        room = Network::GetRoom().lock();
+        room->Create("bench", "127.0.0.1", BENCH_ROOM_PORT);
+        // The members have to be gone before ENet is shut down
+        sender = std::make_unique<RoomMember>();
+        receiver = std::make_unique<RoomMember>();
+        JoinMember(*sender, "sender");
+        JoinMember(*receiver, "receiver");
+
+        // The receiver echoes every frame back to the sender
+        receiver_handle = receiver->BindOnWifiPacketReceived([this](const WifiPacket& packet) {
+            WifiPacket echo = packet;
+            echo.transmitter_address = packet.destination_address;
+            echo.destination_address = packet.transmitter_address;
+            receiver->SendWifiPacket(echo);
+        });
+        sender_handle = sender->BindOnWifiPacketReceived([this](const WifiPacket&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++received;
+            received_cv.notify_one();
+        });
+
+        frame.type = WifiPacket::PacketType::Data;
+        frame.channel = 1;
+        frame.transmitter_address = sender->GetMacAddress();
+        frame.destination_address = receiver->GetMacAddress();
+        frame.data.resize(FRAME_SIZE);
+    }
+
+    ~LoopbackRoom() {
+        sender->Unbind(sender_handle);
+        receiver->Unbind(receiver_handle);
+        sender->Leave();
+        receiver->Leave();
+        sender.reset();
+        receiver.reset();
+        room.reset();
+        Network::Shutdown();
+    }
+
+    /**
+     * Sends the given number of frames to the receiver and waits for all echoes to arrive. Lost
+     * frames fail the run, as the measured time would then include the receive timeout.
+     */
+    void RoundTrip(unsigned count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        received = 0;
+        lock.unlock();
+
+        for (unsigned i = 0; i < count; ++i) {
+            sender->SendWifiPacket(frame);
+        }
+
+        lock.lock();
+        const bool all_received = received_cv.wait_for(
+            lock, RECEIVE_TIMEOUT, [this, count] { return received >= count; });
+        ASSERT_MSG(all_received, "Only %u of %u frames were echoed back", received, count);
+    }
+
+private:
+    static void JoinMember(RoomMember& member, const char* nickname) {
+        member.Join(nickname, "127.0.0.1", BENCH_ROOM_PORT);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (member.GetState() == RoomMember::State::Joining &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_MSG(member.GetState() == RoomMember::State::Joined, "%s could not join the room",
+                   nickname);
+    }
+
+    std::shared_ptr<Network::Room> room;
+    std::unique_ptr<RoomMember> sender;
+    std::unique_ptr<RoomMember> receiver;
+    RoomMember::CallbackHandle<WifiPacket> sender_handle;
+    RoomMember::CallbackHandle<WifiPacket> receiver_handle;
+    WifiPacket frame;
+
+    std::mutex mutex;
+    std::condition_variable received_cv;
+    unsigned received = 0;
+};
+
+void RegisterRoomMemberBenchmarks(Runner& runner) {
+    // Latency of one data frame from a member to another and back, through the room
+    // Joining and leaving the room are not measured, leaving waits for the room loop to time out
+    runner.Add("RoomMember/RoundTrip", [](State& state) {
+        state.PauseTiming();
+        LoopbackRoom loopback;
+        state.ResumeTiming();
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            loopback.RoundTrip(1);
+        }
+        state.PauseTiming();
+    });
+
+    runner.Add("RoomMember/Burst", [](State& state) {
+        state.PauseTiming();
+        LoopbackRoom loopback;
+        state.ResumeTiming();
+        state.SetItemsPerIteration(FRAMES_PER_BURST);
+        state.SetBytesPerIteration(FRAMES_PER_BURST * FRAME_SIZE);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            loopback.RoundTrip(FRAMES_PER_BURST);
+        }
+        state.PauseTiming();
+    });
+}
+
+} // namespace Bench
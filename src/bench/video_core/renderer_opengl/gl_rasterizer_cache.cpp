@@ -0,0 +1,44 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include "bench/bench.h"
+#include "video_core/renderer_opengl/gl_rasterizer_cache.h"
+
+namespace Bench {
+
+using PixelFormat = CachedSurface::PixelFormat;
+
+/// Dimensions of the top screen framebuffer.
+constexpr u32 SURFACE_WIDTH = 400;
+constexpr u32 SURFACE_HEIGHT = 240;
+
+static void AddMortonBenchmark(Runner& runner, const char* name, PixelFormat format,
+                               bool morton_to_gl) {
+    runner.Add(std::string("Morton/MortonCopyPixels/") + name, [=](State& state) {
+        const u32 bytes_per_pixel = CachedSurface::GetFormatBpp(format) / 8;
+        const u32 gl_bytes_per_pixel = format == PixelFormat::D24 ? 4 : bytes_per_pixel;
+        std::vector<u8> morton_data(SURFACE_WIDTH * SURFACE_HEIGHT * bytes_per_pixel);
+        std::vector<u8> gl_data(SURFACE_WIDTH * SURFACE_HEIGHT * gl_bytes_per_pixel);
+        state.SetBytesPerIteration(morton_data.size());
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            MortonCopyPixels(format, SURFACE_WIDTH, SURFACE_HEIGHT, bytes_per_pixel,
+                             gl_bytes_per_pixel, morton_data.data(), gl_data.data(),
+                             morton_to_gl);
+            DoNotOptimize(morton_to_gl ? gl_data[0] : morton_data[0]);
+        }
+    });
+}
+
+void RegisterMortonBenchmarks(Runner& runner) {
+    AddMortonBenchmark(runner, "RGBA8/ToGL", PixelFormat::RGBA8, true);
+    AddMortonBenchmark(runner, "RGBA8/FromGL", PixelFormat::RGBA8, false);
+    AddMortonBenchmark(runner, "RGB8/ToGL", PixelFormat::RGB8, true);
+    AddMortonBenchmark(runner, "RGB565/ToGL", PixelFormat::RGB565, true);
+    AddMortonBenchmark(runner, "D24S8/ToGL", PixelFormat::D24S8, true);
+    AddMortonBenchmark(runner, "D24S8/FromGL", PixelFormat::D24S8, false);
+}
+
+} // namespace Bench
@@ -0,0 +1,161 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "common/thread_pool.h"
+#include "video_core/renderer_opengl/gl_shader_gen.h"
+
+namespace Bench {
+
+using GLShader::PicaShaderConfig;
+using TevStageConfig = Pica::TexturingRegs::TevStageConfig;
+
+/// Number of distinct configurations generated per iteration by the batch benchmarks.
+constexpr unsigned BATCH_SIZE = 64;
+
+constexpr u32 Sources(TevStageConfig::Source a, TevStageConfig::Source b,
+                      TevStageConfig::Source c) {
+    return static_cast<u32>(a) | static_cast<u32>(b) << 4 | static_cast<u32>(c) << 8 |
+           static_cast<u32>(a) << 16 | static_cast<u32>(b) << 20 | static_cast<u32>(c) << 24;
+}
+
+constexpr u32 Ops(u32 op) {
+    return op | op << 16;
+}
+
+/**
+ * Builds a texture combiner setup typical of 3D scenes: the first stages modulate two textures
+ * with the vertex color, the others blend in constants. The variant changes the operations of
+ * the later stages, to obtain distinct configurations.
+ */
+static PicaShaderConfig MakeTevConfig(unsigned variant) {
+    using Source = TevStageConfig::Source;
+
+    PicaShaderConfig config;
+    std::memset(&config.state, 0, sizeof(config.state));
+    auto& state = config.state;
+    state.alpha_test_func = Pica::FramebufferRegs::CompareFunc::GreaterThan;
+    state.scissor_test_mode = Pica::RasterizerRegs::ScissorMode::Disabled;
+    state.depthmap_enable = Pica::RasterizerRegs::DepthBuffering::WBuffering;
+    state.fog_mode = Pica::TexturingRegs::FogMode::Fog;
+
+    state.tev_stages[0].sources_raw =
+        Sources(Source::Texture0, Source::PrimaryColor, Source::Constant);
+    state.tev_stages[0].ops_raw = Ops(1); // Modulate
+    state.tev_stages[1].sources_raw = Sources(Source::Previous, Source::Texture1, Source::Constant);
+    state.tev_stages[1].ops_raw = Ops(1);
+    for (unsigned stage = 2; stage < state.tev_stages.size(); ++stage) {
+        state.tev_stages[stage].sources_raw =
+            Sources(Source::Previous, Source::Constant, Source::PreviousBuffer);
+        state.tev_stages[stage].ops_raw = Ops((variant + stage) % 10);
+        variant /= 10;
+    }
+    state.combiner_buffer_input = 0x3;
+
+    return config;
+}
+
+/// Adds fragment lighting with four positional lights and all lookup tables to a configuration.
+static PicaShaderConfig MakeLightingConfig(unsigned variant) {
+    PicaShaderConfig config = MakeTevConfig(variant);
+    auto& lighting = config.state.lighting;
+    lighting.enable = true;
+    lighting.src_num = 4;
+    for (unsigned i = 0; i < lighting.src_num; ++i) {
+        lighting.light[i].num = i;
+        lighting.light[i].dist_atten_enable = true;
+        lighting.light[i].spot_atten_enable = i % 2 == 0;
+        lighting.light[i].geometric_factor_0 = true;
+    }
+    lighting.config = Pica::LightingRegs::LightingConfig::Config7;
+    lighting.clamp_highlights = true;
+    for (auto* lut : {&lighting.lut_d0, &lighting.lut_d1, &lighting.lut_sp, &lighting.lut_fr,
+                      &lighting.lut_rr, &lighting.lut_rg, &lighting.lut_rb}) {
+        lut->enable = true;
+        lut->abs_input = true;
+        lut->type = Pica::LightingRegs::LightingLutInput::NH;
+        lut->scale = 1.0f;
+    }
+    return config;
+}
+
+/// Adds a noisy procedural texture to a configuration.
+static PicaShaderConfig MakeProcTexConfig(unsigned variant) {
+    using Source = TevStageConfig::Source;
+
+    PicaShaderConfig config = MakeTevConfig(variant);
+    config.state.tev_stages[1].sources_raw =
+        Sources(Source::Previous, Source::Texture3, Source::Constant);
+    auto& proctex = config.state.proctex;
+    proctex.enable = true;
+    proctex.noise_enable = true;
+    proctex.u_clamp = Pica::TexturingRegs::ProcTexClamp::MirroredRepeat;
+    proctex.v_clamp = Pica::TexturingRegs::ProcTexClamp::ToEdge;
+    proctex.color_combiner = Pica::TexturingRegs::ProcTexCombiner::SqrtAdd2;
+    proctex.alpha_combiner = Pica::TexturingRegs::ProcTexCombiner::Min;
+    proctex.lut_width = 128;
+    proctex.lut_filter = Pica::TexturingRegs::ProcTexFilter::Linear;
+    return config;
+}
+
+static void AddGenerateBenchmark(Runner& runner, const char* name,
+                                 PicaShaderConfig (*make_config)(unsigned)) {
+    runner.Add(std::string("GLShader/GenerateFragmentShader/") + name, [=](State& state) {
+        const PicaShaderConfig config = make_config(0);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            std::string source = GLShader::GenerateFragmentShader(config);
+            DoNotOptimize(source.data());
+        }
+    });
+}
+
+static std::vector<PicaShaderConfig> MakeBatch() {
+    std::vector<PicaShaderConfig> configs;
+    for (unsigned i = 0; i < BATCH_SIZE; ++i) {
+        configs.push_back(i % 2 ? MakeLightingConfig(i) : MakeTevConfig(i));
+    }
+    return configs;
+}
+
+void RegisterShaderGenBenchmarks(Runner& runner) {
+    AddGenerateBenchmark(runner, "Tev", MakeTevConfig);
+    AddGenerateBenchmark(runner, "Lighting", MakeLightingConfig);
+    AddGenerateBenchmark(runner, "ProcTex", MakeProcTexConfig);
+
+    // Shader cache warm-up: generating a title's known configurations serially, and on the
+    // thread pool as the OpenGL rasterizer does while booting
+    runner.Add("GLShader/WarmUp/Serial", [](State& state) {
+        const std::vector<PicaShaderConfig> configs = MakeBatch();
+        state.SetItemsPerIteration(configs.size());
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (const auto& config : configs) {
+                std::string source = GLShader::GenerateFragmentShader(config);
+                DoNotOptimize(source.data());
+            }
+        }
+    });
+
+    runner.Add("GLShader/WarmUp/ThreadPool", [](State& state) {
+        const std::vector<PicaShaderConfig> configs = MakeBatch();
+        auto& thread_pool = Common::ThreadPool::GetPool();
+        state.SetItemsPerIteration(configs.size());
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            std::vector<std::future<std::string>> sources;
+            sources.reserve(configs.size());
+            for (const auto& config : configs) {
+                sources.push_back(thread_pool.Push(
+                    [config] { return GLShader::GenerateFragmentShader(config); }));
+            }
+            for (auto& source : sources) {
+                DoNotOptimize(source.get().data());
+            }
+        }
+    });
+}
+
+} // namespace Bench
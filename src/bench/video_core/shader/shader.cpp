@@ -0,0 +1,282 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "common/common_funcs.h"
+#include "video_core/shader/shader.h"
+#include "video_core/shader/shader_interpreter.h"
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/shader/shader_jit_x64.h"
+#endif // ARCHITECTURE_x86_64
+
+namespace Bench {
+
+using namespace Pica::Shader;
+
+constexpr unsigned VERTICES_PER_ITERATION = 1024;
+/// Vertices shaded by each program of the corpus per iteration, as in one draw
+constexpr unsigned VERTICES_PER_DRAW = 256;
+
+namespace OpCode {
+constexpr u32 ADD = 0x00;
+constexpr u32 DP3 = 0x01;
+constexpr u32 DP4 = 0x02;
+constexpr u32 MUL = 0x08;
+constexpr u32 MAX = 0x0C;
+constexpr u32 RSQ = 0x0F;
+constexpr u32 MOVA = 0x12;
+constexpr u32 MOV = 0x13;
+constexpr u32 END = 0x22;
+constexpr u32 CALL = 0x24;
+constexpr u32 LOOP = 0x29;
+} // namespace OpCode
+
+// Register encodings of the PICA instruction set
+constexpr u32 O(u32 index) {
+    return index;
+}
+constexpr u32 V(u32 index) {
+    return index;
+}
+constexpr u32 R(u32 index) {
+    return 0x10 + index;
+}
+constexpr u32 C(u32 index) {
+    return 0x20 + index;
+}
+
+// Operand descriptors, differing only in their destination mask
+enum Desc : u32 { X, Y, Z, W, XYZW };
+
+/// Encodes a format 1 (two source operand) instruction.
+constexpr u32 Instr(u32 opcode, u32 dest, u32 src1, u32 src2, Desc desc) {
+    return (opcode << 26) | (dest << 21) | (src1 << 12) | (src2 << 7) | desc;
+}
+
+// Address registers that can index the first source operand
+enum AddressRegister : u32 { A0X = 1, A0Y = 2, AL = 3 };
+
+/// Encodes a format 1 instruction whose first source operand is indexed by an address register.
+constexpr u32 InstrRel(u32 opcode, u32 dest, u32 src1, AddressRegister index, u32 src2, Desc desc) {
+    return Instr(opcode, dest, src1, src2, desc) | (index << 19);
+}
+
+/// Encodes a flow control instruction.
+constexpr u32 Flow(u32 opcode, u32 dest_offset, u32 num_instructions, u32 uniform_id = 0) {
+    return (opcode << 26) | (uniform_id << 22) | (dest_offset << 10) | num_instructions;
+}
+
+/// Uploads a program and the operand descriptors used by all programs of this file.
+static void UploadProgram(ShaderSetup& setup, const u32* program, size_t length) {
+    // Uploaded like the command processor does, to keep the engines' modification tracking
+    for (unsigned i = 0; i < length; ++i) {
+        setup.WriteProgramCode(i, program[i]);
+    }
+
+    // Destination masks are stored with x in the most significant bit. All three source operands
+    // use the identity swizzle xyzw.
+    constexpr u32 identity_swizzle = 0x1B;
+    const u32 dest_masks[] = {0x8, 0x4, 0x2, 0x1, 0xF};
+    for (u32 i = 0; i < 5; ++i) {
+        setup.WriteSwizzlePattern(i, dest_masks[i] | identity_swizzle << 5 |
+                                         identity_swizzle << 14 | identity_swizzle << 23);
+    }
+}
+
+/// Fills the float uniforms the programs read, and the loop counter of the lighting loop.
+static void SetupUniforms(ShaderSetup& setup) {
+    for (unsigned i = 0; i < 32; ++i) {
+        const float value = 0.25f * (i % 11 + 1);
+        setup.uniforms.f[i] = Math::MakeVec(Pica::float24::FromFloat32(value),
+                                            Pica::float24::FromFloat32(-value),
+                                            Pica::float24::FromFloat32(value * 0.5f),
+                                            Pica::float24::FromFloat32(1.0f));
+    }
+    // 4 iterations, with aL counting up from 0
+    setup.uniforms.i[0] = Math::MakeVec<u8>(3, 0, 1, 0);
+}
+
+/**
+ * Sets up a typical vertex shader: position transform, normal transform and normalization,
+ * diffuse lighting and a texture coordinate passthrough.
+ */
+static void SetupProgram(ShaderSetup& setup) {
+    static const u32 program[] = {
+        Instr(OpCode::DP4, O(0), C(0), V(0), X),     Instr(OpCode::DP4, O(0), C(1), V(0), Y),
+        Instr(OpCode::DP4, O(0), C(2), V(0), Z),     Instr(OpCode::DP4, O(0), C(3), V(0), W),
+        Instr(OpCode::DP3, R(1), C(4), V(1), X),     Instr(OpCode::DP3, R(1), C(5), V(1), Y),
+        Instr(OpCode::DP3, R(1), C(6), V(1), Z),     Instr(OpCode::DP3, R(2), R(1), R(1), XYZW),
+        Instr(OpCode::RSQ, R(2), R(2), 0, XYZW),     Instr(OpCode::MUL, R(1), R(1), R(2), XYZW),
+        Instr(OpCode::DP3, R(3), C(7), R(1), XYZW),  Instr(OpCode::MAX, R(3), C(8), R(3), XYZW),
+        Instr(OpCode::MUL, R(3), C(9), R(3), XYZW),  Instr(OpCode::ADD, O(1), C(10), R(3), XYZW),
+        Instr(OpCode::MOV, O(2), V(2), 0, XYZW),     OpCode::END << 26,
+    };
+    UploadProgram(setup, program, ARRAY_SIZE(program));
+    SetupUniforms(setup);
+}
+
+/**
+ * Vertex shaders in the styles games commonly use, each writing o0 to o2. Together with the
+ * program of SetupProgram they make up the corpus of the Shader/Corpus benchmarks.
+ */
+static const std::vector<std::vector<u32>> corpus_programs = {
+    // Passthrough of pretransformed vertices, as used for 2D and UI elements
+    {
+        Instr(OpCode::MOV, O(0), V(0), 0, XYZW),
+        Instr(OpCode::MOV, O(1), V(1), 0, XYZW),
+        Instr(OpCode::MOV, O(2), V(2), 0, XYZW),
+        OpCode::END << 26,
+    },
+    // Skinning, transforming the position by the bone matrix selected by v3.x
+    {
+        Instr(OpCode::MOVA, 0, V(3), 0, X),
+        InstrRel(OpCode::DP4, O(0), C(20), A0X, V(0), X),
+        InstrRel(OpCode::DP4, O(0), C(21), A0X, V(0), Y),
+        InstrRel(OpCode::DP4, O(0), C(22), A0X, V(0), Z),
+        InstrRel(OpCode::DP4, O(0), C(23), A0X, V(0), W),
+        Instr(OpCode::MOV, O(1), V(1), 0, XYZW),
+        Instr(OpCode::MOV, O(2), V(2), 0, XYZW),
+        OpCode::END << 26,
+    },
+    // Diffuse lighting accumulated over several lights in a loop, indexed by aL
+    {
+        Instr(OpCode::DP4, O(0), C(0), V(0), X),
+        Instr(OpCode::DP4, O(0), C(1), V(0), Y),
+        Instr(OpCode::DP4, O(0), C(2), V(0), Z),
+        Instr(OpCode::DP4, O(0), C(3), V(0), W),
+        Instr(OpCode::MOV, R(1), C(9), 0, XYZW),
+        Flow(OpCode::LOOP, 8, 0),
+        InstrRel(OpCode::DP3, R(2), C(16), AL, V(1), XYZW),
+        Instr(OpCode::MAX, R(2), C(8), R(2), XYZW),
+        Instr(OpCode::ADD, R(1), R(1), R(2), XYZW),
+        Instr(OpCode::MOV, O(1), R(1), 0, XYZW),
+        Instr(OpCode::MOV, O(2), V(2), 0, XYZW),
+        OpCode::END << 26,
+    },
+    // Transform in a subroutine, and an output the pipeline is not configured to read
+    {
+        Instr(OpCode::MOV, O(2), V(2), 0, XYZW),
+        Flow(OpCode::CALL, 5, 4),
+        Instr(OpCode::MOV, O(1), V(1), 0, XYZW),
+        Instr(OpCode::MOV, O(3), V(1), 0, XYZW),
+        OpCode::END << 26,
+        Instr(OpCode::DP4, O(0), C(0), V(0), X),
+        Instr(OpCode::DP4, O(0), C(1), V(0), Y),
+        Instr(OpCode::DP4, O(0), C(2), V(0), Z),
+        Instr(OpCode::DP4, O(0), C(3), V(0), W),
+    },
+};
+
+/// Sets up the input registers of a vertex for all programs of this file.
+static void SetupInputs(UnitState& unit_state) {
+    for (unsigned i = 0; i < 3; ++i) {
+        unit_state.registers.input[i] =
+            Math::MakeVec(Pica::float24::FromFloat32(1.0f), Pica::float24::FromFloat32(2.0f),
+                          Pica::float24::FromFloat32(3.0f), Pica::float24::FromFloat32(1.0f));
+    }
+    // Index of the second bone matrix
+    unit_state.registers.input[3] =
+        Math::MakeVec(Pica::float24::FromFloat32(4.0f), Pica::float24::FromFloat32(0.0f),
+                      Pica::float24::FromFloat32(0.0f), Pica::float24::FromFloat32(0.0f));
+}
+
+static void AddShaderBenchmark(Runner& runner, const char* name,
+                               std::function<std::unique_ptr<ShaderEngine>()> make_engine) {
+    runner.Add(std::string("Shader/Run/") + name, [make_engine](State& state) {
+        auto engine = make_engine();
+        auto setup = std::make_unique<ShaderSetup>();
+        SetupProgram(*setup);
+        // o0 to o2 are written by the program
+        engine->SetupBatch(*setup, 0, 0x7);
+
+        UnitState unit_state;
+        SetupInputs(unit_state);
+        state.SetItemsPerIteration(VERTICES_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (unsigned vertex = 0; vertex < VERTICES_PER_ITERATION; ++vertex) {
+                engine->Run(*setup, unit_state);
+            }
+            DoNotOptimize(unit_state.registers.output[0]);
+        }
+    });
+}
+
+/**
+ * Measures shader throughput over the corpus of programs, each set up for a draw in turn as in a
+ * frame rendering several kinds of objects.
+ */
+static void AddCorpusBenchmark(Runner& runner, const char* name,
+                               std::function<std::unique_ptr<ShaderEngine>()> make_engine) {
+    runner.Add(std::string("Shader/Corpus/") + name, [make_engine](State& state) {
+        auto engine = make_engine();
+        std::vector<std::unique_ptr<ShaderSetup>> setups;
+        setups.push_back(std::make_unique<ShaderSetup>());
+        SetupProgram(*setups.back());
+        for (const auto& program : corpus_programs) {
+            setups.push_back(std::make_unique<ShaderSetup>());
+            UploadProgram(*setups.back(), program.data(), program.size());
+            SetupUniforms(*setups.back());
+        }
+
+        UnitState unit_state;
+        SetupInputs(unit_state);
+        state.SetItemsPerIteration(VERTICES_PER_DRAW * setups.size());
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (auto& setup : setups) {
+                engine->SetupBatch(*setup, 0, 0x7);
+                for (unsigned vertex = 0; vertex < VERTICES_PER_DRAW; ++vertex) {
+                    engine->Run(*setup, unit_state);
+                }
+                DoNotOptimize(unit_state.registers.output[0]);
+            }
+        }
+    });
+}
+
+/**
+ * Measures the per-draw overhead of small draws: the game uploads its program again, as most do
+ * before each draw, then the batch is set up and a quad is shaded.
+ */
+static void AddSmallDrawBenchmark(Runner& runner, const char* name,
+                                  std::function<std::unique_ptr<ShaderEngine>()> make_engine) {
+    runner.Add(std::string("Shader/SmallDraw/") + name, [make_engine](State& state) {
+        auto engine = make_engine();
+        auto setup = std::make_unique<ShaderSetup>();
+        SetupProgram(*setup);
+        const std::array<u32, MAX_PROGRAM_CODE_LENGTH> program = setup->GetProgramCode();
+
+        UnitState unit_state;
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (unsigned word = 0; word < 16; ++word) {
+                setup->WriteProgramCode(word, program[word]);
+            }
+            engine->SetupBatch(*setup, 0, 0x7);
+            for (unsigned vertex = 0; vertex < 4; ++vertex) {
+                engine->Run(*setup, unit_state);
+            }
+            DoNotOptimize(unit_state.registers.output[0]);
+        }
+    });
+}
+
+void RegisterShaderBenchmarks(Runner& runner) {
+    AddShaderBenchmark(runner, "Interpreter", [] { return std::make_unique<InterpreterEngine>(); });
+    AddCorpusBenchmark(runner, "Interpreter", [] { return std::make_unique<InterpreterEngine>(); });
+    AddSmallDrawBenchmark(runner, "Interpreter",
+                          [] { return std::make_unique<InterpreterEngine>(); });
+#ifdef ARCHITECTURE_x86_64
+    AddShaderBenchmark(runner, "JitX64", [] { return std::make_unique<JitX64Engine>(); });
+    AddCorpusBenchmark(runner, "JitX64", [] { return std::make_unique<JitX64Engine>(); });
+    AddSmallDrawBenchmark(runner, "JitX64", [] { return std::make_unique<JitX64Engine>(); });
+#endif // ARCHITECTURE_x86_64
+}
+
+} // namespace Bench
@@ -0,0 +1,72 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include "bench/bench.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+#include "video_core/pica_state.h"
+#include "video_core/swrasterizer/framebuffer.h"
+
+namespace Bench {
+
+using Pica::FramebufferRegs;
+
+constexpr u32 FRAMEBUFFER_WIDTH = 400;
+constexpr u32 FRAMEBUFFER_HEIGHT = 240;
+constexpr unsigned FRAGMENTS_PER_ITERATION = 1024;
+
+/// Places a 400x240 color buffer and a depth buffer in VRAM, like the top screen of a game.
+static void SetupFramebuffer(FramebufferRegs::ColorFormat color_format,
+                             FramebufferRegs::DepthFormat depth_format) {
+    auto& framebuffer = Pica::g_state.regs.framebuffer.framebuffer;
+    framebuffer.color_format.Assign(color_format);
+    framebuffer.depth_format.Assign(depth_format);
+    framebuffer.width.Assign(FRAMEBUFFER_WIDTH);
+    framebuffer.height.Assign(FRAMEBUFFER_HEIGHT - 1);
+    framebuffer.color_buffer_address.Assign(Memory::VRAM_PADDR / 8);
+    framebuffer.depth_buffer_address.Assign((Memory::VRAM_PADDR + 0x100000) / 8);
+    Pica::Rasterizer::InvalidateRenderTargets();
+}
+
+/**
+ * Performs the framebuffer accesses of fragments with depth and stencil testing and blending,
+ * over a horizontal span as the rasterizer walks a triangle.
+ */
+static void AddFragmentOutputBenchmark(Runner& runner, const char* name,
+                                       FramebufferRegs::ColorFormat color_format,
+                                       FramebufferRegs::DepthFormat depth_format) {
+    runner.Add(std::string("Framebuffer/FragmentOutput/") + name, [=](State& state) {
+        Memory::InitPhysicalMemory();
+        SetupFramebuffer(color_format, depth_format);
+        state.SetItemsPerIteration(FRAGMENTS_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            // As in the rasterizer, the targets are fetched once per triangle
+            const auto& targets =
+                Pica::Rasterizer::GetRenderTargets(Pica::g_state.regs.framebuffer.framebuffer);
+            for (unsigned fragment = 0; fragment < FRAGMENTS_PER_ITERATION; ++fragment) {
+                const int x = fragment % FRAMEBUFFER_WIDTH;
+                const int y = fragment / FRAMEBUFFER_WIDTH + 16;
+                const u8 stencil = targets.depth.GetStencil(x, y);
+                targets.depth.SetStencil(x, y, stencil + 1);
+                const u32 depth = targets.depth.GetDepth(x, y);
+                targets.depth.SetDepth(x, y, depth + 1);
+                Math::Vec4<u8> color = targets.color.GetPixel(x, y);
+                color.r() += 1;
+                targets.color.DrawPixel(x, y, color);
+            }
+        }
+        Memory::ShutdownPhysicalMemory();
+    });
+}
+
+void RegisterFramebufferBenchmarks(Runner& runner) {
+    AddFragmentOutputBenchmark(runner, "RGBA8_D24S8", FramebufferRegs::ColorFormat::RGBA8,
+                               FramebufferRegs::DepthFormat::D24S8);
+    AddFragmentOutputBenchmark(runner, "RGB565_D24S8", FramebufferRegs::ColorFormat::RGB565,
+                               FramebufferRegs::DepthFormat::D24S8);
+}
+
+} // namespace Bench
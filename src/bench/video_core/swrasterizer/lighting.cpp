@@ -0,0 +1,142 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "video_core/swrasterizer/lighting.h"
+
+namespace Bench {
+
+using Pica::LightingRegs;
+
+constexpr unsigned FRAGMENTS_PER_ITERATION = 1024;
+
+struct LightingFixture {
+    LightingRegs regs{};
+    Pica::State::Lighting state{};
+    std::vector<Math::Quaternion<float>> normquats;
+    std::vector<Math::Vec3<float>> views;
+};
+
+/**
+ * Configures the given number of positional lights using every LUT of lighting configuration 7,
+ * with random LUT contents, and random normals and view vectors for the fragments.
+ */
+static std::unique_ptr<LightingFixture> MakeFixture(unsigned num_lights) {
+    auto fixture = std::make_unique<LightingFixture>();
+    std::mt19937 rng(num_lights);
+
+    for (auto& lut : fixture->state.luts) {
+        for (auto& entry : lut) {
+            entry.raw = rng();
+        }
+    }
+
+    auto& regs = fixture->regs;
+    regs.max_light_index.Assign(num_lights - 1);
+    regs.config0.config.Assign(LightingRegs::LightingConfig::Config7);
+    regs.config0.fresnel_selector.Assign(LightingRegs::LightingFresnelSelector::Both);
+    regs.config0.clamp_highlights.Assign(1);
+    regs.lut_input.d0.Assign(LightingRegs::LightingLutInput::NH);
+    regs.lut_input.d1.Assign(LightingRegs::LightingLutInput::LN);
+    regs.lut_input.sp.Assign(LightingRegs::LightingLutInput::SP);
+    regs.lut_input.fr.Assign(LightingRegs::LightingLutInput::NV);
+    regs.lut_input.rr.Assign(LightingRegs::LightingLutInput::VH);
+    regs.lut_input.rg.Assign(LightingRegs::LightingLutInput::VH);
+    regs.lut_input.rb.Assign(LightingRegs::LightingLutInput::VH);
+    for (unsigned i = 0; i < num_lights; ++i) {
+        auto& light = regs.light[i];
+        light.x.Assign(0x3C00 + i * 0x40); // 1.0 + i / 16 as float16
+        light.y.Assign(0x4000);            // 2.0
+        light.z.Assign(0xBC00);            // -1.0
+        light.spot_z.Assign(-2047);
+        for (auto* color : {&light.specular_0, &light.specular_1, &light.diffuse}) {
+            color->r.Assign(255);
+            color->g.Assign(192);
+            color->b.Assign(128);
+        }
+        light.ambient.r.Assign(16);
+        light.ambient.g.Assign(16);
+        light.ambient.b.Assign(16);
+        light.config.geometric_factor_0.Assign(1);
+        light.dist_atten_scale.Assign(0x3B000); // 0.0625 as float20
+    }
+
+    auto& slots = regs.light_enable;
+    slots.slot_0.Assign(0);
+    slots.slot_1.Assign(1);
+    slots.slot_2.Assign(2);
+    slots.slot_3.Assign(3);
+    slots.slot_4.Assign(4);
+    slots.slot_5.Assign(5);
+    slots.slot_6.Assign(6);
+    slots.slot_7.Assign(7);
+
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (unsigned i = 0; i < FRAGMENTS_PER_ITERATION; ++i) {
+        fixture->normquats.push_back(
+            Math::Quaternion<float>{{dist(rng), dist(rng), dist(rng)}, dist(rng)}.Normalized());
+        fixture->views.push_back({dist(rng) * 4, dist(rng) * 4, dist(rng) * 4 - 8});
+    }
+    return fixture;
+}
+
+/// Makes the next GetLightingSetup call process the registers and LUTs of a new fixture.
+static void InvalidateLighting() {
+    Pica::InvalidateLightingSetup();
+    for (size_t lut = 0; lut < LightingRegs::NumLightingSampler; ++lut) {
+        Pica::InvalidateLightingLut(lut);
+    }
+}
+
+static void AddLightingBenchmark(Runner& runner, unsigned num_lights) {
+    const std::string name = "Lighting/ComputeFragmentsColors/" + std::to_string(num_lights);
+    runner.Add(name + "Lights", [num_lights](State& state) {
+        const auto fixture = MakeFixture(num_lights);
+        const Math::Vec4<u8> texture_color[4] = {};
+        InvalidateLighting();
+        state.SetItemsPerIteration(FRAGMENTS_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            // As in the rasterizer, the setup is fetched once per triangle
+            const auto& setup = Pica::GetLightingSetup(fixture->regs, fixture->state);
+            for (unsigned fragment = 0; fragment < FRAGMENTS_PER_ITERATION; ++fragment) {
+                auto colors = Pica::ComputeFragmentsColors(setup, fixture->normquats[fragment],
+                                                           fixture->views[fragment], texture_color);
+                DoNotOptimize(colors);
+            }
+        }
+    });
+}
+
+void RegisterLightingBenchmarks(Runner& runner) {
+    AddLightingBenchmark(runner, 1);
+    AddLightingBenchmark(runner, 4);
+    AddLightingBenchmark(runner, 8);
+
+    // Cost of reprocessing the configuration after a register write, and of expanding every LUT
+    // after a full LUT upload
+    runner.Add("Lighting/GetLightingSetup/Registers", [](State& state) {
+        const auto fixture = MakeFixture(8);
+        InvalidateLighting();
+        Pica::GetLightingSetup(fixture->regs, fixture->state);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            Pica::InvalidateLightingSetup();
+            DoNotOptimize(Pica::GetLightingSetup(fixture->regs, fixture->state).num_lights);
+        }
+    });
+
+    runner.Add("Lighting/GetLightingSetup/AllLuts", [](State& state) {
+        const auto fixture = MakeFixture(8);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            InvalidateLighting();
+            DoNotOptimize(Pica::GetLightingSetup(fixture->regs, fixture->state).num_lights);
+        }
+    });
+}
+
+} // namespace Bench
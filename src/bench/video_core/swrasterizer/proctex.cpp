@@ -0,0 +1,124 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench/bench.h"
+#include "video_core/swrasterizer/proctex.h"
+
+namespace Bench {
+
+using Pica::TexturingRegs;
+
+constexpr unsigned FRAGMENTS_PER_ITERATION = 1024;
+
+struct ProcTexFixture {
+    TexturingRegs regs{};
+    Pica::State::ProcTex state{};
+    std::vector<float> us;
+    std::vector<float> vs;
+};
+
+/**
+ * Configures a procedural texture mapping a color ramp. With noise, the coordinates are perturbed
+ * and both are combined, otherwise the ramp only follows u and the texture can be baked.
+ */
+static std::unique_ptr<ProcTexFixture> MakeFixture(bool noise) {
+    auto fixture = std::make_unique<ProcTexFixture>();
+    std::mt19937 rng(noise);
+
+    auto& state = fixture->state;
+    for (auto& entry : state.noise_table) {
+        entry.raw = rng();
+    }
+    for (unsigned i = 0; i < state.color_map_table.size(); ++i) {
+        state.color_map_table[i].value.Assign(i * 32);
+        state.color_map_table[i].difference.Assign(32);
+        state.alpha_map_table[i].value.Assign(4095 - i * 32);
+        state.alpha_map_table[i].difference.Assign(-32);
+    }
+    for (unsigned i = 0; i < state.color_table.size(); ++i) {
+        state.color_table[i].r.Assign(i);
+        state.color_table[i].g.Assign(255 - i);
+        state.color_table[i].b.Assign(i / 2);
+        state.color_table[i].a.Assign(255);
+        state.color_diff_table[i].r.Assign(0);
+        state.color_diff_table[i].g.Assign(-1);
+        state.color_diff_table[i].b.Assign(0);
+        state.color_diff_table[i].a.Assign(0);
+    }
+
+    auto& regs = fixture->regs;
+    regs.proctex.u_clamp.Assign(TexturingRegs::ProcTexClamp::MirroredRepeat);
+    regs.proctex.v_clamp.Assign(TexturingRegs::ProcTexClamp::SymmetricalRepeat);
+    regs.proctex.color_combiner.Assign(noise ? TexturingRegs::ProcTexCombiner::SqrtAdd2
+                                             : TexturingRegs::ProcTexCombiner::U);
+    regs.proctex.alpha_combiner.Assign(TexturingRegs::ProcTexCombiner::V2);
+    regs.proctex.separate_alpha.Assign(1);
+    regs.proctex.noise_enable.Assign(noise);
+    regs.proctex_noise_u.amplitude.Assign(0x400);
+    regs.proctex_noise_u.phase.Assign(0x3800); // 0.5 as float16
+    regs.proctex_noise_v.amplitude.Assign(0x200);
+    regs.proctex_noise_v.phase.Assign(0x3400);     // 0.25
+    regs.proctex_noise_frequency.u.Assign(0x4000); // 2.0
+    regs.proctex_noise_frequency.v.Assign(0x3C00); // 1.0
+    regs.proctex_lut.filter.Assign(TexturingRegs::ProcTexFilter::Linear);
+    regs.proctex_lut.width.Assign(128);
+    regs.proctex_lut_offset.Assign(0);
+
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+    for (unsigned i = 0; i < FRAGMENTS_PER_ITERATION; ++i) {
+        fixture->us.push_back(dist(rng));
+        fixture->vs.push_back(dist(rng));
+    }
+    return fixture;
+}
+
+static void AddProcTexBenchmark(Runner& runner, const char* name, bool noise) {
+    runner.Add(std::string("ProcTex/Sample/") + name, [noise](State& state) {
+        const auto fixture = MakeFixture(noise);
+        Pica::Rasterizer::InvalidateProcTexSetup();
+        state.SetItemsPerIteration(FRAGMENTS_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            // As in the rasterizer, the setup is fetched once per triangle
+            const auto& setup = Pica::Rasterizer::GetProcTexSetup(fixture->regs, fixture->state);
+            for (unsigned fragment = 0; fragment < FRAGMENTS_PER_ITERATION; ++fragment) {
+                auto color = Pica::Rasterizer::ProcTex(setup, fixture->us[fragment],
+                                                       fixture->vs[fragment]);
+                DoNotOptimize(color);
+            }
+        }
+    });
+}
+
+void RegisterProcTexBenchmarks(Runner& runner) {
+    AddProcTexBenchmark(runner, "Noise", true);
+    AddProcTexBenchmark(runner, "Baked", false);
+
+    // Cost of a draw after the game rewrote the registers with the same values, and of rebuilding
+    // the setup and baking the texture after they actually changed
+    runner.Add("ProcTex/GetProcTexSetup/Unchanged", [](State& state) {
+        const auto fixture = MakeFixture(false);
+        Pica::Rasterizer::InvalidateProcTexSetup();
+        Pica::Rasterizer::GetProcTexSetup(fixture->regs, fixture->state);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            Pica::Rasterizer::InvalidateProcTexSetup();
+            DoNotOptimize(Pica::Rasterizer::GetProcTexSetup(fixture->regs, fixture->state).baked);
+        }
+    });
+
+    runner.Add("ProcTex/GetProcTexSetup/Bake", [](State& state) {
+        const auto fixture = MakeFixture(false);
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            fixture->regs.proctex_lut_offset.Assign(i % 2);
+            Pica::Rasterizer::InvalidateProcTexSetup();
+            DoNotOptimize(Pica::Rasterizer::GetProcTexSetup(fixture->regs, fixture->state).baked);
+        }
+    });
+}
+
+} // namespace Bench
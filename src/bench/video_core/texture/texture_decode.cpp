@@ -0,0 +1,77 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+#include "bench/bench.h"
+#include "video_core/texture/etc1.h"
+#include "video_core/texture/texture_decode.h"
+
+namespace Bench {
+
+using TextureFormat = Pica::TexturingRegs::TextureFormat;
+
+constexpr unsigned TEXTURE_SIZE = 128;
+
+static std::vector<u8> RandomData(size_t size) {
+    std::mt19937 rng(0);
+    std::vector<u8> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<u8>(rng());
+    }
+    return data;
+}
+
+void RegisterTextureBenchmarks(Runner& runner) {
+    static const std::pair<TextureFormat, const char*> formats[] = {
+        {TextureFormat::RGBA8, "RGBA8"},   {TextureFormat::RGB8, "RGB8"},
+        {TextureFormat::RGB5A1, "RGB5A1"}, {TextureFormat::RGB565, "RGB565"},
+        {TextureFormat::RGBA4, "RGBA4"},   {TextureFormat::IA8, "IA8"},
+        {TextureFormat::RG8, "RG8"},       {TextureFormat::I8, "I8"},
+        {TextureFormat::A8, "A8"},         {TextureFormat::IA4, "IA4"},
+        {TextureFormat::I4, "I4"},         {TextureFormat::A4, "A4"},
+        {TextureFormat::ETC1, "ETC1"},     {TextureFormat::ETC1A4, "ETC1A4"},
+    };
+
+    for (const auto& format : formats) {
+        // Decodes a whole texture texel by texel, as the software rasterizer and the OpenGL
+        // rasterizer cache do.
+        runner.Add(std::string("Texture/LookupTexture/") + format.second, [format](State& state) {
+            Pica::Texture::TextureInfo info{};
+            info.width = TEXTURE_SIZE;
+            info.height = TEXTURE_SIZE;
+            info.format = format.first;
+            info.SetDefaultStride();
+            const auto data = RandomData(info.stride * (TEXTURE_SIZE / 8));
+            state.SetItemsPerIteration(TEXTURE_SIZE * TEXTURE_SIZE);
+
+            for (u64 i = 0; i < state.Iterations(); ++i) {
+                for (unsigned y = 0; y < TEXTURE_SIZE; ++y) {
+                    for (unsigned x = 0; x < TEXTURE_SIZE; ++x) {
+                        DoNotOptimize(Pica::Texture::LookupTexture(data.data(), x, y, info));
+                    }
+                }
+            }
+        });
+    }
+
+    runner.Add("Texture/SampleETC1Subtile", [](State& state) {
+        const auto data = RandomData(0x1000);
+        const u64* subtiles = reinterpret_cast<const u64*>(data.data());
+        const size_t num_subtiles = data.size() / sizeof(u64);
+        state.SetItemsPerIteration(num_subtiles * 16);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (size_t subtile = 0; subtile < num_subtiles; ++subtile) {
+                for (unsigned y = 0; y < 4; ++y) {
+                    for (unsigned x = 0; x < 4; ++x) {
+                        DoNotOptimize(Pica::Texture::SampleETC1Subtile(subtiles[subtile], x, y));
+                    }
+                }
+            }
+        }
+    });
+}
+
+} // namespace Bench
@@ -0,0 +1,79 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include "bench/bench.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/regs_pipeline.h"
+#include "video_core/shader/shader.h"
+#include "video_core/vertex_loader.h"
+
+namespace Bench {
+
+using Pica::PipelineRegs;
+
+constexpr u32 VERTICES_PER_ITERATION = 1024;
+
+/// Offset of the position, color and texture coordinate buffers from the vertex base address
+constexpr u32 POSITION_OFFSET = 0;
+constexpr u32 COLOR_OFFSET = 0x10000;
+constexpr u32 TEXCOORD_OFFSET = 0x20000;
+
+/**
+ * Configures three attributes, a float position, an unsigned byte color and float texture
+ * coordinates, each read from its own buffer like vertex arrays without interleaving.
+ */
+static PipelineRegs MakeRegs() {
+    PipelineRegs regs{};
+    auto& attributes = regs.vertex_attributes;
+    attributes.base_address.Assign(Memory::VRAM_PADDR / 16);
+    attributes.format0.Assign(PipelineRegs::VertexAttributeFormat::FLOAT);
+    attributes.size0.Assign(2);
+    attributes.format1.Assign(PipelineRegs::VertexAttributeFormat::UBYTE);
+    attributes.size1.Assign(3);
+    attributes.format2.Assign(PipelineRegs::VertexAttributeFormat::FLOAT);
+    attributes.size2.Assign(1);
+    attributes.max_attribute_index.Assign(2);
+
+    const u32 offsets[] = {POSITION_OFFSET, COLOR_OFFSET, TEXCOORD_OFFSET};
+    for (u32 i = 0; i < 3; ++i) {
+        auto& loader = attributes.attribute_loaders[i];
+        loader.data_offset.Assign(offsets[i]);
+        loader.comp0.Assign(i);
+        loader.byte_count.Assign(attributes.GetStride(i));
+        loader.component_count.Assign(1);
+    }
+    return regs;
+}
+
+void RegisterVertexLoaderBenchmarks(Runner& runner) {
+    // Every vertex looks up the physical memory of each of its buffers
+    runner.Add("VertexLoader/LoadVertex", [](State& state) {
+        Memory::InitPhysicalMemory();
+        const PipelineRegs regs = MakeRegs();
+        const PAddr base_address = regs.vertex_attributes.GetPhysicalBaseAddress();
+        u8* vram = Memory::GetPhysicalPointer(base_address);
+        for (u32 i = 0; i < VERTICES_PER_ITERATION * 3; ++i) {
+            const float value = static_cast<float>(i);
+            std::memcpy(vram + POSITION_OFFSET + i * sizeof(float), &value, sizeof(value));
+        }
+
+        Pica::VertexLoader loader(regs);
+        Pica::Shader::AttributeBuffer input;
+        Pica::DebugUtils::MemoryAccessTracker memory_accesses;
+        state.SetItemsPerIteration(VERTICES_PER_ITERATION);
+
+        for (u64 i = 0; i < state.Iterations(); ++i) {
+            for (u32 vertex = 0; vertex < VERTICES_PER_ITERATION; ++vertex) {
+                loader.LoadVertex(base_address, vertex, vertex, input, memory_accesses);
+                DoNotOptimize(input.attr[0][0]);
+            }
+        }
+        Memory::ShutdownPhysicalMemory();
+    });
+}
+
+} // namespace Bench
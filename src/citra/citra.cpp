@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -25,6 +27,7 @@
 #endif
 
 #include "citra/config.h"
+#include "citra/emu_window/emu_window_headless.h"
 #include "citra/emu_window/emu_window_sdl2.h"
 #include "common/logging/backend.h"
 #include "common/logging/filter.h"
@@ -36,6 +39,8 @@
 #include "core/gdbstub/gdbstub.h"
 #include "core/loader/loader.h"
 #include "core/settings.h"
+#include "video_core/renderer_base.h"
+#include "video_core/video_core.h"
 
 static void PrintHelp(const char* argv0) {
     std::cout << "Usage: " << argv0
@@ -43,6 +48,11 @@ static void PrintHelp(const char* argv0) {
                  "-g, --gdbport=NUMBER       Enable gdb stub on port NUMBER\n"
                  "-r, --movie-record=[file]  Record a movie (game inputs) to the given file\n"
                  "-p, --movie-play=[file]    Playback the movie (game inputs) from the given file\n"
+                 "-n, --headless             Run without a window, audio output or frame limiting\n"
+                 "-s, --skip-rasterization   In headless mode, discard triangles instead of\n"
+                 "                           rasterizing them\n"
+                 "-f, --frames=NUMBER        Exit after NUMBER emulated frames and print\n"
+                 "                           performance statistics as JSON\n"
                  "-h, --help                 Display this help and exit\n"
                  "-v, --version              Output version information and exit\n";
 }
@@ -59,6 +69,9 @@ int main(int argc, char** argv) {
     u32 gdb_port = static_cast<u32>(Settings::values.gdbstub_port);
     std::string movie_record;
     std::string movie_play;
+    bool headless = false;
+    bool skip_rasterization = false;
+    unsigned long max_frames = 0;
 
     char* endarg;
 #ifdef _WIN32
@@ -74,12 +87,14 @@ int main(int argc, char** argv) {
 
     static struct option long_options[] = {
         {"gdbport", required_argument, 0, 'g'},    {"movie-record", required_argument, 0, 'r'},
-        {"movie-play", required_argument, 0, 'p'}, {"help", no_argument, 0, 'h'},
-        {"version", no_argument, 0, 'v'},          {0, 0, 0, 0},
+        {"movie-play", required_argument, 0, 'p'}, {"headless", no_argument, 0, 'n'},
+        {"skip-rasterization", no_argument, 0, 's'}, {"frames", required_argument, 0, 'f'},
+        {"help", no_argument, 0, 'h'},             {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        char arg = getopt_long(argc, argv, "g:r:p:hv", long_options, &option_index);
+        char arg = getopt_long(argc, argv, "g:r:p:nsf:hv", long_options, &option_index);
         if (arg != -1) {
             switch (arg) {
             case 'g':
@@ -99,6 +114,22 @@ int main(int argc, char** argv) {
             case 'p':
                 movie_play = optarg;
                 break;
+            case 'n':
+                headless = true;
+                break;
+            case 's':
+                skip_rasterization = true;
+                break;
+            case 'f':
+                errno = 0;
+                max_frames = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--frames");
+                    exit(1);
+                }
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -142,15 +173,32 @@ int main(int argc, char** argv) {
     Settings::values.use_gdbstub = use_gdbstub;
     Settings::values.movie_play = std::move(movie_play);
     Settings::values.movie_record = std::move(movie_record);
+    Settings::values.use_null_renderer = headless;
+    Settings::values.skip_rasterization = skip_rasterization;
+    if (headless) {
+        // Run as fast as possible, consuming audio samples immediately
+        Settings::values.toggle_framelimit = false;
+        Settings::values.sink_id = "null";
+        Settings::values.enable_audio_stretching = false;
+    }
     Settings::Apply();
 
-    std::unique_ptr<EmuWindow_SDL2> emu_window{std::make_unique<EmuWindow_SDL2>()};
+    std::unique_ptr<EmuWindow_SDL2> sdl2_window;
+    std::unique_ptr<EmuWindow_Headless> headless_window;
+    EmuWindow* emu_window;
+    if (headless) {
+        headless_window = std::make_unique<EmuWindow_Headless>();
+        emu_window = headless_window.get();
+    } else {
+        sdl2_window = std::make_unique<EmuWindow_SDL2>();
+        emu_window = sdl2_window.get();
+    }
 
     Core::System& system{Core::System::GetInstance()};
 
     SCOPE_EXIT({ system.Shutdown(); });
 
-    const Core::System::ResultStatus load_result{system.Load(emu_window.get(), filepath)};
+    const Core::System::ResultStatus load_result{system.Load(emu_window, filepath)};
 
     switch (load_result) {
     case Core::System::ResultStatus::ErrorGetLoader:
@@ -181,11 +229,32 @@ int main(int argc, char** argv) {
         break; // Expected case
     }
 
-    Core::Telemetry().AddField(Telemetry::FieldType::App, "Frontend", "SDL");
+    Core::Telemetry().AddField(Telemetry::FieldType::App, "Frontend",
+                               headless ? "SDL_Headless" : "SDL");
+
+    const auto start_time = std::chrono::steady_clock::now();
 
-    while (emu_window->IsOpen()) {
+    while (!sdl2_window || sdl2_window->IsOpen()) {
+        if (max_frames != 0 &&
+            static_cast<unsigned long>(VideoCore::g_renderer->GetCurrentFrame()) >= max_frames) {
+            break;
+        }
         system.RunLoop();
     }
 
+    if (max_frames != 0) {
+        const auto wall_time = std::chrono::duration_cast<std::chrono::duration<double>>(
+                                   std::chrono::steady_clock::now() - start_time)
+                                   .count();
+        const auto results = system.GetAndResetPerfStats();
+        std::printf("{\"frames\": %d, \"wall_time\": %f, \"emulation_speed\": %f, "
+                    "\"game_fps\": %f, \"system_fps\": %f, \"frametime\": %f, "
+                    "\"skipped_frames\": %u}\n",
+                    VideoCore::g_renderer->GetCurrentFrame(), wall_time,
+                    results.emulation_speed, results.game_fps, results.system_fps,
+                    results.frametime, results.skipped_frames);
+        std::fflush(stdout);
+    }
+
     return 0;
 }
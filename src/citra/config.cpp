@@ -87,9 +87,14 @@ void Config::ReadValues() {
     // Renderer
     Settings::values.use_hw_renderer = sdl2_config->GetBoolean("Renderer", "use_hw_renderer", true);
     Settings::values.use_shader_jit = sdl2_config->GetBoolean("Renderer", "use_shader_jit", true);
+    Settings::values.use_async_gpu = sdl2_config->GetBoolean("Renderer", "use_async_gpu", false);
+    Settings::values.use_disk_shader_cache =
+        sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", true);
     Settings::values.resolution_factor =
         (float)sdl2_config->GetReal("Renderer", "resolution_factor", 1.0);
     Settings::values.use_vsync = sdl2_config->GetBoolean("Renderer", "use_vsync", false);
+    Settings::values.max_frame_skip =
+        static_cast<int>(sdl2_config->GetInteger("Renderer", "max_frame_skip", 0));
     Settings::values.toggle_framelimit =
         sdl2_config->GetBoolean("Renderer", "toggle_framelimit", true);
 
@@ -123,6 +128,8 @@ void Config::ReadValues() {
     Settings::values.sink_id = sdl2_config->Get("Audio", "output_engine", "auto");
     Settings::values.enable_audio_stretching =
         sdl2_config->GetBoolean("Audio", "enable_audio_stretching", true);
+    Settings::values.enable_audio_thread =
+        sdl2_config->GetBoolean("Audio", "enable_audio_thread", false);
     Settings::values.audio_device_id = sdl2_config->Get("Audio", "output_device", "auto");
 
     // Data Storage
@@ -156,6 +163,9 @@ void Config::ReadValues() {
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
+    Settings::values.dump_ipc_profile =
+        sdl2_config->GetBoolean("Debugging", "dump_ipc_profile", false);
+    Settings::values.record_trace = sdl2_config->GetBoolean("Debugging", "record_trace", false);
 
     // Web Service
     Settings::values.enable_telemetry =
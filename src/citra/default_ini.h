@@ -80,6 +80,16 @@ use_hw_renderer =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Whether to execute GPU commands on a separate thread, overlapping them with CPU emulation.
+# Only takes effect with the software renderer, and is disabled while recording or playing movies.
+# 0 (default): Off, 1: On
+use_async_gpu =
+
+# Whether to remember the shaders used by each title and build them while booting, instead of on
+# their first use mid-frame. Only takes effect with the hardware renderer.
+# 0: Off, 1 (default): On
+use_disk_shader_cache =
+
 # Resolution scale factor
 # 0: Auto (scales resolution to window size), 1: Native 3DS screen resolution, Otherwise a scale
 # factor for the 3DS resolution
@@ -89,6 +99,11 @@ resolution_factor =
 # 0 (default): Off, 1: On
 use_vsync =
 
+# Maximum number of consecutive frames whose rendering may be skipped when emulation is running
+# slower than real time. Rendering to textures and display transfers are never skipped.
+# 0 (default): Never skip frames, Otherwise the maximum number of consecutive skipped frames
+max_frame_skip =
+
 # The clear color for the renderer. What shows up on the sides of the bottom screen.
 # Must be in range of 0.0-1.0. Defaults to 1.0 for all.
 bg_red =
@@ -135,6 +150,13 @@ output_engine =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Whether or not to generate audio frames on a dedicated thread.
+# This lets audio processing run concurrently with emulation, at the cost of delaying the DSP's
+# responses to the application by one audio frame. Movie recording and playback always use the
+# synchronous path.
+# 0 (default): No, 1: Yes
+enable_audio_thread =
+
 # Which audio device to use.
 # auto (default): Auto-select
 output_device =
@@ -178,6 +200,13 @@ log_filter = *:Info
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
+# Whether to write per-service IPC call statistics to ipc_profile.csv/.json in the log directory
+# when emulation stops. 0 (default): Off, 1: On
+dump_ipc_profile=false
+# Whether to record profiler scopes and emulated events (CoreTiming callbacks, VBlank, GSP
+# interrupts, thread switches) to trace.json in the log directory, viewable in chrome://tracing.
+# 0 (default): Off, 1: On
+record_trace=false
 
 [WebService]
 # Whether or not to enable telemetry
@@ -0,0 +1,18 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "citra/emu_window/emu_window_headless.h"
+#include "core/3ds.h"
+#include "input_common/main.h"
+
+EmuWindow_Headless::EmuWindow_Headless() {
+    InputCommon::Init();
+
+    UpdateCurrentFramebufferLayout(Core::kScreenTopWidth,
+                                   Core::kScreenTopHeight + Core::kScreenBottomHeight);
+}
+
+EmuWindow_Headless::~EmuWindow_Headless() {
+    InputCommon::Shutdown();
+}
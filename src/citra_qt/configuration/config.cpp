@@ -75,7 +75,11 @@ void Config::ReadValues() {
     Settings::values.use_shader_jit = qt_config->value("use_shader_jit", true).toBool();
     Settings::values.resolution_factor = qt_config->value("resolution_factor", 1.0).toFloat();
     Settings::values.use_vsync = qt_config->value("use_vsync", false).toBool();
+    Settings::values.max_frame_skip = qt_config->value("max_frame_skip", 0).toInt();
     Settings::values.toggle_framelimit = qt_config->value("toggle_framelimit", true).toBool();
+    Settings::values.use_async_gpu = qt_config->value("use_async_gpu", false).toBool();
+    Settings::values.use_disk_shader_cache =
+        qt_config->value("use_disk_shader_cache", true).toBool();
 
     Settings::values.bg_red = qt_config->value("bg_red", 0.0).toFloat();
     Settings::values.bg_green = qt_config->value("bg_green", 0.0).toFloat();
@@ -101,6 +105,7 @@ void Config::ReadValues() {
     Settings::values.sink_id = qt_config->value("output_engine", "auto").toString().toStdString();
     Settings::values.enable_audio_stretching =
         qt_config->value("enable_audio_stretching", true).toBool();
+    Settings::values.enable_audio_thread = qt_config->value("enable_audio_thread", false).toBool();
     Settings::values.audio_device_id =
         qt_config->value("output_device", "auto").toString().toStdString();
     qt_config->endGroup();
@@ -138,6 +143,8 @@ void Config::ReadValues() {
     qt_config->beginGroup("Debugging");
     Settings::values.use_gdbstub = false;
     Settings::values.gdbstub_port = qt_config->value("gdbstub_port", 24689).toInt();
+    Settings::values.dump_ipc_profile = qt_config->value("dump_ipc_profile", false).toBool();
+    Settings::values.record_trace = qt_config->value("record_trace", false).toBool();
     qt_config->endGroup();
 
     qt_config->beginGroup("WebService");
@@ -231,7 +238,10 @@ void Config::SaveValues() {
     qt_config->setValue("use_shader_jit", Settings::values.use_shader_jit);
     qt_config->setValue("resolution_factor", (double)Settings::values.resolution_factor);
     qt_config->setValue("use_vsync", Settings::values.use_vsync);
+    qt_config->setValue("max_frame_skip", Settings::values.max_frame_skip);
     qt_config->setValue("toggle_framelimit", Settings::values.toggle_framelimit);
+    qt_config->setValue("use_async_gpu", Settings::values.use_async_gpu);
+    qt_config->setValue("use_disk_shader_cache", Settings::values.use_disk_shader_cache);
 
     // Cast to double because Qt's written float values are not human-readable
     qt_config->setValue("bg_red", (double)Settings::values.bg_red);
@@ -256,6 +266,7 @@ void Config::SaveValues() {
     qt_config->beginGroup("Audio");
     qt_config->setValue("output_engine", QString::fromStdString(Settings::values.sink_id));
     qt_config->setValue("enable_audio_stretching", Settings::values.enable_audio_stretching);
+    qt_config->setValue("enable_audio_thread", Settings::values.enable_audio_thread);
     qt_config->setValue("output_device", QString::fromStdString(Settings::values.audio_device_id));
     qt_config->endGroup();
 
@@ -290,6 +301,8 @@ void Config::SaveValues() {
 
     qt_config->beginGroup("Debugging");
     qt_config->setValue("gdbstub_port", Settings::values.gdbstub_port);
+    qt_config->setValue("dump_ipc_profile", Settings::values.dump_ipc_profile);
+    qt_config->setValue("record_trace", Settings::values.record_trace);
     qt_config->endGroup();
 
     qt_config->beginGroup("WebService");
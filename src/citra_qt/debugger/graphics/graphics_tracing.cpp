@@ -62,8 +62,8 @@ void GraphicsTracingWidget::StartRecording() {
     if (!context)
         return;
 
-    auto shader_binary = Pica::g_state.vs.program_code;
-    auto swizzle_data = Pica::g_state.vs.swizzle_data;
+    auto shader_binary = Pica::g_state.vs.GetProgramCode();
+    auto swizzle_data = Pica::g_state.vs.GetSwizzleData();
 
     // Encode floating point numbers to 24-bit values
     // TODO: Drop this explicit conversion once we store float24 values bit-correctly internally.
@@ -503,11 +503,11 @@ void GraphicsVertexShaderWidget::Reload(bool replace_vertex_data, void* vertex_d
 
     auto& shader_setup = Pica::g_state.vs;
     auto& shader_config = Pica::g_state.regs.vs;
-    for (auto instr : shader_setup.program_code)
+    for (auto instr : shader_setup.GetProgramCode())
         info.code.push_back({instr});
     int num_attributes = shader_config.max_input_attribute_index + 1;
 
-    for (auto pattern : shader_setup.swizzle_data)
+    for (auto pattern : shader_setup.GetSwizzleData())
         info.swizzle_info.push_back({pattern});
 
     u32 entry_point = Pica::g_state.regs.vs.main_offset;
@@ -515,7 +515,7 @@ void GraphicsVertexShaderWidget::Reload(bool replace_vertex_data, void* vertex_d
 
     // Generate debug information
     Pica::Shader::InterpreterEngine shader_engine;
-    shader_engine.SetupBatch(shader_setup, entry_point);
+    shader_engine.SetupBatch(shader_setup, entry_point, shader_config.output_mask);
     debug_data = shader_engine.ProduceDebugInfo(shader_setup, input_vertex, shader_config);
 
     // Reload widget state
@@ -0,0 +1,114 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QStringList>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include "citra_qt/debugger/ipc_profiler.h"
+#include "core/hle/service/ipc_profiler.h"
+
+/// Tree widget item that sorts numeric columns by value instead of by text
+class IPCProfilerItem : public QTreeWidgetItem {
+public:
+    using QTreeWidgetItem::QTreeWidgetItem;
+
+    bool operator<(const QTreeWidgetItem& other) const override {
+        const int column = treeWidget()->sortColumn();
+        const QVariant lhs = data(column, Qt::UserRole);
+        const QVariant rhs = other.data(column, Qt::UserRole);
+        if (lhs.isValid() && rhs.isValid())
+            return lhs.toULongLong() < rhs.toULongLong();
+        return QTreeWidgetItem::operator<(other);
+    }
+};
+
+/// Formats the non-empty histogram buckets as "<upper bound>:<count>"
+static QString FormatHistogram(const Service::IPCProfiler::CallStats& stats) {
+    QStringList buckets;
+    for (size_t bucket = 0; bucket < stats.host_ns_histogram.size(); ++bucket) {
+        if (stats.host_ns_histogram[bucket] == 0)
+            continue;
+        const double upper_bound_us = static_cast<double>(2ULL << bucket) / 1000.0;
+        buckets << QString("<%1us:%2")
+                       .arg(upper_bound_us, 0, 'g', 3)
+                       .arg(stats.host_ns_histogram[bucket]);
+    }
+    return buckets.join(' ');
+}
+
+IPCProfilerWidget::IPCProfilerWidget(QWidget* parent) : QDockWidget(tr("IPC Profiler"), parent) {
+    setObjectName("IPCProfilerWidget");
+
+    tree = new QTreeWidget(this);
+    tree->setRootIsDecorated(false);
+    tree->setSortingEnabled(true);
+    tree->setHeaderLabels({tr("Service"), tr("Function"), tr("Header"), tr("Calls"),
+                           tr("Total (us)"), tr("Average (us)"), tr("Max (us)"),
+                           tr("Cycles"), tr("Host time histogram")});
+    tree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    QPushButton* refresh_button = new QPushButton(tr("Refresh"), this);
+    QPushButton* reset_button = new QPushButton(tr("Reset"), this);
+    connect(refresh_button, &QPushButton::clicked, this, &IPCProfilerWidget::Refresh);
+    connect(reset_button, &QPushButton::clicked, this, &IPCProfilerWidget::Reset);
+
+    QHBoxLayout* button_layout = new QHBoxLayout;
+    button_layout->addWidget(refresh_button);
+    button_layout->addWidget(reset_button);
+    button_layout->addStretch();
+
+    QVBoxLayout* main_layout = new QVBoxLayout;
+    main_layout->addLayout(button_layout);
+    main_layout->addWidget(tree);
+
+    QWidget* main_widget = new QWidget(this);
+    main_widget->setLayout(main_layout);
+    setWidget(main_widget);
+
+    update_timer.setInterval(1000);
+    connect(&update_timer, &QTimer::timeout, this, &IPCProfilerWidget::Refresh);
+}
+
+void IPCProfilerWidget::Refresh() {
+    tree->setSortingEnabled(false);
+    tree->clear();
+
+    for (const auto& stats : Service::IPCProfiler::GetStats()) {
+        const u64 average_ns = stats.total_host_ns / std::max<u64>(stats.num_calls, 1);
+        auto* item = new IPCProfilerItem(tree);
+        item->setText(0, QString::fromStdString(stats.service_name));
+        item->setText(1, QString::fromStdString(stats.function_name));
+        item->setText(2, QString("0x%1").arg(stats.command_header, 8, 16, QChar('0')));
+
+        const u64 values[] = {stats.num_calls, stats.total_host_ns / 1000, average_ns / 1000,
+                              stats.max_host_ns / 1000, stats.total_cycles};
+        for (int i = 0; i < 5; ++i) {
+            item->setText(3 + i, QString::number(values[i]));
+            item->setData(3 + i, Qt::UserRole, QVariant::fromValue<qulonglong>(values[i]));
+        }
+        item->setText(8, FormatHistogram(stats));
+    }
+
+    tree->setSortingEnabled(true);
+}
+
+void IPCProfilerWidget::Reset() {
+    Service::IPCProfiler::Reset();
+    Refresh();
+}
+
+void IPCProfilerWidget::showEvent(QShowEvent* ev) {
+    Refresh();
+    update_timer.start();
+    QDockWidget::showEvent(ev);
+}
+
+void IPCProfilerWidget::hideEvent(QHideEvent* ev) {
+    update_timer.stop();
+    QDockWidget::hideEvent(ev);
+}
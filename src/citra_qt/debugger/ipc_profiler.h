@@ -0,0 +1,32 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <QDockWidget>
+#include <QTimer>
+
+class QTreeWidget;
+
+/// Shows the call statistics recorded by Service::IPCProfiler for every HLE service command
+class IPCProfilerWidget : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit IPCProfilerWidget(QWidget* parent = nullptr);
+
+public slots:
+    void Refresh();
+    void Reset();
+
+protected:
+    void showEvent(QShowEvent* ev) override;
+    void hideEvent(QHideEvent* ev) override;
+
+private:
+    QTreeWidget* tree;
+    /// Refreshes the statistics periodically. To save resources, it only runs while the widget is
+    /// visible.
+    QTimer update_timer;
+};
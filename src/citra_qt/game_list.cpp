@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <QApplication>
+#include <QDateTime>
 #include <QFileInfo>
 #include <QHeaderView>
 #include <QKeyEvent>
@@ -11,6 +13,7 @@
 #include "common/common_paths.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "core/loader/loader.h"
 #include "game_list.h"
 #include "game_list_p.h"
@@ -372,6 +375,27 @@ void GameList::RefreshGameDirectory() {
     }
 }
 
+/// Reads the metadata of a game file, returns nothing if no loader supports the file.
+static boost::optional<GameListEntryMetadata> ReadMetadata(const std::string& physical_name) {
+    std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
+    if (!loader)
+        return boost::none;
+
+    GameListEntryMetadata metadata;
+    metadata.file_type = QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()));
+    loader->ReadProgramId(metadata.program_id);
+
+    std::vector<u8> smdh_data;
+    loader->ReadIcon(smdh_data);
+    if (Loader::IsValidSMDH(smdh_data)) {
+        Loader::SMDH smdh;
+        memcpy(&smdh, smdh_data.data(), sizeof(Loader::SMDH));
+        metadata.icon = GetQImageFromSMDH(smdh, true);
+        metadata.title = GetQStringShortTitleFromSMDH(smdh, Loader::SMDH::TitleLanguage::English);
+    }
+    return metadata;
+}
+
 void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion) {
     const auto callback = [this, recursion](unsigned* num_entries_out, const std::string& directory,
                                             const std::string& virtual_name) -> bool {
@@ -382,22 +406,27 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
 
         bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader)
-                return true;
-
-            std::vector<u8> smdh;
-            loader->ReadIcon(smdh);
-
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            emit EntryReady({
-                new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id),
-                new GameListItem(
-                    QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                new GameListItemSize(FileUtil::GetSize(physical_name)),
-            });
+            const QString path = QString::fromStdString(physical_name);
+            const QFileInfo file_info(path);
+            const qint64 size = file_info.size();
+            const qint64 last_modified = file_info.lastModified().toMSecsSinceEpoch();
+
+            // Files that are new or modified since the last scan are read on the thread pool, as
+            // reading them may take a while on slow storage
+            boost::optional<GameListEntryMetadata> metadata;
+            if (cache.Find(path, size, last_modified, metadata)) {
+                if (metadata)
+                    EmitEntry(path, size, *metadata);
+            } else {
+                auto read = [this, physical_name]() -> boost::optional<GameListEntryMetadata> {
+                    if (stop_processing)
+                        return boost::none;
+                    return ReadMetadata(physical_name);
+                };
+                pending_entries.push_back(
+                    {path, size, last_modified, Common::ThreadPool::GetPool().Push(read)});
+            }
+            EmitPendingEntries(false);
         } else if (is_dir && recursion > 0) {
             watch_list.append(QString::fromStdString(physical_name));
             AddFstEntriesToGameList(physical_name, recursion - 1);
@@ -409,10 +438,43 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
     FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
 }
 
+void GameListWorker::EmitPendingEntries(bool wait) {
+    while (!pending_entries.empty()) {
+        PendingEntry& entry = pending_entries.front();
+        if (!wait &&
+            entry.metadata.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+
+        const auto metadata = entry.metadata.get();
+        // Files skipped after the scan was cancelled have not been read
+        if (!stop_processing)
+            cache.Insert(entry.path, entry.size, entry.last_modified, metadata);
+        if (metadata)
+            EmitEntry(entry.path, entry.size, *metadata);
+        pending_entries.pop_front();
+    }
+}
+
+void GameListWorker::EmitEntry(const QString& path, qint64 size,
+                               const GameListEntryMetadata& metadata) {
+    emit EntryReady({
+        new GameListItemPath(path, metadata),
+        new GameListItem(metadata.file_type),
+        new GameListItemSize(size),
+    });
+}
+
 void GameListWorker::run() {
     stop_processing = false;
+    cache.Load();
     watch_list.append(dir_path);
     AddFstEntriesToGameList(dir_path.toStdString(), deep_scan ? 256 : 0);
+    // The files that are still being read are waited for even when cancelled, as they use the
+    // worker
+    EmitPendingEntries(true);
+    if (!stop_processing)
+        cache.Save();
     emit Finished(watch_list);
 }
 
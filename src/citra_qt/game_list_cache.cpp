@@ -0,0 +1,136 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include "citra_qt/game_list_cache.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+
+namespace {
+
+constexpr quint32 CACHE_FILE_MAGIC = 0x434C4743; // "CGLC"
+
+// Increase whenever the layout of the file changes
+constexpr quint32 CACHE_FILE_VERSION = 2;
+
+/// Serializes the file accesses of scans that overlap, when a scan is restarted
+std::mutex cache_file_mutex;
+
+QString GetCacheFilePath() {
+    return QString::fromStdString(FileUtil::GetUserPath(D_CACHE_IDX) + "game_list.bin");
+}
+
+void WriteIcon(QDataStream& stream, const QImage& icon) {
+    const QImage image = icon.convertToFormat(QImage::Format_RGB16);
+    stream << qint32(image.width()) << qint32(image.height());
+    stream << QByteArray(reinterpret_cast<const char*>(image.constBits()),
+                         image.bytesPerLine() * image.height());
+}
+
+QImage ReadIcon(QDataStream& stream) {
+    qint32 width, height;
+    QByteArray pixels;
+    stream >> width >> height >> pixels;
+    if (width <= 0 || height <= 0)
+        return {};
+
+    QImage image(width, height, QImage::Format_RGB16);
+    if (pixels.size() != image.bytesPerLine() * image.height())
+        return {};
+    std::memcpy(image.bits(), pixels.constData(), pixels.size());
+    return image;
+}
+
+} // Anonymous namespace
+
+void GameListCache::Load() {
+    std::lock_guard<std::mutex> lock(cache_file_mutex);
+    saved_entries.clear();
+    found_entries.clear();
+    modified = false;
+
+    QFile file(GetCacheFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != CACHE_FILE_MAGIC ||
+        version != CACHE_FILE_VERSION) {
+        LOG_INFO(Frontend, "Discarding outdated game list cache");
+        return;
+    }
+
+    for (quint32 i = 0; i < count; ++i) {
+        QString path;
+        Entry entry;
+        bool supported;
+        stream >> path >> entry.size >> entry.last_modified >> supported;
+        if (supported) {
+            GameListEntryMetadata metadata;
+            quint64 program_id;
+            stream >> metadata.file_type >> program_id >> metadata.title;
+            metadata.program_id = program_id;
+            metadata.icon = ReadIcon(stream);
+            entry.metadata = std::move(metadata);
+        }
+        if (stream.status() != QDataStream::Ok) {
+            LOG_WARNING(Frontend, "Game list cache is truncated");
+            break;
+        }
+        saved_entries.insert(path, std::move(entry));
+    }
+}
+
+void GameListCache::Save() {
+    // Entries of removed files are dropped as well
+    if (!modified && found_entries.size() == saved_entries.size())
+        return;
+
+    std::lock_guard<std::mutex> lock(cache_file_mutex);
+    FileUtil::CreateFullPath(FileUtil::GetUserPath(D_CACHE_IDX));
+    QFile file(GetCacheFilePath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_ERROR(Frontend, "Failed to open the game list cache for writing");
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << CACHE_FILE_MAGIC << CACHE_FILE_VERSION << quint32(found_entries.size());
+    for (auto it = found_entries.cbegin(); it != found_entries.cend(); ++it) {
+        const Entry& entry = it.value();
+        stream << it.key() << entry.size << entry.last_modified << bool(entry.metadata);
+        if (entry.metadata) {
+            stream << entry.metadata->file_type << quint64(entry.metadata->program_id)
+                   << entry.metadata->title;
+            WriteIcon(stream, entry.metadata->icon);
+        }
+    }
+}
+
+bool GameListCache::Find(const QString& path, qint64 size, qint64 last_modified,
+                         boost::optional<GameListEntryMetadata>& metadata) {
+    const auto it = saved_entries.constFind(path);
+    if (it == saved_entries.cend() || it->size != size || it->last_modified != last_modified)
+        return false;
+
+    metadata = it->metadata;
+    found_entries.insert(path, *it);
+    return true;
+}
+
+void GameListCache::Insert(const QString& path, qint64 size, qint64 last_modified,
+                           const boost::optional<GameListEntryMetadata>& metadata) {
+    found_entries.insert(path, {size, last_modified, metadata});
+    modified = true;
+}
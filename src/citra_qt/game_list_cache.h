@@ -0,0 +1,58 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QString>
+#include <boost/optional.hpp>
+#include "common/common_types.h"
+
+/// Metadata of a game list entry, which is read from the file by its loader.
+struct GameListEntryMetadata {
+    QString file_type;
+    u64 program_id = 0;
+    QString title; ///< Short English title, empty if the file has no valid SMDH
+    QImage icon;   ///< Large icon, null if the file has no valid SMDH
+};
+
+/**
+ * Metadata of the entries found by previous game list scans, stored in <cache>/game_list.bin.
+ * Entries are keyed by path, and are only used while the size and modification time of their
+ * file are unchanged. Files that no loader supports are remembered as well, so that they are not
+ * read again on every scan. A scan starts from the saved cache and saves the entries it found,
+ * dropping files that were removed.
+ */
+class GameListCache {
+public:
+    /// Loads the entries saved by the last scan, discarding a cache of another format.
+    void Load();
+
+    /// Saves the entries found since Load was called. Does nothing if none of them changed.
+    void Save();
+
+    /**
+     * Looks up the metadata of a file, and remembers it for the next scan if it is found.
+     * @param metadata Set to the metadata of the file, or to nothing if no loader supports it
+     * @return false if there is no entry for the file, or it has been modified since
+     */
+    bool Find(const QString& path, qint64 size, qint64 last_modified,
+              boost::optional<GameListEntryMetadata>& metadata);
+
+    /// Adds the metadata read from a file, or nothing if no loader supports it.
+    void Insert(const QString& path, qint64 size, qint64 last_modified,
+                const boost::optional<GameListEntryMetadata>& metadata);
+
+private:
+    struct Entry {
+        qint64 size;
+        qint64 last_modified;
+        boost::optional<GameListEntryMetadata> metadata;
+    };
+
+    QHash<QString, Entry> saved_entries;
+    QHash<QString, Entry> found_entries;
+    bool modified = false;
+};
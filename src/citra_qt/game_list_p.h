@@ -5,10 +5,14 @@
 #pragma once
 
 #include <atomic>
+#include <future>
+#include <list>
 #include <QImage>
 #include <QRunnable>
 #include <QStandardItem>
 #include <QString>
+#include <boost/optional.hpp>
+#include "citra_qt/game_list_cache.h"
 #include "citra_qt/util/util.h"
 #include "common/string_util.h"
 #include "core/loader/smdh.h"
@@ -17,14 +21,14 @@
  * Gets the game icon from SMDH data.
  * @param smdh SMDH data
  * @param large If true, returns large icon (48x48), otherwise returns small icon (24x24)
- * @return QPixmap game icon
+ * @return QImage game icon
  */
-static QPixmap GetQPixmapFromSMDH(const Loader::SMDH& smdh, bool large) {
+static QImage GetQImageFromSMDH(const Loader::SMDH& smdh, bool large) {
     std::vector<u16> icon_data = smdh.GetIcon(large);
     const uchar* data = reinterpret_cast<const uchar*>(icon_data.data());
     int size = large ? 48 : 24;
-    QImage icon(data, size, size, QImage::Format::Format_RGB16);
-    return QPixmap::fromImage(icon);
+    // Copy the image, it only references the data otherwise
+    return QImage(data, size, size, QImage::Format::Format_RGB16).copy();
 }
 
 /**
@@ -72,26 +76,19 @@ public:
     static const int ProgramIdRole = Qt::UserRole + 3;
 
     GameListItemPath() : GameListItem() {}
-    GameListItemPath(const QString& game_path, const std::vector<u8>& smdh_data, u64 program_id)
+    GameListItemPath(const QString& game_path, const GameListEntryMetadata& metadata)
         : GameListItem() {
         setData(game_path, FullPathRole);
-        setData(qulonglong(program_id), ProgramIdRole);
+        setData(qulonglong(metadata.program_id), ProgramIdRole);
 
-        if (!Loader::IsValidSMDH(smdh_data)) {
+        if (metadata.icon.isNull()) {
             // SMDH is not valid, set a default icon
             setData(GetDefaultIcon(true), Qt::DecorationRole);
             return;
         }
 
-        Loader::SMDH smdh;
-        memcpy(&smdh, smdh_data.data(), sizeof(Loader::SMDH));
-
-        // Get icon from SMDH
-        setData(GetQPixmapFromSMDH(smdh, true), Qt::DecorationRole);
-
-        // Get title form SMDH
-        setData(GetQStringShortTitleFromSMDH(smdh, Loader::SMDH::TitleLanguage::English),
-                TitleRole);
+        setData(QPixmap::fromImage(metadata.icon), Qt::DecorationRole);
+        setData(metadata.title, TitleRole);
     }
 
     QVariant data(int role) const override {
@@ -181,5 +178,26 @@ private:
     bool deep_scan;
     std::atomic_bool stop_processing;
 
+    GameListCache cache;
+
+    struct PendingEntry {
+        QString path;
+        qint64 size;
+        qint64 last_modified;
+        /// Empty if no loader supports the file
+        std::future<boost::optional<GameListEntryMetadata>> metadata;
+    };
+    /// Files not found in the cache, whose metadata is being read on the thread pool
+    std::list<PendingEntry> pending_entries;
+
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion = 0);
+
+    /**
+     * Emits the entries of the files whose metadata has been read, in the order they were found.
+     * @param wait If true, waits for the metadata of all files, otherwise stops at the first file
+     * that is still being read
+     */
+    void EmitPendingEntries(bool wait);
+
+    void EmitEntry(const QString& path, qint64 size, const GameListEntryMetadata& metadata);
 };
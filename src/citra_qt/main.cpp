@@ -22,6 +22,7 @@
 #include "citra_qt/debugger/graphics/graphics_surface.h"
 #include "citra_qt/debugger/graphics/graphics_tracing.h"
 #include "citra_qt/debugger/graphics/graphics_vertex_shader.h"
+#include "citra_qt/debugger/ipc_profiler.h"
 #include "citra_qt/debugger/profiler.h"
 #include "citra_qt/debugger/registers.h"
 #include "citra_qt/debugger/wait_tree.h"
@@ -227,6 +228,11 @@ void GMainWindow::InitializeDebugWidgets() {
             &WaitTreeWidget::OnEmulationStarting);
     connect(this, &GMainWindow::EmulationStopping, waitTreeWidget,
             &WaitTreeWidget::OnEmulationStopping);
+
+    ipcProfilerWidget = new IPCProfilerWidget(this);
+    addDockWidget(Qt::BottomDockWidgetArea, ipcProfilerWidget);
+    ipcProfilerWidget->hide();
+    debug_menu->addAction(ipcProfilerWidget->toggleViewAction());
 }
 
 void GMainWindow::InitializeRecentFileMenuActions() {
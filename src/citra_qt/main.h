@@ -21,6 +21,7 @@ class GraphicsBreakPointsWidget;
 class GraphicsTracingWidget;
 class GraphicsVertexShaderWidget;
 class GRenderWindow;
+class IPCProfilerWidget;
 class MicroProfileDialog;
 class ProfilerWidget;
 class RegistersWidget;
@@ -163,6 +164,7 @@ private:
     GraphicsVertexShaderWidget* graphicsVertexShaderWidget;
     GraphicsTracingWidget* graphicsTracingWidget;
     WaitTreeWidget* waitTreeWidget;
+    IPCProfilerWidget* ipcProfilerWidget;
 
     QAction* actions_recent_files[max_recent_files_item];
 
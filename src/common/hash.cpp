@@ -5,6 +5,7 @@
 #if defined(_MSC_VER)
 #include <stdlib.h>
 #endif
+#include <cstring>
 #include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "common/hash.h"
@@ -138,4 +139,92 @@ void MurmurHash3_128(const void* key, size_t len, u32 seed, void* out) {
     ((u64*)out)[1] = h2;
 }
 
+// xxHash was written by Yann Collet, and is distributed under the BSD 2-Clause License. This is a
+// reimplementation of its 64-bit variant (XXH64), following the reference implementation at:
+// https://github.com/Cyan4973/xxHash
+
+static constexpr u64 XXH_PRIME64_1 = 0x9E3779B185EBCA87llu;
+static constexpr u64 XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4Fllu;
+static constexpr u64 XXH_PRIME64_3 = 0x165667B19E3779F9llu;
+static constexpr u64 XXH_PRIME64_4 = 0x85EBCA77C2B2AE63llu;
+static constexpr u64 XXH_PRIME64_5 = 0x27D4EB2F165667C5llu;
+
+static FORCE_INLINE u64 XXHRead64(const u8* p) {
+    u64 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static FORCE_INLINE u32 XXHRead32(const u8* p) {
+    u32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static FORCE_INLINE u64 XXHRound(u64 acc, u64 input) {
+    acc += input * XXH_PRIME64_2;
+    acc = _rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+static FORCE_INLINE u64 XXHMergeRound(u64 acc, u64 value) {
+    acc ^= XXHRound(0, value);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+u64 XXHash64(const void* key, size_t len, u64 seed) {
+    const u8* data = static_cast<const u8*>(key);
+    const u8* const end = data + len;
+    u64 h;
+
+    if (len >= 32) {
+        // Four independent lanes, so that the multiplications of consecutive stripes overlap
+        const u8* const limit = end - 32;
+        u64 v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        u64 v2 = seed + XXH_PRIME64_2;
+        u64 v3 = seed;
+        u64 v4 = seed - XXH_PRIME64_1;
+        do {
+            v1 = XXHRound(v1, XXHRead64(data));
+            v2 = XXHRound(v2, XXHRead64(data + 8));
+            v3 = XXHRound(v3, XXHRead64(data + 16));
+            v4 = XXHRound(v4, XXHRead64(data + 24));
+            data += 32;
+        } while (data <= limit);
+
+        h = _rotl64(v1, 1) + _rotl64(v2, 7) + _rotl64(v3, 12) + _rotl64(v4, 18);
+        h = XXHMergeRound(h, v1);
+        h = XXHMergeRound(h, v2);
+        h = XXHMergeRound(h, v3);
+        h = XXHMergeRound(h, v4);
+    } else {
+        h = seed + XXH_PRIME64_5;
+    }
+
+    h += len;
+
+    // Tail
+    for (; data + 8 <= end; data += 8) {
+        h ^= XXHRound(0, XXHRead64(data));
+        h = _rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+    if (data + 4 <= end) {
+        h ^= XXHRead32(data) * XXH_PRIME64_1;
+        h = _rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        data += 4;
+    }
+    for (; data < end; ++data) {
+        h ^= *data * XXH_PRIME64_5;
+        h = _rotl64(h, 11) * XXH_PRIME64_1;
+    }
+
+    // Finalization
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
 } // namespace Common
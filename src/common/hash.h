@@ -11,6 +11,9 @@ namespace Common {
 
 void MurmurHash3_128(const void* key, size_t len, u32 seed, void* out);
 
+/// Computes the 64-bit xxHash (XXH64) of a block of data.
+u64 XXHash64(const void* key, size_t len, u64 seed);
+
 /**
  * Computes a 64-bit hash over the specified block of data
  * @param data Block of data to compute hash over
@@ -18,9 +21,7 @@ void MurmurHash3_128(const void* key, size_t len, u32 seed, void* out);
  * @returns 64-bit hash value that was computed over the data block
  */
 static inline u64 ComputeHash64(const void* data, size_t len) {
-    u64 res[2];
-    MurmurHash3_128(data, len, 0, res);
-    return res[0];
+    return XXHash64(data, len, 0);
 }
 
 } // namespace Common
@@ -12,6 +12,7 @@
 #include "common/common_funcs.h"
 #include "common/string_util.h"
 #else
+#include <cstdint>
 #include <cstdlib>
 #include <sys/mman.h>
 #endif
@@ -89,6 +90,57 @@ void* AllocateMemoryPages(size_t size) {
     return ptr;
 }
 
+void* AllocateLargeMemoryPages(size_t size, LargePageBacking& backing) {
+    backing = LargePageBacking::Regular;
+#if !defined(_WIN32) && defined(MAP_HUGETLB)
+    if (size % LARGE_PAGE_SIZE == 0) {
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_ANON | MAP_PRIVATE | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            backing = LargePageBacking::Huge;
+            return ptr;
+        }
+    }
+#endif
+
+#ifdef _WIN32
+    return AllocateMemoryPages(size);
+#else
+    // Huge pages can only back aligned ranges, so the block is cut out of a larger mapping
+    const size_t page_mask = static_cast<size_t>(GetPageSize()) - 1;
+    const size_t mapped_size = (size + page_mask) & ~page_mask;
+    const size_t padded_size = mapped_size + LARGE_PAGE_SIZE;
+    char* padded = static_cast<char*>(AllocateMemoryPages(padded_size));
+    if (padded == nullptr)
+        return nullptr;
+
+    const size_t misalignment = reinterpret_cast<uintptr_t>(padded) % LARGE_PAGE_SIZE;
+    const size_t head = misalignment == 0 ? 0 : LARGE_PAGE_SIZE - misalignment;
+    char* ptr = padded + head;
+    if (head != 0)
+        munmap(padded, head);
+    munmap(ptr + mapped_size, padded_size - head - mapped_size);
+
+#ifdef MADV_HUGEPAGE
+    if (madvise(ptr, mapped_size, MADV_HUGEPAGE) == 0)
+        backing = LargePageBacking::TransparentHuge;
+#endif
+    return ptr;
+#endif
+}
+
+const char* GetLargePageBackingName(LargePageBacking backing) {
+    switch (backing) {
+    case LargePageBacking::Regular:
+        return "regular pages";
+    case LargePageBacking::TransparentHuge:
+        return "transparent huge pages";
+    case LargePageBacking::Huge:
+        return "huge pages";
+    }
+    return "unknown pages";
+}
+
 void* AllocateAlignedMemory(size_t size, size_t alignment) {
 #ifdef _WIN32
     void* ptr = _aligned_malloc(size, alignment);
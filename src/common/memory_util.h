@@ -7,8 +7,24 @@
 #include <cstddef>
 #include <string>
 
+/// Host pages backing a block returned by AllocateLargeMemoryPages
+enum class LargePageBacking {
+    Regular,         ///< Regular host pages
+    TransparentHuge, ///< Regular pages, which the host was advised to merge into huge pages
+    Huge,            ///< Explicitly reserved huge pages
+};
+
 void* AllocateExecutableMemory(size_t size, bool low = true);
 void* AllocateMemoryPages(size_t size);
+/**
+ * Allocates zeroed memory pages for a large block accessed all over, preferably backed by huge
+ * pages to reduce TLB misses. Explicit huge pages are only used when the size is a multiple of
+ * LARGE_PAGE_SIZE and the host has some reserved, otherwise the host is advised to use
+ * transparent huge pages where it supports them. Except on Windows, the block is aligned to
+ * LARGE_PAGE_SIZE either way. Free with FreeMemoryPages.
+ */
+void* AllocateLargeMemoryPages(size_t size, LargePageBacking& backing);
+const char* GetLargePageBackingName(LargePageBacking backing);
 void FreeMemoryPages(void* ptr, size_t size);
 void* AllocateAlignedMemory(size_t size, size_t alignment);
 void FreeAlignedMemory(void* ptr);
@@ -19,3 +35,6 @@ std::string MemUsage();
 inline int GetPageSize() {
     return 4096;
 }
+
+/// Size of the huge pages used by AllocateLargeMemoryPages
+constexpr size_t LARGE_PAGE_SIZE = 0x200000;
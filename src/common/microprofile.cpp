@@ -5,3 +5,13 @@
 // Includes the MicroProfile implementation in this file for compilation
 #define MICROPROFILE_IMPL 1
 #include "common/microprofile.h"
+
+const char* MicroProfileGetCurrentThreadName() {
+#if MICROPROFILE_ENABLED
+    MicroProfileThreadLog* log = MicroProfileGetThreadLog();
+    if (log != nullptr) {
+        return log->ThreadName;
+    }
+#endif
+    return "";
+}
@@ -24,6 +24,18 @@ typedef void* HANDLE;
 
 #define MP_RGB(r, g, b) ((r) << 16 | (g) << 8 | (b) << 0)
 
+/// Returns the name the calling thread was registered with by MicroProfileOnThreadCreate, if any.
+const char* MicroProfileGetCurrentThreadName();
+
+// Scopes are also forwarded to the trace recorder, which is a no-op unless a recording is active.
+#include "common/trace_recorder.h"
+#if MICROPROFILE_ENABLED
+#undef MICROPROFILE_SCOPE
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    Common::TraceRecorder::ScopeHandler<MicroProfileScopeHandler, MicroProfileToken>               \
+        MICROPROFILE_TOKEN_PASTE(foo, __LINE__)(g_mp_##var)
+#endif
+
 // On OS X, some Mach header included by MicroProfile defines these as macros, conflicting with
 // identifiers we use.
 #ifdef PAGE_SIZE
@@ -0,0 +1,103 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Lock-free, unbounded queue for exactly one producer thread and one consumer thread. Push may
+ * only be called by the producer, Pop and Front only by the consumer. Size and Empty may be called
+ * from either thread.
+ */
+template <typename T>
+class SPSCQueue {
+public:
+    SPSCQueue() {
+        write_ptr = read_ptr = new ElementPtr();
+    }
+
+    ~SPSCQueue() {
+        // This will recursively destroy all the elements
+        delete read_ptr;
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    size_t Size() const {
+        return size.load(std::memory_order_acquire);
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    T& Front() const {
+        return read_ptr->current;
+    }
+
+    template <typename Arg>
+    void Push(Arg&& t) {
+        // Create the element, add it to the queue
+        write_ptr->current = std::forward<Arg>(t);
+        // Set the next pointer to a new element ptr, then advance the write pointer
+        ElementPtr* new_ptr = new ElementPtr();
+        write_ptr->next.store(new_ptr, std::memory_order_release);
+        write_ptr = new_ptr;
+        size.fetch_add(1, std::memory_order_release);
+    }
+
+    /// Removes the front element. Must only be called when the queue is not empty.
+    void Pop() {
+        size.fetch_sub(1, std::memory_order_release);
+        ElementPtr* tmpptr = read_ptr;
+        // Advance the read pointer
+        read_ptr = tmpptr->next.load(std::memory_order_acquire);
+        // Set the next element to nullptr to stop the recursive deletion
+        tmpptr->next.store(nullptr, std::memory_order_relaxed);
+        delete tmpptr; // This also deletes the element
+    }
+
+    /// Moves the front element into t and removes it. Returns false if the queue is empty.
+    bool Pop(T& t) {
+        if (Empty())
+            return false;
+
+        ElementPtr* tmpptr = read_ptr;
+        read_ptr = tmpptr->next.load(std::memory_order_acquire);
+        t = std::move(tmpptr->current);
+        tmpptr->next.store(nullptr, std::memory_order_relaxed);
+        delete tmpptr;
+        size.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // Stores a pointer to the next ElementPtr and the element itself. The last ElementPtr in the
+    // queue is always empty and is overwritten by the next Push.
+    struct ElementPtr {
+        ElementPtr() : next(nullptr) {}
+
+        ~ElementPtr() {
+            ElementPtr* next_ptr = next.load(std::memory_order_relaxed);
+            if (next_ptr)
+                delete next_ptr;
+        }
+
+        T current;
+        std::atomic<ElementPtr*> next;
+    };
+
+    ElementPtr* write_ptr;
+    ElementPtr* read_ptr;
+    std::atomic<size_t> size{0};
+};
+
+} // namespace Common
@@ -0,0 +1,294 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "common/trace_recorder.h"
+
+namespace Common {
+namespace TraceRecorder {
+
+namespace Detail {
+std::atomic<bool> is_recording(false);
+} // namespace Detail
+
+using Clock = std::chrono::steady_clock;
+
+/// Per-thread event limit, about 200 MB. Later events are dropped and counted.
+constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 22;
+
+enum class EventType : u8 {
+    Begin,
+    End,
+    Instant,
+};
+
+struct Event {
+    s64 host_ns;
+    u64 emulated_ticks;
+    /// Name and category of emulated events, nullptr for MicroProfile scopes
+    const char* name;
+    const char* category;
+    u64 value;
+    u32 microprofile_token;
+    EventType type;
+    bool is_emulated;
+};
+
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::string thread_name;
+    std::vector<Event> events;
+    u64 dropped_events = 0;
+};
+
+static std::mutex buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+static thread_local ThreadBuffer* local_buffer = nullptr;
+
+static Clock::time_point start_time;
+static std::function<u64()> tick_source;
+static u64 emulated_ticks_per_second = 1;
+
+static ThreadBuffer& GetLocalBuffer() {
+    if (local_buffer == nullptr) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->thread_name = MicroProfileGetCurrentThreadName();
+        local_buffer = buffer.get();
+
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        if (buffer->thread_name.empty()) {
+            buffer->thread_name = "Thread " + std::to_string(buffers.size() + 1);
+        }
+        buffers.push_back(std::move(buffer));
+    }
+    return *local_buffer;
+}
+
+static void Record(EventType type, u32 token, const char* name, const char* category, u64 value,
+                   bool is_emulated) {
+    Event event;
+    event.host_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_time).count();
+    event.emulated_ticks = is_emulated && tick_source ? tick_source() : 0;
+    event.name = name;
+    event.category = category;
+    event.value = value;
+    event.microprofile_token = token;
+    event.type = type;
+    event.is_emulated = is_emulated;
+
+    ThreadBuffer& buffer = GetLocalBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    // Checked again under the lock so that nothing is appended once Stop has returned
+    if (!IsRecording()) {
+        return;
+    }
+    if (buffer.events.size() >= MAX_EVENTS_PER_THREAD) {
+        ++buffer.dropped_events;
+        return;
+    }
+    buffer.events.push_back(event);
+}
+
+void SetTickSource(std::function<u64()> get_ticks, u64 ticks_per_second) {
+    tick_source = std::move(get_ticks);
+    emulated_ticks_per_second = ticks_per_second;
+}
+
+void Start() {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    for (auto& buffer : buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->dropped_events = 0;
+    }
+    start_time = Clock::now();
+    Detail::is_recording.store(true, std::memory_order_release);
+    LOG_INFO(Common, "Trace recording started");
+}
+
+void Stop() {
+    if (!IsRecording()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    // Taking every buffer lock guarantees that no thread is still appending an event
+    for (auto& buffer : buffers) {
+        buffer->mutex.lock();
+    }
+    Detail::is_recording.store(false, std::memory_order_release);
+    for (auto& buffer : buffers) {
+        buffer->mutex.unlock();
+    }
+    LOG_INFO(Common, "Trace recording stopped");
+}
+
+void BeginScope(u32 microprofile_token) {
+    Record(EventType::Begin, microprofile_token, nullptr, nullptr, 0, false);
+}
+
+void EndScope(u32 microprofile_token) {
+    Record(EventType::End, microprofile_token, nullptr, nullptr, 0, false);
+}
+
+void BeginEmulatedScope(const char* name, const char* category) {
+    Record(EventType::Begin, 0, name, category, 0, true);
+}
+
+void EndEmulatedScope(const char* name, const char* category) {
+    Record(EventType::End, 0, name, category, 0, true);
+}
+
+void EmulatedInstant(const char* name, const char* category, u64 value) {
+    Record(EventType::Instant, 0, name, category, value, true);
+}
+
+/// Appends str to out as a JSON string literal.
+static void AppendJSONString(std::string& out, const char* str) {
+    out += '"';
+    for (; *str != '\0'; ++str) {
+        if (*str == '"' || *str == '\\') {
+            out += '\\';
+        } else if (static_cast<unsigned char>(*str) < 0x20) {
+            continue;
+        }
+        out += *str;
+    }
+    out += '"';
+}
+
+static const char* GetPhase(EventType type) {
+    switch (type) {
+    case EventType::Begin:
+        return "B";
+    case EventType::End:
+        return "E";
+    default:
+        return "i";
+    }
+}
+
+// Process ids of the two timelines in the exported trace
+constexpr int HOST_PID = 1;
+constexpr int EMULATED_PID = 2;
+
+/// Appends a single trace event. Timestamps are in microseconds.
+static void AppendEvent(std::string& out, const Event& event, int pid, int tid, double timestamp) {
+    char buffer[128];
+    const char* name = event.name;
+    const char* category = event.category;
+    if (name == nullptr) {
+#if MICROPROFILE_ENABLED
+        MicroProfile* profile = MicroProfileGet();
+        const auto& timer = profile->TimerInfo[MicroProfileGetTimerIndex(event.microprofile_token)];
+        name = timer.pName;
+        category = profile->GroupInfo[timer.nGroupIndex].pName;
+#else
+        name = category = "";
+#endif
+    }
+
+    out += "{\"name\":";
+    AppendJSONString(out, name);
+    out += ",\"cat\":";
+    AppendJSONString(out, category);
+    std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f",
+                  GetPhase(event.type), pid, tid, timestamp);
+    out += buffer;
+    if (event.type == EventType::Instant) {
+        out += ",\"s\":\"t\"";
+    }
+    if (event.is_emulated) {
+        std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"ticks\":%llu,\"value\":%llu}",
+                      static_cast<unsigned long long>(event.emulated_ticks),
+                      static_cast<unsigned long long>(event.value));
+        out += buffer;
+    }
+    out += "},\n";
+}
+
+/// Appends a metadata event naming a process or thread.
+static void AppendMetadata(std::string& out, const char* kind, int pid, int tid, const char* name) {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,",
+                  kind, pid, tid);
+    out += buffer;
+    out += "\"args\":{\"name\":";
+    AppendJSONString(out, name);
+    out += "}},\n";
+}
+
+bool WriteChromeTrace(const std::string& path) {
+    if (IsRecording()) {
+        LOG_ERROR(Common, "Trace recording must be stopped before it can be written");
+        return false;
+    }
+
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Common, "Failed to open trace file %s", path.c_str());
+        return false;
+    }
+
+    // Events are formatted into a chunk that is flushed to the file whenever it grows large, so
+    // that long recordings don't have to be held in memory twice.
+    constexpr size_t FLUSH_THRESHOLD = 1 << 20;
+    std::string chunk = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    const auto flush = [&] {
+        file.WriteBytes(chunk.data(), chunk.size());
+        chunk.clear();
+    };
+
+    AppendMetadata(chunk, "process_name", HOST_PID, 0, "Host");
+    AppendMetadata(chunk, "process_name", EMULATED_PID, 0, "Emulated");
+    AppendMetadata(chunk, "thread_name", EMULATED_PID, 0, "Emulated time");
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    u64 dropped_events = 0;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const ThreadBuffer& buffer = *buffers[i];
+        const int tid = static_cast<int>(i + 1);
+        AppendMetadata(chunk, "thread_name", HOST_PID, tid, buffer.thread_name.c_str());
+        dropped_events += buffer.dropped_events;
+
+        for (const Event& event : buffer.events) {
+            AppendEvent(chunk, event, HOST_PID, tid, event.host_ns / 1000.0);
+            if (event.is_emulated) {
+                const double emulated_us =
+                    event.emulated_ticks * 1000000.0 / emulated_ticks_per_second;
+                AppendEvent(chunk, event, EMULATED_PID, 0, emulated_us);
+            }
+            if (chunk.size() >= FLUSH_THRESHOLD) {
+                flush();
+            }
+        }
+    }
+
+    char footer[128];
+    std::snprintf(footer, sizeof(footer),
+                  "{\"name\":\"dropped_events\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"count\":%llu}}"
+                  "\n]}\n",
+                  HOST_PID, static_cast<unsigned long long>(dropped_events));
+    chunk += footer;
+    flush();
+
+    if (dropped_events != 0) {
+        LOG_WARNING(Common, "Trace buffers were full, %llu events were dropped",
+                    static_cast<unsigned long long>(dropped_events));
+    }
+    LOG_INFO(Common, "Trace written to %s", path.c_str());
+    return file.IsGood();
+}
+
+} // namespace TraceRecorder
+} // namespace Common
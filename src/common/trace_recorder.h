@@ -0,0 +1,98 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include "common/common_types.h"
+
+/**
+ * Records MicroProfile scopes and emulated events into per-thread buffers for offline analysis,
+ * and exports them in the Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+ *
+ * Host events are timestamped with the host clock. Emulated events additionally carry the emulated
+ * tick count and are exported a second time on a separate emulated timeline, so that host and
+ * emulated time can be correlated.
+ */
+namespace Common {
+namespace TraceRecorder {
+
+namespace Detail {
+extern std::atomic<bool> is_recording;
+} // namespace Detail
+
+/// Returns whether a recording is in progress. Cheap enough to guard every instrumentation point.
+inline bool IsRecording() {
+    return Detail::is_recording.load(std::memory_order_relaxed);
+}
+
+/**
+ * Sets the source of emulated time attached to emulated events.
+ * @param get_ticks Returns the current emulated tick count, only called from the CPU thread
+ * @param ticks_per_second Emulated clock rate, used to place events on the emulated timeline
+ */
+void SetTickSource(std::function<u64()> get_ticks, u64 ticks_per_second);
+
+/// Discards any previously recorded events and starts a new recording.
+void Start();
+
+/// Stops the current recording. Recorded events are kept until the next Start.
+void Stop();
+
+/**
+ * Writes the events of the last recording as Chrome trace event JSON.
+ * @param path Destination file
+ * @return True on success
+ */
+bool WriteChromeTrace(const std::string& path);
+
+/// Records entry into a MicroProfile scope on the calling thread.
+void BeginScope(u32 microprofile_token);
+
+/// Records exit from a MicroProfile scope on the calling thread.
+void EndScope(u32 microprofile_token);
+
+/**
+ * Records entry into an emulated scope, such as a CoreTiming callback.
+ * @param name Scope name, must outlive the recording (usually a string literal)
+ * @param category Category name, must outlive the recording
+ */
+void BeginEmulatedScope(const char* name, const char* category);
+
+/// Records exit from the innermost emulated scope started with BeginEmulatedScope.
+void EndEmulatedScope(const char* name, const char* category);
+
+/**
+ * Records an instantaneous emulated event, such as an interrupt or a context switch.
+ * @param name Event name, must outlive the recording (usually a string literal)
+ * @param category Category name, must outlive the recording
+ * @param value Event specific value, exported as an argument
+ */
+void EmulatedInstant(const char* name, const char* category, u64 value);
+
+/// Used by MICROPROFILE_SCOPE to forward scope entry and exit to both MicroProfile and the trace.
+template <typename MicroProfileScope, typename Token>
+class ScopeHandler {
+public:
+    explicit ScopeHandler(Token token) : microprofile_scope(token), recorded(IsRecording()) {
+        if (recorded) {
+            BeginScope(static_cast<u32>(token));
+        }
+    }
+
+    ~ScopeHandler() {
+        if (recorded) {
+            EndScope(static_cast<u32>(microprofile_scope.nToken));
+        }
+    }
+
+private:
+    MicroProfileScope microprofile_scope;
+    bool recorded;
+};
+
+} // namespace TraceRecorder
+} // namespace Common
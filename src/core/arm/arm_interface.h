@@ -41,6 +41,14 @@ public:
     /// Clear all instruction cache
     virtual void ClearInstructionCache() = 0;
 
+    /**
+     * Invalidate the code cache for a range of addresses, so that it is retranslated on the next
+     * execution.
+     * @param start_address Start of the range to invalidate
+     * @param length Size of the range in bytes
+     */
+    virtual void InvalidateCacheRange(u32 start_address, size_t length) = 0;
+
     /// Notify CPU emulation that page tables have changed
     virtual void PageTableChanged() = 0;
 
@@ -11,6 +11,7 @@
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/gdbstub/gdbstub.h"
 #include "core/hle/svc.h"
 #include "core/memory.h"
 
@@ -33,6 +34,39 @@ static void InterpreterFallback(u32 pc, Dynarmic::Jit* jit, void* user_arg) {
     jit->Cpsr() = state->Cpsr;
     jit->ExtRegs() = state->ExtReg;
     jit->SetFpscr(state->VFP[VFP_FPSCR]);
+
+    // The interpreter stops at gdb execute breakpoints, which reach it through ReadCode below.
+    if (GDBStub::IsServerEnabled() && GDBStub::GetCpuHaltFlag()) {
+        jit->HaltExecution();
+    }
+}
+
+static u32 ReadCode(u32 vaddr) {
+    u32 instruction = Memory::Read32(vaddr);
+    if (!GDBStub::IsConnected()) {
+        return instruction;
+    }
+
+    // Execute breakpoints are implemented by handing the JIT a BKPT instead of the original
+    // instruction, which it passes to InterpreterFallback. The interpreter then executes the real
+    // instruction and performs the breakpoint check. Blocks are invalidated by the gdbstub whenever
+    // an execute breakpoint is added or removed.
+    constexpr u32 ARM_BKPT = 0xE1200070;
+    constexpr u32 THUMB_BKPT = 0xBE00;
+
+    // Dynarmic does not tell ReadCode the location descriptor of the block being translated, and
+    // the CPSR of the running core only matches it at the start of a block. The instruction set
+    // of each breakpoint is instead the one gdb set it for, only Thumb code starts at vaddr + 2.
+    if (GDBStub::CheckBreakpoint(vaddr, GDBStub::BreakpointType::Execute)) {
+        if (!GDBStub::IsThumbBreakpoint(vaddr)) {
+            return ARM_BKPT;
+        }
+        instruction = (instruction & 0xFFFF0000) | THUMB_BKPT;
+    }
+    if (GDBStub::CheckBreakpoint(vaddr + 2, GDBStub::BreakpointType::Execute)) {
+        instruction = (instruction & 0x0000FFFF) | (THUMB_BKPT << 16);
+    }
+    return instruction;
 }
 
 static bool IsReadOnlyMemory(u32 vaddr) {
@@ -47,7 +81,7 @@ static Dynarmic::UserCallbacks GetUserCallbacks(
     user_callbacks.user_arg = static_cast<void*>(interpeter_state.get());
     user_callbacks.CallSVC = &SVC::CallSVC;
     user_callbacks.memory.IsReadOnlyMemory = &IsReadOnlyMemory;
-    user_callbacks.memory.ReadCode = &Memory::Read32;
+    user_callbacks.memory.ReadCode = &ReadCode;
     user_callbacks.memory.Read8 = &Memory::Read8;
     user_callbacks.memory.Read16 = &Memory::Read16;
     user_callbacks.memory.Read32 = &Memory::Read32;
@@ -171,6 +205,12 @@ void ARM_Dynarmic::ClearInstructionCache() {
     jit->ClearCache();
 }
 
+void ARM_Dynarmic::InvalidateCacheRange(u32 start_address, size_t length) {
+    for (auto& entry : jits) {
+        entry.second->InvalidateCacheRange(start_address, length);
+    }
+}
+
 void ARM_Dynarmic::PageTableChanged() {
     current_page_table = Memory::GetCurrentPageTable();
 
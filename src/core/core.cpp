@@ -5,7 +5,9 @@
 #include <memory>
 #include <utility>
 #include "audio_core/audio_core.h"
+#include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/trace_recorder.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dyncom/arm_dyncom.h"
@@ -16,6 +18,7 @@
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/thread.h"
 #include "core/hle/service/service.h"
+#include "core/hw/gpu_thread.h"
 #include "core/hw/hw.h"
 #include "core/loader/loader.h"
 #include "core/memory_setup.h"
@@ -44,6 +47,7 @@ System::ResultStatus System::RunLoop(int tight_loop) {
                 GDBStub::SetCpuStepFlag(false);
                 tight_loop = 1;
             } else {
+                GDBStub::WaitForPacket(std::chrono::milliseconds(10));
                 return ResultStatus::Success;
             }
         }
@@ -151,6 +155,11 @@ System::ResultStatus System::Init(EmuWindow* emu_window, u32 system_mode) {
     telemetry_session = std::make_unique<Core::TelemetrySession>();
 
     CoreTiming::Init();
+    Common::TraceRecorder::SetTickSource(&CoreTiming::GetTicks, BASE_CLOCK_RATE_ARM11);
+    if (Settings::values.record_trace) {
+        Common::TraceRecorder::Start();
+    }
+
     HW::Init();
     Kernel::Init(system_mode);
     Service::Init();
@@ -181,6 +190,9 @@ void System::Shutdown() {
     Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_Frametime",
                          perf_results.frametime * 1000.0);
 
+    // Finish any in-flight GPU work before tearing down the subsystems it uses
+    GPU::ShutdownThread();
+
     // Shutdown emulation session
     Movie::Shutdown();
     GDBStub::Shutdown();
@@ -190,6 +202,14 @@ void System::Shutdown() {
     Kernel::Shutdown();
     HW::Shutdown();
     CoreTiming::Shutdown();
+
+    if (Common::TraceRecorder::IsRecording()) {
+        Common::TraceRecorder::Stop();
+        const std::string path = FileUtil::GetUserPath(D_LOGS_IDX) + "trace.json";
+        FileUtil::CreateFullPath(path);
+        Common::TraceRecorder::WriteChromeTrace(path);
+    }
+
     cpu_core = nullptr;
     app_loader = nullptr;
     telemetry_session = nullptr;
@@ -104,6 +104,7 @@ public:
 
     PerfStats perf_stats;
     FrameLimiter frame_limiter;
+    FrameSkipper frame_skipper;
 
     void SetStatus(ResultStatus new_status, const char* details = nullptr) {
         status = new_status;
@@ -4,11 +4,12 @@
 
 #include <atomic>
 #include <cinttypes>
+#include <memory>
 #include <mutex>
 #include <vector>
-#include "common/chunk_file.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/trace_recorder.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -20,59 +21,41 @@ int g_clock_rate_arm11 = BASE_CLOCK_RATE_ARM11;
 #define MAX_SLICE_LENGTH 100000000
 
 namespace CoreTiming {
-struct EventType {
-    EventType() {}
 
-    EventType(TimedCallback cb, const char* n) : callback(cb), name(n) {}
-
-    TimedCallback callback;
-    const char* name;
-};
-
-static std::vector<EventType> event_types;
-
-struct BaseEvent {
+struct Timing::Event {
     s64 time;
     u64 userdata;
     int type;
+    Event* next;
 };
 
-typedef LinkedListItem<BaseEvent> Event;
-
-static Event* first;
-static Event* ts_first;
-static Event* ts_last;
-
-// event pools
-static Event* event_pool = nullptr;
-static Event* event_ts_pool = nullptr;
-static int allocated_ts_events = 0;
-// Optimization to skip MoveEvents when possible.
-static std::atomic<bool> has_ts_events(false);
-
-int g_slice_length;
-
-static s64 global_timer;
-static s64 idled_cycles;
-static s64 last_global_time_ticks;
-static s64 last_global_time_us;
+static void FireMhzChange(const std::vector<MHzChangeCallback>& callbacks) {
+    for (auto callback : callbacks)
+        callback();
+}
 
-static s64 down_count = 0; ///< A decreasing counter of remaining cycles before the next event,
-                           /// decreased by the cpu run loop
+Timing::Timing() : slice_length(INITIAL_SLICE_LENGTH), down_count(INITIAL_SLICE_LENGTH) {}
 
-static std::recursive_mutex external_event_section;
+Timing::~Timing() {
+    MoveEvents();
+    ClearPendingEvents();
+    UnregisterAllEvents();
 
-// Warning: not included in save state.
-using AdvanceCallback = void(int cycles_executed);
-static AdvanceCallback* advance_callback = nullptr;
-static std::vector<MHzChangeCallback> mhz_change_callbacks;
+    while (event_pool) {
+        Event* event = event_pool;
+        event_pool = event->next;
+        delete event;
+    }
 
-static void FireMhzChange() {
-    for (auto callback : mhz_change_callbacks)
-        callback();
+    std::lock_guard<std::recursive_mutex> lock(external_event_section);
+    while (event_ts_pool) {
+        Event* event = event_ts_pool;
+        event_ts_pool = event->next;
+        delete event;
+    }
 }
 
-void SetClockFrequencyMHz(int cpu_mhz) {
+void Timing::SetClockFrequencyMHz(int cpu_mhz) {
     // When the mhz changes, we keep track of what "time" it was before hand.
     // This way, time always moves forward, even if mhz is changed.
     last_global_time_us = GetGlobalTimeUs();
@@ -81,21 +64,17 @@ void SetClockFrequencyMHz(int cpu_mhz) {
     g_clock_rate_arm11 = cpu_mhz * 1000000;
     // TODO: Rescale times of scheduled events?
 
-    FireMhzChange();
+    FireMhzChange(mhz_change_callbacks);
 }
 
-int GetClockFrequencyMHz() {
-    return g_clock_rate_arm11 / 1000000;
-}
-
-u64 GetGlobalTimeUs() {
+u64 Timing::GetGlobalTimeUs() const {
     s64 ticks_since_last = GetTicks() - last_global_time_ticks;
     int freq = GetClockFrequencyMHz();
     s64 us_since_last = ticks_since_last / freq;
     return last_global_time_us + us_since_last;
 }
 
-static Event* GetNewEvent() {
+Timing::Event* Timing::GetNewEvent() {
     if (!event_pool)
         return new Event;
 
@@ -104,7 +83,7 @@ static Event* GetNewEvent() {
     return event;
 }
 
-static Event* GetNewTsEvent() {
+Timing::Event* Timing::GetNewTsEvent() {
     allocated_ts_events++;
 
     if (!event_ts_pool)
@@ -115,18 +94,18 @@ static Event* GetNewTsEvent() {
     return event;
 }
 
-static void FreeEvent(Event* event) {
+void Timing::FreeEvent(Event* event) {
     event->next = event_pool;
     event_pool = event;
 }
 
-static void FreeTsEvent(Event* event) {
+void Timing::FreeTsEvent(Event* event) {
     event->next = event_ts_pool;
     event_ts_pool = event;
     allocated_ts_events--;
 }
 
-int RegisterEvent(const char* name, TimedCallback callback) {
+int Timing::RegisterEvent(const char* name, TimedCallback callback) {
     event_types.emplace_back(callback, name);
     return (int)event_types.size() - 1;
 }
@@ -135,77 +114,37 @@ static void AntiCrashCallback(u64 userdata, int cycles_late) {
     LOG_CRITICAL(Core_Timing, "Savestate broken: an unregistered event was called.");
 }
 
-void RestoreRegisterEvent(int event_type, const char* name, TimedCallback callback) {
+void Timing::RestoreRegisterEvent(int event_type, const char* name, TimedCallback callback) {
     if (event_type >= (int)event_types.size())
         event_types.resize(event_type + 1, EventType(AntiCrashCallback, "INVALID EVENT"));
 
     event_types[event_type] = EventType(callback, name);
 }
 
-void UnregisterAllEvents() {
+void Timing::UnregisterAllEvents() {
     if (first)
         LOG_ERROR(Core_Timing, "Cannot unregister events with events pending");
     event_types.clear();
 }
 
-void Init() {
-    down_count = INITIAL_SLICE_LENGTH;
-    g_slice_length = INITIAL_SLICE_LENGTH;
-    global_timer = 0;
-    idled_cycles = 0;
-    last_global_time_ticks = 0;
-    last_global_time_us = 0;
-    has_ts_events = 0;
-    mhz_change_callbacks.clear();
-
-    first = nullptr;
-    ts_first = nullptr;
-    ts_last = nullptr;
-
-    event_pool = nullptr;
-    event_ts_pool = nullptr;
-    allocated_ts_events = 0;
-
-    advance_callback = nullptr;
-}
-
-void Shutdown() {
-    MoveEvents();
-    ClearPendingEvents();
-    UnregisterAllEvents();
-
-    while (event_pool) {
-        Event* event = event_pool;
-        event_pool = event->next;
-        delete event;
-    }
-
-    std::lock_guard<std::recursive_mutex> lock(external_event_section);
-    while (event_ts_pool) {
-        Event* event = event_ts_pool;
-        event_ts_pool = event->next;
-        delete event;
-    }
-}
-
-void AddTicks(u64 ticks) {
+void Timing::AddTicks(u64 ticks) {
     down_count -= ticks;
     if (down_count < 0) {
         Advance();
     }
 }
 
-u64 GetTicks() {
-    return (u64)global_timer + g_slice_length - down_count;
+u64 Timing::GetTicks() const {
+    return (u64)global_timer + slice_length - down_count;
 }
 
-u64 GetIdleTicks() {
+u64 Timing::GetIdleTicks() const {
     return (u64)idled_cycles;
 }
 
 // This is to be called when outside threads, such as the graphics thread, wants to
 // schedule things to be executed on the main thread.
-void ScheduleEvent_Threadsafe(s64 cycles_into_future, int event_type, u64 userdata) {
+void Timing::ScheduleEvent_Threadsafe(s64 cycles_into_future, int event_type, u64 userdata) {
     std::lock_guard<std::recursive_mutex> lock(external_event_section);
     Event* new_event = GetNewTsEvent();
     new_event->time = GetTicks() + cycles_into_future;
@@ -223,7 +162,7 @@ void ScheduleEvent_Threadsafe(s64 cycles_into_future, int event_type, u64 userda
 
 // Same as ScheduleEvent_Threadsafe(0, ...) EXCEPT if we are already on the CPU thread
 // in which case the event will get handled immediately, before returning.
-void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata) {
+void Timing::ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata) {
     if (false) // Core::IsCPUThread())
     {
         std::lock_guard<std::recursive_mutex> lock(external_event_section);
@@ -232,7 +171,7 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata) {
         ScheduleEvent_Threadsafe(0, event_type, userdata);
 }
 
-void ClearPendingEvents() {
+void Timing::ClearPendingEvents() {
     while (first) {
         Event* event = first->next;
         FreeEvent(first);
@@ -240,7 +179,7 @@ void ClearPendingEvents() {
     }
 }
 
-static void AddEventToQueue(Event* new_event) {
+void Timing::AddEventToQueue(Event* new_event) {
     Event* prev_event = nullptr;
     Event** next_event = &first;
     for (;;) {
@@ -255,7 +194,7 @@ static void AddEventToQueue(Event* new_event) {
     }
 }
 
-void ScheduleEvent(s64 cycles_into_future, int event_type, u64 userdata) {
+void Timing::ScheduleEvent(s64 cycles_into_future, int event_type, u64 userdata) {
     Event* new_event = GetNewEvent();
     new_event->userdata = userdata;
     new_event->type = event_type;
@@ -263,7 +202,7 @@ void ScheduleEvent(s64 cycles_into_future, int event_type, u64 userdata) {
     AddEventToQueue(new_event);
 }
 
-s64 UnscheduleEvent(int event_type, u64 userdata) {
+s64 Timing::UnscheduleEvent(int event_type, u64 userdata) {
     s64 result = 0;
     if (!first)
         return result;
@@ -300,7 +239,7 @@ s64 UnscheduleEvent(int event_type, u64 userdata) {
     return result;
 }
 
-s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata) {
+s64 Timing::UnscheduleThreadsafeEvent(int event_type, u64 userdata) {
     s64 result = 0;
     std::lock_guard<std::recursive_mutex> lock(external_event_section);
     if (!ts_first)
@@ -344,15 +283,15 @@ s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata) {
 }
 
 // Warning: not included in save state.
-void RegisterAdvanceCallback(AdvanceCallback* callback) {
+void Timing::RegisterAdvanceCallback(AdvanceCallback* callback) {
     advance_callback = callback;
 }
 
-void RegisterMHzChangeCallback(MHzChangeCallback callback) {
+void Timing::RegisterMHzChangeCallback(MHzChangeCallback callback) {
     mhz_change_callbacks.push_back(callback);
 }
 
-bool IsScheduled(int event_type) {
+bool Timing::IsScheduled(int event_type) const {
     if (!first)
         return false;
     Event* event = first;
@@ -364,7 +303,7 @@ bool IsScheduled(int event_type) {
     return false;
 }
 
-void RemoveEvent(int event_type) {
+void Timing::RemoveEvent(int event_type) {
     if (!first)
         return;
     while (first) {
@@ -392,7 +331,7 @@ void RemoveEvent(int event_type) {
     }
 }
 
-void RemoveThreadsafeEvent(int event_type) {
+void Timing::RemoveThreadsafeEvent(int event_type) {
     std::lock_guard<std::recursive_mutex> lock(external_event_section);
     if (!ts_first)
         return;
@@ -428,18 +367,26 @@ void RemoveThreadsafeEvent(int event_type) {
     }
 }
 
-void RemoveAllEvents(int event_type) {
+void Timing::RemoveAllEvents(int event_type) {
     RemoveThreadsafeEvent(event_type);
     RemoveEvent(event_type);
 }
 
 // This raise only the events required while the fifo is processing data
-void ProcessFifoWaitEvents() {
+void Timing::ProcessFifoWaitEvents() {
     while (first) {
         if (first->time <= (s64)GetTicks()) {
             Event* evt = first;
             first = first->next;
+            const char* name = event_types[evt->type].name;
+            const bool trace = Common::TraceRecorder::IsRecording();
+            if (trace) {
+                Common::TraceRecorder::BeginEmulatedScope(name, "CoreTiming");
+            }
             event_types[evt->type].callback(evt->userdata, (int)(GetTicks() - evt->time));
+            if (trace) {
+                Common::TraceRecorder::EndEmulatedScope(name, "CoreTiming");
+            }
             FreeEvent(evt);
         } else {
             break;
@@ -447,7 +394,7 @@ void ProcessFifoWaitEvents() {
     }
 }
 
-void MoveEvents() {
+void Timing::MoveEvents() {
     has_ts_events = false;
 
     std::lock_guard<std::recursive_mutex> lock(external_event_section);
@@ -469,28 +416,28 @@ void MoveEvents() {
     }
 }
 
-void ForceCheck() {
-    s64 cycles_executed = g_slice_length - down_count;
+void Timing::ForceCheck() {
+    s64 cycles_executed = slice_length - down_count;
     global_timer += cycles_executed;
     // This will cause us to check for new events immediately.
     down_count = 0;
     // But let's not eat a bunch more time in Advance() because of this.
-    g_slice_length = 0;
+    slice_length = 0;
 }
 
-void Advance() {
-    s64 cycles_executed = g_slice_length - down_count;
+void Timing::Advance() {
+    s64 cycles_executed = slice_length - down_count;
     global_timer += cycles_executed;
-    down_count = g_slice_length;
+    down_count = slice_length;
 
     if (has_ts_events)
         MoveEvents();
     ProcessFifoWaitEvents();
 
     if (!first) {
-        if (g_slice_length < 10000) {
-            g_slice_length += 10000;
-            down_count += g_slice_length;
+        if (slice_length < 10000) {
+            slice_length += 10000;
+            down_count += slice_length;
         }
     } else {
         // Note that events can eat cycles as well.
@@ -498,15 +445,15 @@ void Advance() {
         if (target > MAX_SLICE_LENGTH)
             target = MAX_SLICE_LENGTH;
 
-        const int diff = target - g_slice_length;
-        g_slice_length += diff;
+        const int diff = target - slice_length;
+        slice_length += diff;
         down_count += diff;
     }
     if (advance_callback)
         advance_callback(static_cast<int>(cycles_executed));
 }
 
-void LogPendingEvents() {
+void Timing::LogPendingEvents() const {
     Event* event = first;
     while (event) {
         // LOG_TRACE(Core_Timing, "PENDING: Now: %lld Pending: %lld Type: %d", globalTimer,
@@ -515,13 +462,13 @@ void LogPendingEvents() {
     }
 }
 
-void Idle(int max_idle) {
+void Timing::Idle(int max_idle) {
     s64 cycles_down = down_count;
     if (max_idle != 0 && cycles_down > max_idle)
         cycles_down = max_idle;
 
     if (first && cycles_down > 0) {
-        s64 cycles_executed = g_slice_length - down_count;
+        s64 cycles_executed = slice_length - down_count;
         s64 cycles_next_event = first->time - global_timer;
 
         if (cycles_next_event < cycles_executed + cycles_down) {
@@ -541,7 +488,7 @@ void Idle(int max_idle) {
         down_count = -1;
 }
 
-std::string GetScheduledEventsSummary() {
+std::string Timing::GetScheduledEventsSummary() const {
     Event* event = first;
     std::string text = "Scheduled events\n";
     text.reserve(1000);
@@ -559,4 +506,130 @@ std::string GetScheduledEventsSummary() {
     return text;
 }
 
+int GetClockFrequencyMHz() {
+    return g_clock_rate_arm11 / 1000000;
+}
+
+static std::unique_ptr<Timing> timing;
+
+void Init() {
+    timing = std::make_unique<Timing>();
+}
+
+void Shutdown() {
+    timing.reset();
+}
+
+Timing& GetTiming() {
+    return *timing;
+}
+
+void AddTicks(u64 ticks) {
+    timing->AddTicks(ticks);
+}
+
+u64 GetTicks() {
+    return timing->GetTicks();
+}
+
+u64 GetIdleTicks() {
+    return timing->GetIdleTicks();
+}
+
+u64 GetGlobalTimeUs() {
+    return timing->GetGlobalTimeUs();
+}
+
+int RegisterEvent(const char* name, TimedCallback callback) {
+    return timing->RegisterEvent(name, callback);
+}
+
+void RestoreRegisterEvent(int event_type, const char* name, TimedCallback callback) {
+    timing->RestoreRegisterEvent(event_type, name, callback);
+}
+
+void UnregisterAllEvents() {
+    timing->UnregisterAllEvents();
+}
+
+void ScheduleEvent(s64 cycles_into_future, int event_type, u64 userdata) {
+    timing->ScheduleEvent(cycles_into_future, event_type, userdata);
+}
+
+void ScheduleEvent_Threadsafe(s64 cycles_into_future, int event_type, u64 userdata) {
+    timing->ScheduleEvent_Threadsafe(cycles_into_future, event_type, userdata);
+}
+
+void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata) {
+    timing->ScheduleEvent_Threadsafe_Immediate(event_type, userdata);
+}
+
+s64 UnscheduleEvent(int event_type, u64 userdata) {
+    return timing->UnscheduleEvent(event_type, userdata);
+}
+
+s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata) {
+    return timing->UnscheduleThreadsafeEvent(event_type, userdata);
+}
+
+void RemoveEvent(int event_type) {
+    timing->RemoveEvent(event_type);
+}
+
+void RemoveThreadsafeEvent(int event_type) {
+    timing->RemoveThreadsafeEvent(event_type);
+}
+
+void RemoveAllEvents(int event_type) {
+    timing->RemoveAllEvents(event_type);
+}
+
+bool IsScheduled(int event_type) {
+    return timing->IsScheduled(event_type);
+}
+
+void Advance() {
+    timing->Advance();
+}
+
+void MoveEvents() {
+    timing->MoveEvents();
+}
+
+void ProcessFifoWaitEvents() {
+    timing->ProcessFifoWaitEvents();
+}
+
+void ForceCheck() {
+    timing->ForceCheck();
+}
+
+void Idle(int max_idle) {
+    timing->Idle(max_idle);
+}
+
+void ClearPendingEvents() {
+    timing->ClearPendingEvents();
+}
+
+void LogPendingEvents() {
+    timing->LogPendingEvents();
+}
+
+void RegisterAdvanceCallback(AdvanceCallback* callback) {
+    timing->RegisterAdvanceCallback(callback);
+}
+
+void RegisterMHzChangeCallback(MHzChangeCallback callback) {
+    timing->RegisterMHzChangeCallback(callback);
+}
+
+std::string GetScheduledEventsSummary() {
+    return timing->GetScheduledEventsSummary();
+}
+
+void SetClockFrequencyMHz(int cpu_mhz) {
+    timing->SetClockFrequencyMHz(cpu_mhz);
+}
+
 } // namespace
@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <mutex>
 #include <string>
+#include <vector>
 #include "common/common_types.h"
 
 // This is a system to schedule events into the emulated machine's future. Time is measured
@@ -61,11 +64,112 @@ inline u64 cyclesToMs(s64 cycles) {
 }
 
 namespace CoreTiming {
-void Init();
-void Shutdown();
 
 typedef void (*MHzChangeCallback)();
 typedef std::function<void(u64 userdata, int cycles_late)> TimedCallback;
+using AdvanceCallback = void(int cycles_executed);
+
+/**
+ * Event queue and clock of the timing subsystem. Instances are independent of each other, apart
+ * from the clock rate g_clock_rate_arm11 which SetClockFrequencyMHz sets for all of them. The rest
+ * of the core (memory, kernel, GPU, DSP) is still process-wide and only runs on the instance
+ * created by Init, so a process still emulates a single system. The free functions below operate
+ * on that instance, see them for the documentation of each member.
+ */
+class Timing {
+public:
+    Timing();
+    ~Timing();
+
+    Timing(const Timing&) = delete;
+    Timing& operator=(const Timing&) = delete;
+
+    void AddTicks(u64 ticks);
+    u64 GetTicks() const;
+    u64 GetIdleTicks() const;
+    u64 GetGlobalTimeUs() const;
+
+    int RegisterEvent(const char* name, TimedCallback callback);
+    void RestoreRegisterEvent(int event_type, const char* name, TimedCallback callback);
+    void UnregisterAllEvents();
+
+    void ScheduleEvent(s64 cycles_into_future, int event_type, u64 userdata = 0);
+    void ScheduleEvent_Threadsafe(s64 cycles_into_future, int event_type, u64 userdata = 0);
+    void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata = 0);
+    s64 UnscheduleEvent(int event_type, u64 userdata);
+    s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata);
+
+    void RemoveEvent(int event_type);
+    void RemoveThreadsafeEvent(int event_type);
+    void RemoveAllEvents(int event_type);
+    bool IsScheduled(int event_type) const;
+    void Advance();
+    void MoveEvents();
+    void ProcessFifoWaitEvents();
+    void ForceCheck();
+    void Idle(int max_idle = 0);
+    void ClearPendingEvents();
+    void LogPendingEvents() const;
+
+    void RegisterAdvanceCallback(AdvanceCallback* callback);
+    void RegisterMHzChangeCallback(MHzChangeCallback callback);
+
+    std::string GetScheduledEventsSummary() const;
+
+    void SetClockFrequencyMHz(int cpu_mhz);
+
+private:
+    struct EventType {
+        EventType() {}
+        EventType(TimedCallback cb, const char* n) : callback(cb), name(n) {}
+
+        TimedCallback callback;
+        const char* name;
+    };
+    struct Event;
+
+    Event* GetNewEvent();
+    Event* GetNewTsEvent();
+    void FreeEvent(Event* event);
+    void FreeTsEvent(Event* event);
+    void AddEventToQueue(Event* new_event);
+
+    std::vector<EventType> event_types;
+
+    Event* first = nullptr;
+    Event* ts_first = nullptr;
+    Event* ts_last = nullptr;
+
+    // event pools
+    Event* event_pool = nullptr;
+    Event* event_ts_pool = nullptr;
+    int allocated_ts_events = 0;
+    // Optimization to skip MoveEvents when possible.
+    std::atomic<bool> has_ts_events{false};
+
+    int slice_length;
+    s64 global_timer = 0;
+    s64 idled_cycles = 0;
+    s64 last_global_time_ticks = 0;
+    s64 last_global_time_us = 0;
+
+    /// A decreasing counter of remaining cycles before the next event, decreased by the cpu run
+    /// loop
+    s64 down_count;
+
+    std::recursive_mutex external_event_section;
+
+    // Warning: not included in save state.
+    AdvanceCallback* advance_callback = nullptr;
+    std::vector<MHzChangeCallback> mhz_change_callbacks;
+};
+
+/// Creates the timing instance the free functions operate on, replacing any previous one.
+void Init();
+/// Destroys the timing instance created by Init.
+void Shutdown();
+/// Returns the timing instance created by Init.
+Timing& GetTiming();
 
 /**
 * Advance the CPU core by the specified number of ticks (e.g. to simulate CPU execution time)
@@ -139,6 +243,5 @@ std::string GetScheduledEventsSummary();
 
 void SetClockFrequencyMHz(int cpu_mhz);
 int GetClockFrequencyMHz();
-extern int g_slice_length;
 
 } // namespace
@@ -52,13 +52,10 @@ ResultVal<std::unique_ptr<ArchiveBackend>> ArchiveFactory_NCCH::Open(const Path&
     u32 low = data[0];
     std::string file_path = GetNCCHPath(mount_point, high, low);
 
-    std::shared_ptr<FileUtil::IOFile> romfs_file;
-    u64 romfs_offset = 0;
-    u64 romfs_size = 0;
+    std::shared_ptr<RomFSReader> romfs_file;
     auto ncch_container = NCCHContainer(file_path);
 
-    if (ncch_container.ReadRomFS(romfs_file, romfs_offset, romfs_size) !=
-        Loader::ResultStatus::Success) {
+    if (ncch_container.ReadRomFS(romfs_file) != Loader::ResultStatus::Success) {
         // High Title ID of the archive: The category (https://3dbrew.org/wiki/Title_list).
         constexpr u32 shared_data_archive = 0x0004009B;
         constexpr u32 system_data_archive = 0x000400DB;
@@ -93,7 +90,7 @@ ResultVal<std::unique_ptr<ArchiveBackend>> ArchiveFactory_NCCH::Open(const Path&
         return ERROR_NOT_FOUND;
     }
 
-    auto archive = std::make_unique<IVFCArchive>(romfs_file, romfs_offset, romfs_size);
+    auto archive = std::make_unique<IVFCArchive>(romfs_file);
     return MakeResult<std::unique_ptr<ArchiveBackend>>(std::move(archive));
 }
 
@@ -20,7 +20,7 @@ std::string IVFCArchive::GetName() const {
 ResultVal<std::unique_ptr<FileBackend>> IVFCArchive::OpenFile(const Path& path,
                                                               const Mode& mode) const {
     return MakeResult<std::unique_ptr<FileBackend>>(
-        std::make_unique<IVFCFile>(romfs_file, data_offset, data_size));
+        std::make_unique<IVFCFile>(romfs_file));
 }
 
 ResultCode IVFCArchive::DeleteFile(const Path& path) const {
@@ -87,10 +87,7 @@ u64 IVFCArchive::GetFreeBytes() const {
 
 ResultVal<size_t> IVFCFile::Read(const u64 offset, const size_t length, u8* buffer) const {
     LOG_TRACE(Service_FS, "called offset=%llu, length=%zu", offset, length);
-    romfs_file->Seek(data_offset + offset, SEEK_SET);
-    size_t read_length = (size_t)std::min((u64)length, data_size - offset);
-
-    return MakeResult<size_t>(romfs_file->ReadBytes(buffer, read_length));
+    return MakeResult<size_t>(romfs_file->ReadFile(offset, length, buffer));
 }
 
 ResultVal<size_t> IVFCFile::Write(const u64 offset, const size_t length, const bool flush,
@@ -101,7 +98,7 @@ ResultVal<size_t> IVFCFile::Write(const u64 offset, const size_t length, const b
 }
 
 u64 IVFCFile::GetSize() const {
-    return data_size;
+    return romfs_file->GetSize();
 }
 
 bool IVFCFile::SetSize(const u64 size) const {
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 #include <memory>
@@ -19,6 +20,11 @@ namespace FileSys {
 static const int kMaxSections = 8;   ///< Maximum number of sections (files) in an ExeFs
 static const int kBlockSize = 0x200; ///< Size of ExeFS blocks (in bytes)
 
+// Encryption flags of the NCCH header, in flags[7]
+static const u8 kFixedKeyFlag = 0x01;   ///< Encrypted with a fixed key instead of a KeyY
+static const u8 kNoCryptoFlag = 0x04;   ///< Not encrypted
+static const u8 kSeedCryptoFlag = 0x20; ///< The KeyY of the secondary key is mixed with a seed
+
 /**
  * Get the decompressed size of an LZSS compressed ExeFS file
  * @param buffer Buffer of compressed file
@@ -30,16 +36,8 @@ static u32 LZSS_GetDecompressedSize(const u8* buffer, u32 size) {
     return offset_size + size;
 }
 
-/**
- * Decompress ExeFS file (compressed with LZSS)
- * @param compressed Compressed buffer
- * @param compressed_size Size of compressed buffer
- * @param decompressed Decompressed buffer
- * @param decompressed_size Size of decompressed buffer
- * @return True on success, otherwise false
- */
-static bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decompressed,
-                            u32 decompressed_size) {
+bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decompressed,
+                     u32 decompressed_size) {
     const u8* footer = compressed + compressed_size - 8;
     u32 buffer_top_and_bottom = *reinterpret_cast<const u32*>(footer);
     u32 out = decompressed_size;
@@ -137,12 +135,30 @@ Loader::ResultStatus NCCHContainer::Load() {
 
         has_header = true;
 
+        bool failed_to_decrypt = false;
+        if (!(ncch_header.flags[7] & kNoCryptoFlag)) {
+            is_encrypted = true;
+            failed_to_decrypt = !LoadCrypto();
+        }
+
         // System archives and DLC don't have an extended header but have RomFS
         if (ncch_header.extended_header_size) {
             if (file.ReadBytes(&exheader_header, sizeof(ExHeader_Header)) !=
                 sizeof(ExHeader_Header))
                 return Loader::ResultStatus::Error;
 
+            if (is_encrypted) {
+                if (exheader_header.system_info.jump_id == ncch_header.program_id) {
+                    LOG_WARNING(Service_FS, "NCCH is marked as encrypted but its ExHeader is "
+                                            "decrypted, assuming it is decrypted.");
+                    is_encrypted = false;
+                } else if (!failed_to_decrypt) {
+                    HW::AES::CTRCipher(primary_key, exheader_ctr)
+                        .Process(reinterpret_cast<u8*>(&exheader_header), sizeof(ExHeader_Header),
+                                 0);
+                }
+            }
+
             is_compressed = (exheader_header.codeset_info.flags.flag & 1) == 1;
             u32 entry_point = exheader_header.codeset_info.text.address;
             u32 code_size = exheader_header.codeset_info.text.code_size;
@@ -177,6 +193,9 @@ Loader::ResultStatus NCCHContainer::Load() {
             has_exheader = true;
         }
 
+        if (is_encrypted && failed_to_decrypt)
+            return Loader::ResultStatus::ErrorEncrypted;
+
         // DLC can have an ExeFS and a RomFS but no extended header
         if (ncch_header.exefs_size) {
             exefs_offset = ncch_header.exefs_offset * kBlockSize;
@@ -189,6 +208,12 @@ Loader::ResultStatus NCCHContainer::Load() {
             if (file.ReadBytes(&exefs_header, sizeof(ExeFs_Header)) != sizeof(ExeFs_Header))
                 return Loader::ResultStatus::Error;
 
+            if (is_encrypted) {
+                HW::AES::CTRCipher(primary_key, exefs_ctr)
+                    .Process(reinterpret_cast<u8*>(&exefs_header), sizeof(ExeFs_Header), 0);
+                is_exefs_encrypted = true;
+            }
+
             exefs_file = FileUtil::IOFile(filepath, "rb");
             has_exefs = true;
         }
@@ -207,6 +232,77 @@ Loader::ResultStatus NCCHContainer::Load() {
     return Loader::ResultStatus::Success;
 }
 
+bool NCCHContainer::LoadCrypto() {
+    if (ncch_header.flags[7] & kFixedKeyFlag) {
+        // Only the fixed key of non-system titles is known, which is all zeroes
+        LOG_DEBUG(Service_FS, "Fixed-key crypto");
+        primary_key = {};
+        secondary_key = {};
+    } else {
+        if (ncch_header.flags[7] & kSeedCryptoFlag) {
+            LOG_ERROR(Service_FS, "Seed crypto is not supported");
+            return false;
+        }
+
+        size_t secondary_slot;
+        switch (ncch_header.flags[3]) {
+        case 0x00:
+            secondary_slot = HW::AES::NCCHSecure1;
+            break;
+        case 0x01:
+            secondary_slot = HW::AES::NCCHSecure2;
+            break;
+        case 0x0A:
+            secondary_slot = HW::AES::NCCHSecure3;
+            break;
+        case 0x0B:
+            secondary_slot = HW::AES::NCCHSecure4;
+            break;
+        default:
+            LOG_ERROR(Service_FS, "Unknown crypto method 0x%02X", ncch_header.flags[3]);
+            return false;
+        }
+
+        // Both keys use the start of the header signature as KeyY
+        HW::AES::AESKey key_y;
+        std::memcpy(key_y.data(), ncch_header.signature, key_y.size());
+        if (!HW::AES::GenerateNormalKey(HW::AES::NCCHSecure1, key_y, primary_key) ||
+            !HW::AES::GenerateNormalKey(secondary_slot, key_y, secondary_key)) {
+            LOG_ERROR(Service_FS, "KeyX of slot 0x%02zX or 0x%02zX, or the generator constant, "
+                                  "is missing from the AES key file",
+                      static_cast<size_t>(HW::AES::NCCHSecure1), secondary_slot);
+            return false;
+        }
+    }
+
+    if (ncch_header.version == 0 || ncch_header.version == 2) {
+        // The counter of each section is the partition ID in big endian, followed by its type
+        std::reverse_copy(ncch_header.partition_id, ncch_header.partition_id + 8,
+                          exheader_ctr.begin());
+        exefs_ctr = romfs_ctr = exheader_ctr;
+        exheader_ctr[8] = 1;
+        exefs_ctr[8] = 2;
+        romfs_ctr[8] = 3;
+    } else if (ncch_header.version == 1) {
+        // The counter of each section is the partition ID followed by the offset of the section,
+        // as if the whole NCCH was encrypted as one stream
+        std::copy(ncch_header.partition_id, ncch_header.partition_id + 8, exheader_ctr.begin());
+        exefs_ctr = romfs_ctr = exheader_ctr;
+        auto set_offset = [](HW::AES::AESCounter& ctr, u32 offset) {
+            for (int i = 0; i < 4; ++i) {
+                ctr[15 - i] = static_cast<u8>(offset >> (i * 8));
+            }
+        };
+        set_offset(exheader_ctr, sizeof(NCCH_Header));
+        set_offset(exefs_ctr, ncch_header.exefs_offset * kBlockSize);
+        set_offset(romfs_ctr, ncch_header.romfs_offset * kBlockSize);
+    } else {
+        LOG_ERROR(Service_FS, "Unknown NCCH version %u", ncch_header.version);
+        return false;
+    }
+    return true;
+}
+
 Loader::ResultStatus NCCHContainer::LoadOverrides() {
     // Check for split-off files, mark the archive as tainted if we will use them
     std::string romfs_override = filepath + ".romfs";
@@ -223,6 +319,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrides() {
         if (exefs_file.ReadBytes(&exefs_header, sizeof(ExeFs_Header)) == sizeof(ExeFs_Header)) {
             LOG_DEBUG(Service_FS, "Loading ExeFS section from %s", exefs_override.c_str());
             exefs_offset = 0;
+            is_exefs_encrypted = false;
             is_tainted = true;
             has_exefs = true;
         } else {
@@ -268,6 +365,16 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 (section.offset + exefs_offset + sizeof(ExeFs_Header) + ncch_offset);
             exefs_file.Seek(section_offset, SEEK_SET);
 
+            // The icon and banner are encrypted with the primary key, the rest with the secondary
+            const bool primary = strcmp(section.name, "icon") == 0 ||
+                                 strcmp(section.name, "banner") == 0;
+            auto decrypt = [&](u8* data) {
+                if (is_exefs_encrypted) {
+                    HW::AES::CTRCipher(primary ? primary_key : secondary_key, exefs_ctr)
+                        .Process(data, section.size, sizeof(ExeFs_Header) + section.offset);
+                }
+            };
+
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
                 // Section is compressed, read compressed .code section...
                 std::unique_ptr<u8[]> temp_buffer;
@@ -279,6 +386,7 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
 
                 if (exefs_file.ReadBytes(&temp_buffer[0], section.size) != section.size)
                     return Loader::ResultStatus::Error;
+                decrypt(&temp_buffer[0]);
 
                 // Decompress .code section...
                 u32 decompressed_size = LZSS_GetDecompressedSize(&temp_buffer[0], section.size);
@@ -290,6 +398,7 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 buffer.resize(section.size);
                 if (exefs_file.ReadBytes(&buffer[0], section.size) != section.size)
                     return Loader::ResultStatus::Error;
+                decrypt(&buffer[0]);
             }
             return Loader::ResultStatus::Success;
         }
@@ -330,13 +439,12 @@ Loader::ResultStatus NCCHContainer::LoadOverrideExeFSSection(const char* name,
     return Loader::ResultStatus::ErrorNotUsed;
 }
 
-Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<FileUtil::IOFile>& romfs_file,
-                                              u64& offset, u64& size) {
+Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<RomFSReader>& romfs_file) {
     Loader::ResultStatus result = Load();
     if (result != Loader::ResultStatus::Success)
         return result;
 
-    if (ReadOverrideRomFS(romfs_file, offset, size) == Loader::ResultStatus::Success)
+    if (ReadOverrideRomFS(romfs_file) == Loader::ResultStatus::Success)
         return Loader::ResultStatus::Success;
 
     if (!has_romfs) {
@@ -347,8 +455,10 @@ Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<FileUtil::IOFile>&
     if (!file.IsOpen())
         return Loader::ResultStatus::Error;
 
-    u32 romfs_offset = ncch_offset + (ncch_header.romfs_offset * kBlockSize) + 0x1000;
-    u32 romfs_size = (ncch_header.romfs_size * kBlockSize) - 0x1000;
+    // The IVFC data follows the 0x1000 byte IVFC header
+    const u32 romfs_data_offset = 0x1000;
+    u32 romfs_offset = ncch_offset + (ncch_header.romfs_offset * kBlockSize) + romfs_data_offset;
+    u32 romfs_size = (ncch_header.romfs_size * kBlockSize) - romfs_data_offset;
 
     LOG_DEBUG(Service_FS, "RomFS offset:           0x%08X", romfs_offset);
     LOG_DEBUG(Service_FS, "RomFS size:             0x%08X", romfs_size);
@@ -357,26 +467,31 @@ Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<FileUtil::IOFile>&
         return Loader::ResultStatus::Error;
 
     // We reopen the file, to allow its position to be independent from file's
-    romfs_file = std::make_shared<FileUtil::IOFile>(filepath, "rb");
-    if (!romfs_file->IsOpen())
+    FileUtil::IOFile romfs_file_inner(filepath, "rb");
+    if (!romfs_file_inner.IsOpen())
         return Loader::ResultStatus::Error;
 
-    offset = romfs_offset;
-    size = romfs_size;
+    if (is_encrypted) {
+        romfs_file = std::make_shared<RomFSReader>(std::move(romfs_file_inner), romfs_offset,
+                                                   romfs_size, secondary_key, romfs_ctr,
+                                                   romfs_data_offset);
+    } else {
+        romfs_file =
+            std::make_shared<RomFSReader>(std::move(romfs_file_inner), romfs_offset, romfs_size);
+    }
 
     return Loader::ResultStatus::Success;
 }
 
-Loader::ResultStatus NCCHContainer::ReadOverrideRomFS(std::shared_ptr<FileUtil::IOFile>& romfs_file,
-                                                      u64& offset, u64& size) {
+Loader::ResultStatus NCCHContainer::ReadOverrideRomFS(std::shared_ptr<RomFSReader>& romfs_file) {
     // Check for RomFS overrides
     std::string split_filepath = filepath + ".romfs";
     if (FileUtil::Exists(split_filepath)) {
-        romfs_file = std::make_shared<FileUtil::IOFile>(split_filepath, "rb");
-        if (romfs_file->IsOpen()) {
+        FileUtil::IOFile romfs_file_inner(split_filepath, "rb");
+        if (romfs_file_inner.IsOpen()) {
             LOG_WARNING(Service_FS, "File %s overriding built-in RomFS", split_filepath.c_str());
-            offset = 0;
-            size = romfs_file->GetSize();
+            const u64 size = romfs_file_inner.GetSize();
+            romfs_file = std::make_shared<RomFSReader>(std::move(romfs_file_inner), 0, size);
             return Loader::ResultStatus::Success;
         }
     }
@@ -13,6 +13,9 @@
 #include "common/file_util.h"
 #include "common/swap.h"
 #include "core/core.h"
+#include "core/file_sys/romfs_reader.h"
+#include "core/hw/aes/ctr.h"
+#include "core/hw/aes/key.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /// NCCH header (Note: "NCCH" appears to be a publicly unknown acronym)
@@ -162,6 +165,17 @@ static_assert(sizeof(ExHeader_Header) == 0x800, "ExHeader structure size is wron
 
 namespace FileSys {
 
+/**
+ * Decompress ExeFS file (compressed with LZSS)
+ * @param compressed Compressed buffer
+ * @param compressed_size Size of compressed buffer
+ * @param decompressed Decompressed buffer
+ * @param decompressed_size Size of decompressed buffer
+ * @return True on success, otherwise false
+ */
+bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decompressed,
+                     u32 decompressed_size);
+
 /**
  * Helper which implements an interface to deal with NCCH containers which can
  * contain ExeFS archives or RomFS archives for games or other applications.
@@ -206,24 +220,18 @@ public:
     /**
      * Get the RomFS of the NCCH container
      * Since the RomFS can be huge, we return a file reference instead of copying to a buffer
-     * @param romfs_file The file containing the RomFS
-     * @param offset The offset the romfs begins on
-     * @param size The size of the romfs
+     * @param romfs_file The reader of the RomFS, which decrypts it if needed
      * @return ResultStatus result of function
      */
-    Loader::ResultStatus ReadRomFS(std::shared_ptr<FileUtil::IOFile>& romfs_file, u64& offset,
-                                   u64& size);
+    Loader::ResultStatus ReadRomFS(std::shared_ptr<RomFSReader>& romfs_file);
 
     /**
     * Get the override RomFS of the NCCH container
     * Since the RomFS can be huge, we return a file reference instead of copying to a buffer
-    * @param romfs_file The file containing the RomFS
-    * @param offset The offset the romfs begins on
-    * @param size The size of the romfs
+    * @param romfs_file The reader of the RomFS
     * @return ResultStatus result of function
     */
-    Loader::ResultStatus ReadOverrideRomFS(std::shared_ptr<FileUtil::IOFile>& romfs_file,
-                                           u64& offset, u64& size);
+    Loader::ResultStatus ReadOverrideRomFS(std::shared_ptr<RomFSReader>& romfs_file);
 
     /**
      * Get the Program ID of the NCCH container
@@ -254,6 +262,12 @@ public:
     ExHeader_Header exheader_header;
 
 private:
+    /**
+     * Derives the keys and counters the NCCH is encrypted with.
+     * @return false if the encryption is not supported or the keys are missing
+     */
+    bool LoadCrypto();
+
     bool has_header = false;
     bool has_exheader = false;
     bool has_exefs = false;
@@ -263,6 +277,14 @@ private:
     bool is_loaded = false;
     bool is_compressed = false;
 
+    bool is_encrypted = false;
+    bool is_exefs_encrypted = false; // False when the ExeFS is overridden
+    HW::AES::AESKey primary_key{};   // For the ExHeader, and the ExeFS header, icon and banner
+    HW::AES::AESKey secondary_key{}; // For the other ExeFS sections and the RomFS
+    HW::AES::AESCounter exheader_ctr{};
+    HW::AES::AESCounter exefs_ctr{};
+    HW::AES::AESCounter romfs_ctr{};
+
     u32 ncch_offset = 0; // Offset to NCCH header, can be 0 or after NCSD header
     u32 exefs_offset = 0;
 
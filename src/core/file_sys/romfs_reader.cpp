@@ -0,0 +1,90 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include "core/file_sys/romfs_reader.h"
+
+namespace FileSys {
+
+RomFSReader::RomFSReader(FileUtil::IOFile&& file, u64 file_offset, u64 data_size)
+    : file(std::move(file)), file_offset(file_offset), data_size(data_size) {}
+
+RomFSReader::RomFSReader(FileUtil::IOFile&& file, u64 file_offset, u64 data_size,
+                         const HW::AES::AESKey& key, const HW::AES::AESCounter& ctr,
+                         u64 crypto_offset)
+    : file(std::move(file)), file_offset(file_offset), data_size(data_size),
+      cipher(std::make_unique<HW::AES::CTRCipher>(key, ctr)), crypto_offset(crypto_offset),
+      cache(std::make_unique<std::array<CachedBlock, CacheBlockCount>>()) {}
+
+RomFSReader::~RomFSReader() = default;
+
+size_t RomFSReader::ReadFile(u64 offset, size_t length, u8* buffer) {
+    if (offset >= data_size)
+        return 0;
+    length = static_cast<size_t>(std::min<u64>(length, data_size - offset));
+
+    if (!cipher)
+        return ReadRaw(offset, length, buffer);
+
+    size_t read = 0;
+    while (read < length) {
+        const u64 position = offset + read;
+        const size_t block_offset = static_cast<size_t>(position % CacheBlockSize);
+        const size_t remaining = length - read;
+
+        if (block_offset == 0 && remaining >= CacheBlockSize) {
+            // Whole blocks are read and decrypted in one go, bypassing the cache
+            const size_t size = remaining - remaining % CacheBlockSize;
+            const size_t size_read = ReadRaw(position, size, buffer + read);
+            cipher->Process(buffer + read, size_read, crypto_offset + position);
+            read += size_read;
+            if (size_read != size)
+                break;
+        } else {
+            const CachedBlock& block = GetBlock(position / CacheBlockSize);
+            if (block.size <= block_offset)
+                break;
+            const size_t size = std::min(remaining, block.size - block_offset);
+            std::memcpy(buffer + read, block.data.data() + block_offset, size);
+            read += size;
+        }
+    }
+    return read;
+}
+
+size_t RomFSReader::ReadRaw(u64 offset, size_t length, u8* buffer) {
+    if (!file.Seek(file_offset + offset, SEEK_SET))
+        return 0;
+    return file.ReadBytes(buffer, length);
+}
+
+const RomFSReader::CachedBlock& RomFSReader::GetBlock(u64 index) {
+    CachedBlock* least_recently_used = &cache->front();
+    for (CachedBlock& block : *cache) {
+        if (block.index == index) {
+            block.last_use = ++use_counter;
+            return block;
+        }
+        if (block.last_use < least_recently_used->last_use)
+            least_recently_used = &block;
+    }
+
+    CachedBlock& block = *least_recently_used;
+    const u64 position = index * CacheBlockSize;
+    const size_t size = static_cast<size_t>(std::min<u64>(CacheBlockSize, data_size - position));
+    block.size = ReadRaw(position, size, block.data.data());
+    cipher->Process(block.data.data(), block.size, crypto_offset + position);
+    if (block.size == size) {
+        block.index = index;
+        block.last_use = ++use_counter;
+    } else {
+        // Don't keep a block the file ended in the middle of, the next read tries it again
+        block.index = ~0ull;
+        block.last_use = 0;
+    }
+    return block;
+}
+
+} // namespace FileSys
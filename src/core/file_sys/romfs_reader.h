@@ -0,0 +1,94 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "core/hw/aes/ctr.h"
+#include "core/hw/aes/key.h"
+
+namespace FileSys {
+
+/**
+ * Reads the RomFS of a title from the file containing it, and decrypts it transparently if it is
+ * encrypted. Reads can start anywhere, and only the blocks of the RomFS that they touch are read
+ * and decrypted. Games read small pieces of the same areas many times, e.g. the file tables, so
+ * the most recently used blocks that reads only partially cover are kept decrypted.
+ */
+class RomFSReader {
+public:
+    /// Size of the blocks kept in the cache, in bytes
+    static constexpr size_t CacheBlockSize = 0x1000;
+    /// Number of blocks kept in the cache
+    static constexpr size_t CacheBlockCount = 32;
+
+    /**
+     * Creates a reader of an unencrypted RomFS.
+     * @param file The file containing the RomFS
+     * @param file_offset The offset the RomFS begins on
+     * @param data_size The size of the RomFS
+     */
+    RomFSReader(FileUtil::IOFile&& file, u64 file_offset, u64 data_size);
+
+    /**
+     * Creates a reader of an encrypted RomFS.
+     * @param file The file containing the RomFS
+     * @param file_offset The offset the RomFS begins on
+     * @param data_size The size of the RomFS
+     * @param key The key the RomFS is encrypted with
+     * @param ctr The counter at the start of the encrypted stream
+     * @param crypto_offset The position of the RomFS in the encrypted stream
+     */
+    RomFSReader(FileUtil::IOFile&& file, u64 file_offset, u64 data_size,
+                const HW::AES::AESKey& key, const HW::AES::AESCounter& ctr, u64 crypto_offset);
+
+    ~RomFSReader();
+
+    u64 GetSize() const {
+        return data_size;
+    }
+
+    bool IsEncrypted() const {
+        return cipher != nullptr;
+    }
+
+    /**
+     * Reads data from the RomFS.
+     * @param offset The offset in the RomFS to read from
+     * @param length The number of bytes to read
+     * @param buffer The buffer to read to
+     * @return The number of bytes read, which is less than length past the end of the RomFS
+     */
+    size_t ReadFile(u64 offset, size_t length, u8* buffer);
+
+private:
+    struct CachedBlock {
+        u64 index = ~0ull; ///< Index of the block in the RomFS, ~0 if unused
+        u64 last_use = 0;
+        size_t size = 0; ///< Less than CacheBlockSize for the last block of the RomFS
+        std::array<u8, CacheBlockSize> data;
+    };
+
+    /// Reads data from the file without decrypting it
+    size_t ReadRaw(u64 offset, size_t length, u8* buffer);
+
+    /// Returns the decrypted block with the given index, reading it if it is not cached
+    const CachedBlock& GetBlock(u64 index);
+
+    FileUtil::IOFile file;
+    u64 file_offset;
+    u64 data_size;
+
+    std::unique_ptr<HW::AES::CTRCipher> cipher;
+    u64 crypto_offset = 0;
+
+    std::unique_ptr<std::array<CachedBlock, CacheBlockCount>> cache;
+    u64 use_counter = 0;
+};
+
+} // namespace FileSys
@@ -6,13 +6,19 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bitset>
+#include <chrono>
 #include <climits>
+#include <condition_variable>
 #include <csignal>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
 #include <map>
+#include <mutex>
 #include <numeric>
+#include <thread>
+#include <vector>
 #include <fcntl.h>
 
 #ifdef _WIN32
@@ -32,6 +38,7 @@
 
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/threadsafe_queue.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
@@ -150,6 +157,26 @@ static std::map<u32, Breakpoint> breakpoints_execute;
 static std::map<u32, Breakpoint> breakpoints_read;
 static std::map<u32, Breakpoint> breakpoints_write;
 
+// One bit per page, set while at least one breakpoint of the matching type starts in that page.
+// CheckBreakpoint runs on every memory access, so this keeps the common case away from the maps.
+using BreakpointPageBitmap = std::bitset<Memory::PAGE_TABLE_NUM_ENTRIES>;
+static BreakpointPageBitmap breakpoint_pages_execute;
+static BreakpointPageBitmap breakpoint_pages_read;
+static BreakpointPageBitmap breakpoint_pages_write;
+
+// The socket is serviced by a dedicated I/O thread. Complete packets are queued for the CPU thread,
+// which only checks has_pending_packets once per RunLoop instead of polling the socket.
+static std::thread io_thread;
+static std::atomic<bool> io_thread_running(false);
+static std::atomic<bool> has_pending_packets(false);
+static std::atomic<bool> connection_lost(false);
+static Common::SPSCQueue<std::vector<u8>> pending_packets;
+static std::mutex pending_mutex;
+static std::condition_variable pending_cv;
+
+// Acks are sent from the I/O thread while replies are sent from the CPU thread.
+static std::mutex send_mutex;
+
 /**
  * Turns hex string character into the equivalent byte.
  *
@@ -255,16 +282,23 @@ static u32 GdbHexToInt(const u8* src) {
     return output;
 }
 
-/// Read a byte from the gdb client.
-static u8 ReadByte() {
-    u8 c;
-    size_t received_size = recv(gdbserver_socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL);
+/**
+ * Read a byte from the gdb client. Only called from the I/O thread.
+ *
+ * @param socket Socket of the connected client.
+ * @param c Receives the byte that was read.
+ * @return False if the connection was closed or the read failed.
+ */
+static bool ReadByte(int socket, u8& c) {
+    int received_size = static_cast<int>(recv(socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL));
     if (received_size != 1) {
-        LOG_ERROR(Debug_GDBStub, "recv failed : %ld", received_size);
-        Shutdown();
+        if (io_thread_running) {
+            LOG_ERROR(Debug_GDBStub, "recv failed : %d", received_size);
+        }
+        return false;
     }
 
-    return c;
+    return true;
 }
 
 /// Calculate the checksum of the current command buffer.
@@ -290,6 +324,48 @@ static std::map<u32, Breakpoint>& GetBreakpointList(BreakpointType type) {
     }
 }
 
+/**
+ * Get the page bitmap for a given breakpoint type.
+ *
+ * @param type Type of breakpoint bitmap.
+ */
+static BreakpointPageBitmap& GetBreakpointPages(BreakpointType type) {
+    switch (type) {
+    case BreakpointType::Execute:
+        return breakpoint_pages_execute;
+    case BreakpointType::Read:
+        return breakpoint_pages_read;
+    case BreakpointType::Write:
+        return breakpoint_pages_write;
+    default:
+        return breakpoint_pages_read;
+    }
+}
+
+/**
+ * Recompute the page bitmap bit covering the given address after a breakpoint was removed.
+ *
+ * @param type Type of breakpoint.
+ * @param addr Address within the page to update.
+ */
+static void UpdateBreakpointPage(BreakpointType type, PAddr addr) {
+    const std::map<u32, Breakpoint>& p = GetBreakpointList(type);
+    const u32 page = addr >> Memory::PAGE_BITS;
+
+    auto next = p.lower_bound(page << Memory::PAGE_BITS);
+    GetBreakpointPages(type)[page] = next != p.end() && (next->first >> Memory::PAGE_BITS) == page;
+}
+
+/**
+ * Make the CPU pick up an added or removed execute breakpoint. The JIT patches breakpoints into
+ * the code it translates, so only the blocks covering the breakpoint need to be recompiled.
+ *
+ * @param addr Address of breakpoint.
+ */
+static void InvalidateExecuteBreakpoint(PAddr addr) {
+    Core::CPU().InvalidateCacheRange(addr, 4);
+}
+
 /**
  * Remove the breakpoint from the given address of the specified type.
  *
@@ -304,6 +380,11 @@ static void RemoveBreakpoint(BreakpointType type, PAddr addr) {
         LOG_DEBUG(Debug_GDBStub, "gdb: removed a breakpoint: %08x bytes at %08x of type %d\n",
                   bp->second.len, bp->second.addr, type);
         p.erase(addr);
+        UpdateBreakpointPage(type, addr);
+
+        if (type == BreakpointType::Execute) {
+            InvalidateExecuteBreakpoint(addr);
+        }
     }
 }
 
@@ -328,6 +409,10 @@ bool CheckBreakpoint(PAddr addr, BreakpointType type) {
         return false;
     }
 
+    if (!GetBreakpointPages(type)[addr >> Memory::PAGE_BITS]) {
+        return false;
+    }
+
     std::map<u32, Breakpoint>& p = GetBreakpointList(type);
 
     auto bp = p.find(addr);
@@ -357,12 +442,18 @@ bool CheckBreakpoint(PAddr addr, BreakpointType type) {
     return false;
 }
 
+bool IsThumbBreakpoint(PAddr addr) {
+    auto bp = breakpoints_execute.find(addr);
+    return bp != breakpoints_execute.end() && bp->second.len < 4;
+}
+
 /**
  * Send packet to gdb client.
  *
  * @param packet Packet to be sent to client.
  */
 static void SendPacket(const char packet) {
+    std::lock_guard<std::mutex> lock(send_mutex);
     size_t sent_size = send(gdbserver_socket, &packet, 1, 0);
     if (sent_size != 1) {
         LOG_ERROR(Debug_GDBStub, "send failed");
@@ -395,12 +486,14 @@ static void SendReply(const char* reply) {
     command_buffer[command_length + 2] = NibbleToHex(checksum >> 4);
     command_buffer[command_length + 3] = NibbleToHex(checksum);
 
+    std::unique_lock<std::mutex> lock(send_mutex);
     u8* ptr = command_buffer;
     u32 left = command_length + 4;
     while (left > 0) {
         int sent_size = send(gdbserver_socket, reinterpret_cast<char*>(ptr), left, 0);
         if (sent_size < 0) {
             LOG_ERROR(Debug_GDBStub, "gdb: send failed");
+            lock.unlock();
             return Shutdown();
         }
 
@@ -457,74 +550,111 @@ static void SendSignal(u32 signal) {
     SendReply(buffer.c_str());
 }
 
-/// Read command from gdb client.
-static void ReadCommand() {
-    command_length = 0;
-    memset(command_buffer, 0, sizeof(command_buffer));
+/// Hand a packet received by the I/O thread over to the CPU thread.
+static void QueuePacket(std::vector<u8> packet) {
+    pending_packets.Push(std::move(packet));
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        has_pending_packets.store(true, std::memory_order_release);
+    }
+    pending_cv.notify_one();
+}
+
+/// Tell the CPU thread that the client went away so that it shuts the server down.
+static void SignalConnectionLost() {
+    connection_lost = true;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        has_pending_packets.store(true, std::memory_order_release);
+    }
+    pending_cv.notify_one();
+}
+
+/**
+ * Read a single packet from the gdb client, acknowledging it if its checksum matches. Only called
+ * from the I/O thread.
+ *
+ * @param socket Socket of the connected client.
+ * @param packet Receives the packet contents without framing. A lone 0x03 is a break request, and
+ *               an empty packet means nothing needs to be handled.
+ * @return False if the connection was closed.
+ */
+static bool ReadCommand(int socket, std::vector<u8>& packet) {
+    packet.clear();
+
+    u8 c;
+    if (!ReadByte(socket, c)) {
+        return false;
+    }
 
-    u8 c = ReadByte();
     if (c == '+') {
         // ignore ack
-        return;
+        return true;
     } else if (c == 0x03) {
         LOG_INFO(Debug_GDBStub, "gdb: found break command\n");
-        halt_loop = true;
-        SendSignal(SIGTRAP);
-        return;
+        packet.push_back(c);
+        return true;
     } else if (c != GDB_STUB_START) {
         LOG_DEBUG(Debug_GDBStub, "gdb: read invalid byte %02x\n", c);
-        return;
+        return true;
     }
 
-    while ((c = ReadByte()) != GDB_STUB_END) {
-        if (command_length >= sizeof(command_buffer)) {
+    while (true) {
+        if (!ReadByte(socket, c)) {
+            return false;
+        }
+        if (c == GDB_STUB_END) {
+            break;
+        }
+        if (packet.size() >= GDB_BUFFER_SIZE - 1) {
             LOG_ERROR(Debug_GDBStub, "gdb: command_buffer overflow\n");
+            packet.clear();
             SendPacket(GDB_STUB_NACK);
-            return;
+            return true;
         }
-        command_buffer[command_length++] = c;
+        packet.push_back(c);
     }
 
-    u8 checksum_received = HexCharToValue(ReadByte()) << 4;
-    checksum_received |= HexCharToValue(ReadByte());
+    u8 checksum_high, checksum_low;
+    if (!ReadByte(socket, checksum_high) || !ReadByte(socket, checksum_low)) {
+        return false;
+    }
 
-    u8 checksum_calculated = CalculateChecksum(command_buffer, command_length);
+    u8 checksum_received = (HexCharToValue(checksum_high) << 4) | HexCharToValue(checksum_low);
+    u8 checksum_calculated = CalculateChecksum(packet.data(), packet.size());
 
     if (checksum_received != checksum_calculated) {
+        packet.push_back(0);
         LOG_ERROR(Debug_GDBStub,
-                  "gdb: invalid checksum: calculated %02x and read %02x for $%s# (length: %d)\n",
-                  checksum_calculated, checksum_received, command_buffer, command_length);
+                  "gdb: invalid checksum: calculated %02x and read %02x for $%s# (length: %zu)\n",
+                  checksum_calculated, checksum_received, packet.data(), packet.size() - 1);
 
-        command_length = 0;
+        packet.clear();
 
         SendPacket(GDB_STUB_NACK);
-        return;
+        return true;
     }
 
     SendPacket(GDB_STUB_ACK);
+    return true;
 }
 
-/// Check if there is data to be read from the gdb client.
-static bool IsDataAvailable() {
-    if (!IsConnected()) {
-        return false;
-    }
-
-    fd_set fd_socket;
-
-    FD_ZERO(&fd_socket);
-    FD_SET(gdbserver_socket, &fd_socket);
-
-    struct timeval t;
-    t.tv_sec = 0;
-    t.tv_usec = 0;
+/// Body of the I/O thread: blocks on the socket and queues every complete packet.
+static void IOThreadLoop(int socket) {
+    std::vector<u8> packet;
+    while (io_thread_running) {
+        if (!ReadCommand(socket, packet)) {
+            if (io_thread_running) {
+                SignalConnectionLost();
+            }
+            return;
+        }
 
-    if (select(gdbserver_socket + 1, &fd_socket, nullptr, nullptr, &t) < 0) {
-        LOG_ERROR(Debug_GDBStub, "select failed");
-        return false;
+        if (!packet.empty()) {
+            QueuePacket(std::move(packet));
+            packet = std::vector<u8>();
+        }
     }
-
-    return FD_ISSET(gdbserver_socket, &fd_socket) != 0;
 }
 
 /// Send requested register to gdb client.
@@ -733,6 +863,11 @@ static bool CommitBreakpoint(BreakpointType type, PAddr addr, u32 len) {
     breakpoint.addr = addr;
     breakpoint.len = len;
     p.insert({addr, breakpoint});
+    GetBreakpointPages(type).set(addr >> Memory::PAGE_BITS);
+
+    if (type == BreakpointType::Execute) {
+        InvalidateExecuteBreakpoint(addr);
+    }
 
     LOG_DEBUG(Debug_GDBStub, "gdb: added %d breakpoint: %08x bytes at %08x\n", type, breakpoint.len,
               breakpoint.addr);
@@ -829,18 +964,35 @@ static void RemoveBreakpoint() {
 }
 
 void HandlePacket() {
-    if (!IsConnected()) {
+    if (!has_pending_packets.load(std::memory_order_acquire)) {
         return;
     }
+    has_pending_packets = false;
 
-    if (!IsDataAvailable()) {
+    if (connection_lost) {
+        LOG_INFO(Debug_GDBStub, "gdb: client disconnected");
+        Shutdown();
         return;
     }
 
-    ReadCommand();
-    if (command_length == 0) {
+    // Handle one packet per call so that step and continue take effect before the next one.
+    std::vector<u8> packet;
+    if (!pending_packets.Pop(packet)) {
         return;
     }
+    if (!pending_packets.Empty()) {
+        has_pending_packets = true;
+    }
+
+    if (packet.size() == 1 && packet[0] == 0x03) {
+        halt_loop = true;
+        SendSignal(SIGTRAP);
+        return;
+    }
+
+    memset(command_buffer, 0, sizeof(command_buffer));
+    std::copy(packet.begin(), packet.end(), command_buffer);
+    command_length = static_cast<u32>(packet.size());
 
     LOG_DEBUG(Debug_GDBStub, "Packet: %s", command_buffer);
 
@@ -895,6 +1047,11 @@ void HandlePacket() {
     }
 }
 
+void WaitForPacket(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(pending_mutex);
+    pending_cv.wait_for(lock, timeout, [] { return has_pending_packets.load(); });
+}
+
 void SetServerPort(u16 port) {
     gdbstub_port = port;
 }
@@ -933,6 +1090,9 @@ static void Init(u16 port) {
     breakpoints_execute.clear();
     breakpoints_read.clear();
     breakpoints_write.clear();
+    breakpoint_pages_execute.reset();
+    breakpoint_pages_read.reset();
+    breakpoint_pages_write.reset();
 
     // Start gdb server
     LOG_INFO(Debug_GDBStub, "Starting GDB server on port %d...", port);
@@ -984,6 +1144,10 @@ static void Init(u16 port) {
     } else {
         LOG_INFO(Debug_GDBStub, "Client connected.\n");
         saddr_client.sin_addr.s_addr = ntohl(saddr_client.sin_addr.s_addr);
+
+        connection_lost = false;
+        io_thread_running = true;
+        io_thread = std::thread(IOThreadLoop, gdbserver_socket);
     }
 
     // Clean up temporary socket if it's still alive at this point.
@@ -1002,11 +1166,26 @@ void Shutdown() {
     }
 
     LOG_INFO(Debug_GDBStub, "Stopping GDB ...");
+    io_thread_running = false;
     if (gdbserver_socket != -1) {
+        // Shutting the socket down wakes the I/O thread from its blocking recv.
         shutdown(gdbserver_socket, SHUT_RDWR);
+        if (io_thread.joinable()) {
+            io_thread.join();
+        }
         gdbserver_socket = -1;
     }
 
+    std::vector<u8> packet;
+    while (pending_packets.Pop(packet)) {
+    }
+    has_pending_packets = false;
+    connection_lost = false;
+
+    // Without a client there is nobody left to resume a halted CPU.
+    halt_loop = false;
+    step_loop = false;
+
 #ifdef _WIN32
     WSACleanup();
 #endif
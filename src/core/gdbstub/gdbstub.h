@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <chrono>
 #include "common/common_types.h"
 
 namespace GDBStub {
@@ -60,9 +61,20 @@ void Break(bool is_memory_break = false);
 /// Determine if there was a memory breakpoint.
 bool IsMemoryBreak();
 
-/// Read and handle packet from gdb client.
+/**
+ * Handle the next packet received from the gdb client, if any. Packets are read on a separate I/O
+ * thread, so this only checks an atomic flag when nothing has arrived.
+ */
 void HandlePacket();
 
+/**
+ * Block until a packet from the gdb client is ready to be handled or the timeout expires. Used to
+ * avoid spinning while the CPU is halted.
+ *
+ * @param timeout Maximum time to wait.
+ */
+void WaitForPacket(std::chrono::milliseconds timeout);
+
 /**
  * Get the nearest breakpoint of the specified type at the given address.
  *
@@ -79,6 +91,14 @@ BreakpointAddress GetNextBreakpointFromAddress(u32 addr, GDBStub::BreakpointType
  */
 bool CheckBreakpoint(u32 addr, GDBStub::BreakpointType type);
 
+/**
+ * Check if the execute breakpoint at the given address was set on a Thumb instruction. gdb sends
+ * the size of the instruction it replaces as the breakpoint kind: 2 or 3 for Thumb, 4 for ARM.
+ *
+ * @param addr Address of breakpoint.
+ */
+bool IsThumbBreakpoint(u32 addr);
+
 // If set to true, the CPU will halt at the beginning of the next CPU loop.
 bool GetCpuHaltFlag();
 
@@ -318,6 +318,14 @@ public:
     VAddr PopMappedBuffer(size_t* data_size = nullptr,
                           MappedBufferPermissions* buffer_perms = nullptr);
 
+    /**
+     * @brief Pops a mapped or static buffer descriptor
+     * @return The buffer resolved by the kernel when the request was received, which gives direct
+     * access to the memory of the requesting process
+     * @note Only available for requests received through a HLERequestContext.
+     */
+    Kernel::MappedBuffer& PopBuffer();
+
     /**
      * @brief Reads the next normal parameters as a struct, by copying it
      * @note: The output class must be correctly packed/padded to fit hardware layout.
@@ -479,4 +487,13 @@ inline VAddr RequestParser::PopMappedBuffer(size_t* data_size,
     return Pop<VAddr>();
 }
 
+inline Kernel::MappedBuffer& RequestParser::PopBuffer() {
+    ASSERT_MSG(context != nullptr, "Buffers are only translated for HLERequestContext requests");
+    // The descriptor has already been validated when the request was translated
+    Pop<u32>();
+    const size_t address_index = static_cast<size_t>(index);
+    Pop<VAddr>();
+    return context->GetMappedBuffer(address_index);
+}
+
 } // namespace IPC
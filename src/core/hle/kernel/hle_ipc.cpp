@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include <boost/range/algorithm_ext/erase.hpp>
 #include "common/assert.h"
 #include "common/common_types.h"
@@ -10,6 +12,7 @@
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/memory.h"
 
 namespace Kernel {
 
@@ -23,6 +26,65 @@ void SessionRequestHandler::ClientDisconnected(SharedPtr<ServerSession> server_s
     boost::range::remove_erase(connected_sessions, server_session);
 }
 
+MappedBuffer::MappedBuffer(const Process& process, VAddr address, u32 size,
+                           IPC::MappedBufferPermissions perms)
+    : process(&process), address(address), size(size), perms(perms) {
+    // Cached GPU surfaces in the buffer have to be invalidated if the service may write to it
+    const auto flush_mode = (perms & IPC::MappedBufferPermissions::W)
+                                ? Memory::FlushMode::FlushAndInvalidate
+                                : Memory::FlushMode::Flush;
+    spans = Memory::GetHostSpans(process, address, size, flush_mode);
+}
+
+void MappedBuffer::Read(void* dest_buffer, size_t offset, size_t size) const {
+    ASSERT(offset + size <= this->size);
+
+    if (spans.empty()) {
+        Memory::ReadBlock(*process, address + static_cast<VAddr>(offset), dest_buffer, size);
+        return;
+    }
+
+    u8* dest = static_cast<u8*>(dest_buffer);
+    for (const auto& span : spans) {
+        if (size == 0)
+            break;
+        if (offset >= span.size) {
+            offset -= span.size;
+            continue;
+        }
+        const size_t copy_size = std::min(span.size - offset, size);
+        std::memcpy(dest, span.pointer + offset, copy_size);
+        dest += copy_size;
+        size -= copy_size;
+        offset = 0;
+    }
+}
+
+void MappedBuffer::Write(const void* src_buffer, size_t offset, size_t size) {
+    ASSERT(offset + size <= this->size);
+    ASSERT_MSG(perms & IPC::MappedBufferPermissions::W, "Writing to a read-only buffer");
+
+    if (spans.empty()) {
+        Memory::WriteBlock(*process, address + static_cast<VAddr>(offset), src_buffer, size);
+        return;
+    }
+
+    const u8* src = static_cast<const u8*>(src_buffer);
+    for (const auto& span : spans) {
+        if (size == 0)
+            break;
+        if (offset >= span.size) {
+            offset -= span.size;
+            continue;
+        }
+        const size_t copy_size = std::min(span.size - offset, size);
+        std::memcpy(span.pointer + offset, src, copy_size);
+        src += copy_size;
+        size -= copy_size;
+        offset = 0;
+    }
+}
+
 HLERequestContext::HLERequestContext(SharedPtr<ServerSession> session)
     : session(std::move(session)) {
     cmd_buf[0] = 0;
@@ -44,6 +106,14 @@ void HLERequestContext::ClearIncomingObjects() {
     request_handles.clear();
 }
 
+MappedBuffer& HLERequestContext::GetMappedBuffer(size_t cmdbuf_index) {
+    auto itr =
+        std::find_if(request_buffers.begin(), request_buffers.end(),
+                     [cmdbuf_index](const auto& entry) { return entry.first == cmdbuf_index; });
+    ASSERT_MSG(itr != request_buffers.end(), "No buffer descriptor at index %zu", cmdbuf_index);
+    return itr->second;
+}
+
 ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* src_cmdbuf,
                                                                 Process& src_process,
                                                                 HandleTable& src_table) {
@@ -84,6 +154,26 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
             cmd_buf[i++] = src_process.process_id;
             break;
         }
+        case IPC::DescriptorType::StaticBuffer: {
+            // The buffer is read in place instead of being copied to the static buffer area of
+            // the receiving thread, so the address is kept as is.
+            ASSERT(i < command_size); // TODO(yuriks): Return error
+            VAddr address = cmd_buf[i] = src_cmdbuf[i];
+            u32 size = IPC::StaticBufferDescInfo{descriptor}.size;
+            request_buffers.emplace_back(
+                i, MappedBuffer(src_process, address, size, IPC::MappedBufferPermissions::R));
+            i += 1;
+            break;
+        }
+        case IPC::DescriptorType::MappedBuffer: {
+            ASSERT(i < command_size); // TODO(yuriks): Return error
+            VAddr address = cmd_buf[i] = src_cmdbuf[i];
+            IPC::MappedBufferDescInfo info{descriptor};
+            request_buffers.emplace_back(i, MappedBuffer(src_process, address, info.size,
+                                                         info.perms.Value()));
+            i += 1;
+            break;
+        }
         default:
             UNIMPLEMENTED_MSG("Unsupported handle translation: 0x%08X", descriptor);
         }
@@ -124,6 +214,14 @@ ResultCode HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf, P
             }
             break;
         }
+        case IPC::DescriptorType::StaticBuffer:
+        case IPC::DescriptorType::MappedBuffer: {
+            // Buffers are accessed in place, so only their address needs to be passed back
+            ASSERT(i < command_size);
+            dst_cmdbuf[i] = cmd_buf[i];
+            i += 1;
+            break;
+        }
         default:
             UNIMPLEMENTED_MSG("Unsupported handle translation: 0x%08X", descriptor);
         }
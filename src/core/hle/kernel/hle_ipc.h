@@ -6,6 +6,7 @@
 
 #include <array>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <boost/container/small_vector.hpp>
 #include "common/common_types.h"
@@ -13,6 +14,7 @@
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/memory.h"
 
 namespace Service {
 class ServiceFrameworkBase;
@@ -63,6 +65,52 @@ protected:
     std::vector<SharedPtr<ServerSession>> connected_sessions;
 };
 
+/**
+ * A buffer of the requesting process passed to a HLE service through a mapped or static buffer
+ * descriptor. The buffer is resolved to the host memory backing it when the request is received,
+ * so services can access guest memory in place instead of copying it with Memory::ReadBlock and
+ * Memory::WriteBlock.
+ */
+class MappedBuffer {
+public:
+    MappedBuffer(const Process& process, VAddr address, u32 size,
+                 IPC::MappedBufferPermissions perms);
+
+    VAddr GetAddress() const {
+        return address;
+    }
+
+    u32 GetSize() const {
+        return size;
+    }
+
+    IPC::MappedBufferPermissions GetPermissions() const {
+        return perms;
+    }
+
+    /**
+     * Returns the host memory backing the buffer, split where it is not contiguous in host memory.
+     * The list is empty if part of the buffer is not backed by host memory (e.g. MMIO), in which
+     * case the buffer can still be accessed with Read and Write.
+     */
+    const std::vector<Memory::HostSpan>& GetHostSpans() const {
+        return spans;
+    }
+
+    /// Copies `size` bytes starting at `offset` in the buffer to `dest_buffer`.
+    void Read(void* dest_buffer, size_t offset, size_t size) const;
+
+    /// Copies `size` bytes from `src_buffer` to `offset` in the buffer.
+    void Write(const void* src_buffer, size_t offset, size_t size);
+
+private:
+    const Process* process;
+    VAddr address;
+    u32 size;
+    IPC::MappedBufferPermissions perms;
+    std::vector<Memory::HostSpan> spans;
+};
+
 /**
  * Class containing information about an in-flight IPC request being handled by an HLE service
  * implementation. Services should avoid using old global APIs (e.g. Kernel::GetCommandBuffer()) and
@@ -119,6 +167,13 @@ public:
      */
     void ClearIncomingObjects();
 
+    /**
+     * Returns the buffer described by a mapped or static buffer descriptor of the request.
+     * @param cmdbuf_index Index in the command buffer of the buffer address following the
+     *                     descriptor.
+     */
+    MappedBuffer& GetMappedBuffer(size_t cmdbuf_index);
+
     /// Populates this context with data from the requesting process/thread.
     ResultCode PopulateFromIncomingCommandBuffer(const u32_le* src_cmdbuf, Process& src_process,
                                                  HandleTable& src_table);
@@ -131,6 +186,8 @@ private:
     SharedPtr<ServerSession> session;
     // TODO(yuriks): Check common usage of this and optimize size accordingly
     boost::container::small_vector<SharedPtr<Object>, 8> request_handles;
+    /// Buffers of the request, along with the command buffer index of their address
+    boost::container::small_vector<std::pair<size_t, MappedBuffer>, 4> request_buffers;
 };
 
 } // namespace Kernel
@@ -46,6 +46,8 @@ void MemoryInit(u32 mem_type) {
     ASSERT_MSG(mem_type <= 5, "New 3DS memory configuration aren't supported yet!");
     ASSERT(mem_type != 1);
 
+    Memory::InitPhysicalMemory();
+
     // The kernel allocation regions (APPLICATION, SYSTEM and BASE) are laid out in sequence, with
     // the sizes specified in the memory_region_sizes table.
     VAddr base = 0;
@@ -53,10 +55,10 @@ void MemoryInit(u32 mem_type) {
         memory_regions[i].base = base;
         memory_regions[i].size = memory_region_sizes[mem_type][i];
         memory_regions[i].used = 0;
-        memory_regions[i].linear_heap_memory = std::make_shared<std::vector<u8>>();
-        // Reserve enough space for this region of FCRAM.
-        // We do not want this block of memory to be relocated when allocating from it.
-        memory_regions[i].linear_heap_memory->reserve(memory_regions[i].size);
+        memory_regions[i].memory = Memory::GetFCRAMPointer(base);
+        memory_regions[i].linear_heap_size = 0;
+        Memory::MapPhysicalRegion(Memory::FCRAM_PADDR + base, memory_regions[i].size,
+                                  memory_regions[i].memory);
 
         base += memory_regions[i].size;
     }
@@ -78,8 +80,10 @@ void MemoryShutdown() {
         region.base = 0;
         region.size = 0;
         region.used = 0;
-        region.linear_heap_memory = nullptr;
+        region.memory = nullptr;
+        region.linear_heap_size = 0;
     }
+    Memory::ShutdownPhysicalMemory();
 }
 
 MemoryRegionInfo* GetMemoryRegion(MemoryRegion region) {
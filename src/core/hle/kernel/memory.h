@@ -17,7 +17,10 @@ struct MemoryRegionInfo {
     u32 size;
     u32 used;
 
-    std::shared_ptr<std::vector<u8>> linear_heap_memory;
+    /// Host memory backing the region, a view into FCRAM
+    u8* memory;
+    /// Bytes of the region used by the linear heap, which only grows and shrinks at its end
+    u32 linear_heap_size;
 };
 
 void MemoryInit(u32 mem_type);
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include <memory>
 #include "common/assert.h"
 #include "common/common_funcs.h"
@@ -220,9 +221,7 @@ ResultCode Process::HeapFree(VAddr target, u32 size) {
 }
 
 ResultVal<VAddr> Process::LinearAllocate(VAddr target, u32 size, VMAPermission perms) {
-    auto& linheap_memory = memory_region->linear_heap_memory;
-
-    VAddr heap_end = GetLinearHeapBase() + (u32)linheap_memory->size();
+    VAddr heap_end = GetLinearHeapBase() + memory_region->linear_heap_size;
     // Games and homebrew only ever seem to pass 0 here (which lets the kernel decide the address),
     // but explicit addresses are also accepted and respected.
     if (target == 0) {
@@ -239,15 +238,15 @@ ResultVal<VAddr> Process::LinearAllocate(VAddr target, u32 size, VMAPermission p
     // end. It's possible to free gaps in the middle of the heap and then reallocate them later,
     // but expansions are only allowed at the end.
     if (target == heap_end) {
-        linheap_memory->insert(linheap_memory->end(), size, 0);
-        vm_manager.RefreshMemoryBlockMappings(linheap_memory.get());
+        std::memset(memory_region->memory + memory_region->linear_heap_size, 0, size);
+        memory_region->linear_heap_size += size;
     }
 
     // TODO(yuriks): As is, this lets processes map memory allocated by other processes from the
     // same region. It is unknown if or how the 3DS kernel checks against this.
     size_t offset = target - GetLinearHeapBase();
-    CASCADE_RESULT(auto vma, vm_manager.MapMemoryBlock(target, linheap_memory, offset, size,
-                                                       MemoryState::Continuous));
+    CASCADE_RESULT(auto vma, vm_manager.MapBackingMemory(target, memory_region->memory + offset,
+                                                         size, MemoryState::Continuous));
     vm_manager.Reprotect(vma, perms);
 
     linear_heap_used += size;
@@ -257,8 +256,6 @@ ResultVal<VAddr> Process::LinearAllocate(VAddr target, u32 size, VMAPermission p
 }
 
 ResultCode Process::LinearFree(VAddr target, u32 size) {
-    auto& linheap_memory = memory_region->linear_heap_memory;
-
     if (target < GetLinearHeapBase() || target + size > GetLinearHeapLimit() ||
         target + size < target) {
 
@@ -269,7 +266,7 @@ ResultCode Process::LinearFree(VAddr target, u32 size) {
         return RESULT_SUCCESS;
     }
 
-    VAddr heap_end = GetLinearHeapBase() + (u32)linheap_memory->size();
+    VAddr heap_end = GetLinearHeapBase() + memory_region->linear_heap_size;
     if (target + size > heap_end) {
         return ERR_INVALID_ADDRESS_STATE;
     }
@@ -289,7 +286,7 @@ ResultCode Process::LinearFree(VAddr target, u32 size) {
         ASSERT(vma->second.type == VMAType::Free);
         VAddr new_end = vma->second.base;
         if (new_end >= GetLinearHeapBase()) {
-            linheap_memory->resize(new_end - GetLinearHeapBase());
+            memory_region->linear_heap_size = new_end - GetLinearHeapBase();
         }
     }
 
@@ -30,44 +30,41 @@ SharedPtr<SharedMemory> SharedMemory::Create(SharedPtr<Process> owner_process, u
         // We need to allocate a block from the Linear Heap ourselves.
         // We'll manually allocate some memory from the linear heap in the specified region.
         MemoryRegionInfo* memory_region = GetMemoryRegion(region);
-        auto& linheap_memory = memory_region->linear_heap_memory;
 
-        ASSERT_MSG(linheap_memory->size() + size <= memory_region->size,
+        ASSERT_MSG(memory_region->linear_heap_size + size <= memory_region->size,
                    "Not enough space in region to allocate shared memory!");
 
-        shared_memory->backing_block = linheap_memory;
-        shared_memory->backing_block_offset = linheap_memory->size();
+        shared_memory->backing_memory = memory_region->memory + memory_region->linear_heap_size;
+        shared_memory->linear_heap_phys_address =
+            Memory::FCRAM_PADDR + memory_region->base + memory_region->linear_heap_size;
         // Allocate some memory from the end of the linear heap for this region.
-        linheap_memory->insert(linheap_memory->end(), size, 0);
+        std::memset(shared_memory->backing_memory, 0, size);
+        memory_region->linear_heap_size += size;
         memory_region->used += size;
 
-        shared_memory->linear_heap_phys_address =
-            Memory::FCRAM_PADDR + memory_region->base +
-            static_cast<PAddr>(shared_memory->backing_block_offset);
-
         // Increase the amount of used linear heap memory for the owner process.
         if (shared_memory->owner_process != nullptr) {
             shared_memory->owner_process->linear_heap_used += size;
         }
-
-        // Refresh the address mappings for the current process.
-        if (Kernel::g_current_process != nullptr) {
-            Kernel::g_current_process->vm_manager.RefreshMemoryBlockMappings(linheap_memory.get());
-        }
     } else {
         auto& vm_manager = shared_memory->owner_process->vm_manager;
         // The memory is already available and mapped in the owner process.
         auto vma = vm_manager.FindVMA(address);
         ASSERT_MSG(vma != vm_manager.vma_map.end(), "Invalid memory address");
-        ASSERT_MSG(vma->second.backing_block, "Backing block doesn't exist for address");
+        ASSERT_MSG(vma->second.backing_block || vma->second.backing_memory,
+                   "Backing memory doesn't exist for address");
 
         // The returned VMA might be a bigger one encompassing the desired address.
         auto vma_offset = address - vma->first;
         ASSERT_MSG(vma_offset + size <= vma->second.size,
                    "Shared memory exceeds bounds of mapped block");
 
-        shared_memory->backing_block = vma->second.backing_block;
-        shared_memory->backing_block_offset = vma->second.offset + vma_offset;
+        if (vma->second.backing_block) {
+            shared_memory->backing_block = vma->second.backing_block;
+            shared_memory->backing_block_offset = vma->second.offset + vma_offset;
+        } else {
+            shared_memory->backing_memory = vma->second.backing_memory + vma_offset;
+        }
     }
 
     shared_memory->base_address = address;
@@ -151,8 +148,12 @@ ResultCode SharedMemory::Map(Process* target_process, VAddr address, MemoryPermi
     }
 
     // Map the memory block into the target process
-    auto result = target_process->vm_manager.MapMemoryBlock(
-        target_address, backing_block, backing_block_offset, size, MemoryState::Shared);
+    auto& vm_manager = target_process->vm_manager;
+    auto result = backing_block ? vm_manager.MapMemoryBlock(target_address, backing_block,
+                                                            backing_block_offset, size,
+                                                            MemoryState::Shared)
+                                : vm_manager.MapBackingMemory(target_address, backing_memory,
+                                                              size, MemoryState::Shared);
     if (result.Failed()) {
         LOG_ERROR(
             Kernel,
@@ -178,7 +179,9 @@ VMAPermission SharedMemory::ConvertPermissions(MemoryPermission permission) {
 };
 
 u8* SharedMemory::GetPointer(u32 offset) {
-    return backing_block->data() + backing_block_offset + offset;
+    if (backing_block)
+        return backing_block->data() + backing_block_offset + offset;
+    return backing_memory + offset;
 }
 
 } // namespace Kernel
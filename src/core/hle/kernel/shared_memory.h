@@ -111,10 +111,12 @@ public:
     /// Physical address of the shared memory block in the linear heap if no address was specified
     /// during creation.
     PAddr linear_heap_phys_address;
-    /// Backing memory for this shared memory block.
+    /// Backing memory for this shared memory block, if it is a ref-counted block.
     std::shared_ptr<std::vector<u8>> backing_block;
     /// Offset into the backing block for this shared memory.
     size_t backing_block_offset;
+    /// Backing memory for this shared memory block otherwise, like the linear heap in FCRAM.
+    u8* backing_memory = nullptr;
     /// Size of the memory block. Page-aligned.
     u32 size;
     /// Permission restrictions applied to the process which created the block.
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <list>
 #include <vector>
 #include "common/assert.h"
@@ -10,6 +11,7 @@
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/thread_queue_list.h"
+#include "common/trace_recorder.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/core.h"
@@ -423,18 +425,17 @@ ResultVal<SharedPtr<Thread>> Thread::Create(std::string name, VAddr entry_point,
         // There are no already-allocated pages with free slots, lets allocate a new one.
         // TLS pages are allocated from the BASE region in the linear heap.
         MemoryRegionInfo* memory_region = GetMemoryRegion(MemoryRegion::BASE);
-        auto& linheap_memory = memory_region->linear_heap_memory;
-
-        if (linheap_memory->size() + Memory::PAGE_SIZE > memory_region->size) {
+        if (memory_region->linear_heap_size + Memory::PAGE_SIZE > memory_region->size) {
             LOG_ERROR(Kernel_SVC,
                       "Not enough space in region to allocate a new TLS page for thread");
             return ERR_OUT_OF_MEMORY;
         }
 
-        size_t offset = linheap_memory->size();
+        u8* page = memory_region->memory + memory_region->linear_heap_size;
 
         // Allocate some memory from the end of the linear heap for this region.
-        linheap_memory->insert(linheap_memory->end(), Memory::PAGE_SIZE, 0);
+        std::memset(page, 0, Memory::PAGE_SIZE);
+        memory_region->linear_heap_size += Memory::PAGE_SIZE;
         memory_region->used += Memory::PAGE_SIZE;
         owner_process->linear_heap_used += Memory::PAGE_SIZE;
 
@@ -442,13 +443,11 @@ ResultVal<SharedPtr<Thread>> Thread::Create(std::string name, VAddr entry_point,
         available_page = static_cast<u32>(tls_slots.size() - 1);
         available_slot = 0; // Use the first slot in the new page
 
-        auto& vm_manager = owner_process->vm_manager;
-        vm_manager.RefreshMemoryBlockMappings(linheap_memory.get());
-
         // Map the page to the current process' address space.
         // TODO(Subv): Find the correct MemoryState for this region.
-        vm_manager.MapMemoryBlock(Memory::TLS_AREA_VADDR + available_page * Memory::PAGE_SIZE,
-                                  linheap_memory, offset, Memory::PAGE_SIZE, MemoryState::Private);
+        owner_process->vm_manager.MapBackingMemory(
+            Memory::TLS_AREA_VADDR + available_page * Memory::PAGE_SIZE, page, Memory::PAGE_SIZE,
+            MemoryState::Private);
     }
 
     // Mark the slot as used
@@ -526,6 +525,11 @@ void Reschedule() {
         LOG_TRACE(Kernel, "context switch idle -> %u", next->GetObjectId());
     }
 
+    if (cur != next && Common::TraceRecorder::IsRecording()) {
+        Common::TraceRecorder::EmulatedInstant("Context switch", "Kernel",
+                                               next ? next->GetObjectId() : 0);
+    }
+
     SwitchContext(next);
 }
 
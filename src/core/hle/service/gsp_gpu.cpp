@@ -4,7 +4,9 @@
 
 #include "common/bit_field.h"
 #include "common/microprofile.h"
+#include "common/trace_recorder.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/handle_table.h"
@@ -12,11 +14,17 @@
 #include "core/hle/result.h"
 #include "core/hle/service/gsp_gpu.h"
 #include "core/hw/gpu.h"
+#include "core/hw/gpu_thread.h"
 #include "core/hw/hw.h"
 #include "core/hw/lcd.h"
 #include "core/memory.h"
+#include "core/movie.h"
+#include "core/settings.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/gpu_debugger.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+#include "video_core/video_core.h"
 
 // Main graphics debugger object - TODO: Here is probably not the best place for this
 GraphicsDebugger g_debugger;
@@ -57,6 +65,8 @@ u32 g_thread_id = 0;
 
 static bool gpu_right_acquired = false;
 static bool first_initialization = true;
+/// CoreTiming event used to deliver interrupts raised on the GPU thread to the CPU thread
+static int interrupt_event_type;
 /// Gets a pointer to a thread command buffer in GSP shared memory
 static inline u8* GetCommandBuffer(u32 thread_id) {
     return g_shared_memory->GetPointer(0x800 + (thread_id * sizeof(CommandBuffer)));
@@ -420,6 +430,16 @@ static void UnregisterInterruptRelayQueue(Interface* self) {
  * @todo This probably does not belong in the GSP module, instead move to video_core
  */
 void SignalInterrupt(InterruptId interrupt_id) {
+    if (GPU::IsGPUThread()) {
+        // Kernel objects and GSP shared memory may only be touched from the CPU thread
+        CoreTiming::ScheduleEvent_Threadsafe(0, interrupt_event_type,
+                                             static_cast<u64>(interrupt_id));
+        return;
+    }
+    if (Common::TraceRecorder::IsRecording()) {
+        Common::TraceRecorder::EmulatedInstant("GSP interrupt", "GSP",
+                                               static_cast<u64>(interrupt_id));
+    }
     if (!gpu_right_acquired) {
         return;
     }
@@ -618,8 +638,22 @@ static void SetLcdForceBlack(Interface* self) {
     cmd_buff[1] = RESULT_SUCCESS.raw;
 }
 
+/// Returns whether GX commands should be executed on the GPU thread
+static bool UseGPUThread() {
+    // The hardware rasterizer needs the graphics context, which is owned by the CPU thread.
+    // Interrupt timing on the GPU thread isn't deterministic, so movies always run synchronously.
+    return Settings::values.use_async_gpu &&
+           !VideoCore::g_renderer->Rasterizer()->RequiresGraphicsContext() &&
+           !Movie::IsPlayingInput() && !Movie::IsRecordingInput();
+}
+
 /// This triggers handling of the GX command written to the command buffer in shared memory.
 static void TriggerCmdReqQueue(Interface* self) {
+    const bool use_gpu_thread = UseGPUThread();
+    if (!use_gpu_thread) {
+        GPU::ShutdownThread();
+    }
+
     // Iterate through each thread's command queue...
     for (unsigned thread_id = 0; thread_id < 0x4; ++thread_id) {
         CommandBuffer* command_buffer = (CommandBuffer*)GetCommandBuffer(thread_id);
@@ -629,7 +663,12 @@ static void TriggerCmdReqQueue(Interface* self) {
             g_debugger.GXCommandProcessed((u8*)&command_buffer->commands[i]);
 
             // Decode and execute command
-            ExecuteCommand(command_buffer->commands[i], thread_id);
+            if (use_gpu_thread) {
+                const Command command = command_buffer->commands[i];
+                GPU::PushThreadWork([command, thread_id] { ExecuteCommand(command, thread_id); });
+            } else {
+                ExecuteCommand(command_buffer->commands[i], thread_id);
+            }
 
             // Indicates that command has completed
             command_buffer->number_commands.Assign(command_buffer->number_commands - 1);
@@ -791,6 +830,11 @@ GSP_GPU::GSP_GPU() {
     g_thread_id = 0;
     gpu_right_acquired = false;
     first_initialization = true;
+
+    interrupt_event_type =
+        CoreTiming::RegisterEvent("GSP_GPU::InterruptEvent", [](u64 userdata, int cycles_late) {
+            SignalInterrupt(static_cast<InterruptId>(userdata));
+        });
 }
 
 GSP_GPU::~GSP_GPU() {
@@ -0,0 +1,161 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/core_timing.h"
+#include "core/hle/service/ipc_profiler.h"
+
+namespace Service {
+namespace IPCProfiler {
+
+static std::mutex stats_mutex;
+/// Statistics keyed by service object and command header
+static std::map<std::pair<const void*, u32>, CallStats> stats_map;
+
+static size_t GetHistogramBucket(u64 ns) {
+    size_t bucket = 0;
+    while (ns > 1 && bucket < NUM_HISTOGRAM_BUCKETS - 1) {
+        ns >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+ScopedCall::ScopedCall(const void* service, const std::string& service_name,
+                       const char* function_name, u32 command_header)
+    : service(service), service_name(service_name), function_name(function_name),
+      command_header(command_header), start_time(Clock::now()),
+      start_ticks(CoreTiming::GetTicks()) {}
+
+ScopedCall::~ScopedCall() {
+    const u64 host_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                              start_time)
+                            .count();
+    RecordCall(service, service_name, function_name, command_header, host_ns,
+               CoreTiming::GetTicks() - start_ticks);
+}
+
+void RecordCall(const void* service, const std::string& service_name, const char* function_name,
+                u32 command_header, u64 host_ns, u64 cycles) {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    auto itr = stats_map.find({service, command_header});
+    if (itr == stats_map.end()) {
+        CallStats new_stats;
+        new_stats.service_name = service_name;
+        new_stats.function_name = function_name;
+        new_stats.command_header = command_header;
+        itr = stats_map.emplace(std::make_pair(service, command_header), std::move(new_stats))
+                  .first;
+    }
+
+    CallStats& stats = itr->second;
+    ++stats.num_calls;
+    stats.total_host_ns += host_ns;
+    stats.max_host_ns = std::max(stats.max_host_ns, host_ns);
+    stats.total_cycles += cycles;
+    ++stats.host_ns_histogram[GetHistogramBucket(host_ns)];
+}
+
+std::vector<CallStats> GetStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    std::vector<CallStats> stats;
+    stats.reserve(stats_map.size());
+    for (const auto& entry : stats_map) {
+        stats.push_back(entry.second);
+    }
+    return stats;
+}
+
+void Reset() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats_map.clear();
+}
+
+/// Quotes a CSV field if it contains a separator, a quote or a line break.
+static std::string EscapeCSV(const std::string& field) {
+    if (field.find_first_of(",\"\r\n") == std::string::npos)
+        return field;
+
+    std::string escaped = "\"";
+    for (char c : field) {
+        if (c == '"')
+            escaped += '"';
+        escaped += c;
+    }
+    return escaped + '"';
+}
+
+/// Escapes quotes, backslashes and control characters for a JSON string.
+static std::string EscapeJSON(const std::string& string) {
+    std::string escaped;
+    for (char c : string) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string FormatCSV(const std::vector<CallStats>& stats) {
+    std::string csv = "service,function,header,calls,total_host_ns,max_host_ns,total_cycles";
+    for (size_t bucket = 0; bucket < NUM_HISTOGRAM_BUCKETS; ++bucket) {
+        csv += fmt::format(",hist_{}", bucket);
+    }
+    csv += '\n';
+
+    for (const auto& entry : stats) {
+        csv += fmt::format("{},{},{:#010x},{},{},{},{}", EscapeCSV(entry.service_name),
+                           EscapeCSV(entry.function_name), entry.command_header, entry.num_calls,
+                           entry.total_host_ns, entry.max_host_ns, entry.total_cycles);
+        for (u64 count : entry.host_ns_histogram) {
+            csv += fmt::format(",{}", count);
+        }
+        csv += '\n';
+    }
+    return csv;
+}
+
+std::string FormatJSON(const std::vector<CallStats>& stats) {
+    std::string json = "[";
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const auto& entry = stats[i];
+        json += fmt::format("{}\n  {{\"service\": \"{}\", \"function\": \"{}\", "
+                            "\"header\": {}, \"calls\": {}, \"total_host_ns\": {}, "
+                            "\"max_host_ns\": {}, \"total_cycles\": {}, \"histogram\": [",
+                            i == 0 ? "" : ",", EscapeJSON(entry.service_name),
+                            EscapeJSON(entry.function_name), entry.command_header, entry.num_calls,
+                            entry.total_host_ns, entry.max_host_ns, entry.total_cycles);
+        for (size_t bucket = 0; bucket < NUM_HISTOGRAM_BUCKETS; ++bucket) {
+            json += fmt::format("{}{}", bucket == 0 ? "" : ", ", entry.host_ns_histogram[bucket]);
+        }
+        json += "]}";
+    }
+    json += "\n]\n";
+    return json;
+}
+
+void DumpToLogDirectory() {
+    const auto stats = GetStats();
+    if (stats.empty())
+        return;
+
+    const std::string path = FileUtil::GetUserPath(D_LOGS_IDX) + "ipc_profile";
+    FileUtil::CreateFullPath(path);
+    FileUtil::WriteStringToFile(true, FormatCSV(stats), (path + ".csv").c_str());
+    FileUtil::WriteStringToFile(true, FormatJSON(stats), (path + ".json").c_str());
+    LOG_INFO(Service, "IPC profile written to %s.{csv,json}", path.c_str());
+}
+
+} // namespace IPCProfiler
+} // namespace Service
@@ -0,0 +1,81 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Service {
+namespace IPCProfiler {
+
+/// Number of host time histogram buckets. Bucket N counts calls that took [2^N, 2^(N+1)) ns.
+constexpr size_t NUM_HISTOGRAM_BUCKETS = 32;
+
+/// Statistics of all calls to one command of one service
+struct CallStats {
+    std::string service_name;
+    std::string function_name;
+    /// IPC command header the command is registered with
+    u32 command_header = 0;
+    u64 num_calls = 0;
+    /// Host time spent in the HLE handler, in nanoseconds
+    u64 total_host_ns = 0;
+    u64 max_host_ns = 0;
+    /// Emulated CPU ticks that passed while the HLE handler ran, i.e. the ticks it charged
+    u64 total_cycles = 0;
+    std::array<u64, NUM_HISTOGRAM_BUCKETS> host_ns_histogram{};
+};
+
+/**
+ * Measures a HLE service call for as long as it is in scope. The names are only copied the first
+ * time a command is seen, so they must outlive the scope.
+ */
+class ScopedCall {
+public:
+    ScopedCall(const void* service, const std::string& service_name, const char* function_name,
+               u32 command_header);
+    ~ScopedCall();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const void* service;
+    const std::string& service_name;
+    const char* function_name;
+    u32 command_header;
+    Clock::time_point start_time;
+    u64 start_ticks;
+};
+
+/**
+ * Adds a call to the statistics of a command. Used by ScopedCall, the names are only copied the
+ * first time a command is seen. Thread-safe.
+ * @param service Object identifying the service
+ * @param host_ns Host time the call took, in nanoseconds
+ * @param cycles Emulated CPU ticks that passed during the call
+ */
+void RecordCall(const void* service, const std::string& service_name, const char* function_name,
+                u32 command_header, u64 host_ns, u64 cycles);
+
+/// Returns a snapshot of the statistics of all commands called so far. Thread-safe.
+std::vector<CallStats> GetStats();
+
+/// Discards all recorded statistics. Thread-safe.
+void Reset();
+
+/// Formats the statistics as CSV, one row per command.
+std::string FormatCSV(const std::vector<CallStats>& stats);
+
+/// Formats the statistics as a JSON array, one object per command.
+std::string FormatJSON(const std::vector<CallStats>& stats);
+
+/// Writes the recorded statistics as CSV and JSON files to the log directory.
+void DumpToLogDirectory();
+
+} // namespace IPCProfiler
+} // namespace Service
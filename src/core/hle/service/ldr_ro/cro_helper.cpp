@@ -2,9 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+#include <unordered_map>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
+#include "core/hle/kernel/process.h"
 #include "core/hle/service/ldr_ro/cro_helper.h"
 
 namespace Service {
@@ -37,6 +40,79 @@ const std::array<CROHelper::HeaderField, 4> CROHelper::FIX_BARRIERS{{
     Fix0Barrier, Fix1Barrier, Fix2Barrier, Fix3Barrier,
 }};
 
+/// Index of the named symbols exported by a module, from name to export table index
+using ExportIndex = std::unordered_map<std::string, u32>;
+
+// TODO: this should be in the per-client storage when we implement multi-process
+/// Export indices of the loaded modules by module address, see CROHelper::FindExportNamedSymbol
+static std::unordered_map<VAddr, ExportIndex> export_indices;
+
+void CROHelper::ClearExportIndices() {
+    export_indices.clear();
+}
+
+void CROHelper::InvalidateExportIndex() const {
+    export_indices.erase(module_address);
+}
+
+/**
+ * Returns the host memory backing a guest memory range of the current process.
+ * @returns the host pointer, or nullptr if the range isn't contiguous in host memory.
+ */
+static u8* GetContiguousHostPointer(VAddr address, u32 size) {
+    if (address == 0 || size == 0)
+        return nullptr;
+
+    auto spans = Memory::GetHostSpans(*Kernel::g_current_process, address, size,
+                                      Memory::FlushMode::FlushAndInvalidate);
+    return spans.size() == 1 ? spans[0].pointer : nullptr;
+}
+
+/// Writes a relocated word to host memory if the target was resolved to it, or to guest memory.
+static void WriteRelocation(VAddr target_address, u8* target_pointer, u32 value) {
+    if (target_pointer) {
+        const u32_le value_le = value;
+        std::memcpy(target_pointer, &value_le, sizeof(value_le));
+    } else {
+        Memory::Write32(target_address, value);
+    }
+}
+
+const std::vector<CROHelper::ResolvedSegment>& CROHelper::GetResolvedSegments() {
+    if (!segments_resolved) {
+        std::vector<SegmentEntry> segments = GetEntries<SegmentEntry>();
+        resolved_segments.clear();
+        resolved_segments.reserve(segments.size());
+        for (const SegmentEntry& segment : segments) {
+            resolved_segments.push_back({segment.offset, segment.size, segment.type,
+                                         GetContiguousHostPointer(segment.offset, segment.size)});
+        }
+        segments_resolved = true;
+    }
+    return resolved_segments;
+}
+
+bool CROHelper::ResolveRelocationTarget(SegmentTag segment_tag, VAddr& address, u8*& pointer) {
+    const auto& segments = GetResolvedSegments();
+
+    if (segment_tag.segment_index >= segments.size())
+        return false;
+
+    const ResolvedSegment& segment = segments[segment_tag.segment_index];
+    const u32 offset = segment_tag.offset_into_segment;
+    if (offset >= segment.size)
+        return false;
+
+    address = segment.address + offset;
+    if (address == 0)
+        return false;
+
+    // A word at the very end of the segment can spill over the resolved range
+    const bool in_range = segment.pointer && offset + sizeof(u32) <= segment.size;
+    pointer = in_range ? segment.pointer + offset : nullptr;
+    return true;
+}
+
 VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
     u32 segment_num = GetField(SegmentNum);
 
@@ -52,18 +128,20 @@ VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
     return entry.offset + segment_tag.offset_into_segment;
 }
 
-ResultCode CROHelper::ApplyRelocation(VAddr target_address, RelocationType relocation_type,
-                                      u32 addend, u32 symbol_address, u32 target_future_address) {
+ResultCode CROHelper::ApplyRelocation(VAddr target_address, u8* target_pointer,
+                                      RelocationType relocation_type, u32 addend,
+                                      u32 symbol_address, u32 target_future_address) {
 
     switch (relocation_type) {
     case RelocationType::Nothing:
         break;
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
-        Memory::Write32(target_address, symbol_address + addend);
+        WriteRelocation(target_address, target_pointer, symbol_address + addend);
         break;
     case RelocationType::RelativeAddress:
-        Memory::Write32(target_address, symbol_address + addend - target_future_address);
+        WriteRelocation(target_address, target_pointer,
+                        symbol_address + addend - target_future_address);
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -78,14 +156,15 @@ ResultCode CROHelper::ApplyRelocation(VAddr target_address, RelocationType reloc
     return RESULT_SUCCESS;
 }
 
-ResultCode CROHelper::ClearRelocation(VAddr target_address, RelocationType relocation_type) {
+ResultCode CROHelper::ClearRelocation(VAddr target_address, u8* target_pointer,
+                                      RelocationType relocation_type) {
     switch (relocation_type) {
     case RelocationType::Nothing:
         break;
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
     case RelocationType::RelativeAddress:
-        Memory::Write32(target_address, 0);
+        WriteRelocation(target_address, target_pointer, 0);
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -109,13 +188,15 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
         RelocationEntry relocation;
         Memory::ReadBlock(relocation_address, &relocation, sizeof(RelocationEntry));
 
-        VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
-        if (relocation_target == 0) {
+        VAddr relocation_target;
+        u8* target_pointer;
+        if (!ResolveRelocationTarget(relocation.target_position, relocation_target,
+                                     target_pointer)) {
             return CROFormatError(0x12);
         }
 
-        ResultCode result = ApplyRelocation(relocation_target, relocation.type, relocation.addend,
-                                            symbol_address, relocation_target);
+        ResultCode result = ApplyRelocation(relocation_target, target_pointer, relocation.type,
+                                            relocation.addend, symbol_address, relocation_target);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error applying relocation %08X", result.raw);
             return result;
@@ -138,45 +219,38 @@ VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
     if (!GetField(ExportTreeNum))
         return 0;
 
-    std::size_t len = name.size();
-    ExportTreeEntry entry;
-    GetEntry(0, entry);
-    ExportTreeEntry::Child next;
-    next.raw = entry.left.raw;
-    u32 found_id;
-
-    while (true) {
-        GetEntry(next.next_index, entry);
-
-        if (next.is_end) {
-            found_id = entry.export_table_index;
-            break;
-        }
-
-        u16 test_byte = entry.test_bit >> 3;
-        u16 test_bit_in_byte = entry.test_bit & 7;
+    auto index = export_indices.find(module_address);
+    if (index == export_indices.end()) {
+        // Builds the index from the whole export table and string table, read at once
+        index = export_indices.emplace(module_address, ExportIndex{}).first;
+
+        VAddr export_strings_offset = GetField(ExportStringsOffset);
+        u32 export_strings_size = GetField(ExportStringsSize);
+        std::vector<char> export_strings(export_strings_size);
+        Memory::ReadBlock(export_strings_offset, export_strings.data(), export_strings_size);
+
+        std::vector<ExportNamedSymbolEntry> entries = GetEntries<ExportNamedSymbolEntry>();
+        index->second.reserve(entries.size());
+        for (u32 i = 0; i < entries.size(); ++i) {
+            u32 name_offset = entries[i].name_offset - export_strings_offset;
+            if (entries[i].name_offset < export_strings_offset ||
+                name_offset >= export_strings_size) {
+                continue;
+            }
 
-        if (test_byte >= len) {
-            next.raw = entry.left.raw;
-        } else if ((name[test_byte] >> test_bit_in_byte) & 1) {
-            next.raw = entry.right.raw;
-        } else {
-            next.raw = entry.left.raw;
+            const char* symbol_name = export_strings.data() + name_offset;
+            std::size_t length = strnlen(symbol_name, export_strings_size - name_offset);
+            // Symbol names are unique in a module, the export tree would find the first one too
+            index->second.emplace(std::string(symbol_name, length), i);
         }
     }
 
-    u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
-
-    if (found_id >= export_named_symbol_num)
+    auto found = index->second.find(name);
+    if (found == index->second.end())
         return 0;
 
-    u32 export_strings_size = GetField(ExportStringsSize);
     ExportNamedSymbolEntry symbol_entry;
-    GetEntry(found_id, symbol_entry);
-
-    if (Memory::ReadCString(symbol_entry.name_offset, export_strings_size) != name)
-        return 0;
-
+    GetEntry(found->second, symbol_entry);
     return SegmentTagToAddress(symbol_entry.symbol_position);
 }
 
@@ -274,6 +348,7 @@ ResultVal<VAddr> CROHelper::RebaseSegmentTable(u32 cro_size, VAddr data_segment_
         }
         SetEntry(i, segment);
     }
+    InvalidateResolvedSegments();
     return MakeResult<u32>(prev_data_segment + module_address);
 }
 
@@ -446,26 +521,27 @@ VAddr CROHelper::GetOnUnresolvedAddress() {
 
 ResultCode CROHelper::ResetExternalRelocations() {
     u32 unresolved_symbol = GetOnUnresolvedAddress();
-    u32 external_relocation_num = GetField(ExternalRelocationNum);
-    ExternalRelocationEntry relocation;
+    std::vector<ExternalRelocationEntry> relocations = GetEntries<ExternalRelocationEntry>();
+    if (relocations.empty())
+        return RESULT_SUCCESS;
 
     // Verifies that the last relocation is the end of a batch
-    GetEntry(external_relocation_num - 1, relocation);
-    if (!relocation.is_batch_end) {
+    if (!relocations.back().is_batch_end) {
         return CROFormatError(0x12);
     }
 
     bool batch_begin = true;
-    for (u32 i = 0; i < external_relocation_num; ++i) {
-        GetEntry(i, relocation);
-        VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
-
-        if (relocation_target == 0) {
+    for (ExternalRelocationEntry& relocation : relocations) {
+        VAddr relocation_target;
+        u8* target_pointer;
+        if (!ResolveRelocationTarget(relocation.target_position, relocation_target,
+                                     target_pointer)) {
             return CROFormatError(0x12);
         }
 
-        ResultCode result = ApplyRelocation(relocation_target, relocation.type, relocation.addend,
-                                            unresolved_symbol, relocation_target);
+        ResultCode result = ApplyRelocation(relocation_target, target_pointer, relocation.type,
+                                            relocation.addend, unresolved_symbol,
+                                            relocation_target);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error applying relocation %08X", result.raw);
             return result;
@@ -474,30 +550,29 @@ ResultCode CROHelper::ResetExternalRelocations() {
         if (batch_begin) {
             // resets to unresolved state
             relocation.is_batch_resolved = 0;
-            SetEntry(i, relocation);
         }
 
         // if current is an end, then the next is a beginning
         batch_begin = relocation.is_batch_end != 0;
     }
 
+    SetEntries(relocations);
     return RESULT_SUCCESS;
 }
 
 ResultCode CROHelper::ClearExternalRelocations() {
-    u32 external_relocation_num = GetField(ExternalRelocationNum);
-    ExternalRelocationEntry relocation;
+    std::vector<ExternalRelocationEntry> relocations = GetEntries<ExternalRelocationEntry>();
 
     bool batch_begin = true;
-    for (u32 i = 0; i < external_relocation_num; ++i) {
-        GetEntry(i, relocation);
-        VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
-
-        if (relocation_target == 0) {
+    for (ExternalRelocationEntry& relocation : relocations) {
+        VAddr relocation_target;
+        u8* target_pointer;
+        if (!ResolveRelocationTarget(relocation.target_position, relocation_target,
+                                     target_pointer)) {
             return CROFormatError(0x12);
         }
 
-        ResultCode result = ClearRelocation(relocation_target, relocation.type);
+        ResultCode result = ClearRelocation(relocation_target, target_pointer, relocation.type);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error clearing relocation %08X", result.raw);
             return result;
@@ -506,13 +581,13 @@ ResultCode CROHelper::ClearExternalRelocations() {
         if (batch_begin) {
             // resets to unresolved state
             relocation.is_batch_resolved = 0;
-            SetEntry(i, relocation);
         }
 
         // if current is an end, then the next is a beginning
         batch_begin = relocation.is_batch_end != 0;
     }
 
+    SetEntries(relocations);
     return RESULT_SUCCESS;
 }
 
@@ -549,38 +624,49 @@ ResultCode CROHelper::ApplyStaticAnonymousSymbolToCRS(VAddr crs_address) {
 }
 
 ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
-    u32 segment_num = GetField(SegmentNum);
-    u32 internal_relocation_num = GetField(InternalRelocationNum);
-    for (u32 i = 0; i < internal_relocation_num; ++i) {
-        InternalRelocationEntry relocation;
-        GetEntry(i, relocation);
-        VAddr target_addressB = SegmentTagToAddress(relocation.target_position);
-        if (target_addressB == 0) {
+    const auto& segments = GetResolvedSegments();
+    std::vector<InternalRelocationEntry> relocations = GetEntries<InternalRelocationEntry>();
+
+    // The .data segment still is in the CRO buffer, resolved when first relocated
+    u8* old_data_segment_pointer = nullptr;
+    bool old_data_segment_resolved = false;
+
+    for (const InternalRelocationEntry& relocation : relocations) {
+        VAddr target_addressB;
+        u8* target_pointer;
+        if (!ResolveRelocationTarget(relocation.target_position, target_addressB,
+                                     target_pointer)) {
             return CROFormatError(0x15);
         }
 
         VAddr target_address;
-        SegmentEntry target_segment;
-        GetEntry(relocation.target_position.segment_index, target_segment);
+        const ResolvedSegment& target_segment = segments[relocation.target_position.segment_index];
 
         if (target_segment.type == SegmentType::Data) {
             // If the relocation is to the .data segment, we need to relocate it in the old buffer
-            target_address =
-                old_data_segment_address + relocation.target_position.offset_into_segment;
+            const u32 offset = relocation.target_position.offset_into_segment;
+            if (!old_data_segment_resolved) {
+                old_data_segment_pointer =
+                    GetContiguousHostPointer(old_data_segment_address, target_segment.size);
+                old_data_segment_resolved = true;
+            }
+            target_address = old_data_segment_address + offset;
+            target_pointer = old_data_segment_pointer && offset + sizeof(u32) <= target_segment.size
+                                 ? old_data_segment_pointer + offset
+                                 : nullptr;
         } else {
             target_address = target_addressB;
         }
 
-        if (relocation.symbol_segment >= segment_num) {
+        if (relocation.symbol_segment >= segments.size()) {
             return CROFormatError(0x15);
         }
 
-        SegmentEntry symbol_segment;
-        GetEntry(relocation.symbol_segment, symbol_segment);
+        VAddr symbol_address = segments[relocation.symbol_segment].address;
         LOG_TRACE(Service_LDR, "Internally relocates 0x%08X with 0x%08X", target_address,
-                  symbol_segment.offset);
-        ResultCode result = ApplyRelocation(target_address, relocation.type, relocation.addend,
-                                            symbol_segment.offset, target_addressB);
+                  symbol_address);
+        ResultCode result = ApplyRelocation(target_address, target_pointer, relocation.type,
+                                            relocation.addend, symbol_address, target_addressB);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error applying relocation %08X", result.raw);
             return result;
@@ -590,17 +676,15 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
 }
 
 ResultCode CROHelper::ClearInternalRelocations() {
-    u32 internal_relocation_num = GetField(InternalRelocationNum);
-    for (u32 i = 0; i < internal_relocation_num; ++i) {
-        InternalRelocationEntry relocation;
-        GetEntry(i, relocation);
-        VAddr target_address = SegmentTagToAddress(relocation.target_position);
-
-        if (target_address == 0) {
+    std::vector<InternalRelocationEntry> relocations = GetEntries<InternalRelocationEntry>();
+    for (const InternalRelocationEntry& relocation : relocations) {
+        VAddr target_address;
+        u8* target_pointer;
+        if (!ResolveRelocationTarget(relocation.target_position, target_address, target_pointer)) {
             return CROFormatError(0x15);
         }
 
-        ResultCode result = ClearRelocation(target_address, relocation.type);
+        ResultCode result = ClearRelocation(target_address, target_pointer, relocation.type);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error clearing relocation %08X", result.raw);
             return result;
@@ -705,6 +789,7 @@ void CROHelper::UnrebaseSegmentTable() {
 
         SetEntry(i, segment);
     }
+    InvalidateResolvedSegments();
 }
 
 void CROHelper::UnrebaseHeader() {
@@ -731,10 +816,9 @@ ResultCode CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
         Memory::ReadBlock(relocation_addr, &relocation_entry, sizeof(ExternalRelocationEntry));
 
         if (!relocation_entry.is_batch_resolved) {
+            std::string symbol_name = Memory::ReadCString(entry.name_offset, import_strings_size);
             ResultCode result =
                 ForEachAutoLinkCRO(crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                    std::string symbol_name =
-                        Memory::ReadCString(entry.name_offset, import_strings_size);
                     u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
 
                     if (symbol_address != 0) {
@@ -1090,6 +1174,9 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
                              u32 data_segment_size, VAddr bss_segment_address, u32 bss_segment_size,
                              bool is_crs) {
 
+    // A module previously loaded at the same address may have left its index
+    InvalidateExportIndex();
+
     ResultCode result = RebaseHeader(cro_size);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error rebasing header %08X", result.raw);
@@ -1193,6 +1280,8 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
 }
 
 void CROHelper::Unrebase(bool is_crs) {
+    InvalidateExportIndex();
+
     UnrebaseImportAnonymousSymbolTable();
     UnrebaseImportIndexedSymbolTable();
     UnrebaseImportNamedSymbolTable();
@@ -1239,6 +1328,7 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
                 data_segment_address = entry.offset;
                 entry.offset = GetField(DataOffset);
                 SetEntry(2, entry);
+                InvalidateResolvedSegments();
             }
         }
         SCOPE_EXIT({
@@ -1249,6 +1339,7 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
                     GetEntry(2, entry);
                     entry.offset = data_segment_address;
                     SetEntry(2, entry);
+                    InvalidateResolvedSegments();
                 }
             }
         });
@@ -1454,6 +1545,9 @@ u32 CROHelper::Fix(u32 fix_level) {
     if (fix_level != 0) {
         SetField(Magic, MAGIC_FIXD);
 
+        // Fixing can crop the export tables
+        InvalidateExportIndex();
+
         for (int field = FIX_BARRIERS[fix_level]; field < Fix0Barrier; field += 2) {
             SetField(static_cast<HeaderField>(field), fix_end);
             SetField(static_cast<HeaderField>(field + 1), 0);
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <tuple>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -142,6 +144,9 @@ public:
      */
     std::tuple<VAddr, u32> GetExecutablePages() const;
 
+    /// Drops the export indices of all modules, see FindExportNamedSymbol.
+    static void ClearExportIndices();
+
 private:
     const VAddr module_address; ///< the virtual address of this module
 
@@ -430,6 +435,60 @@ private:
                            &data, sizeof(T));
     }
 
+    /**
+     * Reads all entries of one of module tables at once.
+     * @note the entry type must have the static member TABLE_OFFSET_FIELD
+     *       indicating which table the entries are in. The entry number field follows it.
+     */
+    template <typename T>
+    std::vector<T> GetEntries() const {
+        std::vector<T> entries(GetField(static_cast<HeaderField>(T::TABLE_OFFSET_FIELD + 1)));
+        Memory::ReadBlock(GetField(T::TABLE_OFFSET_FIELD), entries.data(),
+                          entries.size() * sizeof(T));
+        return entries;
+    }
+
+    /// Writes back all entries of one of module tables read by GetEntries.
+    template <typename T>
+    void SetEntries(const std::vector<T>& entries) {
+        Memory::WriteBlock(GetField(T::TABLE_OFFSET_FIELD), entries.data(),
+                           entries.size() * sizeof(T));
+    }
+
+    /// A segment of this module, with the host memory backing it
+    struct ResolvedSegment {
+        VAddr address;
+        u32 size;
+        SegmentType type;
+        u8* pointer; ///< nullptr if the segment isn't contiguous in host memory
+    };
+
+    /**
+     * Segments of this module resolved to host memory, so that relocations to them are written
+     * directly instead of going through the guest page table. Resolved on first use by a
+     * relocation, and reset when the segment table changes.
+     */
+    std::vector<ResolvedSegment> resolved_segments;
+    bool segments_resolved = false;
+
+    /// Returns the resolved segments of this module, resolving them if needed.
+    const std::vector<ResolvedSegment>& GetResolvedSegments();
+
+    /// Drops the resolved segments after the segment table changed.
+    void InvalidateResolvedSegments() {
+        resolved_segments.clear();
+        segments_resolved = false;
+    }
+
+    /**
+     * Converts a segment tag to the virtual address and host memory of a relocation target.
+     * @param segment_tag the segment tag to convert
+     * @param address where to put the virtual address the segment tag points to
+     * @param pointer where to put the host memory of the target, nullptr if not resolved
+     * @returns false if the segment tag is invalid.
+     */
+    bool ResolveRelocationTarget(SegmentTag segment_tag, VAddr& address, u8*& pointer);
+
     /**
      * Converts a segment tag to virtual address in this module.
      * @param segment_tag the segment tag to convert
@@ -481,6 +540,7 @@ private:
     /**
      * Applies a relocation
      * @param target_address where to apply the relocation
+     * @param target_pointer host memory at target_address, or nullptr to write to guest memory
      * @param relocation_type the type of the relocation
      * @param addend address addend applied to the relocated symbol
      * @param symbol_address the symbol address to be relocated with
@@ -488,16 +548,19 @@ private:
      *        Usually equals to target_address, but will be different for a target in .data segment
      * @returns ResultCode RESULT_SUCCESS on success, otherwise error code.
      */
-    ResultCode ApplyRelocation(VAddr target_address, RelocationType relocation_type, u32 addend,
-                               u32 symbol_address, u32 target_future_address);
+    ResultCode ApplyRelocation(VAddr target_address, u8* target_pointer,
+                               RelocationType relocation_type, u32 addend, u32 symbol_address,
+                               u32 target_future_address);
 
     /**
      * Clears a relocation to zero
      * @param target_address where to apply the relocation
+     * @param target_pointer host memory at target_address, or nullptr to write to guest memory
      * @param relocation_type the type of the relocation
      * @returns ResultCode RESULT_SUCCESS on success, otherwise error code.
      */
-    ResultCode ClearRelocation(VAddr target_address, RelocationType relocation_type);
+    ResultCode ClearRelocation(VAddr target_address, u8* target_pointer,
+                               RelocationType relocation_type);
 
     /**
      * Applies or resets a batch of relocations
@@ -511,11 +574,16 @@ private:
 
     /**
      * Finds an exported named symbol in this module.
+     * Instead of walking the export tree in guest memory, the names are looked up in a hash index
+     * of the module, which is built on the first lookup and kept until the export table changes.
      * @param name the name of the symbol to find
      * @return VAddr the virtual address of the symbol; 0 if not found.
      */
     VAddr FindExportNamedSymbol(const std::string& name) const;
 
+    /// Drops the export index of this module after its export table changed.
+    void InvalidateExportIndex() const;
+
     /**
      * Rebases offsets in module header according to module address.
      * @param cro_size the size of the CRO file
@@ -712,6 +712,7 @@ LDR_RO::LDR_RO() {
 
     loaded_crs = 0;
     memory_synchronizer.Clear();
+    CROHelper::ClearExportIndices();
 }
 
 } // namespace LDR
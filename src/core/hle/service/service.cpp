@@ -31,6 +31,7 @@
 #include "core/hle/service/gsp_lcd.h"
 #include "core/hle/service/hid/hid.h"
 #include "core/hle/service/http_c.h"
+#include "core/hle/service/ipc_profiler.h"
 #include "core/hle/service/ir/ir.h"
 #include "core/hle/service/ldr_ro/ldr_ro.h"
 #include "core/hle/service/mic_u.h"
@@ -50,6 +51,7 @@
 #include "core/hle/service/soc/soc_u.h"
 #include "core/hle/service/ssl_c.h"
 #include "core/hle/service/y2r_u.h"
+#include "core/settings.h"
 
 using Kernel::ClientPort;
 using Kernel::ServerPort;
@@ -99,9 +101,12 @@ void Interface::HandleSyncRequest(SharedPtr<ServerSession> server_session) {
         cmd_buff[1] = 0;
         return;
     }
+    if (port_name.empty())
+        port_name = GetPortName();
     LOG_TRACE(Service, "%s",
-              MakeFunctionString(itr->second.name, GetPortName().c_str(), cmd_buff).c_str());
+              MakeFunctionString(itr->second.name, port_name.c_str(), cmd_buff).c_str());
 
+    IPCProfiler::ScopedCall profile(this, port_name, itr->second.name, itr->first);
     itr->second.func(this);
 }
 
@@ -180,7 +185,10 @@ void ServiceFrameworkBase::HandleSyncRequest(SharedPtr<ServerSession> server_ses
 
     LOG_TRACE(Service, "%s",
               MakeFunctionString(info->name, GetServiceName().c_str(), cmd_buf).c_str());
-    handler_invoker(this, info->handler_callback, context);
+    {
+        IPCProfiler::ScopedCall profile(this, service_name, info->name, header_code);
+        handler_invoker(this, info->handler_callback, context);
+    }
     context.WriteToOutgoingCommandBuffer(cmd_buf, *Kernel::g_current_process,
                                          Kernel::g_handle_table);
 }
@@ -318,6 +326,10 @@ void Shutdown() {
     AC::Shutdown();
     FS::ArchiveShutdown();
 
+    if (Settings::values.dump_ipc_profile)
+        IPCProfiler::DumpToLogDirectory();
+    IPCProfiler::Reset();
+
     SM::g_service_manager = nullptr;
     g_kernel_named_ports.clear();
     LOG_DEBUG(Service, "shutdown OK");
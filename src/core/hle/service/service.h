@@ -108,6 +108,8 @@ protected:
 private:
     u32 max_sessions; ///< Maximum number of concurrent sessions that this service can handle.
     boost::container::flat_map<u32, FunctionInfo> m_functions;
+    /// Port name used for each request, cached as GetPortName builds a new string every time
+    std::string port_name;
 };
 
 /**
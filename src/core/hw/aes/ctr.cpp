@@ -0,0 +1,29 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "core/hw/aes/ctr.h"
+
+namespace HW {
+namespace AES {
+
+struct CTRCipher::Impl {
+    // CryptoPP dispatches to AES-NI at runtime
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption decryption;
+};
+
+CTRCipher::CTRCipher(const AESKey& key, const AESCounter& ctr) : impl(std::make_unique<Impl>()) {
+    impl->decryption.SetKeyWithIV(key.data(), key.size(), ctr.data(), ctr.size());
+}
+
+CTRCipher::~CTRCipher() = default;
+
+void CTRCipher::Process(u8* data, size_t size, u64 offset) {
+    impl->decryption.Seek(offset);
+    impl->decryption.ProcessData(data, data, size);
+}
+
+} // namespace AES
+} // namespace HW
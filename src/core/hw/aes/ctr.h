@@ -0,0 +1,41 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include "common/common_types.h"
+#include "core/hw/aes/key.h"
+
+namespace HW {
+namespace AES {
+
+using AESCounter = std::array<u8, AES_BLOCK_SIZE>;
+
+/**
+ * AES-CTR cipher for one key and initial counter. Data at any position of the stream can be
+ * processed without processing what comes before it. AES-NI is used when the host supports it.
+ */
+class CTRCipher {
+public:
+    CTRCipher(const AESKey& key, const AESCounter& ctr);
+    ~CTRCipher();
+
+    /**
+     * Encrypts or decrypts data in place, which is the same operation in CTR mode.
+     * @param data The data to process
+     * @param size The size of the data in bytes
+     * @param offset The position of the data in the stream, in bytes
+     */
+    void Process(u8* data, size_t size, u64 offset);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace AES
+} // namespace HW
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <mutex>
 #include <sstream>
 #include <boost/optional.hpp>
 #include "common/common_paths.h"
@@ -18,6 +19,9 @@ namespace AES {
 
 namespace {
 
+/// Guards the generator constant and the key slots, which are read by the loader threads
+std::mutex key_mutex;
+
 boost::optional<AESKey> generator_constant;
 
 struct KeySlot {
@@ -56,6 +60,9 @@ struct KeySlot {
 
 std::array<KeySlot, KeySlotID::MaxKeySlotID> key_slots;
 
+/// Set once the keys have been loaded from the key file
+std::once_flag preset_keys_loaded;
+
 void ClearAllKeys() {
     for (KeySlot& slot : key_slots) {
         slot.Clear();
@@ -141,33 +148,62 @@ void LoadPresetKeys() {
 } // namespace
 
 void InitKeys() {
-    ClearAllKeys();
-    LoadPresetKeys();
+    {
+        std::lock_guard<std::mutex> lock(key_mutex);
+        ClearAllKeys();
+        LoadPresetKeys();
+    }
+    // Not called with the lock held, as a concurrent first call of GenerateNormalKey takes it
+    // while holding the flag
+    std::call_once(preset_keys_loaded, [] {});
 }
 
 void SetGeneratorConstant(const AESKey& key) {
+    std::lock_guard<std::mutex> lock(key_mutex);
     generator_constant = key;
 }
 
 void SetKeyX(size_t slot_id, const AESKey& key) {
+    std::lock_guard<std::mutex> lock(key_mutex);
     key_slots.at(slot_id).SetKeyX(key);
 }
 
 void SetKeyY(size_t slot_id, const AESKey& key) {
+    std::lock_guard<std::mutex> lock(key_mutex);
     key_slots.at(slot_id).SetKeyY(key);
 }
 
 void SetNormalKey(size_t slot_id, const AESKey& key) {
+    std::lock_guard<std::mutex> lock(key_mutex);
     key_slots.at(slot_id).SetNormalKey(key);
 }
 
 bool IsNormalKeyAvailable(size_t slot_id) {
+    std::lock_guard<std::mutex> lock(key_mutex);
     return key_slots.at(slot_id).normal.is_initialized();
 }
 
 AESKey GetNormalKey(size_t slot_id) {
+    std::lock_guard<std::mutex> lock(key_mutex);
     return key_slots.at(slot_id).normal.value_or(AESKey{});
 }
 
+bool GenerateNormalKey(size_t slot_id, const AESKey& key_y, AESKey& normal_key) {
+    // Content can be read before the system is booted, e.g. by the game list
+    std::call_once(preset_keys_loaded, [] {
+        std::lock_guard<std::mutex> lock(key_mutex);
+        LoadPresetKeys();
+    });
+
+    std::lock_guard<std::mutex> lock(key_mutex);
+    KeySlot slot = key_slots.at(slot_id);
+    if (!slot.x || !generator_constant) {
+        return false;
+    }
+    slot.SetKeyY(key_y);
+    normal_key = *slot.normal;
+    return true;
+}
+
 } // namespace AES
 } // namespace HW
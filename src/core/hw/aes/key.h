@@ -12,6 +12,12 @@ namespace HW {
 namespace AES {
 
 enum KeySlotID : size_t {
+    // AES Keyslots used to decrypt NCCH
+    NCCHSecure1 = 0x2C,
+    NCCHSecure2 = 0x25,
+    NCCHSecure3 = 0x18,
+    NCCHSecure4 = 0x1B,
+
     // AES Keyslot used to generate the UDS data frame CCMP key.
     UDSDataKey = 0x2D,
     APTWrap = 0x31,
@@ -33,5 +39,11 @@ void SetNormalKey(size_t slot_id, const AESKey& key);
 bool IsNormalKeyAvailable(size_t slot_id);
 AESKey GetNormalKey(size_t slot_id);
 
+/**
+ * Generates the normal key a slot would have with the given KeyY, without changing the slot.
+ * @return false if the KeyX of the slot or the generator constant is missing
+ */
+bool GenerateNormalKey(size_t slot_id, const AESKey& key_y, AESKey& normal_key);
+
 } // namspace AES
 } // namespace HW
@@ -2,18 +2,23 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <numeric>
 #include <type_traits>
+#include <vector>
 #include "common/alignment.h"
 #include "common/color.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/trace_recorder.h"
 #include "common/vector_math.h"
+#include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp_gpu.h"
 #include "core/hw/gpu.h"
+#include "core/hw/gpu_thread.h"
 #include "core/hw/hw.h"
 #include "core/memory.h"
 #include "core/tracer/recorder.h"
@@ -35,6 +40,9 @@ static int vblank_event;
 
 template <typename T>
 inline void Read(T& var, const u32 raw_addr) {
+    // Register state may still be changed by pending work on the GPU thread
+    SyncThread();
+
     u32 addr = raw_addr - HW::VADDR_GPU;
     u32 index = addr / 4;
 
@@ -47,29 +55,6 @@ inline void Read(T& var, const u32 raw_addr) {
     var = g_regs[addr / 4];
 }
 
-static Math::Vec4<u8> DecodePixel(Regs::PixelFormat input_format, const u8* src_pixel) {
-    switch (input_format) {
-    case Regs::PixelFormat::RGBA8:
-        return Color::DecodeRGBA8(src_pixel);
-
-    case Regs::PixelFormat::RGB8:
-        return Color::DecodeRGB8(src_pixel);
-
-    case Regs::PixelFormat::RGB565:
-        return Color::DecodeRGB565(src_pixel);
-
-    case Regs::PixelFormat::RGB5A1:
-        return Color::DecodeRGB5A1(src_pixel);
-
-    case Regs::PixelFormat::RGBA4:
-        return Color::DecodeRGBA4(src_pixel);
-
-    default:
-        LOG_ERROR(HW_GPU, "Unknown source framebuffer format %x", input_format);
-        return {0, 0, 0, 0};
-    }
-}
-
 MICROPROFILE_DEFINE(GPU_DisplayTransfer, "GPU", "DisplayTransfer", MP_RGB(100, 100, 255));
 MICROPROFILE_DEFINE(GPU_CmdlistProcessing, "GPU", "Cmdlist Processing", MP_RGB(100, 255, 100));
 
@@ -112,11 +97,20 @@ static void MemoryFill(const Regs::MemoryFillConfig& config) {
                                                config.GetEndAddress() - config.GetStartAddress());
 
     if (config.fill_24bit) {
-        // fill with 24-bit values
-        for (u8* ptr = start; ptr < end; ptr += 3) {
-            ptr[0] = config.value_24bit_r;
-            ptr[1] = config.value_24bit_g;
-            ptr[2] = config.value_24bit_b;
+        // fill with 24-bit values: write the pattern once, then keep doubling the filled span
+        // with memcpy so the bulk of the work runs at memset speed.
+        const size_t len = end - start;
+        const u8 pattern[3] = {static_cast<u8>(config.value_24bit_r),
+                               static_cast<u8>(config.value_24bit_g),
+                               static_cast<u8>(config.value_24bit_b)};
+        const size_t pattern_size = std::min(len, sizeof(pattern));
+        std::memcpy(start, pattern, pattern_size);
+
+        size_t filled = pattern_size;
+        while (filled < len) {
+            size_t copy_size = std::min(filled, len - filled);
+            std::memcpy(start + filled, start, copy_size);
+            filled += copy_size;
         }
     } else if (config.fill_32bit) {
         // fill with 32-bit values
@@ -134,6 +128,219 @@ static void MemoryFill(const Regs::MemoryFillConfig& config) {
     }
 }
 
+/// Compile-time description of a framebuffer format, used to specialize the transfer kernels
+template <Regs::PixelFormat format>
+struct PixelFormatTraits;
+
+template <>
+struct PixelFormatTraits<Regs::PixelFormat::RGBA8> {
+    static constexpr u32 bytes_per_pixel = 4;
+    static Math::Vec4<u8> Decode(const u8* bytes) {
+        return Color::DecodeRGBA8(bytes);
+    }
+    static void Encode(const Math::Vec4<u8>& color, u8* bytes) {
+        Color::EncodeRGBA8(color, bytes);
+    }
+};
+
+template <>
+struct PixelFormatTraits<Regs::PixelFormat::RGB8> {
+    static constexpr u32 bytes_per_pixel = 3;
+    static Math::Vec4<u8> Decode(const u8* bytes) {
+        return Color::DecodeRGB8(bytes);
+    }
+    static void Encode(const Math::Vec4<u8>& color, u8* bytes) {
+        Color::EncodeRGB8(color, bytes);
+    }
+};
+
+template <>
+struct PixelFormatTraits<Regs::PixelFormat::RGB565> {
+    static constexpr u32 bytes_per_pixel = 2;
+    static Math::Vec4<u8> Decode(const u8* bytes) {
+        return Color::DecodeRGB565(bytes);
+    }
+    static void Encode(const Math::Vec4<u8>& color, u8* bytes) {
+        Color::EncodeRGB565(color, bytes);
+    }
+};
+
+template <>
+struct PixelFormatTraits<Regs::PixelFormat::RGB5A1> {
+    static constexpr u32 bytes_per_pixel = 2;
+    static Math::Vec4<u8> Decode(const u8* bytes) {
+        return Color::DecodeRGB5A1(bytes);
+    }
+    static void Encode(const Math::Vec4<u8>& color, u8* bytes) {
+        Color::EncodeRGB5A1(color, bytes);
+    }
+};
+
+template <>
+struct PixelFormatTraits<Regs::PixelFormat::RGBA4> {
+    static constexpr u32 bytes_per_pixel = 2;
+    static Math::Vec4<u8> Decode(const u8* bytes) {
+        return Color::DecodeRGBA4(bytes);
+    }
+    static void Encode(const Math::Vec4<u8>& color, u8* bytes) {
+        Color::EncodeRGBA4(color, bytes);
+    }
+};
+
+/// Returns the x-dependent part of a tiled pixel offset, in pixels
+static u32 GetTiledColumnOffset(u32 x) {
+    return VideoCore::MortonInterleave(x, 0) + (x & ~7) * 8;
+}
+
+/// Returns the y-dependent part of a tiled pixel offset, in pixels
+static u32 GetTiledRowOffset(u32 y, u32 width) {
+    return VideoCore::MortonInterleave(0, y) + (y & ~7) * width;
+}
+
+/**
+ * Performs a display transfer between two fixed formats. The tiling-dependent parts of the pixel
+ * offsets are split into per-column and per-row terms, so the inner loop only does two table
+ * lookups and a format conversion the compiler can fully inline.
+ */
+template <Regs::PixelFormat input_format, Regs::PixelFormat output_format>
+static void DisplayTransferKernel(const Regs::DisplayTransferConfig& config, const u8* src_pointer,
+                                  u8* dst_pointer, u32 output_width, u32 output_height) {
+    using InputTraits = PixelFormatTraits<input_format>;
+    using OutputTraits = PixelFormatTraits<output_format>;
+    constexpr u32 src_bytes_per_pixel = InputTraits::bytes_per_pixel;
+    constexpr u32 dst_bytes_per_pixel = OutputTraits::bytes_per_pixel;
+
+    const int horizontal_scale = config.scaling != config.NoScale ? 1 : 0;
+    const int vertical_scale = config.scaling == config.ScaleXY ? 1 : 0;
+    const bool input_tiled = !config.input_linear;
+    const bool output_tiled = config.input_linear != config.dont_swizzle;
+    const u32 input_width = config.input_width;
+
+    // Column offsets are the same for every row, so compute them once per transfer
+    std::vector<u32> src_column_offsets(output_width);
+    std::vector<u32> dst_column_offsets(output_width);
+    for (u32 x = 0; x < output_width; ++x) {
+        u32 input_x = x << horizontal_scale;
+        src_column_offsets[x] =
+            (input_tiled ? GetTiledColumnOffset(input_x) : input_x) * src_bytes_per_pixel;
+        dst_column_offsets[x] = (output_tiled ? GetTiledColumnOffset(x) : x) * dst_bytes_per_pixel;
+    }
+
+    for (u32 y = 0; y < output_height; ++y) {
+        u32 input_y = y << vertical_scale;
+
+        // Flip the y value of the output data, we do this after calculating the [x,y] position
+        // of the input image to account for the scaling options.
+        u32 output_y = config.flip_vertically ? output_height - y - 1 : y;
+
+        const u8* src_row =
+            src_pointer + (input_tiled ? GetTiledRowOffset(input_y, input_width)
+                                       : input_y * input_width) *
+                              src_bytes_per_pixel;
+        u8* dst_row = dst_pointer + (output_tiled ? GetTiledRowOffset(output_y, output_width)
+                                                  : output_y * output_width) *
+                                        dst_bytes_per_pixel;
+
+        for (u32 x = 0; x < output_width; ++x) {
+            const u8* src_pixel = src_row + src_column_offsets[x];
+            u8* dst_pixel = dst_row + dst_column_offsets[x];
+
+            if (input_format == output_format && config.scaling == config.NoScale) {
+                // Decoding and re-encoding the same format is lossless, so copy the raw bytes
+                std::memcpy(dst_pixel, src_pixel, src_bytes_per_pixel);
+                continue;
+            }
+
+            Math::Vec4<u8> src_color = InputTraits::Decode(src_pixel);
+            if (config.scaling == config.ScaleX) {
+                Math::Vec4<u8> pixel = InputTraits::Decode(src_pixel + src_bytes_per_pixel);
+                src_color = ((src_color + pixel) / 2).Cast<u8>();
+            } else if (config.scaling == config.ScaleXY) {
+                Math::Vec4<u8> pixel1 = InputTraits::Decode(src_pixel + 1 * src_bytes_per_pixel);
+                Math::Vec4<u8> pixel2 = InputTraits::Decode(src_pixel + 2 * src_bytes_per_pixel);
+                Math::Vec4<u8> pixel3 = InputTraits::Decode(src_pixel + 3 * src_bytes_per_pixel);
+                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
+            }
+
+            OutputTraits::Encode(src_color, dst_pixel);
+        }
+    }
+}
+
+template <Regs::PixelFormat input_format>
+static void DisplayTransferKernel(const Regs::DisplayTransferConfig& config, const u8* src_pointer,
+                                  u8* dst_pointer, u32 output_width, u32 output_height) {
+    switch (config.output_format) {
+    case Regs::PixelFormat::RGBA8:
+        return DisplayTransferKernel<input_format, Regs::PixelFormat::RGBA8>(
+            config, src_pointer, dst_pointer, output_width, output_height);
+    case Regs::PixelFormat::RGB8:
+        return DisplayTransferKernel<input_format, Regs::PixelFormat::RGB8>(
+            config, src_pointer, dst_pointer, output_width, output_height);
+    case Regs::PixelFormat::RGB565:
+        return DisplayTransferKernel<input_format, Regs::PixelFormat::RGB565>(
+            config, src_pointer, dst_pointer, output_width, output_height);
+    case Regs::PixelFormat::RGB5A1:
+        return DisplayTransferKernel<input_format, Regs::PixelFormat::RGB5A1>(
+            config, src_pointer, dst_pointer, output_width, output_height);
+    case Regs::PixelFormat::RGBA4:
+        return DisplayTransferKernel<input_format, Regs::PixelFormat::RGBA4>(
+            config, src_pointer, dst_pointer, output_width, output_height);
+    default:
+        LOG_ERROR(HW_GPU, "Unknown destination framebuffer format %x",
+                  config.output_format.Value());
+        return;
+    }
+}
+
+void SoftwareDisplayTransfer(const Regs::DisplayTransferConfig& config, const u8* src_pointer,
+                             u8* dst_pointer) {
+    if (config.scaling > config.ScaleXY) {
+        LOG_CRITICAL(HW_GPU, "Unimplemented display transfer scaling mode %u",
+                     config.scaling.Value());
+        UNIMPLEMENTED();
+        return;
+    }
+
+    if (config.input_linear && config.scaling != config.NoScale) {
+        LOG_CRITICAL(HW_GPU, "Scaling is only implemented on tiled input");
+        UNIMPLEMENTED();
+        return;
+    }
+
+    int horizontal_scale = config.scaling != config.NoScale ? 1 : 0;
+    int vertical_scale = config.scaling == config.ScaleXY ? 1 : 0;
+
+    u32 output_width = config.output_width >> horizontal_scale;
+    u32 output_height = config.output_height >> vertical_scale;
+
+    switch (config.input_format) {
+    case Regs::PixelFormat::RGBA8:
+        DisplayTransferKernel<Regs::PixelFormat::RGBA8>(config, src_pointer, dst_pointer,
+                                                        output_width, output_height);
+        break;
+    case Regs::PixelFormat::RGB8:
+        DisplayTransferKernel<Regs::PixelFormat::RGB8>(config, src_pointer, dst_pointer,
+                                                       output_width, output_height);
+        break;
+    case Regs::PixelFormat::RGB565:
+        DisplayTransferKernel<Regs::PixelFormat::RGB565>(config, src_pointer, dst_pointer,
+                                                         output_width, output_height);
+        break;
+    case Regs::PixelFormat::RGB5A1:
+        DisplayTransferKernel<Regs::PixelFormat::RGB5A1>(config, src_pointer, dst_pointer,
+                                                         output_width, output_height);
+        break;
+    case Regs::PixelFormat::RGBA4:
+        DisplayTransferKernel<Regs::PixelFormat::RGBA4>(config, src_pointer, dst_pointer,
+                                                        output_width, output_height);
+        break;
+    default:
+        LOG_ERROR(HW_GPU, "Unknown source framebuffer format %x", config.input_format.Value());
+        break;
+    }
+}
+
 static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     const PAddr src_addr = config.GetPhysicalInputAddress();
     const PAddr dst_addr = config.GetPhysicalOutputAddress();
@@ -172,22 +379,6 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     if (VideoCore::g_renderer->Rasterizer()->AccelerateDisplayTransfer(config))
         return;
 
-    u8* src_pointer = Memory::GetPhysicalPointer(src_addr);
-    u8* dst_pointer = Memory::GetPhysicalPointer(dst_addr);
-
-    if (config.scaling > config.ScaleXY) {
-        LOG_CRITICAL(HW_GPU, "Unimplemented display transfer scaling mode %u",
-                     config.scaling.Value());
-        UNIMPLEMENTED();
-        return;
-    }
-
-    if (config.input_linear && config.scaling != config.NoScale) {
-        LOG_CRITICAL(HW_GPU, "Scaling is only implemented on tiled input");
-        UNIMPLEMENTED();
-        return;
-    }
-
     int horizontal_scale = config.scaling != config.NoScale ? 1 : 0;
     int vertical_scale = config.scaling == config.ScaleXY ? 1 : 0;
 
@@ -201,113 +392,8 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(), input_size);
     Memory::RasterizerFlushAndInvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
 
-    for (u32 y = 0; y < output_height; ++y) {
-        for (u32 x = 0; x < output_width; ++x) {
-            Math::Vec4<u8> src_color;
-
-            // Calculate the [x,y] position of the input image
-            // based on the current output position and the scale
-            u32 input_x = x << horizontal_scale;
-            u32 input_y = y << vertical_scale;
-
-            u32 output_y;
-            if (config.flip_vertically) {
-                // Flip the y value of the output data,
-                // we do this after calculating the [x,y] position of the input image
-                // to account for the scaling options.
-                output_y = output_height - y - 1;
-            } else {
-                output_y = y;
-            }
-
-            u32 dst_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.output_format);
-            u32 src_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.input_format);
-            u32 src_offset;
-            u32 dst_offset;
-
-            if (config.input_linear) {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as linear and the output as tiled
-                    u32 coarse_y = output_y & ~7;
-                    u32 stride = output_width * dst_bytes_per_pixel;
-
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 coarse_y * stride;
-                } else {
-                    // Both input and output are linear
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                }
-            } else {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as tiled and the output as linear
-                    u32 coarse_y = input_y & ~7;
-                    u32 stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 coarse_y * stride;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                } else {
-                    // Both input and output are tiled
-                    u32 out_coarse_y = output_y & ~7;
-                    u32 out_stride = output_width * dst_bytes_per_pixel;
-
-                    u32 in_coarse_y = input_y & ~7;
-                    u32 in_stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 in_coarse_y * in_stride;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 out_coarse_y * out_stride;
-                }
-            }
-
-            const u8* src_pixel = src_pointer + src_offset;
-            src_color = DecodePixel(config.input_format, src_pixel);
-            if (config.scaling == config.ScaleX) {
-                Math::Vec4<u8> pixel =
-                    DecodePixel(config.input_format, src_pixel + src_bytes_per_pixel);
-                src_color = ((src_color + pixel) / 2).Cast<u8>();
-            } else if (config.scaling == config.ScaleXY) {
-                Math::Vec4<u8> pixel1 =
-                    DecodePixel(config.input_format, src_pixel + 1 * src_bytes_per_pixel);
-                Math::Vec4<u8> pixel2 =
-                    DecodePixel(config.input_format, src_pixel + 2 * src_bytes_per_pixel);
-                Math::Vec4<u8> pixel3 =
-                    DecodePixel(config.input_format, src_pixel + 3 * src_bytes_per_pixel);
-                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
-            }
-
-            u8* dst_pixel = dst_pointer + dst_offset;
-            switch (config.output_format) {
-            case Regs::PixelFormat::RGBA8:
-                Color::EncodeRGBA8(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB8:
-                Color::EncodeRGB8(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB565:
-                Color::EncodeRGB565(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB5A1:
-                Color::EncodeRGB5A1(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGBA4:
-                Color::EncodeRGBA4(src_color, dst_pixel);
-                break;
-
-            default:
-                LOG_ERROR(HW_GPU, "Unknown destination framebuffer format %x",
-                          config.output_format.Value());
-                break;
-            }
-        }
-    }
+    SoftwareDisplayTransfer(config, Memory::GetPhysicalPointer(src_addr),
+                            Memory::GetPhysicalPointer(dst_addr));
 }
 
 static void TextureCopy(const Regs::DisplayTransferConfig& config) {
@@ -390,8 +476,21 @@ static void TextureCopy(const Regs::DisplayTransferConfig& config) {
     }
 }
 
+/// Returns whether the given address is one of the framebuffers scanned out to the screens
+static bool IsFramebufferAddress(PAddr addr) {
+    for (const auto& framebuffer : g_regs.framebuffer_config) {
+        if (addr == framebuffer.address_left1 || addr == framebuffer.address_left2 ||
+            addr == framebuffer.address_right1 || addr == framebuffer.address_right2)
+            return true;
+    }
+    return false;
+}
+
 template <typename T>
 inline void Write(u32 addr, const T data) {
+    // Writes from the CPU thread must be ordered after pending work on the GPU thread
+    SyncThread();
+
     addr -= HW::VADDR_GPU;
     u32 index = addr / 4;
 
@@ -444,7 +543,9 @@ inline void Write(u32 addr, const T data) {
                 Pica::g_debug_context->OnEvent(Pica::DebugContext::Event::IncomingDisplayTransfer,
                                                nullptr);
 
+            auto& frame_skipper = Core::System::GetInstance().frame_skipper;
             if (config.is_texture_copy) {
+                frame_skipper.NotifyBufferRead(config.GetPhysicalInputAddress());
                 TextureCopy(config);
                 LOG_TRACE(HW_GPU, "TextureCopy: 0x%X bytes from 0x%08X(%u+%u)-> "
                                   "0x%08X(%u+%u), flags 0x%08X",
@@ -453,6 +554,11 @@ inline void Write(u32 addr, const T data) {
                           config.GetPhysicalOutputAddress(), config.texture_copy.output_width * 16,
                           config.texture_copy.output_gap * 16, config.flags);
             } else {
+                if (IsFramebufferAddress(config.GetPhysicalOutputAddress())) {
+                    frame_skipper.NotifyPresentTransfer(config.GetPhysicalInputAddress());
+                } else {
+                    frame_skipper.NotifyBufferRead(config.GetPhysicalInputAddress());
+                }
                 DisplayTransfer(config);
                 LOG_TRACE(HW_GPU, "DisplayTransfer: 0x%08x(%ux%u)-> "
                                   "0x%08x(%ux%u), dst format %x, flags 0x%08X",
@@ -515,6 +621,13 @@ template void Write<u8>(u32 addr, const u8 data);
 
 /// Update hardware
 static void VBlankCallback(u64 userdata, int cycles_late) {
+    if (Common::TraceRecorder::IsRecording()) {
+        Common::TraceRecorder::EmulatedInstant("VBlank", "GPU", 0);
+    }
+
+    // Present only what the GPU thread has finished rendering so far
+    SyncThread();
+
     VideoCore::g_renderer->SwapBuffers();
 
     // Signal to GSP that GPU interrupt has occurred
@@ -567,6 +680,8 @@ void Init() {
 
 /// Shutdown hardware
 void Shutdown() {
+    ShutdownThread();
+
     LOG_DEBUG(HW_GPU, "shutdown OK");
 }
 
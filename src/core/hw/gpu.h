@@ -325,6 +325,16 @@ void Read(T& var, const u32 addr);
 template <typename T>
 void Write(u32 addr, const T data);
 
+/**
+ * Converts the pixels of a display transfer on the CPU, used when the rasterizer can't accelerate
+ * the transfer. The caller is responsible for validating the configuration and flushing caches.
+ * @param config The display transfer configuration
+ * @param src_pointer Pointer to the input pixels
+ * @param dst_pointer Pointer to the output pixels
+ */
+void SoftwareDisplayTransfer(const Regs::DisplayTransferConfig& config, const u8* src_pointer,
+                             u8* dst_pointer);
+
 /// Initialize hardware
 void Init();
 
@@ -0,0 +1,100 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "common/threadsafe_queue.h"
+#include "core/hw/gpu_thread.h"
+
+namespace GPU {
+
+static std::thread gpu_thread;
+static Common::SPSCQueue<std::function<void()>> work_queue;
+/// Signalled by the CPU thread whenever work is pushed
+static Common::Event work_available;
+
+/// Number of work items pushed so far. Only accessed by the CPU thread.
+static u64 pushed_work = 0;
+/// Number of work items completed so far. Guarded by sync_mutex.
+static u64 completed_work = 0;
+static std::mutex sync_mutex;
+static std::condition_variable work_completed;
+
+static thread_local bool is_gpu_thread = false;
+
+static void ThreadLoop() {
+    is_gpu_thread = true;
+    Common::SetCurrentThreadName("GpuThread");
+    MicroProfileOnThreadCreate("GpuThread");
+
+    while (true) {
+        std::function<void()> work;
+        if (!work_queue.Pop(work)) {
+            work_available.Wait();
+            continue;
+        }
+
+        // An empty function is the signal to exit the loop
+        if (!work)
+            break;
+
+        work();
+
+        {
+            std::lock_guard<std::mutex> lock(sync_mutex);
+            ++completed_work;
+        }
+        work_completed.notify_one();
+    }
+
+#if MICROPROFILE_ENABLED
+    MicroProfileOnThreadExit();
+#endif
+}
+
+void PushThreadWork(std::function<void()> work) {
+    if (!gpu_thread.joinable()) {
+        work_available.Reset();
+        gpu_thread = std::thread(ThreadLoop);
+        LOG_INFO(HW_GPU, "GPU thread started");
+    }
+
+    ++pushed_work;
+    work_queue.Push(std::move(work));
+    work_available.Set();
+}
+
+void SyncThread() {
+    if (!gpu_thread.joinable() || is_gpu_thread)
+        return;
+
+    std::unique_lock<std::mutex> lock(sync_mutex);
+    work_completed.wait(lock, [] { return completed_work == pushed_work; });
+}
+
+void ShutdownThread() {
+    if (!gpu_thread.joinable())
+        return;
+
+    SyncThread();
+
+    work_queue.Push(std::function<void()>());
+    work_available.Set();
+    gpu_thread.join();
+
+    pushed_work = 0;
+    completed_work = 0;
+    LOG_INFO(HW_GPU, "GPU thread stopped");
+}
+
+bool IsGPUThread() {
+    return is_gpu_thread;
+}
+
+} // namespace GPU
@@ -0,0 +1,36 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+
+namespace GPU {
+
+/**
+ * Asynchronous GPU emulation. When enabled, GSP commands (command list processing, memory fills,
+ * display transfers, DMA) are executed on a dedicated thread, so that PICA emulation overlaps with
+ * CPU emulation. Work is handed over through a lock-free single-producer queue, and interrupts
+ * raised on the GPU thread are delivered back to the CPU thread through CoreTiming.
+ *
+ * The CPU thread only has to wait for the GPU thread (see SyncThread) where it may observe state
+ * written by the GPU: GPU register accesses and the VBlank, where framebuffers are presented.
+ */
+
+/**
+ * Queues work to be executed on the GPU thread, starting the thread if necessary. Must only be
+ * called from the CPU thread.
+ */
+void PushThreadWork(std::function<void()> work);
+
+/// Blocks until all work queued to the GPU thread has been executed. No-op on the GPU thread.
+void SyncThread();
+
+/// Finishes all queued work and stops the GPU thread, if it is running.
+void ShutdownThread();
+
+/// Returns whether the calling thread is the GPU thread
+bool IsGPUThread();
+
+} // namespace GPU
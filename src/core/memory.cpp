@@ -8,6 +8,7 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/memory_util.h"
 #include "common/swap.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
@@ -21,11 +22,62 @@
 
 namespace Memory {
 
-static std::array<u8, Memory::VRAM_SIZE> vram;
-static std::array<u8, Memory::N3DS_EXTRA_RAM_SIZE> n3ds_extra_ram;
+/// Size of the host reservation backing FCRAM, VRAM and the New 3DS extra RAM
+constexpr size_t PHYSICAL_MEMORY_SIZE = FCRAM_SIZE + VRAM_SIZE + N3DS_EXTRA_RAM_SIZE;
+static_assert(PHYSICAL_MEMORY_SIZE % LARGE_PAGE_SIZE == 0,
+              "Physical memory should fit huge pages exactly");
+
+/// FCRAM, VRAM and the New 3DS extra RAM in one reservation, in that order, see InitPhysicalMemory
+static u8* physical_memory = nullptr;
+static LargePageBacking physical_memory_backing;
 
 static PageTable* current_page_table = nullptr;
 
+/// Host memory backing each page of the physical address space, nullptr for unbacked pages
+static std::array<u8*, PAGE_TABLE_NUM_ENTRIES> physical_page_pointers;
+
+void MapPhysicalRegion(PAddr base, u32 size, u8* target) {
+    ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: %08X", size);
+    ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: %08X", base);
+    for (u32 page = 0; page < size / PAGE_SIZE; ++page) {
+        physical_page_pointers[(base >> PAGE_BITS) + page] =
+            target != nullptr ? target + page * PAGE_SIZE : nullptr;
+    }
+}
+
+void UnmapPhysicalRegion(PAddr base, u32 size) {
+    MapPhysicalRegion(base, size, nullptr);
+}
+
+void InitPhysicalMemory() {
+    ASSERT_MSG(physical_memory == nullptr, "Physical memory is already initialized");
+    physical_memory = static_cast<u8*>(
+        AllocateLargeMemoryPages(PHYSICAL_MEMORY_SIZE, physical_memory_backing));
+    ASSERT_MSG(physical_memory != nullptr,
+               "Failed to reserve %zu MiB of host memory for FCRAM and VRAM",
+               PHYSICAL_MEMORY_SIZE >> 20);
+    LOG_INFO(HW_Memory, "Physical memory of %zu MiB at %p, backed by %s",
+             PHYSICAL_MEMORY_SIZE >> 20, physical_memory,
+             GetLargePageBackingName(physical_memory_backing));
+
+    u8* vram = physical_memory + FCRAM_SIZE;
+    MapPhysicalRegion(VRAM_PADDR, VRAM_SIZE, vram);
+    MapPhysicalRegion(DSP_RAM_PADDR, DSP_RAM_SIZE, AudioCore::GetDspMemory().data());
+    MapPhysicalRegion(N3DS_EXTRA_RAM_PADDR, N3DS_EXTRA_RAM_SIZE, vram + VRAM_SIZE);
+}
+
+void ShutdownPhysicalMemory() {
+    physical_page_pointers.fill(nullptr);
+    FreeMemoryPages(physical_memory, PHYSICAL_MEMORY_SIZE);
+    physical_memory = nullptr;
+}
+
+u8* GetFCRAMPointer(u32 offset) {
+    ASSERT_MSG(physical_memory != nullptr, "Physical memory is not initialized");
+    ASSERT_MSG(offset <= FCRAM_SIZE, "FCRAM offset out of range: %08X", offset);
+    return physical_memory + offset;
+}
+
 void SetCurrentPageTable(PageTable* page_table) {
     current_page_table = page_table;
     if (Core::System::GetInstance().IsPoweredOn()) {
@@ -275,63 +327,19 @@ std::string ReadCString(VAddr vaddr, std::size_t max_length) {
 }
 
 u8* GetPhysicalPointer(PAddr address) {
-    struct MemoryArea {
-        PAddr paddr_base;
-        u32 size;
-    };
-
-    static constexpr MemoryArea memory_areas[] = {
-        {VRAM_PADDR, VRAM_SIZE},
-        {IO_AREA_PADDR, IO_AREA_SIZE},
-        {DSP_RAM_PADDR, DSP_RAM_SIZE},
-        {FCRAM_PADDR, FCRAM_N3DS_SIZE},
-        {N3DS_EXTRA_RAM_PADDR, N3DS_EXTRA_RAM_SIZE},
-    };
-
-    const auto area =
-        std::find_if(std::begin(memory_areas), std::end(memory_areas), [&](const auto& area) {
-            return address >= area.paddr_base && address < area.paddr_base + area.size;
-        });
-
-    if (area == std::end(memory_areas)) {
-        LOG_ERROR(HW_Memory, "unknown GetPhysicalPointer @ 0x%08X", address);
-        return nullptr;
+    u8* page_pointer = physical_page_pointers[address >> PAGE_BITS];
+    if (page_pointer) {
+        return page_pointer + (address & PAGE_MASK);
     }
 
-    if (area->paddr_base == IO_AREA_PADDR) {
+    if (address >= IO_AREA_PADDR && address < IO_AREA_PADDR_END) {
         LOG_ERROR(HW_Memory, "MMIO mappings are not supported yet. phys_addr=0x%08X", address);
-        return nullptr;
-    }
-
-    u32 offset_into_region = address - area->paddr_base;
-
-    u8* target_pointer = nullptr;
-    switch (area->paddr_base) {
-    case VRAM_PADDR:
-        target_pointer = vram.data() + offset_into_region;
-        break;
-    case DSP_RAM_PADDR:
-        target_pointer = AudioCore::GetDspMemory().data() + offset_into_region;
-        break;
-    case FCRAM_PADDR:
-        for (const auto& region : Kernel::memory_regions) {
-            if (offset_into_region >= region.base &&
-                offset_into_region < region.base + region.size) {
-                target_pointer =
-                    region.linear_heap_memory->data() + offset_into_region - region.base;
-                break;
-            }
-        }
-        ASSERT_MSG(target_pointer != nullptr, "Invalid FCRAM address");
-        break;
-    case N3DS_EXTRA_RAM_PADDR:
-        target_pointer = n3ds_extra_ram.data() + offset_into_region;
-        break;
-    default:
-        UNREACHABLE();
+    } else if (address >= FCRAM_PADDR && address < FCRAM_N3DS_PADDR_END) {
+        ASSERT_MSG(false, "Invalid FCRAM address 0x%08X", address);
+    } else {
+        LOG_ERROR(HW_Memory, "unknown GetPhysicalPointer @ 0x%08X", address);
     }
-
-    return target_pointer;
+    return nullptr;
 }
 
 void RasterizerMarkRegionCached(PAddr start, u32 size, int count_delta) {
@@ -462,6 +470,48 @@ void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
     }
 }
 
+std::vector<HostSpan> GetHostSpans(const Kernel::Process& process, const VAddr vaddr,
+                                   const size_t size, FlushMode flush_mode) {
+    auto& page_table = process.vm_manager.page_table;
+
+    std::vector<HostSpan> spans;
+    size_t remaining_size = size;
+    size_t page_index = vaddr >> PAGE_BITS;
+    size_t page_offset = vaddr & PAGE_MASK;
+
+    while (remaining_size > 0) {
+        const size_t span_size = std::min(PAGE_SIZE - page_offset, remaining_size);
+        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
+
+        u8* pointer;
+        switch (page_table.attributes[page_index]) {
+        case PageType::Memory:
+            DEBUG_ASSERT(page_table.pointers[page_index]);
+            pointer = page_table.pointers[page_index] + page_offset;
+            break;
+        case PageType::RasterizerCachedMemory:
+            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(span_size), flush_mode);
+            pointer = GetPointerFromVMA(process, current_vaddr);
+            break;
+        default:
+            // Unmapped and MMIO pages have no host memory that could be accessed directly
+            return {};
+        }
+
+        if (!spans.empty() && spans.back().pointer + spans.back().size == pointer) {
+            spans.back().size += span_size;
+        } else {
+            spans.push_back({pointer, span_size});
+        }
+
+        page_index++;
+        page_offset = 0;
+        remaining_size -= span_size;
+    }
+
+    return spans;
+}
+
 u8 Read8(const VAddr addr) {
     return Read<u8>(addr);
 }
@@ -238,7 +238,15 @@ PAddr VirtualToPhysicalAddress(VAddr addr);
 boost::optional<VAddr> PhysicalToVirtualAddress(PAddr addr);
 
 /**
- * Gets a pointer to the memory region beginning at the specified physical address.
+ * Gets the host memory backing FCRAM at the given offset. FCRAM, VRAM and the New 3DS extra RAM
+ * are carved out of a single page-aligned host reservation, preferably backed by huge pages, which
+ * exists between InitPhysicalMemory and ShutdownPhysicalMemory.
+ */
+u8* GetFCRAMPointer(u32 offset);
+
+/**
+ * Gets a pointer to the memory region beginning at the specified physical address. This is a
+ * single lookup in a page table of the physical address space, see MapPhysicalRegion.
  */
 u8* GetPhysicalPointer(PAddr address);
 
@@ -271,4 +279,20 @@ enum class FlushMode {
  */
 void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode);
 
+/// A range of host memory backing part of a guest virtual memory range
+struct HostSpan {
+    u8* pointer;
+    size_t size;
+};
+
+/**
+ * Resolves a virtual memory range of a process into the host memory backing it, merging pages that
+ * are contiguous in host memory. Rasterizer cached pages in the range are flushed using the given
+ * mode, so the returned memory can be accessed directly.
+ * @returns The spans covering the range in order, or an empty list if part of the range is not
+ *          backed by host memory (unmapped or MMIO pages).
+ */
+std::vector<HostSpan> GetHostSpans(const Kernel::Process& process, VAddr vaddr, size_t size,
+                                   FlushMode flush_mode);
+
 } // namespace Memory
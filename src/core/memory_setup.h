@@ -29,4 +29,26 @@ void MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, u8* target);
 void MapIoRegion(PageTable& page_table, VAddr base, u32 size, MMIORegionPointer mmio_handler);
 
 void UnmapRegion(PageTable& page_table, VAddr base, u32 size);
+
+/**
+ * Maps a buffer onto a region of the physical address space, through which GetPhysicalPointer
+ * translates addresses.
+ *
+ * @param base The physical address to start mapping at. Must be page-aligned.
+ * @param size The amount of bytes to map. Must be page-aligned.
+ * @param target Buffer with the memory backing the mapping. Must be of length at least `size`.
+ */
+void MapPhysicalRegion(PAddr base, u32 size, u8* target);
+
+void UnmapPhysicalRegion(PAddr base, u32 size);
+
+/**
+ * Reserves the host memory backing FCRAM, VRAM and the New 3DS extra RAM, and maps VRAM, DSP RAM
+ * and the New 3DS extra RAM. FCRAM is mapped by the kernel, as it carves it into memory regions.
+ * The memory starts out cleared, so nothing carries over from a previous session.
+ */
+void InitPhysicalMemory();
+
+/// Unmaps the whole physical address space and frees the memory reserved by InitPhysicalMemory.
+void ShutdownPhysicalMemory();
 }
@@ -120,10 +120,10 @@ static PlayMode play_mode = PlayMode::None;
 static std::vector<u8> recorded_input;
 static size_t current_byte = 0;
 
-static bool IsPlayingInput() {
+bool IsPlayingInput() {
     return play_mode == PlayMode::Playing;
 }
-static bool IsRecordingInput() {
+bool IsRecordingInput() {
     return play_mode == PlayMode::Recording;
 }
 
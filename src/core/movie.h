@@ -25,6 +25,12 @@ void Init();
 
 void Shutdown();
 
+/// Returns whether a movie is currently being played back
+bool IsPlayingInput();
+
+/// Returns whether a movie is currently being recorded
+bool IsRecordingInput();
+
 /**
  * When recording: Takes a copy of the given input states so they can be used for playback
  * When playing: Replaces the given input states with the ones stored in the playback file
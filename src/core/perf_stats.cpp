@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <mutex>
 #include <thread>
@@ -40,6 +41,12 @@ void PerfStats::EndGameFrame() {
     game_frames += 1;
 }
 
+void PerfStats::SkipSystemFrame() {
+    std::lock_guard<std::mutex> lock(object_mutex);
+
+    skipped_frames += 1;
+}
+
 PerfStats::Results PerfStats::GetAndResetStats(u64 current_system_time_us) {
     std::lock_guard<std::mutex> lock(object_mutex);
 
@@ -56,6 +63,7 @@ PerfStats::Results PerfStats::GetAndResetStats(u64 current_system_time_us) {
     results.frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second / 1'000'000.0;
+    results.skipped_frames = skipped_frames;
 
     // Reset counters
     reset_point = now;
@@ -63,6 +71,7 @@ PerfStats::Results PerfStats::GetAndResetStats(u64 current_system_time_us) {
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
+    skipped_frames = 0;
 
     return results;
 }
@@ -102,4 +111,61 @@ void FrameLimiter::DoFrameLimiting(u64 current_system_time_us) {
     previous_walltime = now;
 }
 
+void FrameSkipper::BeginFrame(PerfStats& perf_stats) {
+    const u32 max_frame_skip = static_cast<u32>(std::max(Settings::values.max_frame_skip, 0));
+    if (BeginFrame(perf_stats.GetLastFrameTimeScale(), max_frame_skip)) {
+        perf_stats.SkipSystemFrame();
+    }
+}
+
+bool FrameSkipper::BeginFrame(double last_frame_time_scale, u32 max_frame_skip) {
+    // Only skip when the previous frame took noticeably longer than real time, to avoid skipping
+    // because of jitter while running at full speed.
+    constexpr double SKIP_THRESHOLD = 1.05;
+
+    if (max_frame_skip == 0) {
+        enabled = false;
+        skipping_frame = false;
+        consecutive_skips = 0;
+        return false;
+    }
+
+    if (!enabled) {
+        // Buffer uses weren't reported while skipping was disabled, so observe a whole frame
+        // before deciding which draws can be dropped.
+        enabled = true;
+        presented_buffers.fill(0);
+        next_presented_buffer = 0;
+        read_buffers.clear();
+        skipping_frame = false;
+        return false;
+    }
+
+    skipping_frame = consecutive_skips < max_frame_skip && last_frame_time_scale > SKIP_THRESHOLD;
+    consecutive_skips = skipping_frame ? consecutive_skips + 1 : 0;
+    return skipping_frame;
+}
+
+void FrameSkipper::NotifyPresentTransfer(PAddr src_addr) {
+    if (!enabled || src_addr == 0 || IsPresentedBuffer(src_addr) ||
+        read_buffers.count(src_addr) != 0)
+        return;
+
+    presented_buffers[next_presented_buffer] = src_addr;
+    next_presented_buffer = (next_presented_buffer + 1) % presented_buffers.size();
+}
+
+void FrameSkipper::NotifyBufferRead(PAddr addr) {
+    if (!enabled || addr == 0 || !read_buffers.insert(addr).second)
+        return;
+
+    std::replace(presented_buffers.begin(), presented_buffers.end(), addr, PAddr{0});
+}
+
+bool FrameSkipper::IsPresentedBuffer(PAddr color_buffer_addr) const {
+    return color_buffer_addr != 0 &&
+           std::find(presented_buffers.begin(), presented_buffers.end(), color_buffer_addr) !=
+               presented_buffers.end();
+}
+
 } // namespace Core
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <mutex>
+#include <unordered_set>
 #include "common/common_types.h"
 
 namespace Core {
@@ -27,11 +29,14 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Number of system frames whose rendering was skipped
+        u32 skipped_frames;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
+    void SkipSystemFrame();
 
     Results GetAndResetStats(u64 current_system_time_us);
 
@@ -55,6 +60,8 @@ private:
     u32 system_frames = 0;
     /// Cumulative number of game frames (GSP frame submissions) since last reset
     u32 game_frames = 0;
+    /// Cumulative number of system frames whose rendering was skipped since last reset
+    u32 skipped_frames = 0;
 
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
@@ -80,4 +87,64 @@ private:
     std::chrono::microseconds frame_limiting_delta_err{0};
 };
 
+/**
+ * Decides, once per system frame, whether rendering of the upcoming frame should be skipped because
+ * emulation is running slower than real time. Only draws targeting color buffers whose sole use is
+ * being transferred to a screen framebuffer are skipped, so render-to-texture, display transfers
+ * and interrupts are unaffected. The renderer keeps the previous image on screen in place of a
+ * skipped frame.
+ */
+class FrameSkipper {
+public:
+    /**
+     * Makes the skip decision for the frame that is about to begin. Must be called at the start of
+     * every system frame, after PerfStats::BeginSystemFrame.
+     */
+    void BeginFrame(PerfStats& perf_stats);
+
+    /**
+     * Makes the skip decision for the frame that is about to begin.
+     * @param last_frame_time_scale Time the previous frame took, relative to real time
+     * @param max_frame_skip Maximum number of consecutive frames to skip, 0 disables skipping
+     * @return Whether the frame is skipped
+     */
+    bool BeginFrame(double last_frame_time_scale, u32 max_frame_skip);
+
+    /// Returns whether frame skipping is enabled. Buffer uses only need to be reported if it is.
+    bool IsEnabled() const {
+        return enabled;
+    }
+
+    /// Returns whether rendering to presented buffers is being skipped in the current frame
+    bool IsSkippingFrame() const {
+        return skipping_frame;
+    }
+
+    /// Records the source of a display transfer into a screen framebuffer
+    void NotifyPresentTransfer(PAddr src_addr);
+
+    /**
+     * Records that a buffer is read by something other than a transfer to the screen, e.g. used as
+     * a texture or copied elsewhere. Draws into it are never skipped from then on.
+     */
+    void NotifyBufferRead(PAddr addr);
+
+    /// Returns whether the given color buffer has recently only been presented
+    bool IsPresentedBuffer(PAddr color_buffer_addr) const;
+
+private:
+    /// Whether frame skipping was enabled at the start of the current system frame
+    bool enabled = false;
+    /// Whether the current system frame is being skipped
+    bool skipping_frame = false;
+    /// Number of consecutive system frames skipped up to and including the current one
+    u32 consecutive_skips = 0;
+
+    /// Recently presented color buffers. Enough for double-buffering both screens.
+    std::array<PAddr, 4> presented_buffers{};
+    size_t next_presented_buffer = 0;
+    /// Buffers that have been read other than by a transfer to the screen
+    std::unordered_set<PAddr> read_buffers;
+};
+
 } // namespace Core
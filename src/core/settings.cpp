@@ -31,6 +31,7 @@ void Apply() {
 
     AudioCore::SelectSink(values.sink_id);
     AudioCore::EnableStretching(values.enable_audio_stretching);
+    AudioCore::EnableAudioThread(values.enable_audio_thread);
 
     Service::HID::ReloadInputDevices();
     Service::IR::ReloadInputDevices();
@@ -95,9 +95,14 @@ struct Values {
     // Renderer
     bool use_hw_renderer;
     bool use_shader_jit;
+    bool use_async_gpu;
+    bool use_disk_shader_cache;
     float resolution_factor;
     bool use_vsync;
     bool toggle_framelimit;
+    int max_frame_skip;
+    bool use_null_renderer;
+    bool skip_rasterization;
 
     LayoutOption layout_option;
     bool swap_screen;
@@ -120,6 +125,7 @@ struct Values {
     // Audio
     std::string sink_id;
     bool enable_audio_stretching;
+    bool enable_audio_thread;
     std::string audio_device_id;
 
     // Camera
@@ -129,6 +135,8 @@ struct Values {
     // Debugging
     bool use_gdbstub;
     u16 gdbstub_port;
+    bool dump_ipc_profile;
+    bool record_trace;
 
     // Movie
     std::string movie_play;
@@ -4,9 +4,11 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <mutex>
 #include <random>
 #include <thread>
+#include <unordered_map>
 #include "enet/enet.h"
 #include "network/packet.h"
 #include "network/room.h"
@@ -16,6 +18,18 @@ namespace Network {
 /// Maximum number of concurrent connections allowed to this room.
 static constexpr u32 MaxConcurrentConnections = 10;
 
+/// Offset of the destination address in a wifi packet: message type, frame type, channel and
+/// transmitter address come before it.
+static constexpr size_t WifiPacketDestinationOffset = 3 * sizeof(u8) + sizeof(MacAddress);
+
+struct MacAddressHash {
+    size_t operator()(const MacAddress& address) const {
+        u64 value = 0;
+        std::memcpy(&value, address.data(), address.size());
+        return std::hash<u64>()(value);
+    }
+};
+
 class Room::RoomImpl {
 public:
     // This MAC address is used to generate a 'Nintendo' like Mac address.
@@ -38,6 +52,12 @@ public:
     mutable std::mutex member_mutex; ///< Mutex for locking the members list
     /// This should be a std::shared_mutex as soon as C++17 is supported
 
+    /// The peers of the members, indexed by MAC address and in a flat list for broadcasts. Members
+    /// only join and leave on the room thread, which is also the only one forwarding packets, so
+    /// these are used without holding member_mutex.
+    std::unordered_map<MacAddress, ENetPeer*, MacAddressHash> peers_by_mac;
+    std::vector<ENetPeer*> member_peers;
+
     RoomImpl()
         : random_gen(std::random_device()()), NintendoOUI{0x00, 0x1F, 0x32, 0x00, 0x00, 0x00} {}
 
@@ -48,6 +68,12 @@ public:
     void ServerLoop();
     void StartLoop();
 
+    /**
+     * Handles a received ENet event.
+     * @param event The ENet event that was received.
+     */
+    void HandleEvent(const ENetEvent* event);
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -114,7 +140,8 @@ public:
     MacAddress GenerateMacAddress();
 
     /**
-     * Broadcasts this packet to all members except the sender.
+     * Forwards this packet to its destination, or to all members except the sender if it is a
+     * broadcast. The received ENet packet is sent as is, without copying it.
      * @param event The ENet event containing the data
      */
     void HandleWifiPacket(const ENetEvent* event);
@@ -143,34 +170,45 @@ void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
         ENetEvent event;
         if (enet_host_service(server, &event, 100) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameNamePacket(&event);
-                    break;
-                case IdWifiPacket:
-                    HandleWifiPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            }
+            // Handle all pending events before sending the packets queued while handling them, so
+            // that a burst of forwarded frames goes out in as few datagrams as possible
+            do {
+                HandleEvent(&event);
+            } while (enet_host_service(server, &event, 0) > 0);
+            enet_host_flush(server);
         }
     }
     // Close the connection to all members:
     SendCloseMessage();
 }
 
+void Room::RoomImpl::HandleEvent(const ENetEvent* event) {
+    switch (event->type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        switch (event->packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(event);
+            break;
+        case IdSetGameInfo:
+            HandleGameNamePacket(event);
+            break;
+        case IdWifiPacket:
+            HandleWifiPacket(event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(event);
+            break;
+        }
+        // Forwarded packets are destroyed by ENet once they have been sent to every receiver
+        if (event->packet->referenceCount == 0)
+            enet_packet_destroy(event->packet);
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event->peer);
+        break;
+    }
+}
+
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
@@ -219,6 +257,8 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         std::lock_guard<std::mutex> lock(member_mutex);
         members.push_back(std::move(member));
     }
+    peers_by_mac[preferred_mac] = event->peer;
+    member_peers.push_back(event->peer);
 
     // Notify everyone that the room information has changed.
     BroadcastRoomInformation();
@@ -332,37 +372,30 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
 }
 
 void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+    ENetPacket* enet_packet = event->packet;
+    if (enet_packet->dataLength < WifiPacketDestinationOffset + sizeof(MacAddress))
+        return; // Too short to be a wifi packet
     MacAddress destination_address;
-    in_packet >> destination_address;
+    std::memcpy(destination_address.data(), enet_packet->data + WifiPacketDestinationOffset,
+                destination_address.size());
 
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    // Forward the frame as reliably as the sender sent it, on the same channel if the receiver
+    // has it, otherwise on the control channel
+    auto channel_for = [event](const ENetPeer* peer) -> u8 {
+        return event->channelID < peer->channelCount ? event->channelID : ControlChannel;
+    };
 
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
-        std::lock_guard<std::mutex> lock(member_mutex);
-        for (const auto& member : members) {
-            if (member.peer != event->peer)
-                enet_peer_send(member.peer, 0, enet_packet);
+        for (ENetPeer* peer : member_peers) {
+            if (peer != event->peer)
+                enet_peer_send(peer, channel_for(peer), enet_packet);
         }
     } else { // Send the data only to the destination client
-        std::lock_guard<std::mutex> lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member) -> bool {
-                                       return member.mac_address == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        const auto peer = peers_by_mac.find(destination_address);
+        if (peer != peers_by_mac.end()) {
+            enet_peer_send(peer->second, channel_for(peer->second), enet_packet);
         }
     }
-    enet_host_flush(server);
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
@@ -422,11 +455,16 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
     // Remove the client from the members list.
     {
         std::lock_guard<std::mutex> lock(member_mutex);
-        members.erase(
-            std::remove_if(members.begin(), members.end(),
-                           [client](const Member& member) { return member.peer == client; }),
-            members.end());
+        auto member =
+            std::find_if(members.begin(), members.end(),
+                         [client](const Member& member) { return member.peer == client; });
+        if (member != members.end()) {
+            peers_by_mac.erase(member->mac_address);
+            members.erase(member);
+        }
     }
+    member_peers.erase(std::remove(member_peers.begin(), member_peers.end(), client),
+                       member_peers.end());
 
     // Announce the change to all clients.
     enet_peer_disconnect(client, 0);
@@ -490,6 +528,8 @@ void Room::Destroy() {
         std::lock_guard<std::mutex> lock(room_impl->member_mutex);
         room_impl->members.clear();
     }
+    room_impl->peers_by_mac.clear();
+    room_impl->member_peers.clear();
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
 }
@@ -15,7 +15,17 @@ namespace Network {
 constexpr u32 network_version = 1; ///< The version of this Room and RoomMember
 
 constexpr u16 DefaultRoomPort = 1234;
-constexpr size_t NumChannels = 1; // Number of channels used for the connection
+constexpr size_t NumChannels = 2; // Number of channels used for the connection
+
+/**
+ * Channels of the connection. Reliable packets are delivered in order on the control channel,
+ * while beacons and data frames are sent unreliably on their own channel, so that they are
+ * neither retransmitted nor held back behind a lost reliable packet.
+ */
+enum RoomChannels : u8 {
+    ControlChannel = 0,
+    WifiDataChannel = 1,
+};
 
 struct RoomInformation {
     std::string name; ///< Name of the server
@@ -2,12 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
 #include <list>
 #include <mutex>
 #include <set>
 #include <thread>
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
 #include "network/room_member.h"
@@ -15,6 +17,10 @@
 namespace Network {
 
 constexpr u32 ConnectionTimeoutMs = 5000;
+/// Longest time the loop thread waits for network traffic before checking the connection state
+constexpr u32 LoopWaitTimeoutMs = 100;
+/// How often packets are sent when the wakeup socket is unavailable and the loop has to poll
+constexpr u32 LoopPollIntervalMs = 5;
 
 class RoomMember::RoomMemberImpl {
 public:
@@ -39,8 +45,20 @@ public:
     std::mutex network_mutex; ///< Mutex that controls access to the `client` variable.
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> loop_thread;
-    std::mutex send_list_mutex;  ///< Mutex that controls access to the `send_list` variable.
-    std::list<Packet> send_list; ///< A list that stores all packets to send the async
+
+    struct OutgoingPacket {
+        Packet packet;
+        bool reliable; ///< Whether ENet resends the packet until it is acknowledged
+    };
+    std::mutex send_list_mutex; ///< Mutex that controls access to the `send_list` variable.
+    /// A list that stores all packets to send the async
+    std::list<OutgoingPacket> send_list;
+
+    /// Loopback socket the loop thread waits on next to the connection, written to in order to
+    /// wake it up as soon as there is something to send.
+    ENetSocket wakeup_socket = ENET_SOCKET_NULL;
+    ENetAddress wakeup_address{};            ///< Address the wakeup socket is bound to.
+    std::atomic<bool> wakeup_pending{false}; ///< Whether a wakeup datagram is on its way.
 
     template <typename T>
     using CallbackSet = std::set<CallbackHandle<T>>;
@@ -64,10 +82,37 @@ public:
     void StartLoop();
 
     /**
-     * Sends data to the room. It will be send on channel 0 with flag RELIABLE
+     * Handles a received ENet event.
+     * @param event The ENet event that was received.
+     */
+    void HandleEvent(const ENetEvent* event);
+
+    /**
+     * Creates the loopback socket used to wake up the loop thread. Without it, the loop thread
+     * falls back to polling for packets to send.
+     */
+    void CreateWakeupSocket();
+
+    /// Interrupts the wait of the loop thread, to have it send the queued packets or exit.
+    void Wakeup();
+
+    /**
+     * Waits until data arrives on the connection, the loop thread is woken up, or the timeout
+     * expires.
+     * @param timeout_ms The maximum time to wait, in milliseconds.
+     */
+    void WaitForEvents(u32 timeout_ms);
+
+    /// Hands the queued packets to ENet and sends them right away.
+    void FlushSendList();
+
+    /**
+     * Sends data to the room. Reliable packets are sent in order on the control channel,
+     * unreliable ones on the wifi data channel if the room supports it.
      * @param packet The data to send
+     * @param reliable Whether the packet has to be resent until it is received
      */
-    void Send(Packet&& packet);
+    void Send(Packet&& packet, bool reliable = true);
 
     /**
      * Sends a request to the server, asking for permission to join a room with the specified
@@ -127,72 +172,150 @@ bool RoomMember::RoomMemberImpl::IsConnected() const {
 }
 
 void RoomMember::RoomMemberImpl::MemberLoop() {
-    // Receive packets while the connection is open
+    // Receive packets while the connection is open. The lock is only held while servicing the
+    // connection, never while waiting, so that queued packets are sent as soon as they come in
     while (IsConnected()) {
+        WaitForEvents(wakeup_socket != ENET_SOCKET_NULL ? LoopWaitTimeoutMs : LoopPollIntervalMs);
+
         std::lock_guard<std::mutex> lock(network_mutex);
         ENetEvent event;
-        if (enet_host_service(client, &event, 100) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdWifiPacket:
-                    HandleWifiPackets(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                case IdRoomInformation:
-                    HandleRoomInformationPacket(&event);
-                    break;
-                case IdJoinSuccess:
-                    // The join request was successful, we are now in the room.
-                    // If we joined successfully, there must be at least one client in the room: us.
-                    ASSERT_MSG(member_information.size() > 0,
-                               "We have not yet received member information.");
-                    HandleJoinPacket(&event); // Get the MAC Address for the client
-                    SetState(State::Joined);
-                    break;
-                case IdNameCollision:
-                    SetState(State::NameCollision);
-                    break;
-                case IdMacCollision:
-                    SetState(State::MacCollision);
-                    break;
-                case IdVersionMismatch:
-                    SetState(State::WrongVersion);
-                    break;
-                case IdCloseRoom:
-                    SetState(State::LostConnection);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                SetState(State::LostConnection);
-                break;
-            }
-        }
-        {
-            std::lock_guard<std::mutex> lock(send_list_mutex);
-            for (const auto& packet : send_list) {
-                ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
-                                                            ENET_PACKET_FLAG_RELIABLE);
-                enet_peer_send(server, 0, enetPacket);
-            }
-            enet_host_flush(client);
-            send_list.clear();
+        while (enet_host_service(client, &event, 0) > 0) {
+            HandleEvent(&event);
         }
+        FlushSendList();
     }
     Disconnect();
 };
 
+void RoomMember::RoomMemberImpl::HandleEvent(const ENetEvent* event) {
+    switch (event->type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        switch (event->packet->data[0]) {
+        case IdWifiPacket:
+            HandleWifiPackets(event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(event);
+            break;
+        case IdRoomInformation:
+            HandleRoomInformationPacket(event);
+            break;
+        case IdJoinSuccess:
+            // The join request was successful, we are now in the room.
+            // If we joined successfully, there must be at least one client in the room: us.
+            ASSERT_MSG(member_information.size() > 0,
+                       "We have not yet received member information.");
+            HandleJoinPacket(event); // Get the MAC Address for the client
+            SetState(State::Joined);
+            break;
+        case IdNameCollision:
+            SetState(State::NameCollision);
+            break;
+        case IdMacCollision:
+            SetState(State::MacCollision);
+            break;
+        case IdVersionMismatch:
+            SetState(State::WrongVersion);
+            break;
+        case IdCloseRoom:
+            SetState(State::LostConnection);
+            break;
+        }
+        enet_packet_destroy(event->packet);
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        SetState(State::LostConnection);
+        break;
+    }
+}
+
+void RoomMember::RoomMemberImpl::CreateWakeupSocket() {
+    wakeup_socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+    if (wakeup_socket == ENET_SOCKET_NULL) {
+        LOG_WARNING(Network, "Could not create the wakeup socket, polling for packets to send");
+        return;
+    }
+    enet_address_set_host(&wakeup_address, "127.0.0.1");
+    wakeup_address.port = 0;
+    if (enet_socket_bind(wakeup_socket, &wakeup_address) != 0 ||
+        enet_socket_get_address(wakeup_socket, &wakeup_address) != 0 ||
+        enet_socket_set_option(wakeup_socket, ENET_SOCKOPT_NONBLOCK, 1) != 0) {
+        LOG_WARNING(Network, "Could not bind the wakeup socket, polling for packets to send");
+        enet_socket_destroy(wakeup_socket);
+        wakeup_socket = ENET_SOCKET_NULL;
+    }
+}
+
+void RoomMember::RoomMemberImpl::Wakeup() {
+    // A single pending datagram is enough, the loop thread sends everything that was queued
+    // before it drained the socket
+    if (wakeup_socket == ENET_SOCKET_NULL || wakeup_pending.exchange(true))
+        return;
+    u8 data = 0;
+    ENetBuffer buffer;
+    buffer.data = &data;
+    buffer.dataLength = sizeof(data);
+    enet_socket_send(wakeup_socket, &wakeup_address, &buffer, 1);
+}
+
+void RoomMember::RoomMemberImpl::WaitForEvents(u32 timeout_ms) {
+    ENetSocketSet read_set;
+    ENET_SOCKETSET_EMPTY(read_set);
+    ENET_SOCKETSET_ADD(read_set, client->socket);
+    if (wakeup_socket != ENET_SOCKET_NULL)
+        ENET_SOCKETSET_ADD(read_set, wakeup_socket);
+
+    const ENetSocket max_socket = wakeup_socket != ENET_SOCKET_NULL
+                                      ? std::max(client->socket, wakeup_socket)
+                                      : client->socket;
+    if (enet_socketset_select(max_socket, &read_set, nullptr, timeout_ms) <= 0)
+        return;
+
+    if (wakeup_socket != ENET_SOCKET_NULL && ENET_SOCKETSET_CHECK(read_set, wakeup_socket)) {
+        wakeup_pending = false;
+        u8 data[16];
+        ENetBuffer buffer;
+        buffer.data = data;
+        buffer.dataLength = sizeof(data);
+        ENetAddress sender;
+        while (enet_socket_receive(wakeup_socket, &sender, &buffer, 1) > 0) {
+        }
+    }
+}
+
+void RoomMember::RoomMemberImpl::FlushSendList() {
+    std::list<OutgoingPacket> packets;
+    {
+        std::lock_guard<std::mutex> lock(send_list_mutex);
+        packets.swap(send_list);
+    }
+    if (packets.empty())
+        return;
+
+    // Rooms of older versions only open the control channel
+    const bool has_data_channel = server->channelCount > WifiDataChannel;
+    for (const auto& outgoing : packets) {
+        const Packet& packet = outgoing.packet;
+        ENetPacket* enet_packet =
+            enet_packet_create(packet.GetData(), packet.GetDataSize(),
+                               outgoing.reliable ? ENET_PACKET_FLAG_RELIABLE : 0);
+        const u8 channel =
+            outgoing.reliable || !has_data_channel ? ControlChannel : WifiDataChannel;
+        enet_peer_send(server, channel, enet_packet);
+    }
+    enet_host_flush(client);
+}
+
 void RoomMember::RoomMemberImpl::StartLoop() {
     loop_thread = std::make_unique<std::thread>(&RoomMember::RoomMemberImpl::MemberLoop, this);
 }
 
-void RoomMember::RoomMemberImpl::Send(Packet&& packet) {
-    std::lock_guard<std::mutex> lock(send_list_mutex);
-    send_list.push_back(std::move(packet));
+void RoomMember::RoomMemberImpl::Send(Packet&& packet, bool reliable) {
+    {
+        std::lock_guard<std::mutex> lock(send_list_mutex);
+        send_list.push_back({std::move(packet), reliable});
+    }
+    Wakeup();
 }
 
 void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
@@ -351,10 +474,13 @@ RoomMember::CallbackHandle<T> RoomMember::RoomMemberImpl::Bind(
 RoomMember::RoomMember() : room_member_impl{std::make_unique<RoomMemberImpl>()} {
     room_member_impl->client = enet_host_create(nullptr, 1, NumChannels, 0, 0);
     ASSERT_MSG(room_member_impl->client != nullptr, "Could not create client");
+    room_member_impl->CreateWakeupSocket();
 }
 
 RoomMember::~RoomMember() {
     ASSERT_MSG(!IsConnected(), "RoomMember is being destroyed while connected");
+    if (room_member_impl->wakeup_socket != ENET_SOCKET_NULL)
+        enet_socket_destroy(room_member_impl->wakeup_socket);
     enet_host_destroy(room_member_impl->client);
 }
 
@@ -384,6 +510,7 @@ void RoomMember::Join(const std::string& nick, const char* server_addr, u16 serv
     // If the member is connected, kill the connection first
     if (room_member_impl->loop_thread && room_member_impl->loop_thread->joinable()) {
         room_member_impl->SetState(State::Error);
+        room_member_impl->Wakeup();
         room_member_impl->loop_thread->join();
         room_member_impl->loop_thread.reset();
     }
@@ -428,7 +555,11 @@ void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet) {
     packet << wifi_packet.transmitter_address;
     packet << wifi_packet.destination_address;
     packet << wifi_packet.data;
-    room_member_impl->Send(std::move(packet));
+    // Like on a real wireless network, beacons and data frames may get lost, the games already
+    // handle that. Only the connection setup frames have to arrive.
+    const bool reliable = wifi_packet.type != WifiPacket::PacketType::Beacon &&
+                          wifi_packet.type != WifiPacket::PacketType::Data;
+    room_member_impl->Send(std::move(packet), reliable);
 }
 
 void RoomMember::SendChatMessage(const std::string& message) {
@@ -478,6 +609,7 @@ void RoomMember::Unbind(CallbackHandle<T> handle) {
 
 void RoomMember::Leave() {
     room_member_impl->SetState(State::Idle);
+    room_member_impl->Wakeup();
     room_member_impl->loop_thread->join();
     room_member_impl->loop_thread.reset();
 }
@@ -0,0 +1,76 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <catch.hpp>
+#include "audio_core/hle/dsp.h"
+#include "audio_core/null_sink.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+
+namespace DSP {
+namespace HLE {
+
+using Configuration = SourceConfiguration::Configuration;
+
+/// Queues a silent PCM16 mono buffer of `length` samples in slot `slot` of `config`.
+static void QueueBuffer(Configuration& config, size_t slot, u16 buffer_id, u32 length) {
+    auto& buffer = config.buffers[slot];
+    buffer.physical_address = Memory::VRAM_PADDR;
+    buffer.length = length;
+    buffer.adpcm_dirty = 0;
+    buffer.is_looping = 0;
+    buffer.buffer_id = buffer_id;
+    config.buffers_dirty = config.buffers_dirty | (1 << slot);
+    config.buffer_queue_dirty.Assign(1);
+}
+
+TEST_CASE("DSP::HLE::Tick on the audio thread consumes queued buffers once", "[audio_core][hle]") {
+    // The queued buffers are read from VRAM, which starts out silent
+    Memory::InitPhysicalMemory();
+    std::memset(&g_dsp_memory, 0, sizeof(g_dsp_memory));
+    // The DSP reads from region 0 and publishes its results to region 1.
+    g_dsp_memory.region_0.frame_counter = 1;
+    SharedMemory& read = g_dsp_memory.region_0;
+    SharedMemory& write = g_dsp_memory.region_1;
+
+    Init();
+    SetSink(std::make_unique<AudioCore::NullSink>());
+    EnableAudioThread(true);
+
+    Configuration& config = read.source_configurations.config[0];
+    config.enable = 1;
+    config.enable_dirty.Assign(1);
+    config.format.Assign(Configuration::Format::PCM16);
+    config.format_dirty.Assign(1);
+    config.mono_or_stereo.Assign(Configuration::MonoOrStereo::Mono);
+    config.mono_or_stereo_dirty.Assign(1);
+    config.interpolation_mode = Configuration::InterpolationMode::None;
+    config.interpolation_dirty.Assign(1);
+
+    // Buffer 2 plays out within the first frame.
+    QueueBuffer(config, 0, 2, samples_per_frame / 2);
+    Tick();
+    CHECK(config.dirty_raw == 0);
+    CHECK(config.buffers_dirty == 0);
+
+    // Buffer 1 spans the second and third frames. Had buffer 2 been queued again alongside it,
+    // it would start playing once buffer 1 finishes in the third frame.
+    QueueBuffer(config, 1, 1, samples_per_frame + samples_per_frame / 4);
+    Tick();
+    CHECK(config.buffers_dirty == 0);
+    Tick();
+    Shutdown();
+
+    const auto& status = write.source_statuses.status[0];
+    CHECK(status.is_enabled == 1);
+    CHECK(status.current_buffer_id == 1);
+
+    EnableAudioThread(false);
+    Memory::ShutdownPhysicalMemory();
+}
+
+} // namespace HLE
+} // namespace DSP
@@ -0,0 +1,25 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <catch.hpp>
+#include "common/hash.h"
+
+namespace Common {
+
+static u64 HashString(const char* str) {
+    return XXHash64(str, std::strlen(str), 0);
+}
+
+TEST_CASE("XXHash64", "[common]") {
+    // Short inputs only go through the tail, long ones through the four lanes as well
+    REQUIRE(HashString("") == 0xEF46DB3751D8E999);
+    REQUIRE(HashString("a") == 0xD24EC4F1A98C6E5B);
+    REQUIRE(HashString("abc") == 0x44BC2CF5AD770999);
+    REQUIRE(HashString("message digest") == 0x066ED728FCEEB3BE);
+    REQUIRE(HashString("abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ") ==
+            0xD5000C4AC53D14A0);
+}
+
+} // namespace Common
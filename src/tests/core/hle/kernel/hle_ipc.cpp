@@ -11,6 +11,7 @@
 #include "core/hle/kernel/hle_ipc.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/memory.h"
 
 namespace Kernel {
 
@@ -136,6 +137,45 @@ TEST_CASE("HLERequestContext::PopulateFromIncomingCommandBuffer", "[core][kernel
         REQUIRE(context.GetIncomingHandle(output[4]) == a);
         REQUIRE(output[6] == process->process_id);
     }
+
+    SECTION("translates mapped buffers spanning pages") {
+        auto block = std::make_shared<std::vector<u8>>(2 * Memory::PAGE_SIZE);
+        for (size_t j = 0; j < block->size(); ++j)
+            (*block)[j] = static_cast<u8>(j);
+        const VAddr target = Memory::HEAP_VADDR;
+        process->vm_manager
+            .MapMemoryBlock(target, block, 0, static_cast<u32>(block->size()), MemoryState::Private)
+            .Unwrap();
+
+        const VAddr buffer_address = target + Memory::PAGE_SIZE - 8;
+        const u32_le input[]{
+            IPC::MakeHeader(0, 0, 2), IPC::MappedBufferDesc(16, IPC::MappedBufferPermissions::RW),
+            buffer_address,
+        };
+
+        context.PopulateFromIncomingCommandBuffer(input, *process, handle_table);
+
+        REQUIRE(context.CommandBuffer()[2] == buffer_address);
+        auto& buffer = context.GetMappedBuffer(2);
+        REQUIRE(buffer.GetAddress() == buffer_address);
+        REQUIRE(buffer.GetSize() == 16);
+
+        // Both pages are backed by the same host block, so the buffer resolves to a single span
+        const auto& spans = buffer.GetHostSpans();
+        REQUIRE(spans.size() == 1);
+        REQUIRE(spans[0].pointer == block->data() + Memory::PAGE_SIZE - 8);
+        REQUIRE(spans[0].size == 16);
+
+        u8 data[4];
+        buffer.Read(data, 6, sizeof(data));
+        REQUIRE(data[0] == static_cast<u8>(Memory::PAGE_SIZE - 2));
+        REQUIRE(data[3] == static_cast<u8>(Memory::PAGE_SIZE + 1));
+
+        const u8 new_data[2] = {0xAA, 0xBB};
+        buffer.Write(new_data, 7, sizeof(new_data));
+        REQUIRE((*block)[Memory::PAGE_SIZE - 1] == 0xAA);
+        REQUIRE((*block)[Memory::PAGE_SIZE] == 0xBB);
+    }
 }
 
 TEST_CASE("HLERequestContext::WriteToOutgoingCommandBuffer", "[core][kernel]") {
@@ -0,0 +1,63 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <catch.hpp>
+#include "core/hle/service/ipc_profiler.h"
+
+namespace Service {
+namespace IPCProfiler {
+
+TEST_CASE("IPCProfiler aggregates calls per service and command", "[core][service]") {
+    Reset();
+    const int service_a = 0, service_b = 0;
+    const std::string name_a = "srv:a", name_b = "srv:b";
+
+    RecordCall(&service_a, name_a, "Foo", 0x00010000, 1000, 10);
+    RecordCall(&service_a, name_a, "Foo", 0x00010000, 3000, 30);
+    RecordCall(&service_a, name_a, "Bar", 0x00020040, 1, 0);
+    RecordCall(&service_b, name_b, "Foo", 0x00010000, 500, 0);
+
+    const auto stats = GetStats();
+    REQUIRE(stats.size() == 3);
+
+    const CallStats* foo_a = nullptr;
+    for (const auto& entry : stats) {
+        if (entry.service_name == name_a && entry.command_header == 0x00010000)
+            foo_a = &entry;
+    }
+    REQUIRE(foo_a != nullptr);
+    CHECK(foo_a->function_name == "Foo");
+    CHECK(foo_a->num_calls == 2);
+    CHECK(foo_a->total_host_ns == 4000);
+    CHECK(foo_a->max_host_ns == 3000);
+    CHECK(foo_a->total_cycles == 40);
+    // Bucket N counts calls of [2^N, 2^(N+1)) ns
+    CHECK(foo_a->host_ns_histogram[9] == 1);
+    CHECK(foo_a->host_ns_histogram[11] == 1);
+
+    Reset();
+    CHECK(GetStats().empty());
+}
+
+TEST_CASE("IPCProfiler escapes names in its reports", "[core][service]") {
+    CallStats entry;
+    entry.service_name = "a\"b\\c,d";
+    entry.function_name = "Func\n";
+    entry.command_header = 0x00010040;
+    entry.num_calls = 1;
+
+    const std::string json = FormatJSON({entry});
+    CHECK(json.find("\"service\": \"a\\\"b\\\\c,d\"") != std::string::npos);
+    CHECK(json.find("\"function\": \"Func\\u000a\"") != std::string::npos);
+    CHECK(json.find("\"header\": 65600") != std::string::npos);
+
+    const std::string csv = FormatCSV({entry});
+    CHECK(csv.find("\n\"a\"\"b\\c,d\",\"Func\n\",0x00010040,1,0,0,0,") != std::string::npos);
+
+    CHECK(FormatJSON({}) == "[\n]\n");
+}
+
+} // namespace IPCProfiler
+} // namespace Service
@@ -6,6 +6,7 @@
 #include "core/hle/kernel/memory.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
+#include "core/memory_setup.h"
 
 TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
     SECTION("these regions should not be mapped on an empty process") {
@@ -29,9 +30,11 @@ TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
     SECTION("special regions should be valid after mapping them") {
         auto process = Kernel::Process::Create(Kernel::CodeSet::Create("", 0));
         SECTION("VRAM") {
+            Memory::InitPhysicalMemory();
             Kernel::HandleSpecialMapping(process->vm_manager,
                                          {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
             CHECK(Memory::IsValidVirtualAddress(*process, Memory::VRAM_VADDR) == true);
+            Memory::ShutdownPhysicalMemory();
         }
 
         SECTION("IO (Not yet implemented)") {
@@ -0,0 +1,82 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+#include "core/perf_stats.h"
+
+namespace Core {
+
+constexpr double FULL_SPEED = 1.0;
+constexpr double SLOW = 1.5;
+constexpr PAddr RENDER_TARGET = 0x18000000;
+constexpr PAddr TEXTURE_TARGET = 0x18100000;
+
+TEST_CASE("FrameSkipper never skips when disabled", "[core]") {
+    FrameSkipper skipper;
+    for (int frame = 0; frame < 4; ++frame) {
+        CHECK_FALSE(skipper.BeginFrame(SLOW, 0));
+        CHECK_FALSE(skipper.IsEnabled());
+    }
+
+    // Buffer uses are not tracked either
+    skipper.NotifyPresentTransfer(RENDER_TARGET);
+    CHECK_FALSE(skipper.IsPresentedBuffer(RENDER_TARGET));
+}
+
+TEST_CASE("FrameSkipper skips slow frames up to the limit", "[core]") {
+    FrameSkipper skipper;
+
+    // The first enabled frame only observes buffer uses
+    CHECK_FALSE(skipper.BeginFrame(SLOW, 2));
+    CHECK(skipper.IsEnabled());
+
+    CHECK(skipper.BeginFrame(SLOW, 2));
+    CHECK(skipper.IsSkippingFrame());
+    CHECK(skipper.BeginFrame(SLOW, 2));
+    CHECK_FALSE(skipper.BeginFrame(SLOW, 2));
+    CHECK(skipper.BeginFrame(SLOW, 2));
+
+    CHECK_FALSE(skipper.BeginFrame(FULL_SPEED, 2));
+    CHECK_FALSE(skipper.IsSkippingFrame());
+}
+
+TEST_CASE("FrameSkipper only drops draws into presented buffers", "[core]") {
+    FrameSkipper skipper;
+    skipper.BeginFrame(FULL_SPEED, 1);
+
+    SECTION("buffers transferred to the screen are presented") {
+        skipper.NotifyPresentTransfer(RENDER_TARGET);
+        CHECK(skipper.IsPresentedBuffer(RENDER_TARGET));
+        CHECK_FALSE(skipper.IsPresentedBuffer(TEXTURE_TARGET));
+        CHECK_FALSE(skipper.IsPresentedBuffer(0));
+    }
+
+    SECTION("buffers read otherwise are never presented again") {
+        skipper.NotifyPresentTransfer(TEXTURE_TARGET);
+        skipper.NotifyBufferRead(TEXTURE_TARGET);
+        CHECK_FALSE(skipper.IsPresentedBuffer(TEXTURE_TARGET));
+        skipper.NotifyPresentTransfer(TEXTURE_TARGET);
+        CHECK_FALSE(skipper.IsPresentedBuffer(TEXTURE_TARGET));
+    }
+
+    SECTION("only the most recently presented buffers are kept") {
+        for (PAddr i = 0; i < 5; ++i) {
+            skipper.NotifyPresentTransfer(RENDER_TARGET + i * 0x1000);
+        }
+        CHECK_FALSE(skipper.IsPresentedBuffer(RENDER_TARGET));
+        CHECK(skipper.IsPresentedBuffer(RENDER_TARGET + 4 * 0x1000));
+    }
+
+    SECTION("tracking restarts when skipping is enabled again") {
+        skipper.NotifyBufferRead(TEXTURE_TARGET);
+        skipper.NotifyPresentTransfer(RENDER_TARGET);
+        skipper.BeginFrame(SLOW, 0);
+        CHECK_FALSE(skipper.BeginFrame(SLOW, 1));
+        CHECK_FALSE(skipper.IsPresentedBuffer(RENDER_TARGET));
+        skipper.NotifyPresentTransfer(TEXTURE_TARGET);
+        CHECK(skipper.IsPresentedBuffer(TEXTURE_TARGET));
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,247 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch.hpp>
+#include "common/assert.h"
+#include "common/color.h"
+#include "core/hw/gpu.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+#include "video_core/pica_state.h"
+#include "video_core/regs_framebuffer.h"
+#include "video_core/swrasterizer/framebuffer.h"
+#include "video_core/utils.h"
+
+namespace Pica {
+namespace Rasterizer {
+
+using FramebufferConfig = FramebufferRegs::FramebufferConfig;
+
+// Framebuffer accesses as they were done directly from the registers, before the render targets
+// were resolved into ColorTarget and DepthTarget. The targets must match them exactly.
+
+static u8* ReferenceColorPointer(const FramebufferConfig& framebuffer, int x, int y) {
+    // Similarly to textures, the render framebuffer is laid out from bottom to top, too.
+    // NOTE: The framebuffer height register contains the actual FB height minus one.
+    y = framebuffer.height - y;
+
+    const u32 coarse_y = y & ~7;
+    u32 bytes_per_pixel =
+        GPU::Regs::BytesPerPixel(GPU::Regs::PixelFormat(framebuffer.color_format.Value()));
+    u32 offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) +
+                 coarse_y * framebuffer.width * bytes_per_pixel;
+    return Memory::GetPhysicalPointer(framebuffer.GetColorBufferPhysicalAddress()) + offset;
+}
+
+static u8* ReferenceDepthPointer(const FramebufferConfig& framebuffer, int x, int y) {
+    y = framebuffer.height - y;
+
+    const u32 coarse_y = y & ~7;
+    u32 bytes_per_pixel = FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
+    u32 stride = framebuffer.width * bytes_per_pixel;
+
+    u32 offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
+    return Memory::GetPhysicalPointer(framebuffer.GetDepthBufferPhysicalAddress()) + offset;
+}
+
+static void ReferenceDrawPixel(const FramebufferConfig& framebuffer, int x, int y,
+                               const Math::Vec4<u8>& color) {
+    u8* dst_pixel = ReferenceColorPointer(framebuffer, x, y);
+    switch (framebuffer.color_format) {
+    case FramebufferRegs::ColorFormat::RGBA8:
+        Color::EncodeRGBA8(color, dst_pixel);
+        break;
+    case FramebufferRegs::ColorFormat::RGB8:
+        Color::EncodeRGB8(color, dst_pixel);
+        break;
+    case FramebufferRegs::ColorFormat::RGB5A1:
+        Color::EncodeRGB5A1(color, dst_pixel);
+        break;
+    case FramebufferRegs::ColorFormat::RGB565:
+        Color::EncodeRGB565(color, dst_pixel);
+        break;
+    case FramebufferRegs::ColorFormat::RGBA4:
+        Color::EncodeRGBA4(color, dst_pixel);
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+static Math::Vec4<u8> ReferenceGetPixel(const FramebufferConfig& framebuffer, int x, int y) {
+    const u8* src_pixel = ReferenceColorPointer(framebuffer, x, y);
+    switch (framebuffer.color_format) {
+    case FramebufferRegs::ColorFormat::RGBA8:
+        return Color::DecodeRGBA8(src_pixel);
+    case FramebufferRegs::ColorFormat::RGB8:
+        return Color::DecodeRGB8(src_pixel);
+    case FramebufferRegs::ColorFormat::RGB5A1:
+        return Color::DecodeRGB5A1(src_pixel);
+    case FramebufferRegs::ColorFormat::RGB565:
+        return Color::DecodeRGB565(src_pixel);
+    case FramebufferRegs::ColorFormat::RGBA4:
+        return Color::DecodeRGBA4(src_pixel);
+    default:
+        UNREACHABLE();
+    }
+    return {0, 0, 0, 0};
+}
+
+static u32 ReferenceGetDepth(const FramebufferConfig& framebuffer, int x, int y) {
+    const u8* src_pixel = ReferenceDepthPointer(framebuffer, x, y);
+    switch (framebuffer.depth_format) {
+    case FramebufferRegs::DepthFormat::D16:
+        return Color::DecodeD16(src_pixel);
+    case FramebufferRegs::DepthFormat::D24:
+        return Color::DecodeD24(src_pixel);
+    case FramebufferRegs::DepthFormat::D24S8:
+        return Color::DecodeD24S8(src_pixel).x;
+    default:
+        UNREACHABLE();
+    }
+    return 0;
+}
+
+static u8 ReferenceGetStencil(const FramebufferConfig& framebuffer, int x, int y) {
+    const u8* src_pixel = ReferenceDepthPointer(framebuffer, x, y);
+    switch (framebuffer.depth_format) {
+    case FramebufferRegs::DepthFormat::D24S8:
+        return Color::DecodeD24S8(src_pixel).y;
+    default:
+        return 0;
+    }
+}
+
+static void ReferenceSetDepth(const FramebufferConfig& framebuffer, int x, int y, u32 value) {
+    u8* dst_pixel = ReferenceDepthPointer(framebuffer, x, y);
+    switch (framebuffer.depth_format) {
+    case FramebufferRegs::DepthFormat::D16:
+        Color::EncodeD16(value, dst_pixel);
+        break;
+    case FramebufferRegs::DepthFormat::D24:
+        Color::EncodeD24(value, dst_pixel);
+        break;
+    case FramebufferRegs::DepthFormat::D24S8:
+        Color::EncodeD24X8(value, dst_pixel);
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+static void ReferenceSetStencil(const FramebufferConfig& framebuffer, int x, int y, u8 value) {
+    u8* dst_pixel = ReferenceDepthPointer(framebuffer, x, y);
+    switch (framebuffer.depth_format) {
+    case FramebufferRegs::DepthFormat::D16:
+    case FramebufferRegs::DepthFormat::D24:
+        // Nothing to do
+        break;
+    case FramebufferRegs::DepthFormat::D24S8:
+        Color::EncodeX24S8(value, dst_pixel);
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+/// Packs a color into one integer, so that a mismatch reports both colors
+static u32 PackColor(const Math::Vec4<u8>& color) {
+    return color.r() | color.g() << 8 | color.b() << 16 | color.a() << 24;
+}
+
+/// Values read back after each access, and the contents of both buffers at the end
+struct AccessResults {
+    std::vector<u32> colors;
+    std::vector<u32> depths;
+    std::vector<u8> stencils;
+    std::vector<u8> memory;
+};
+
+constexpr PAddr COLOR_BUFFER_REGION = Memory::VRAM_PADDR;
+constexpr PAddr DEPTH_BUFFER_REGION = Memory::VRAM_PADDR + Memory::VRAM_SIZE / 2;
+/// Enough for a 480x480 buffer of 4 byte pixels placed up to 256 KiB into its region
+constexpr u32 BUFFER_REGION_SIZE = 0x140000;
+constexpr unsigned ACCESSES_PER_CONFIG = 2000;
+
+/**
+ * Writes random pixels, depths and stencils to the buffers and reads each back, with either the
+ * reference functions or the render targets. Both runs see the same accesses for the same seed.
+ */
+static AccessResults RunAccesses(const FramebufferConfig& framebuffer, bool reference, u32 seed) {
+    u8* color_region = Memory::GetPhysicalPointer(COLOR_BUFFER_REGION);
+    u8* depth_region = Memory::GetPhysicalPointer(DEPTH_BUFFER_REGION);
+    std::memset(color_region, 0, BUFFER_REGION_SIZE);
+    std::memset(depth_region, 0, BUFFER_REGION_SIZE);
+
+    std::mt19937 rng(seed);
+    AccessResults results;
+    const RenderTargets& targets = GetRenderTargets(framebuffer);
+    for (unsigned i = 0; i < ACCESSES_PER_CONFIG; ++i) {
+        const int x = rng() % framebuffer.width;
+        const int y = rng() % (framebuffer.height + 1);
+        const auto color = Math::MakeVec<u8>(rng(), rng(), rng(), rng());
+        const u32 depth = rng() & 0xFFFFFF;
+        const u8 stencil = rng();
+
+        if (reference) {
+            ReferenceDrawPixel(framebuffer, x, y, color);
+            ReferenceSetDepth(framebuffer, x, y, depth);
+            ReferenceSetStencil(framebuffer, x, y, stencil);
+            results.colors.push_back(PackColor(ReferenceGetPixel(framebuffer, x, y)));
+            results.depths.push_back(ReferenceGetDepth(framebuffer, x, y));
+            results.stencils.push_back(ReferenceGetStencil(framebuffer, x, y));
+        } else {
+            targets.color.DrawPixel(x, y, color);
+            targets.depth.SetDepth(x, y, depth);
+            targets.depth.SetStencil(x, y, stencil);
+            results.colors.push_back(PackColor(targets.color.GetPixel(x, y)));
+            results.depths.push_back(targets.depth.GetDepth(x, y));
+            results.stencils.push_back(targets.depth.GetStencil(x, y));
+        }
+    }
+
+    results.memory.assign(color_region, color_region + BUFFER_REGION_SIZE);
+    results.memory.insert(results.memory.end(), depth_region, depth_region + BUFFER_REGION_SIZE);
+    return results;
+}
+
+TEST_CASE("Render targets match the unresolved framebuffer accesses", "[video_core]") {
+    Memory::InitPhysicalMemory();
+    std::mt19937 rng(3);
+    // Accesses to buffers of unknown formats report the format in the registers
+    FramebufferConfig& framebuffer = g_state.regs.framebuffer.framebuffer;
+
+    for (int config = 0; config < 200; ++config) {
+        static const FramebufferRegs::DepthFormat depth_formats[] = {
+            FramebufferRegs::DepthFormat::D16, FramebufferRegs::DepthFormat::D24,
+            FramebufferRegs::DepthFormat::D24S8};
+        framebuffer.color_format.Assign(static_cast<FramebufferRegs::ColorFormat>(rng() % 5));
+        framebuffer.depth_format.Assign(depth_formats[rng() % 3]);
+        framebuffer.width.Assign(8 * (1 + rng() % 60));
+        framebuffer.height.Assign(rng() % 480);
+        framebuffer.color_buffer_address.Assign(COLOR_BUFFER_REGION / 8 + rng() % 0x8000);
+        framebuffer.depth_buffer_address.Assign(DEPTH_BUFFER_REGION / 8 + rng() % 0x8000);
+        InvalidateRenderTargets();
+
+        const u32 seed = rng();
+        const AccessResults expected = RunAccesses(framebuffer, true, seed);
+        const AccessResults result = RunAccesses(framebuffer, false, seed);
+        for (unsigned i = 0; i < ACCESSES_PER_CONFIG; ++i) {
+            REQUIRE(result.colors[i] == expected.colors[i]);
+            REQUIRE(result.depths[i] == expected.depths[i]);
+            REQUIRE(result.stencils[i] == expected.stencils[i]);
+        }
+        // Not compared with REQUIRE directly, which would print all of both buffers
+        const bool memory_matches = result.memory == expected.memory;
+        REQUIRE(memory_matches);
+    }
+
+    Memory::ShutdownPhysicalMemory();
+}
+
+} // namespace Rasterizer
+} // namespace Pica
@@ -0,0 +1,354 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <catch.hpp>
+#include "common/math_util.h"
+#include "video_core/swrasterizer/proctex.h"
+
+namespace Pica {
+namespace Rasterizer {
+
+// Procedural texture sampling as it was computed directly from the registers and LUTs, before the
+// state was preprocessed into a ProcTexSetup. The preprocessed version must match it exactly.
+
+using ProcTexClamp = TexturingRegs::ProcTexClamp;
+using ProcTexShift = TexturingRegs::ProcTexShift;
+using ProcTexCombiner = TexturingRegs::ProcTexCombiner;
+using ProcTexFilter = TexturingRegs::ProcTexFilter;
+
+static float LookupLUT(const std::array<State::ProcTex::ValueEntry, 128>& lut, float coord) {
+    // For NoiseLUT/ColorMap/AlphaMap, coord=0.0 is lut[0], coord=127.0/128.0 is lut[127] and
+    // coord=1.0 is lut[127]+lut_diff[127]. For other indices, the result is interpolated using
+    // value entries and difference entries.
+    coord *= 128;
+    const int index_int = std::min(static_cast<int>(coord), 127);
+    const float frac = coord - index_int;
+    return lut[index_int].ToFloat() + frac * lut[index_int].DiffToFloat();
+}
+
+// These function are used to generate random noise for procedural texture. Their results are
+// verified against real hardware, but it's not known if the algorithm is the same as hardware.
+static unsigned int NoiseRand1D(unsigned int v) {
+    static constexpr std::array<unsigned int, 16> table{
+        {0, 4, 10, 8, 4, 9, 7, 12, 5, 15, 13, 14, 11, 15, 2, 11}};
+    return ((v % 9 + 2) * 3 & 0xF) ^ table[(v / 9) & 0xF];
+}
+
+static float NoiseRand2D(unsigned int x, unsigned int y) {
+    static constexpr std::array<unsigned int, 16> table{
+        {10, 2, 15, 8, 0, 7, 4, 5, 5, 13, 2, 6, 13, 9, 3, 14}};
+    unsigned int u2 = NoiseRand1D(x);
+    unsigned int v2 = NoiseRand1D(y);
+    v2 += ((u2 & 3) == 1) ? 4 : 0;
+    v2 ^= (u2 & 1) * 6;
+    v2 += 10 + u2;
+    v2 &= 0xF;
+    v2 ^= table[u2];
+    return -1.0f + v2 * 2.0f / 15.0f;
+}
+
+static float NoiseCoef(float u, float v, TexturingRegs regs, State::ProcTex state) {
+    const float freq_u = float16::FromRaw(regs.proctex_noise_frequency.u).ToFloat32();
+    const float freq_v = float16::FromRaw(regs.proctex_noise_frequency.v).ToFloat32();
+    const float phase_u = float16::FromRaw(regs.proctex_noise_u.phase).ToFloat32();
+    const float phase_v = float16::FromRaw(regs.proctex_noise_v.phase).ToFloat32();
+    const float x = 9 * freq_u * std::abs(u + phase_u);
+    const float y = 9 * freq_v * std::abs(v + phase_v);
+    const int x_int = static_cast<int>(x);
+    const int y_int = static_cast<int>(y);
+    const float x_frac = x - x_int;
+    const float y_frac = y - y_int;
+
+    const float g0 = NoiseRand2D(x_int, y_int) * (x_frac + y_frac);
+    const float g1 = NoiseRand2D(x_int + 1, y_int) * (x_frac + y_frac - 1);
+    const float g2 = NoiseRand2D(x_int, y_int + 1) * (x_frac + y_frac - 1);
+    const float g3 = NoiseRand2D(x_int + 1, y_int + 1) * (x_frac + y_frac - 2);
+    const float x_noise = LookupLUT(state.noise_table, x_frac);
+    const float y_noise = LookupLUT(state.noise_table, y_frac);
+    return Math::BilinearInterp(g0, g1, g2, g3, x_noise, y_noise);
+}
+
+static float GetShiftOffset(float v, ProcTexShift mode, ProcTexClamp clamp_mode) {
+    const float offset = (clamp_mode == ProcTexClamp::MirroredRepeat) ? 1 : 0.5f;
+    switch (mode) {
+    case ProcTexShift::None:
+        return 0;
+    case ProcTexShift::Odd:
+        return offset * (((int)v / 2) % 2);
+    case ProcTexShift::Even:
+        return offset * ((((int)v + 1) / 2) % 2);
+    default:
+        LOG_CRITICAL(HW_GPU, "Unknown shift mode %u", static_cast<u32>(mode));
+        return 0;
+    }
+};
+
+static void ClampCoord(float& coord, ProcTexClamp mode) {
+    switch (mode) {
+    case ProcTexClamp::ToZero:
+        if (coord > 1.0f)
+            coord = 0.0f;
+        break;
+    case ProcTexClamp::ToEdge:
+        coord = std::min(coord, 1.0f);
+        break;
+    case ProcTexClamp::SymmetricalRepeat:
+        coord = coord - std::floor(coord);
+        break;
+    case ProcTexClamp::MirroredRepeat: {
+        int integer = static_cast<int>(coord);
+        float frac = coord - integer;
+        coord = (integer % 2) == 0 ? frac : (1.0f - frac);
+        break;
+    }
+    case ProcTexClamp::Pulse:
+        if (coord <= 0.5f)
+            coord = 0.0f;
+        else
+            coord = 1.0f;
+        break;
+    default:
+        LOG_CRITICAL(HW_GPU, "Unknown clamp mode %u", static_cast<u32>(mode));
+        coord = std::min(coord, 1.0f);
+        break;
+    }
+}
+
+static float CombineAndMap(float u, float v, ProcTexCombiner combiner,
+                           const std::array<State::ProcTex::ValueEntry, 128>& map_table) {
+    float f;
+    switch (combiner) {
+    case ProcTexCombiner::U:
+        f = u;
+        break;
+    case ProcTexCombiner::U2:
+        f = u * u;
+        break;
+    case TexturingRegs::ProcTexCombiner::V:
+        f = v;
+        break;
+    case TexturingRegs::ProcTexCombiner::V2:
+        f = v * v;
+        break;
+    case TexturingRegs::ProcTexCombiner::Add:
+        f = (u + v) * 0.5f;
+        break;
+    case TexturingRegs::ProcTexCombiner::Add2:
+        f = (u * u + v * v) * 0.5f;
+        break;
+    case TexturingRegs::ProcTexCombiner::SqrtAdd2:
+        f = std::min(std::sqrt(u * u + v * v), 1.0f);
+        break;
+    case TexturingRegs::ProcTexCombiner::Min:
+        f = std::min(u, v);
+        break;
+    case TexturingRegs::ProcTexCombiner::Max:
+        f = std::max(u, v);
+        break;
+    case TexturingRegs::ProcTexCombiner::RMax:
+        f = std::min(((u + v) * 0.5f + std::sqrt(u * u + v * v)) * 0.5f, 1.0f);
+        break;
+    default:
+        LOG_CRITICAL(HW_GPU, "Unknown combiner %u", static_cast<u32>(combiner));
+        f = 0.0f;
+        break;
+    }
+    return LookupLUT(map_table, f);
+}
+
+static Math::Vec4<u8> ReferenceProcTex(float u, float v, const TexturingRegs& regs,
+                                       const State::ProcTex& state) {
+    u = std::abs(u);
+    v = std::abs(v);
+
+    // Get shift offset before noise generation
+    const float u_shift = GetShiftOffset(v, regs.proctex.u_shift, regs.proctex.u_clamp);
+    const float v_shift = GetShiftOffset(u, regs.proctex.v_shift, regs.proctex.v_clamp);
+
+    // Generate noise
+    if (regs.proctex.noise_enable) {
+        float noise = NoiseCoef(u, v, regs, state);
+        u += noise * regs.proctex_noise_u.amplitude / 4095.0f;
+        v += noise * regs.proctex_noise_v.amplitude / 4095.0f;
+        u = std::abs(u);
+        v = std::abs(v);
+    }
+
+    // Shift
+    u += u_shift;
+    v += v_shift;
+
+    // Clamp
+    ClampCoord(u, regs.proctex.u_clamp);
+    ClampCoord(v, regs.proctex.v_clamp);
+
+    // Combine and map
+    const float lut_coord = CombineAndMap(u, v, regs.proctex.color_combiner, state.color_map_table);
+
+    // Look up the color
+    // For the color lut, coord=0.0 is lut[offset] and coord=1.0 is lut[offset+width-1]
+    const u32 offset = regs.proctex_lut_offset;
+    const u32 width = regs.proctex_lut.width;
+    const float index = offset + (lut_coord * (width - 1));
+    Math::Vec4<u8> final_color;
+    // TODO(wwylele): implement mipmap
+    switch (regs.proctex_lut.filter) {
+    case ProcTexFilter::Linear:
+    case ProcTexFilter::LinearMipmapLinear:
+    case ProcTexFilter::LinearMipmapNearest: {
+        const int index_int = static_cast<int>(index);
+        const float frac = index - index_int;
+        const auto color_value = state.color_table[index_int].ToVector().Cast<float>();
+        const auto color_diff = state.color_diff_table[index_int].ToVector().Cast<float>();
+        final_color = (color_value + frac * color_diff).Cast<u8>();
+        break;
+    }
+    case ProcTexFilter::Nearest:
+    case ProcTexFilter::NearestMipmapLinear:
+    case ProcTexFilter::NearestMipmapNearest:
+        final_color = state.color_table[static_cast<int>(std::round(index))].ToVector();
+        break;
+    }
+
+    if (regs.proctex.separate_alpha) {
+        // Note: in separate alpha mode, the alpha channel skips the color LUT look up stage. It
+        // uses the output of CombineAndMap directly instead.
+        const float final_alpha =
+            CombineAndMap(u, v, regs.proctex.alpha_combiner, state.alpha_map_table);
+        return Math::MakeVec<u8>(final_color.rgb(), static_cast<u8>(final_alpha * 255));
+    } else {
+        return final_color;
+    }
+}
+
+/// Packs a color into one integer, so that a mismatch reports both colors
+static u32 PackColor(const Math::Vec4<u8>& color) {
+    return color.r() | color.g() << 8 | color.b() << 16 | color.a() << 24;
+}
+
+/**
+ * Fills the LUTs with random entries. Map entries keep value + difference within the 12 bit range,
+ * so that the color LUT is never indexed past the configured entries.
+ */
+static void RandomizeLuts(std::mt19937& rng, State::ProcTex& state) {
+    for (auto& entry : state.noise_table) {
+        entry.raw = rng();
+    }
+    for (auto* table : {&state.color_map_table, &state.alpha_map_table}) {
+        for (auto& entry : *table) {
+            const int value = rng() % 4096;
+            const int min_diff = std::max(-2048, -value);
+            const int max_diff = std::min(2047, 4095 - value);
+            entry.raw = 0;
+            entry.value.Assign(value);
+            entry.difference.Assign(min_diff + static_cast<int>(rng() % (max_diff - min_diff + 1)));
+        }
+    }
+    for (auto& entry : state.color_table) {
+        entry.raw = rng();
+    }
+    for (auto& entry : state.color_diff_table) {
+        entry.raw = rng();
+    }
+}
+
+/// Randomizes the registers, with the enums kept to valid values and the color LUT range in bounds
+static void RandomizeRegs(std::mt19937& rng, TexturingRegs& regs) {
+    regs.proctex.u_clamp.Assign(static_cast<ProcTexClamp>(rng() % 5));
+    regs.proctex.v_clamp.Assign(static_cast<ProcTexClamp>(rng() % 5));
+    regs.proctex.color_combiner.Assign(static_cast<ProcTexCombiner>(rng() % 10));
+    regs.proctex.alpha_combiner.Assign(static_cast<ProcTexCombiner>(rng() % 10));
+    regs.proctex.separate_alpha.Assign(rng() % 2);
+    regs.proctex.noise_enable.Assign(rng() % 2);
+    regs.proctex.u_shift.Assign(static_cast<ProcTexShift>(rng() % 3));
+    regs.proctex.v_shift.Assign(static_cast<ProcTexShift>(rng() % 3));
+    regs.proctex_noise_u.amplitude.Assign(rng() % 4096);
+    regs.proctex_noise_v.amplitude.Assign(rng() % 4096);
+    regs.proctex_noise_u.phase.Assign(rng() % 0x4000 + 0x2000);
+    regs.proctex_noise_v.phase.Assign(rng() % 0x4000 + 0x2000);
+    regs.proctex_noise_frequency.u.Assign(rng() % 0x800 + 0x3800);
+    regs.proctex_noise_frequency.v.Assign(rng() % 0x800 + 0x3800);
+    regs.proctex_lut.filter.Assign(static_cast<ProcTexFilter>(rng() % 6));
+    regs.proctex_lut.width.Assign(1 + rng() % 128);
+    regs.proctex_lut_offset.Assign(rng() % (257 - regs.proctex_lut.width));
+}
+
+TEST_CASE("ProcTex matches the unprocessed procedural texture", "[video_core]") {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coord(-3.0f, 3.0f);
+    static TexturingRegs regs;
+    static State::ProcTex state;
+
+    for (int config = 0; config < 1000; ++config) {
+        RandomizeLuts(rng, state);
+        RandomizeRegs(rng, regs);
+        InvalidateProcTexSetup();
+        const ProcTexSetup& setup = GetProcTexSetup(regs, state);
+
+        for (int sample = 0; sample < 200; ++sample) {
+            const float u = coord(rng);
+            const float v = coord(rng);
+            REQUIRE(PackColor(ProcTex(setup, u, v)) ==
+                    PackColor(ReferenceProcTex(u, v, regs, state)));
+        }
+    }
+}
+
+TEST_CASE("Baked ProcTex matches the unprocessed procedural texture", "[video_core]") {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> coord(-3.0f, 3.0f);
+    static TexturingRegs regs;
+    static State::ProcTex state;
+    int baked_configs = 0;
+
+    for (int config = 0; config < 1000; ++config) {
+        RandomizeLuts(rng, state);
+        // Smooth map tables, as used for gradients, alternating with random ones
+        if (config % 2) {
+            for (int i = 0; i < 128; ++i) {
+                state.color_map_table[i].value.Assign(i * 32);
+                state.color_map_table[i].difference.Assign(32);
+                state.alpha_map_table[i].value.Assign(4095 - i * 32);
+                state.alpha_map_table[i].difference.Assign(-32);
+            }
+        }
+
+        // Only coordinates which are neither shifted nor perturbed by noise can be baked
+        RandomizeRegs(rng, regs);
+        regs.proctex.noise_enable.Assign(0);
+        regs.proctex.u_shift.Assign(ProcTexShift::None);
+        regs.proctex.v_shift.Assign(ProcTexShift::None);
+        InvalidateProcTexSetup();
+        const ProcTexSetup& setup = GetProcTexSetup(regs, state);
+        baked_configs += setup.baked;
+
+        for (int sample = 0; sample < 400; ++sample) {
+            float u = coord(rng);
+            float v = coord(rng);
+            if (sample % 2) {
+                // Coordinates within a few ulps of the edges of the baked intervals
+                u = static_cast<float>(rng() % (ProcTexSetup::BakeResolution + 1)) /
+                    ProcTexSetup::BakeResolution;
+                const int steps = static_cast<int>(rng() % 5) - 2;
+                for (int i = 0; i < std::abs(steps); ++i) {
+                    u = std::nextafter(u, steps < 0 ? 0.0f : 2.0f);
+                }
+                v = std::nextafter(static_cast<float>(rng() % (ProcTexSetup::BakeResolution + 1)) /
+                                       ProcTexSetup::BakeResolution,
+                                   0.0f);
+            }
+            REQUIRE(PackColor(ProcTex(setup, u, v)) ==
+                    PackColor(ReferenceProcTex(u, v, regs, state)));
+        }
+    }
+
+    CHECK(baked_configs > 0);
+}
+
+} // namespace Rasterizer
+} // namespace Pica
@@ -10,6 +10,7 @@
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/vector_math.h"
+#include "core/core.h"
 #include "core/hle/service/gsp_gpu.h"
 #include "core/hw/gpu.h"
 #include "core/memory.h"
@@ -41,6 +42,9 @@ static u32 gs_uniform_write_buffer[4];
 static int default_attr_counter = 0;
 static u32 default_attr_write_buffer[3];
 
+/// Vertex loader of the last draw, reused while the vertex attribute layout stays the same
+static VertexLoader vertex_loader;
+
 // Expand a 4-bit mask to 4-byte mask, e.g. 0b0101 -> 0x00FF00FF
 static const u32 expand_bits_to_bytes[] = {
     0x00000000, 0x000000ff, 0x0000ff00, 0x0000ffff, 0x00ff0000, 0x00ff00ff, 0x00ffff00, 0x00ffffff,
@@ -174,7 +178,7 @@ static void LoadDefaultVertexAttributes(u32 register_value) {
                 immediate_attribute_id = 0;
 
                 auto* shader_engine = Shader::GetEngine();
-                shader_engine->SetupBatch(g_state.vs, regs.vs.main_offset);
+                shader_engine->SetupBatch(g_state.vs, regs.vs.main_offset, regs.vs.output_mask);
 
                 // Send to vertex shader
                 if (g_debug_context)
@@ -215,14 +219,34 @@ static void Draw(u32 command_id) {
 #if PICA_LOG_TEV
     DebugUtils::DumpTevStageConfig(regs.GetTevStages());
 #endif
+    // When skipping a frame, draws into buffers that are only ever presented are dropped
+    // entirely. Their only effect is on the displayed image, which is not going to be shown.
+    // Buffers sampled as textures are excluded from then on.
+    auto& frame_skipper = Core::System::GetInstance().frame_skipper;
+    if (frame_skipper.IsEnabled()) {
+        for (const auto& texture : regs.texturing.GetTextures()) {
+            if (texture.enabled)
+                frame_skipper.NotifyBufferRead(texture.config.GetPhysicalAddress());
+        }
+    }
+    if (frame_skipper.IsSkippingFrame() && !g_debug_context &&
+        frame_skipper.IsPresentedBuffer(
+            regs.framebuffer.framebuffer.GetColorBufferPhysicalAddress())) {
+        // Vertices of this batch are not submitted, so drop any partially assembled primitive
+        // instead of combining it with vertices of a later batch.
+        g_state.primitive_assembler.Reset();
+        return;
+    }
+
     if (g_debug_context)
         g_debug_context->OnEvent(DebugContext::Event::IncomingPrimitiveBatch, nullptr);
 
     // Processes information about internal vertex attributes to figure out how a vertex is
-    // loaded.
-    // Later, these can be compiled and cached.
+    // loaded. The layout rarely changes between draws, so the last loader is reused.
     const u32 base_address = regs.pipeline.vertex_attributes.GetPhysicalBaseAddress();
-    VertexLoader loader(regs.pipeline);
+    if (!vertex_loader.MatchesLayout(regs.pipeline))
+        vertex_loader = VertexLoader(regs.pipeline);
+    VertexLoader& loader = vertex_loader;
 
     // Load vertices
     bool is_indexed = (command_id == PICA_REG_INDEX(pipeline.trigger_draw_indexed));
@@ -263,7 +287,7 @@ static void Draw(u32 command_id) {
     auto* shader_engine = Shader::GetEngine();
     Shader::UnitState shader_unit;
 
-    shader_engine->SetupBatch(g_state.vs, regs.vs.main_offset);
+    shader_engine->SetupBatch(g_state.vs, regs.vs.main_offset, regs.vs.output_mask);
 
     g_state.geometry_pipeline.Reconfigure();
     g_state.geometry_pipeline.Setup(shader_engine);
@@ -451,7 +475,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (offset >= 4096) {
             LOG_ERROR(HW_GPU, "Invalid GS program offset %u", offset);
         } else {
-            g_state.gs.program_code[offset] = value;
+            g_state.gs.WriteProgramCode(offset, value);
             offset++;
         }
         break;
@@ -466,10 +490,10 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
     case PICA_REG_INDEX_WORKAROUND(gs.swizzle_patterns.set_word[6], 0x2ac):
     case PICA_REG_INDEX_WORKAROUND(gs.swizzle_patterns.set_word[7], 0x2ad): {
         u32& offset = g_state.regs.gs.swizzle_patterns.offset;
-        if (offset >= g_state.gs.swizzle_data.size()) {
+        if (offset >= g_state.gs.GetSwizzleData().size()) {
             LOG_ERROR(HW_GPU, "Invalid GS swizzle pattern offset %u", offset);
         } else {
-            g_state.gs.swizzle_data[offset] = value;
+            g_state.gs.WriteSwizzlePattern(offset, value);
             offset++;
         }
         break;
@@ -518,9 +542,9 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (offset >= 512) {
             LOG_ERROR(HW_GPU, "Invalid VS program offset %u", offset);
         } else {
-            g_state.vs.program_code[offset] = value;
+            g_state.vs.WriteProgramCode(offset, value);
             if (!g_state.regs.pipeline.gs_unit_exclusive_configuration) {
-                g_state.gs.program_code[offset] = value;
+                g_state.gs.WriteProgramCode(offset, value);
             }
             offset++;
         }
@@ -536,12 +560,12 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
     case PICA_REG_INDEX_WORKAROUND(vs.swizzle_patterns.set_word[6], 0x2dc):
     case PICA_REG_INDEX_WORKAROUND(vs.swizzle_patterns.set_word[7], 0x2dd): {
         u32& offset = g_state.regs.vs.swizzle_patterns.offset;
-        if (offset >= g_state.vs.swizzle_data.size()) {
+        if (offset >= g_state.vs.GetSwizzleData().size()) {
             LOG_ERROR(HW_GPU, "Invalid VS swizzle pattern offset %u", offset);
         } else {
-            g_state.vs.swizzle_data[offset] = value;
+            g_state.vs.WriteSwizzlePattern(offset, value);
             if (!g_state.regs.pipeline.gs_unit_exclusive_configuration) {
-                g_state.gs.swizzle_data[offset] = value;
+                g_state.gs.WriteSwizzlePattern(offset, value);
             }
             offset++;
         }
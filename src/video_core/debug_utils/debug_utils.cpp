@@ -206,17 +206,18 @@ void DumpShader(const std::string& filename, const ShaderRegs& config,
     dvlb.dvle_offset = QueueForWriting(reinterpret_cast<const u8*>(&dvle), sizeof(dvle));
 
     // TODO: Reduce the amount of binary code written to relevant portions
+    const auto& program_code = setup.GetProgramCode();
+    const auto& swizzle_data = setup.GetSwizzleData();
     dvlp.binary_offset = write_offset - dvlp_offset;
-    dvlp.binary_size_words = static_cast<uint32_t>(setup.program_code.size());
-    QueueForWriting(reinterpret_cast<const u8*>(setup.program_code.data()),
-                    static_cast<u32>(setup.program_code.size()) * sizeof(u32));
+    dvlp.binary_size_words = static_cast<uint32_t>(program_code.size());
+    QueueForWriting(reinterpret_cast<const u8*>(program_code.data()),
+                    static_cast<u32>(program_code.size()) * sizeof(u32));
 
     dvlp.swizzle_info_offset = write_offset - dvlp_offset;
-    dvlp.swizzle_info_num_entries = static_cast<uint32_t>(setup.swizzle_data.size());
+    dvlp.swizzle_info_num_entries = static_cast<uint32_t>(swizzle_data.size());
     u32 dummy = 0;
-    for (unsigned int i = 0; i < setup.swizzle_data.size(); ++i) {
-        QueueForWriting(reinterpret_cast<const u8*>(&setup.swizzle_data[i]),
-                        sizeof(setup.swizzle_data[i]));
+    for (unsigned int i = 0; i < swizzle_data.size(); ++i) {
+        QueueForWriting(reinterpret_cast<const u8*>(&swizzle_data[i]), sizeof(swizzle_data[i]));
         QueueForWriting(reinterpret_cast<const u8*>(&dummy), sizeof(dummy));
     }
 
@@ -205,7 +205,7 @@ void GeometryPipeline::Setup(Shader::ShaderEngine* shader_engine) {
         return;
 
     this->shader_engine = shader_engine;
-    shader_engine->SetupBatch(state.gs, state.regs.gs.main_offset);
+    shader_engine->SetupBatch(state.gs, state.regs.gs.main_offset, state.regs.gs.output_mask);
 }
 
 void GeometryPipeline::Reconfigure() {
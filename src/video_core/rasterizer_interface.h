@@ -57,6 +57,11 @@ public:
         return false;
     }
 
+    /// Whether this rasterizer must be driven from the thread owning the host graphics context
+    virtual bool RequiresGraphicsContext() const {
+        return false;
+    }
+
     /// Attempt to use a faster method to display the framebuffer to screen
     virtual bool AccelerateDisplay(const GPU::Regs::FramebufferConfig& config,
                                    PAddr framebuffer_addr, u32 pixel_stride,
@@ -0,0 +1,59 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/frontend/emu_window.h"
+#include "core/tracer/recorder.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/renderer_null/null_rasterizer.h"
+#include "video_core/renderer_null/renderer_null.h"
+#include "video_core/swrasterizer/swrasterizer.h"
+
+RendererNull::RendererNull(bool skip_rasterization) : skip_rasterization(skip_rasterization) {}
+RendererNull::~RendererNull() = default;
+
+/// Swap buffers (render frame)
+void RendererNull::SwapBuffers() {
+    m_current_frame++;
+
+    Core::System::GetInstance().perf_stats.EndSystemFrame();
+
+    render_window->PollEvents();
+    render_window->SwapBuffers();
+
+    Core::System::GetInstance().frame_limiter.DoFrameLimiting(CoreTiming::GetGlobalTimeUs());
+    Core::System::GetInstance().perf_stats.BeginSystemFrame();
+    Core::System::GetInstance().frame_skipper.BeginFrame(Core::System::GetInstance().perf_stats);
+
+    if (Pica::g_debug_context && Pica::g_debug_context->recorder) {
+        Pica::g_debug_context->recorder->FrameFinished();
+    }
+}
+
+/**
+ * Set the emulator window to use for renderer
+ * @param window EmuWindow handle to emulator window to use for rendering
+ */
+void RendererNull::SetWindow(EmuWindow* window) {
+    render_window = window;
+}
+
+/// Initialize the renderer
+bool RendererNull::Init() {
+    if (skip_rasterization) {
+        rasterizer = std::make_unique<VideoCore::NullRasterizer>();
+    } else {
+        rasterizer = std::make_unique<VideoCore::SWRasterizer>();
+    }
+
+    LOG_INFO(Render, "Using null renderer (rasterization %s)",
+             skip_rasterization ? "skipped" : "in software");
+    return true;
+}
+
+/// Shutdown the renderer
+void RendererNull::ShutDown() {}
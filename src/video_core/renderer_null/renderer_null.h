@@ -0,0 +1,43 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "video_core/renderer_base.h"
+
+class EmuWindow;
+
+/**
+ * Renderer that never presents anything to the host. The PICA pipeline still runs, and triangles
+ * are either rasterized into emulated memory by the software rasterizer or discarded entirely.
+ * Intended for headless batch runs where only the emulated state matters.
+ */
+class RendererNull : public RendererBase {
+public:
+    /**
+     * @param skip_rasterization If true, triangles produced by the PICA pipeline are discarded
+     * instead of being rasterized into emulated memory.
+     */
+    explicit RendererNull(bool skip_rasterization);
+    ~RendererNull() override;
+
+    /// Swap buffers (render frame)
+    void SwapBuffers() override;
+
+    /**
+     * Set the emulator window to use for renderer
+     * @param window EmuWindow handle to emulator window to use for rendering
+     */
+    void SetWindow(EmuWindow* window) override;
+
+    /// Initialize the renderer
+    bool Init() override;
+
+    /// Shutdown the renderer
+    void ShutDown() override;
+
+private:
+    EmuWindow* render_window = nullptr; ///< Handle to render window
+    bool skip_rasterization;
+};
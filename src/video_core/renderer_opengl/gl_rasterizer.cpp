@@ -2,18 +2,24 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <future>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 #include <glad/glad.h>
 #include "common/assert.h"
 #include "common/color.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/microprofile.h"
+#include "common/thread_pool.h"
 #include "common/vector_math.h"
+#include "core/core.h"
 #include "core/hw/gpu.h"
+#include "core/loader/loader.h"
+#include "core/settings.h"
 #include "video_core/pica_state.h"
 #include "video_core/regs_framebuffer.h"
 #include "video_core/regs_rasterizer.h"
@@ -181,6 +187,9 @@ RasterizerOpenGL::RasterizerOpenGL() : shader_dirty(true) {
     SyncColorWriteMask();
     SyncStencilWriteMask();
     SyncDepthWriteMask();
+
+    vertex_shader_source = GLShader::GenerateVertexShader();
+    LoadDiskShaderCache();
 }
 
 RasterizerOpenGL::~RasterizerOpenGL() {}
@@ -1195,7 +1204,10 @@ void RasterizerOpenGL::SamplerInfo::SyncWithConfig(
 
 void RasterizerOpenGL::SetShader() {
     auto config = GLShader::PicaShaderConfig::BuildFromRegs(Pica::g_state.regs);
-    std::unique_ptr<PicaShader> shader = std::make_unique<PicaShader>();
+
+    // The uniforms are synced for every new program, and for the first program used, which may
+    // have been built up front from the disk cache
+    bool sync_uniforms = current_shader == nullptr;
 
     // Find (or generate) the GLSL shader for the current TEV state
     auto cached_shader = shader_cache.find(config);
@@ -1207,102 +1219,224 @@ void RasterizerOpenGL::SetShader() {
     } else {
         LOG_DEBUG(Render_OpenGL, "Creating new shader");
 
-        shader->shader.Create(GLShader::GenerateVertexShader().c_str(),
-                              GLShader::GenerateFragmentShader(config).c_str());
+        // The draw needs the program right away, so unknown configurations are still generated
+        // on this thread. Recording them lets the next session build them while booting. Gas fog
+        // configurations are never built while booting, so they are not recorded.
+        if (shader_disk_cache && config.state.fog_mode != Pica::TexturingRegs::FogMode::Gas) {
+            shader_disk_cache->SaveConfig(config);
+        }
 
-        state.draw.shader_program = shader->shader.handle;
-        state.Apply();
+        current_shader =
+            AddShader(config, CompileShader(config, GLShader::GenerateFragmentShader(config)));
+        sync_uniforms = true;
+    }
 
-        // Set the texture samplers to correspond to different texture units
-        GLint uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[0]");
-        if (uniform_tex != -1) {
-            glUniform1i(uniform_tex, TextureUnits::PicaTexture(0).id);
+    if (sync_uniforms) {
+        // Update uniforms
+        SyncDepthScale();
+        SyncDepthOffset();
+        SyncAlphaTest();
+        SyncCombinerColor();
+        auto& tev_stages = Pica::g_state.regs.texturing.GetTevStages();
+        for (int index = 0; index < tev_stages.size(); ++index)
+            SyncTevConstColor(index, tev_stages[index]);
+
+        SyncGlobalAmbient();
+        for (int light_index = 0; light_index < 8; light_index++) {
+            SyncLightSpecular0(light_index);
+            SyncLightSpecular1(light_index);
+            SyncLightDiffuse(light_index);
+            SyncLightAmbient(light_index);
+            SyncLightPosition(light_index);
+            SyncLightDistanceAttenuationBias(light_index);
+            SyncLightDistanceAttenuationScale(light_index);
         }
-        uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[1]");
-        if (uniform_tex != -1) {
-            glUniform1i(uniform_tex, TextureUnits::PicaTexture(1).id);
+
+        SyncFogColor();
+        SyncProcTexNoise();
+    }
+}
+
+void RasterizerOpenGL::LoadDiskShaderCache() {
+    u64 program_id;
+    if (!Settings::values.use_disk_shader_cache ||
+        Core::System::GetInstance().GetAppLoader().ReadProgramId(program_id) !=
+            Loader::ResultStatus::Success) {
+        return;
+    }
+
+    // glad only loads the program binary functions on drivers that provide them
+    GLint num_binary_formats = 0;
+    if (glGetProgramBinary != nullptr && glProgramBinary != nullptr &&
+        glProgramParameteri != nullptr) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_binary_formats);
+    }
+    program_binaries_supported = num_binary_formats > 0;
+
+    std::string driver_id;
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        driver_id += reinterpret_cast<const char*>(glGetString(name));
+        driver_id += '\n';
+    }
+    shader_disk_cache = std::make_unique<GLShader::ShaderDiskCache>(program_id, driver_id);
+
+    const std::vector<GLShader::PicaShaderConfig> configs = shader_disk_cache->LoadConfigs();
+    if (configs.empty()) {
+        return;
+    }
+
+    std::unordered_map<GLShader::PicaShaderConfig, GLShader::ProgramBinary> binaries;
+    if (program_binaries_supported) {
+        binaries = shader_disk_cache->LoadBinaries();
+    }
+
+    const GLuint old_program = state.draw.shader_program;
+
+    // Programs with a binary the driver still accepts don't need their GLSL generated
+    std::vector<GLShader::PicaShaderConfig> pending_configs;
+    size_t num_from_binaries = 0;
+    for (const auto& config : configs) {
+        if (shader_cache.count(config)) {
+            continue;
         }
-        uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[2]");
-        if (uniform_tex != -1) {
-            glUniform1i(uniform_tex, TextureUnits::PicaTexture(2).id);
+        // Gas fog is unimplemented and reports telemetry while being generated, which may not
+        // happen on another thread. Leave such configurations to their first draw.
+        if (config.state.fog_mode == Pica::TexturingRegs::FogMode::Gas) {
+            continue;
         }
 
-        // Set the texture samplers to correspond to different lookup table texture units
-        GLint uniform_lut = glGetUniformLocation(shader->shader.handle, "lighting_lut");
-        if (uniform_lut != -1) {
-            glUniform1i(uniform_lut, TextureUnits::LightingLUT.id);
+        auto binary = binaries.find(config);
+        if (binary != binaries.end()) {
+            OGLShader program;
+            program.handle = GLShader::LoadProgramBinary(
+                binary->second.format, binary->second.data.data(),
+                static_cast<GLsizei>(binary->second.data.size()));
+            if (program.handle != 0) {
+                AddShader(config, std::move(program));
+                ++num_from_binaries;
+                continue;
+            }
         }
+        pending_configs.push_back(config);
+    }
 
-        GLint uniform_fog_lut = glGetUniformLocation(shader->shader.handle, "fog_lut");
-        if (uniform_fog_lut != -1) {
-            glUniform1i(uniform_fog_lut, TextureUnits::FogLUT.id);
-        }
+    // GLSL generation is CPU-only and runs on the thread pool. Programs are linked here, on the
+    // thread owning the context, as their sources become ready.
+    auto& thread_pool = Common::ThreadPool::GetPool();
+    std::vector<std::future<std::string>> sources;
+    sources.reserve(pending_configs.size());
+    for (const auto& config : pending_configs) {
+        sources.push_back(
+            thread_pool.Push([config] { return GLShader::GenerateFragmentShader(config); }));
+    }
+    for (size_t i = 0; i < pending_configs.size(); ++i) {
+        AddShader(pending_configs[i], CompileShader(pending_configs[i], sources[i].get()));
+    }
 
-        GLint uniform_proctex_noise_lut =
-            glGetUniformLocation(shader->shader.handle, "proctex_noise_lut");
-        if (uniform_proctex_noise_lut != -1) {
-            glUniform1i(uniform_proctex_noise_lut, TextureUnits::ProcTexNoiseLUT.id);
-        }
+    state.draw.shader_program = old_program;
+    state.Apply();
 
-        GLint uniform_proctex_color_map =
-            glGetUniformLocation(shader->shader.handle, "proctex_color_map");
-        if (uniform_proctex_color_map != -1) {
-            glUniform1i(uniform_proctex_color_map, TextureUnits::ProcTexColorMap.id);
-        }
+    LOG_INFO(Render_OpenGL, "Built %zu shaders from the disk cache (%zu from program binaries)",
+             num_from_binaries + pending_configs.size(), num_from_binaries);
+}
 
-        GLint uniform_proctex_alpha_map =
-            glGetUniformLocation(shader->shader.handle, "proctex_alpha_map");
-        if (uniform_proctex_alpha_map != -1) {
-            glUniform1i(uniform_proctex_alpha_map, TextureUnits::ProcTexAlphaMap.id);
+OGLShader RasterizerOpenGL::CompileShader(const GLShader::PicaShaderConfig& config,
+                                          const std::string& fragment_shader) {
+    const bool save_binary = shader_disk_cache && program_binaries_supported;
+
+    OGLShader program;
+    program.Create(vertex_shader_source.c_str(), fragment_shader.c_str(), save_binary);
+
+    if (save_binary) {
+        GLint length = 0;
+        glGetProgramiv(program.handle, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length > 0) {
+            GLShader::ProgramBinary binary;
+            GLenum format;
+            binary.data.resize(length);
+            glGetProgramBinary(program.handle, length, nullptr, &format, binary.data.data());
+            binary.format = format;
+            shader_disk_cache->SaveBinary(config, binary);
         }
+    }
 
-        GLint uniform_proctex_lut = glGetUniformLocation(shader->shader.handle, "proctex_lut");
-        if (uniform_proctex_lut != -1) {
-            glUniform1i(uniform_proctex_lut, TextureUnits::ProcTexLUT.id);
-        }
+    return program;
+}
 
-        GLint uniform_proctex_diff_lut =
-            glGetUniformLocation(shader->shader.handle, "proctex_diff_lut");
-        if (uniform_proctex_diff_lut != -1) {
-            glUniform1i(uniform_proctex_diff_lut, TextureUnits::ProcTexDiffLUT.id);
-        }
+RasterizerOpenGL::PicaShader* RasterizerOpenGL::AddShader(
+    const GLShader::PicaShaderConfig& config, OGLShader program) {
+    std::unique_ptr<PicaShader> shader = std::make_unique<PicaShader>();
+    shader->shader = std::move(program);
 
-        current_shader = shader_cache.emplace(config, std::move(shader)).first->second.get();
-
-        GLuint block_index = glGetUniformBlockIndex(current_shader->shader.handle, "shader_data");
-        if (block_index != GL_INVALID_INDEX) {
-            GLint block_size;
-            glGetActiveUniformBlockiv(current_shader->shader.handle, block_index,
-                                      GL_UNIFORM_BLOCK_DATA_SIZE, &block_size);
-            ASSERT_MSG(block_size == sizeof(UniformData),
-                       "Uniform block size did not match! Got %d, expected %zu",
-                       static_cast<int>(block_size), sizeof(UniformData));
-            glUniformBlockBinding(current_shader->shader.handle, block_index, 0);
-
-            // Update uniforms
-            SyncDepthScale();
-            SyncDepthOffset();
-            SyncAlphaTest();
-            SyncCombinerColor();
-            auto& tev_stages = Pica::g_state.regs.texturing.GetTevStages();
-            for (int index = 0; index < tev_stages.size(); ++index)
-                SyncTevConstColor(index, tev_stages[index]);
-
-            SyncGlobalAmbient();
-            for (int light_index = 0; light_index < 8; light_index++) {
-                SyncLightSpecular0(light_index);
-                SyncLightSpecular1(light_index);
-                SyncLightDiffuse(light_index);
-                SyncLightAmbient(light_index);
-                SyncLightPosition(light_index);
-                SyncLightDistanceAttenuationBias(light_index);
-                SyncLightDistanceAttenuationScale(light_index);
-            }
+    state.draw.shader_program = shader->shader.handle;
+    state.Apply();
 
-            SyncFogColor();
-            SyncProcTexNoise();
-        }
+    // Set the texture samplers to correspond to different texture units
+    GLint uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[0]");
+    if (uniform_tex != -1) {
+        glUniform1i(uniform_tex, TextureUnits::PicaTexture(0).id);
+    }
+    uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[1]");
+    if (uniform_tex != -1) {
+        glUniform1i(uniform_tex, TextureUnits::PicaTexture(1).id);
     }
+    uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[2]");
+    if (uniform_tex != -1) {
+        glUniform1i(uniform_tex, TextureUnits::PicaTexture(2).id);
+    }
+
+    // Set the texture samplers to correspond to different lookup table texture units
+    GLint uniform_lut = glGetUniformLocation(shader->shader.handle, "lighting_lut");
+    if (uniform_lut != -1) {
+        glUniform1i(uniform_lut, TextureUnits::LightingLUT.id);
+    }
+
+    GLint uniform_fog_lut = glGetUniformLocation(shader->shader.handle, "fog_lut");
+    if (uniform_fog_lut != -1) {
+        glUniform1i(uniform_fog_lut, TextureUnits::FogLUT.id);
+    }
+
+    GLint uniform_proctex_noise_lut =
+        glGetUniformLocation(shader->shader.handle, "proctex_noise_lut");
+    if (uniform_proctex_noise_lut != -1) {
+        glUniform1i(uniform_proctex_noise_lut, TextureUnits::ProcTexNoiseLUT.id);
+    }
+
+    GLint uniform_proctex_color_map =
+        glGetUniformLocation(shader->shader.handle, "proctex_color_map");
+    if (uniform_proctex_color_map != -1) {
+        glUniform1i(uniform_proctex_color_map, TextureUnits::ProcTexColorMap.id);
+    }
+
+    GLint uniform_proctex_alpha_map =
+        glGetUniformLocation(shader->shader.handle, "proctex_alpha_map");
+    if (uniform_proctex_alpha_map != -1) {
+        glUniform1i(uniform_proctex_alpha_map, TextureUnits::ProcTexAlphaMap.id);
+    }
+
+    GLint uniform_proctex_lut = glGetUniformLocation(shader->shader.handle, "proctex_lut");
+    if (uniform_proctex_lut != -1) {
+        glUniform1i(uniform_proctex_lut, TextureUnits::ProcTexLUT.id);
+    }
+
+    GLint uniform_proctex_diff_lut =
+        glGetUniformLocation(shader->shader.handle, "proctex_diff_lut");
+    if (uniform_proctex_diff_lut != -1) {
+        glUniform1i(uniform_proctex_diff_lut, TextureUnits::ProcTexDiffLUT.id);
+    }
+
+    GLuint block_index = glGetUniformBlockIndex(shader->shader.handle, "shader_data");
+    if (block_index != GL_INVALID_INDEX) {
+        GLint block_size;
+        glGetActiveUniformBlockiv(shader->shader.handle, block_index, GL_UNIFORM_BLOCK_DATA_SIZE,
+                                  &block_size);
+        ASSERT_MSG(block_size == sizeof(UniformData),
+                   "Uniform block size did not match! Got %d, expected %zu",
+                   static_cast<int>(block_size), sizeof(UniformData));
+        glUniformBlockBinding(shader->shader.handle, block_index, 0);
+    }
+
+    return shader_cache.emplace(config, std::move(shader)).first->second.get();
 }
 
 void RasterizerOpenGL::SyncClipEnabled() {
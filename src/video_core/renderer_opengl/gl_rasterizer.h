@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include <glad/glad.h>
@@ -25,6 +26,7 @@
 #include "video_core/regs_texturing.h"
 #include "video_core/renderer_opengl/gl_rasterizer_cache.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 #include "video_core/renderer_opengl/gl_shader_gen.h"
 #include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/pica_to_gl.h"
@@ -49,6 +51,9 @@ public:
     bool AccelerateFill(const GPU::Regs::MemoryFillConfig& config) override;
     bool AccelerateDisplay(const GPU::Regs::FramebufferConfig& config, PAddr framebuffer_addr,
                            u32 pixel_stride, ScreenInfo& screen_info) override;
+    bool RequiresGraphicsContext() const override {
+        return true;
+    }
 
     /// OpenGL shader generated for a given Pica register state
     struct PicaShader {
@@ -169,6 +174,19 @@ private:
     /// Sets the OpenGL shader in accordance with the current PICA register state
     void SetShader();
 
+    /**
+     * Builds the programs of all shader configurations the current title used in previous
+     * sessions, so that they don't have to be built mid-frame on their first use
+     */
+    void LoadDiskShaderCache();
+
+    /// Links a program from the given fragment shader source, saving its binary if possible
+    OGLShader CompileShader(const GLShader::PicaShaderConfig& config,
+                            const std::string& fragment_shader);
+
+    /// Sets up the texture units and uniform block of a new program and adds it to the cache
+    PicaShader* AddShader(const GLShader::PicaShaderConfig& config, OGLShader program);
+
     /// Syncs the cull mode to match the PICA register
     void SyncCullMode();
 
@@ -268,6 +286,11 @@ private:
     const PicaShader* current_shader = nullptr;
     bool shader_dirty;
 
+    /// The vertex shader is the same for every program
+    std::string vertex_shader_source;
+    std::unique_ptr<GLShader::ShaderDiskCache> shader_disk_cache;
+    bool program_binaries_supported = false;
+
     struct {
         UniformData data;
         std::array<bool, Pica::LightingRegs::NumLightingSampler> lut_dirty;
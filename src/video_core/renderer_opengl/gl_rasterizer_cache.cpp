@@ -55,9 +55,9 @@ RasterizerCacheOpenGL::~RasterizerCacheOpenGL() {
     FlushAll();
 }
 
-static void MortonCopyPixels(CachedSurface::PixelFormat pixel_format, u32 width, u32 height,
-                             u32 bytes_per_pixel, u32 gl_bytes_per_pixel, u8* morton_data,
-                             u8* gl_data, bool morton_to_gl) {
+void MortonCopyPixels(CachedSurface::PixelFormat pixel_format, u32 width, u32 height,
+                      u32 bytes_per_pixel, u32 gl_bytes_per_pixel, u8* morton_data, u8* gl_data,
+                      bool morton_to_gl) {
     using PixelFormat = CachedSurface::PixelFormat;
 
     u8* data_ptrs[2];
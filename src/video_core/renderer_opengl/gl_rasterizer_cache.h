@@ -189,6 +189,18 @@ struct CachedSurface {
     bool dirty;
 };
 
+/**
+ * Copies pixels between a PICA morton-tiled buffer and a linear, bottom-up OpenGL buffer.
+ * @param pixel_format Format of the surface, D24S8 additionally swaps the depth/stencil order
+ * @param width, height Surface dimensions in pixels
+ * @param bytes_per_pixel Size of a pixel in the morton buffer
+ * @param gl_bytes_per_pixel Size of a pixel in the OpenGL buffer
+ * @param morton_to_gl Direction of the copy
+ */
+void MortonCopyPixels(CachedSurface::PixelFormat pixel_format, u32 width, u32 height,
+                      u32 bytes_per_pixel, u32 gl_bytes_per_pixel, u8* morton_data, u8* gl_data,
+                      bool morton_to_gl);
+
 class RasterizerCacheOpenGL : NonCopyable {
 public:
     RasterizerCacheOpenGL();
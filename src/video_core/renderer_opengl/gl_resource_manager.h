@@ -91,10 +91,11 @@ public:
     }
 
     /// Creates a new internal OpenGL resource and stores the handle
-    void Create(const char* vert_shader, const char* frag_shader) {
+    void Create(const char* vert_shader, const char* frag_shader,
+                bool retrievable_binary = false) {
         if (handle != 0)
             return;
-        handle = GLShader::LoadProgram(vert_shader, frag_shader);
+        handle = GLShader::LoadProgram(vert_shader, frag_shader, retrievable_binary);
     }
 
     /// Deletes the internal OpenGL resource
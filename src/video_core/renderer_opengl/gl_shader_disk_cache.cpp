@@ -0,0 +1,202 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cinttypes>
+#include <cstring>
+#include "common/common_paths.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "common/swap.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+
+namespace GLShader {
+
+namespace {
+
+constexpr u32 MakeMagic(char a, char b, char c, char d) {
+    return a | b << 8 | c << 16 | d << 24;
+}
+
+constexpr u32 CONFIG_FILE_MAGIC = MakeMagic('C', 'S', 'C', 'F');
+constexpr u32 BINARY_FILE_MAGIC = MakeMagic('C', 'S', 'B', 'N');
+
+// Increase whenever the layout of the files changes. Changes to PicaShaderConfig::State are
+// usually caught by the entry size, but not when members are rearranged or reinterpreted.
+constexpr u32 FILE_VERSION = 1;
+
+struct FileHeader {
+    u32_le magic;
+    u32_le version;
+    u32_le state_size;
+    u32_le reserved;
+    u64_le driver_hash; ///< Only used by the program binary file
+};
+static_assert(sizeof(FileHeader) == 24, "FileHeader has incorrect size");
+
+struct BinaryEntryHeader {
+    u32_le format;
+    u32_le size;
+};
+static_assert(sizeof(BinaryEntryHeader) == 8, "BinaryEntryHeader has incorrect size");
+
+FileHeader MakeHeader(u32 magic, u64 driver_hash) {
+    FileHeader header{};
+    header.magic = magic;
+    header.version = FILE_VERSION;
+    header.state_size = sizeof(PicaShaderConfig::State);
+    header.reserved = 0;
+    header.driver_hash = driver_hash;
+    return header;
+}
+
+/// Reads the header of a cache file and checks that it matches the expected one.
+bool ReadHeader(FileUtil::IOFile& file, const FileHeader& expected) {
+    FileHeader header;
+    return file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+           std::memcmp(&header, &expected, sizeof(header)) == 0;
+}
+
+/// Opens a cache file for reading, returning false if it is missing or doesn't match the header.
+bool OpenForReading(FileUtil::IOFile& file, const std::string& path, const FileHeader& expected) {
+    if (!FileUtil::Exists(path)) {
+        return false;
+    }
+
+    file.Open(path, "rb");
+    if (!ReadHeader(file, expected)) {
+        LOG_INFO(Render_OpenGL, "Discarding outdated shader cache %s", path.c_str());
+        file.Close();
+        FileUtil::Delete(path);
+        return false;
+    }
+    return true;
+}
+
+/// Opens a cache file for appending. Missing or outdated files are started over.
+bool OpenForAppending(FileUtil::IOFile& file, const std::string& path, const FileHeader& header) {
+    if (file.IsOpen()) {
+        return file.IsGood();
+    }
+
+    bool is_new = true;
+    if (FileUtil::Exists(path)) {
+        FileUtil::IOFile existing(path, "rb");
+        is_new = !ReadHeader(existing, header);
+    }
+    if (!file.Open(path, is_new ? "wb" : "ab")) {
+        LOG_ERROR(Render_OpenGL, "Failed to open shader cache %s", path.c_str());
+        return false;
+    }
+    if (is_new) {
+        file.WriteBytes(&header, sizeof(header));
+    }
+    return file.IsGood();
+}
+
+PicaShaderConfig ReadConfig(FileUtil::IOFile& file, bool& ok) {
+    PicaShaderConfig config;
+    ok = file.ReadBytes(&config.state, sizeof(config.state)) == sizeof(config.state);
+    return config;
+}
+
+} // Anonymous namespace
+
+ShaderDiskCache::ShaderDiskCache(u64 program_id, const std::string& driver_id) {
+    const std::string dir = FileUtil::GetUserPath(D_CACHE_IDX) + "shaders" DIR_SEP;
+    FileUtil::CreateFullPath(dir);
+
+    const std::string title = Common::StringFromFormat("%016" PRIX64, program_id);
+    config_path = dir + title + ".bin";
+    binary_path = dir + title + "_programs.bin";
+    driver_hash = Common::ComputeHash64(driver_id.data(), driver_id.size());
+}
+
+std::vector<PicaShaderConfig> ShaderDiskCache::LoadConfigs() {
+    std::vector<PicaShaderConfig> configs;
+
+    FileUtil::IOFile file;
+    if (!OpenForReading(file, config_path, MakeHeader(CONFIG_FILE_MAGIC, 0))) {
+        return configs;
+    }
+
+    const size_t count = (file.GetSize() - sizeof(FileHeader)) / sizeof(PicaShaderConfig::State);
+    configs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        bool ok;
+        PicaShaderConfig config = ReadConfig(file, ok);
+        if (!ok) {
+            break;
+        }
+        configs.push_back(config);
+    }
+
+    LOG_INFO(Render_OpenGL, "Loaded %zu shader configurations from %s", configs.size(),
+             config_path.c_str());
+    return configs;
+}
+
+std::unordered_map<PicaShaderConfig, ProgramBinary> ShaderDiskCache::LoadBinaries() {
+    std::unordered_map<PicaShaderConfig, ProgramBinary> binaries;
+
+    FileUtil::IOFile file;
+    if (!OpenForReading(file, binary_path, MakeHeader(BINARY_FILE_MAGIC, driver_hash))) {
+        return binaries;
+    }
+
+    const u64 file_size = file.GetSize();
+    while (true) {
+        bool ok;
+        PicaShaderConfig config = ReadConfig(file, ok);
+        BinaryEntryHeader entry;
+        if (!ok || file.ReadBytes(&entry, sizeof(entry)) != sizeof(entry)) {
+            break;
+        }
+
+        // A corrupt or truncated size must not make us allocate more than the file holds
+        if (entry.size > file_size - file.Tell()) {
+            LOG_ERROR(Render_OpenGL, "Invalid program binary size %u in %s",
+                      static_cast<u32>(entry.size), binary_path.c_str());
+            break;
+        }
+
+        ProgramBinary binary;
+        binary.format = entry.format;
+        binary.data.resize(entry.size);
+        if (file.ReadBytes(binary.data.data(), binary.data.size()) != binary.data.size()) {
+            break;
+        }
+
+        // A program is saved again when the driver rejected its previous binary
+        binaries[config] = std::move(binary);
+    }
+
+    return binaries;
+}
+
+void ShaderDiskCache::SaveConfig(const PicaShaderConfig& config) {
+    if (!OpenForAppending(config_file, config_path, MakeHeader(CONFIG_FILE_MAGIC, 0))) {
+        return;
+    }
+
+    config_file.WriteBytes(&config.state, sizeof(config.state));
+    config_file.Flush();
+}
+
+void ShaderDiskCache::SaveBinary(const PicaShaderConfig& config, const ProgramBinary& binary) {
+    if (!OpenForAppending(binary_file, binary_path, MakeHeader(BINARY_FILE_MAGIC, driver_hash))) {
+        return;
+    }
+
+    BinaryEntryHeader entry;
+    entry.format = binary.format;
+    entry.size = static_cast<u32>(binary.data.size());
+
+    binary_file.WriteBytes(&config.state, sizeof(config.state));
+    binary_file.WriteBytes(&entry, sizeof(entry));
+    binary_file.WriteBytes(binary.data.data(), binary.data.size());
+    binary_file.Flush();
+}
+
+} // namespace GLShader
@@ -0,0 +1,59 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "video_core/renderer_opengl/gl_shader_gen.h"
+
+namespace GLShader {
+
+/// A linked program, as returned by glGetProgramBinary
+struct ProgramBinary {
+    u32 format;
+    std::vector<u8> data;
+};
+
+/**
+ * Per-title record of the fragment shader configurations a title has used, so that their programs
+ * can be built while booting instead of on their first draw. Configurations don't depend on the
+ * host and are stored in <cache>/shaders/<program id>.bin. Program binaries are only valid for
+ * the driver that produced them, so they are kept in a separate file that is discarded whenever
+ * the driver changes.
+ */
+class ShaderDiskCache {
+public:
+    /**
+     * @param program_id Title whose cache to open
+     * @param driver_id String identifying the graphics driver that program binaries are used with
+     */
+    ShaderDiskCache(u64 program_id, const std::string& driver_id);
+
+    /// Returns the configurations recorded by previous sessions, discarding an invalid cache.
+    std::vector<PicaShaderConfig> LoadConfigs();
+
+    /// Returns the program binaries stored by previous sessions with the same driver.
+    std::unordered_map<PicaShaderConfig, ProgramBinary> LoadBinaries();
+
+    /// Records a configuration that was used for the first time.
+    void SaveConfig(const PicaShaderConfig& config);
+
+    /// Stores the binary of a program linked for the given configuration.
+    void SaveBinary(const PicaShaderConfig& config, const ProgramBinary& binary);
+
+private:
+    std::string config_path;
+    std::string binary_path;
+    u64 driver_hash;
+
+    // Opened for appending on the first save
+    FileUtil::IOFile config_file;
+    FileUtil::IOFile binary_file;
+};
+
+} // namespace GLShader
@@ -10,7 +10,8 @@
 
 namespace GLShader {
 
-GLuint LoadProgram(const char* vertex_shader, const char* fragment_shader) {
+GLuint LoadProgram(const char* vertex_shader, const char* fragment_shader,
+                   bool retrievable_binary) {
 
     // Create the shaders
     GLuint vertex_shader_id = glCreateShader(GL_VERTEX_SHADER);
@@ -67,6 +68,10 @@ GLuint LoadProgram(const char* vertex_shader, const char* fragment_shader) {
     glAttachShader(program_id, vertex_shader_id);
     glAttachShader(program_id, fragment_shader_id);
 
+    if (retrievable_binary) {
+        glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     glLinkProgram(program_id);
 
     // Check the program
@@ -96,4 +101,19 @@ GLuint LoadProgram(const char* vertex_shader, const char* fragment_shader) {
     return program_id;
 }
 
+GLuint LoadProgramBinary(GLenum format, const void* binary, GLsizei length) {
+    GLuint program_id = glCreateProgram();
+    glProgramBinary(program_id, format, binary, length);
+
+    GLint result = GL_FALSE;
+    glGetProgramiv(program_id, GL_LINK_STATUS, &result);
+    if (result == GL_FALSE) {
+        LOG_DEBUG(Render_OpenGL, "Program binary was rejected by the driver");
+        glDeleteProgram(program_id);
+        return 0;
+    }
+
+    return program_id;
+}
+
 } // namespace GLShader
@@ -12,8 +12,20 @@ namespace GLShader {
  * Utility function to create and compile an OpenGL GLSL shader program (vertex + fragment shader)
  * @param vertex_shader String of the GLSL vertex shader program
  * @param fragment_shader String of the GLSL fragment shader program
+ * @param retrievable_binary Whether the binary of the program will be retrieved after linking
  * @returns Handle of the newly created OpenGL shader object
  */
-GLuint LoadProgram(const char* vertex_shader, const char* fragment_shader);
+GLuint LoadProgram(const char* vertex_shader, const char* fragment_shader,
+                   bool retrievable_binary = false);
+
+/**
+ * Utility function to create an OpenGL program from a binary returned by glGetProgramBinary
+ * @param format Binary format reported by glGetProgramBinary
+ * @param binary Program binary
+ * @param length Size of the binary in bytes
+ * @returns Handle of the newly created OpenGL program object, or 0 if the driver rejected the
+ *          binary (e.g. because it was produced by a different driver version)
+ */
+GLuint LoadProgramBinary(GLenum format, const void* binary, GLsizei length);
 
 } // namespace
@@ -103,50 +103,58 @@ void RendererOpenGL::SwapBuffers() {
     OpenGLState prev_state = OpenGLState::GetCurState();
     state.Apply();
 
-    for (int i : {0, 1}) {
-        const auto& framebuffer = GPU::g_regs.framebuffer_config[i];
-
-        // Main LCD (0): 0x1ED02204, Sub LCD (1): 0x1ED02A04
-        u32 lcd_color_addr =
-            (i == 0) ? LCD_REG_INDEX(color_fill_top) : LCD_REG_INDEX(color_fill_bottom);
-        lcd_color_addr = HW::VADDR_LCD + 4 * lcd_color_addr;
-        LCD::Regs::ColorFill color_fill = {0};
-        LCD::Read(color_fill.raw, lcd_color_addr);
-
-        if (color_fill.is_enabled) {
-            LoadColorToActiveGLTexture(color_fill.color_r, color_fill.color_g, color_fill.color_b,
-                                       screen_infos[i].texture);
-
-            // Resize the texture in case the framebuffer size has changed
-            screen_infos[i].texture.width = 1;
-            screen_infos[i].texture.height = 1;
-        } else {
-            if (screen_infos[i].texture.width != (GLsizei)framebuffer.width ||
-                screen_infos[i].texture.height != (GLsizei)framebuffer.height ||
-                screen_infos[i].texture.format != framebuffer.color_format) {
-                // Reallocate texture if the framebuffer size has changed.
-                // This is expected to not happen very often and hence should not be a
-                // performance problem.
-                ConfigureFramebufferTexture(screen_infos[i].texture, framebuffer);
+    // The draws of a skipped frame were dropped, so what the framebuffers hold is incomplete. The
+    // previous image is left on screen instead of loading and presenting them.
+    const bool frame_skipped = Core::System::GetInstance().frame_skipper.IsSkippingFrame();
+
+    if (!frame_skipped) {
+        for (int i : {0, 1}) {
+            const auto& framebuffer = GPU::g_regs.framebuffer_config[i];
+
+            // Main LCD (0): 0x1ED02204, Sub LCD (1): 0x1ED02A04
+            u32 lcd_color_addr =
+                (i == 0) ? LCD_REG_INDEX(color_fill_top) : LCD_REG_INDEX(color_fill_bottom);
+            lcd_color_addr = HW::VADDR_LCD + 4 * lcd_color_addr;
+            LCD::Regs::ColorFill color_fill = {0};
+            LCD::Read(color_fill.raw, lcd_color_addr);
+
+            if (color_fill.is_enabled) {
+                LoadColorToActiveGLTexture(color_fill.color_r, color_fill.color_g,
+                                           color_fill.color_b, screen_infos[i].texture);
+
+                // Resize the texture in case the framebuffer size has changed
+                screen_infos[i].texture.width = 1;
+                screen_infos[i].texture.height = 1;
+            } else {
+                if (screen_infos[i].texture.width != (GLsizei)framebuffer.width ||
+                    screen_infos[i].texture.height != (GLsizei)framebuffer.height ||
+                    screen_infos[i].texture.format != framebuffer.color_format) {
+                    // Reallocate texture if the framebuffer size has changed.
+                    // This is expected to not happen very often and hence should not be a
+                    // performance problem.
+                    ConfigureFramebufferTexture(screen_infos[i].texture, framebuffer);
+                }
+                LoadFBToScreenInfo(framebuffer, screen_infos[i]);
+
+                // Resize the texture in case the framebuffer size has changed
+                screen_infos[i].texture.width = framebuffer.width;
+                screen_infos[i].texture.height = framebuffer.height;
             }
-            LoadFBToScreenInfo(framebuffer, screen_infos[i]);
-
-            // Resize the texture in case the framebuffer size has changed
-            screen_infos[i].texture.width = framebuffer.width;
-            screen_infos[i].texture.height = framebuffer.height;
         }
-    }
 
-    DrawScreens();
+        DrawScreens();
+    }
 
     Core::System::GetInstance().perf_stats.EndSystemFrame();
 
     // Swap buffers
     render_window->PollEvents();
-    render_window->SwapBuffers();
+    if (!frame_skipped)
+        render_window->SwapBuffers();
 
     Core::System::GetInstance().frame_limiter.DoFrameLimiting(CoreTiming::GetGlobalTimeUs());
     Core::System::GetInstance().perf_stats.BeginSystemFrame();
+    Core::System::GetInstance().frame_skipper.BeginFrame(Core::System::GetInstance().perf_stats);
 
     prev_state.Apply();
     RefreshRasterizerSetting();
@@ -2,9 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include "common/bit_set.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "video_core/pica_state.h"
@@ -84,6 +86,42 @@ void UnitState::WriteOutput(const ShaderRegs& config, AttributeBuffer& output) {
     }
 }
 
+void ShaderSetup::WriteProgramCode(unsigned offset, u32 value) {
+    ASSERT(offset < program_code.size());
+    if (program_code[offset] != value) {
+        program_code[offset] = value;
+        code_tracking.program_code_hash_valid = false;
+        code_tracking.program_code_length = std::max(code_tracking.program_code_length, offset + 1);
+    }
+}
+
+void ShaderSetup::WriteSwizzlePattern(unsigned offset, u32 value) {
+    ASSERT(offset < swizzle_data.size());
+    if (swizzle_data[offset] != value) {
+        swizzle_data[offset] = value;
+        code_tracking.swizzle_data_hash_valid = false;
+        code_tracking.swizzle_data_length = std::max(code_tracking.swizzle_data_length, offset + 1);
+    }
+}
+
+u64 ShaderSetup::GetProgramCodeHash() {
+    if (!code_tracking.program_code_hash_valid) {
+        code_tracking.program_code_hash = Common::ComputeHash64(
+            program_code.data(), code_tracking.program_code_length * sizeof(u32));
+        code_tracking.program_code_hash_valid = true;
+    }
+    return code_tracking.program_code_hash;
+}
+
+u64 ShaderSetup::GetSwizzleDataHash() {
+    if (!code_tracking.swizzle_data_hash_valid) {
+        code_tracking.swizzle_data_hash = Common::ComputeHash64(
+            swizzle_data.data(), code_tracking.swizzle_data_length * sizeof(u32));
+        code_tracking.swizzle_data_hash_valid = true;
+    }
+    return code_tracking.swizzle_data_hash;
+}
+
 UnitState::UnitState(GSEmitter* emitter) : emitter_ptr(emitter) {}
 
 GSEmitter::GSEmitter() {
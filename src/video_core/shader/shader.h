@@ -173,7 +173,7 @@ struct GSUnitState : public UnitState {
 };
 
 struct ShaderSetup {
-    struct {
+    struct Uniforms {
         // The float uniforms are accessed by the shader JIT using SSE instructions, and are
         // therefore required to be 16-byte aligned.
         alignas(16) Math::Vec4<float24> f[96];
@@ -182,20 +182,56 @@ struct ShaderSetup {
         std::array<Math::Vec4<u8>, 4> i;
     } uniforms;
 
+    // Offsets within Uniforms, as the JIT addresses the uniforms through a pointer to them
     static size_t GetFloatUniformOffset(unsigned index) {
-        return offsetof(ShaderSetup, uniforms.f) + index * sizeof(Math::Vec4<float24>);
+        return offsetof(Uniforms, f) + index * sizeof(Math::Vec4<float24>);
     }
 
     static size_t GetBoolUniformOffset(unsigned index) {
-        return offsetof(ShaderSetup, uniforms.b) + index * sizeof(bool);
+        return offsetof(Uniforms, b) + index * sizeof(bool);
     }
 
     static size_t GetIntUniformOffset(unsigned index) {
-        return offsetof(ShaderSetup, uniforms.i) + index * sizeof(Math::Vec4<u8>);
+        return offsetof(Uniforms, i) + index * sizeof(Math::Vec4<u8>);
     }
 
-    std::array<u32, MAX_PROGRAM_CODE_LENGTH> program_code;
-    std::array<u32, MAX_SWIZZLE_DATA_LENGTH> swizzle_data;
+    const std::array<u32, MAX_PROGRAM_CODE_LENGTH>& GetProgramCode() const {
+        return program_code;
+    }
+
+    const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>& GetSwizzleData() const {
+        return swizzle_data;
+    }
+
+    /**
+     * Writes a word of the program code, as uploaded through the shader unit registers. Games
+     * usually upload the same programs over and over, so only writes that change the code
+     * invalidate its hash.
+     */
+    void WriteProgramCode(unsigned offset, u32 value);
+
+    /// Writes an operand descriptor, as uploaded through the shader unit registers.
+    void WriteSwizzlePattern(unsigned offset, u32 value);
+
+    /// Returns a hash of the program code, only computed again after the code was modified.
+    u64 GetProgramCodeHash();
+
+    /// Returns a hash of the swizzle data, only computed again after the data was modified.
+    u64 GetSwizzleDataHash();
+
+    /**
+     * Tracks modifications of the program code and swizzle data. Only the words up to the highest
+     * one ever written are hashed, the ones after it are still zero. Zero-initialized, this
+     * state requires hashing everything written so far on the next use.
+     */
+    struct {
+        bool program_code_hash_valid;
+        bool swizzle_data_hash_valid;
+        unsigned program_code_length;
+        unsigned swizzle_data_length;
+        u64 program_code_hash;
+        u64 swizzle_data_hash;
+    } code_tracking{};
 
     /// Data private to ShaderEngines
     struct EngineData {
@@ -203,6 +239,11 @@ struct ShaderSetup {
         /// Used by the JIT, points to a compiled shader object.
         const void* cached_shader = nullptr;
     } engine_data;
+
+private:
+    // Only modified through WriteProgramCode and WriteSwizzlePattern, which track the changes
+    std::array<u32, MAX_PROGRAM_CODE_LENGTH> program_code;
+    std::array<u32, MAX_SWIZZLE_DATA_LENGTH> swizzle_data;
 };
 
 class ShaderEngine {
@@ -212,8 +253,12 @@ public:
     /**
      * Performs any shader unit setup that only needs to happen once per shader (as opposed to once
      * per vertex, which would happen within the `Run` function).
+     * @param setup Shader engine state
+     * @param entry_point Offset of the first instruction executed by `Run`
+     * @param output_mask Output registers read after the shader has run. Engines may skip
+     *                    computing the other outputs.
      */
-    virtual void SetupBatch(ShaderSetup& setup, unsigned int entry_point) = 0;
+    virtual void SetupBatch(ShaderSetup& setup, unsigned int entry_point, u32 output_mask) = 0;
 
     /**
      * Runs the currently setup shader.
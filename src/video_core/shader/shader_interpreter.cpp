@@ -79,8 +79,8 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
     };
 
     const auto& uniforms = setup.uniforms;
-    const auto& swizzle_data = setup.swizzle_data;
-    const auto& program_code = setup.program_code;
+    const auto& swizzle_data = setup.GetSwizzleData();
+    const auto& program_code = setup.GetProgramCode();
 
     // Placeholder for invalid inputs
     static float24 dummy_vec4_float24[4];
@@ -668,7 +668,8 @@ static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData
     }
 }
 
-void InterpreterEngine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
+void InterpreterEngine::SetupBatch(ShaderSetup& setup, unsigned int entry_point,
+                                   u32 output_mask) {
     ASSERT(entry_point < MAX_PROGRAM_CODE_LENGTH);
     setup.engine_data.entry_point = entry_point;
 }
@@ -13,7 +13,7 @@ namespace Shader {
 
 class InterpreterEngine final : public ShaderEngine {
 public:
-    void SetupBatch(ShaderSetup& setup, unsigned int entry_point) override;
+    void SetupBatch(ShaderSetup& setup, unsigned int entry_point, u32 output_mask) override;
     void Run(const ShaderSetup& setup, UnitState& state) const override;
 
     /**
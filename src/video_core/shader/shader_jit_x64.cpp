@@ -14,20 +14,25 @@ namespace Shader {
 JitX64Engine::JitX64Engine() = default;
 JitX64Engine::~JitX64Engine() = default;
 
-void JitX64Engine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
+void JitX64Engine::SetupBatch(ShaderSetup& setup, unsigned int entry_point, u32 output_mask) {
     ASSERT(entry_point < MAX_PROGRAM_CODE_LENGTH);
     setup.engine_data.entry_point = entry_point;
 
-    u64 code_hash = Common::ComputeHash64(&setup.program_code, sizeof(setup.program_code));
-    u64 swizzle_hash = Common::ComputeHash64(&setup.swizzle_data, sizeof(setup.swizzle_data));
+    // Only hashed again when the game uploaded different code since the last batch
+    u64 code_hash = setup.GetProgramCodeHash();
+    u64 swizzle_hash = setup.GetSwizzleDataHash();
 
-    u64 cache_key = code_hash ^ swizzle_hash;
+    // Shaders are specialized for the entry point and the enabled outputs
+    const u64 variant = (static_cast<u64>(output_mask) << 32) | entry_point;
+    u64 variant_hash = Common::ComputeHash64(&variant, sizeof(variant));
+
+    u64 cache_key = code_hash ^ swizzle_hash ^ variant_hash;
     auto iter = cache.find(cache_key);
     if (iter != cache.end()) {
         setup.engine_data.cached_shader = iter->second.get();
     } else {
         auto shader = std::make_unique<JitShader>();
-        shader->Compile(&setup.program_code, &setup.swizzle_data);
+        shader->Compile(&setup.GetProgramCode(), &setup.GetSwizzleData(), entry_point, output_mask);
         setup.engine_data.cached_shader = shader.get();
         cache.emplace_hint(iter, cache_key, std::move(shader));
     }
@@ -19,7 +19,7 @@ public:
     JitX64Engine();
     ~JitX64Engine() override;
 
-    void SetupBatch(ShaderSetup& setup, unsigned int entry_point) override;
+    void SetupBatch(ShaderSetup& setup, unsigned int entry_point, u32 output_mask) override;
     void Run(const ShaderSetup& setup, UnitState& state) const override;
 
 private:
@@ -176,7 +176,8 @@ void JitShader::Compile_SwizzleSrc(Instruction instr, unsigned src_num, SourceRe
     Reg64 src_ptr;
     size_t src_offset;
 
-    if (src_reg.GetRegisterType() == RegisterType::FloatUniform) {
+    const bool is_uniform = src_reg.GetRegisterType() == RegisterType::FloatUniform;
+    if (is_uniform) {
         src_ptr = SETUP;
         src_offset = ShaderSetup::GetFloatUniformOffset(src_reg.GetIndex());
     } else {
@@ -206,8 +207,27 @@ void JitShader::Compile_SwizzleSrc(Instruction instr, unsigned src_num, SourceRe
         address_register_index = instr.common.address_register_index;
     }
 
-    if (src_num == offset_src && address_register_index != 0) {
-        switch (address_register_index) {
+    SwizzlePattern swiz = {(*swizzle_data)[operand_desc_id]};
+    const bool negate[] = {swiz.negate_src1, swiz.negate_src2, swiz.negate_src3};
+    u8 sel = swiz.GetRawSelector(src_num);
+
+    // Operands that read the same register with the same swizzle and negation, e.g. the two
+    // sources of `dp3 r0, r1, r1`, produce the same value, so copy the one loaded earlier.
+    const unsigned relative_index = src_num == offset_src ? address_register_index : 0;
+    const u64 key = (static_cast<u64>(src_offset_disp) << 16) | (is_uniform ? 0x8000 : 0) |
+                    (relative_index << 9) | (negate[src_num - 1] ? 0x100 : 0) | sel;
+    for (unsigned i = 0; i < num_loaded_sources; ++i) {
+        if (loaded_sources[i].key == key) {
+            movaps(dest, loaded_sources[i].reg);
+            return;
+        }
+    }
+    if (num_loaded_sources < loaded_sources.size()) {
+        loaded_sources[num_loaded_sources++] = {key, dest};
+    }
+
+    if (relative_index != 0) {
+        switch (relative_index) {
         case 1: // address offset 1
             movaps(dest, xword[src_ptr + ADDROFFS_REG_0 + src_offset_disp]);
             break;
@@ -226,10 +246,7 @@ void JitShader::Compile_SwizzleSrc(Instruction instr, unsigned src_num, SourceRe
         movaps(dest, xword[src_ptr + src_offset_disp]);
     }
 
-    SwizzlePattern swiz = {(*swizzle_data)[operand_desc_id]};
-
     // Generate instructions for source register swizzling as needed
-    u8 sel = swiz.GetRawSelector(src_num);
     if (sel != NO_SRC_REG_SWIZZLE) {
         // Selector component order needs to be reversed for the SHUFPS instruction
         sel = ((sel & 0xc0) >> 6) | ((sel & 3) << 6) | ((sel & 0xc) << 2) | ((sel & 0x30) >> 2);
@@ -239,7 +256,6 @@ void JitShader::Compile_SwizzleSrc(Instruction instr, unsigned src_num, SourceRe
     }
 
     // If the source register should be negated, flip the negative bit using XOR
-    const bool negate[] = {swiz.negate_src1, swiz.negate_src2, swiz.negate_src3};
     if (negate[src_num - 1]) {
         xorps(dest, NEGBIT);
     }
@@ -835,6 +851,51 @@ void JitShader::Compile_Return() {
     L(b);
 }
 
+/**
+ * Returns whether the instruction only computes a value for a float register, and if so stores
+ * that register to `dest`.
+ */
+static bool GetArithmeticDest(Instruction instr, DestRegister& dest) {
+    switch (instr.opcode.Value().EffectiveOpCode()) {
+    case OpCode::Id::ADD:
+    case OpCode::Id::DP3:
+    case OpCode::Id::DP4:
+    case OpCode::Id::DPH:
+    case OpCode::Id::DPHI:
+    case OpCode::Id::EX2:
+    case OpCode::Id::LG2:
+    case OpCode::Id::MUL:
+    case OpCode::Id::SGE:
+    case OpCode::Id::SGEI:
+    case OpCode::Id::SLT:
+    case OpCode::Id::SLTI:
+    case OpCode::Id::FLR:
+    case OpCode::Id::MAX:
+    case OpCode::Id::MIN:
+    case OpCode::Id::RCP:
+    case OpCode::Id::RSQ:
+    case OpCode::Id::MOV:
+        dest = instr.common.dest.Value();
+        break;
+
+    case OpCode::Id::MAD:
+    case OpCode::Id::MADI:
+        dest = instr.mad.dest.Value();
+        break;
+
+    default:
+        // Other instructions have side effects besides writing a float register
+        return false;
+    }
+    return true;
+}
+
+bool JitShader::IsDeadOutputWrite(Instruction instr) const {
+    DestRegister dest;
+    return GetArithmeticDest(instr, dest) && dest.GetRegisterType() == RegisterType::Output &&
+           (output_mask & (1 << dest.GetIndex())) == 0;
+}
+
 void JitShader::Compile_NextInstr() {
     if (std::binary_search(return_offsets.begin(), return_offsets.end(), program_counter)) {
         Compile_Return();
@@ -842,11 +903,23 @@ void JitShader::Compile_NextInstr() {
 
     L(instruction_labels[program_counter]);
 
+    const bool reachable = reachable_instructions[program_counter];
     Instruction instr = {(*program_code)[program_counter++]};
 
     OpCode::Id opcode = instr.opcode.Value();
     auto instr_func = instr_table[static_cast<unsigned>(opcode)];
 
+    // Skip data instructions that are never executed or whose result is never read. Flow control
+    // instructions are always compiled, as they shape the emitted blocks.
+    DestRegister dest;
+    const bool is_data_instr = GetArithmeticDest(instr, dest) ||
+                               instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MOVA ||
+                               instr.opcode.Value().EffectiveOpCode() == OpCode::Id::CMP;
+    if (is_data_instr && (!reachable || IsDeadOutputWrite(instr)))
+        return;
+
+    num_loaded_sources = 0;
+
     if (instr_func) {
         // JIT the instruction!
         ((*this).*instr_func)(instr);
@@ -879,10 +952,58 @@ void JitShader::FindReturnOffsets() {
     std::sort(return_offsets.begin(), return_offsets.end());
 }
 
+void JitShader::FindReachableInstructions(unsigned entry_point) {
+    reachable_instructions.reset();
+
+    std::vector<unsigned> pending = {entry_point};
+    auto visit = [&](unsigned offset) {
+        if (offset < MAX_PROGRAM_CODE_LENGTH && !reachable_instructions[offset])
+            pending.push_back(offset);
+    };
+
+    while (!pending.empty()) {
+        unsigned offset = pending.back();
+        pending.pop_back();
+
+        // Walk straight-line code until it ends or reaches code that was already visited
+        while (offset < MAX_PROGRAM_CODE_LENGTH && !reachable_instructions[offset]) {
+            reachable_instructions[offset] = true;
+            Instruction instr = {(*program_code)[offset]};
+
+            switch (instr.opcode.Value()) {
+            case OpCode::Id::END:
+                offset = MAX_PROGRAM_CODE_LENGTH;
+                continue;
+
+            case OpCode::Id::CALL:
+            case OpCode::Id::CALLC:
+            case OpCode::Id::CALLU:
+            case OpCode::Id::JMPC:
+            case OpCode::Id::JMPU:
+            case OpCode::Id::IFU:
+            case OpCode::Id::IFC:
+                visit(instr.flow_control.dest_offset);
+                break;
+
+            case OpCode::Id::LOOP:
+                visit(instr.flow_control.dest_offset + 1);
+                break;
+
+            default:
+                break;
+            }
+
+            ++offset;
+        }
+    }
+}
+
 void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code_,
-                        const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data_) {
+                        const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data_,
+                        unsigned entry_point, u32 output_mask_) {
     program_code = program_code_;
     swizzle_data = swizzle_data_;
+    output_mask = output_mask_;
 
     // Reset flow control state
     program = (CompiledShader*)getCurr();
@@ -893,6 +1014,9 @@ void JitShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_
     // Find all `CALL` instructions and identify return locations
     FindReturnOffsets();
 
+    // Find the code that needs to be emitted for this entry point
+    FindReachableInstructions(entry_point);
+
     // The stack pointer is 8 modulo 16 at the entry of a procedure
     // We reserve 16 bytes and assign a dummy value to the first 8 bytes, to catch any potential
     // return checks (see Compile_Return) that happen in shader main routine.
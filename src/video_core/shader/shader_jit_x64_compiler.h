@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <bitset>
 #include <cstddef>
 #include <utility>
 #include <vector>
@@ -34,11 +35,17 @@ public:
     JitShader();
 
     void Run(const ShaderSetup& setup, UnitState& state, unsigned offset) const {
-        program(&setup, &state, instruction_labels[offset].getAddress());
+        program(&setup.uniforms, &state, instruction_labels[offset].getAddress());
     }
 
+    /**
+     * Compiles the shader program. Code that can't be reached from `entry_point` and writes to
+     * output registers outside of `output_mask` are omitted, so the compiled shader may only be
+     * run from `entry_point` with the same output mask.
+     */
     void Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code,
-                 const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data);
+                 const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data,
+                 unsigned entry_point, u32 output_mask);
 
     void Compile_ADD(Instruction instr);
     void Compile_DP3(Instruction instr);
@@ -106,6 +113,18 @@ private:
      */
     void FindReturnOffsets();
 
+    /**
+     * Follows the control flow of the program from the entry point, marking all instructions that
+     * may be executed.
+     */
+    void FindReachableInstructions(unsigned entry_point);
+
+    /**
+     * Returns whether the instruction only computes a value for an output register that is not
+     * enabled in the output mask, in which case no code needs to be emitted for it.
+     */
+    bool IsDeadOutputWrite(Instruction instr) const;
+
     const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code = nullptr;
     const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data = nullptr;
 
@@ -115,10 +134,24 @@ private:
     /// Offsets in code where a return needs to be inserted
     std::vector<unsigned> return_offsets;
 
+    /// Instructions that may be executed when starting from the entry point
+    std::bitset<MAX_PROGRAM_CODE_LENGTH> reachable_instructions;
+
+    /// Output registers read after the shader has run
+    u32 output_mask = 0;
+
+    /// Source operand already loaded by the current instruction, reused if it is read again
+    struct LoadedSource {
+        u64 key;
+        Xbyak::Xmm reg;
+    };
+    std::array<LoadedSource, 3> loaded_sources;
+    unsigned num_loaded_sources = 0;
+
     unsigned program_counter = 0; ///< Offset of the next instruction to decode
     bool looping = false;         ///< True if compiling a loop, used to check for nested loops
 
-    using CompiledShader = void(const void* setup, void* state, const u8* start_addr);
+    using CompiledShader = void(const void* uniforms, void* state, const u8* start_addr);
     CompiledShader* program = nullptr;
 };
 
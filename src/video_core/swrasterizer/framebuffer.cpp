@@ -20,205 +20,165 @@
 namespace Pica {
 namespace Rasterizer {
 
-void DrawPixel(int x, int y, const Math::Vec4<u8>& color) {
-    const auto& framebuffer = g_state.regs.framebuffer.framebuffer;
-    const PAddr addr = framebuffer.GetColorBufferPhysicalAddress();
+namespace {
 
-    // Similarly to textures, the render framebuffer is laid out from bottom to top, too.
-    // NOTE: The framebuffer height register contains the actual FB height minus one.
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    u32 bytes_per_pixel =
-        GPU::Regs::BytesPerPixel(GPU::Regs::PixelFormat(framebuffer.color_format.Value()));
-    u32 dst_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) +
-                     coarse_y * framebuffer.width * bytes_per_pixel;
-    u8* dst_pixel = Memory::GetPhysicalPointer(addr) + dst_offset;
-
-    switch (framebuffer.color_format) {
-    case FramebufferRegs::ColorFormat::RGBA8:
-        Color::EncodeRGBA8(color, dst_pixel);
-        break;
+RenderTargets cached_targets;
+bool targets_valid = false;
 
-    case FramebufferRegs::ColorFormat::RGB8:
-        Color::EncodeRGB8(color, dst_pixel);
-        break;
+} // Anonymous namespace
 
-    case FramebufferRegs::ColorFormat::RGB5A1:
-        Color::EncodeRGB5A1(color, dst_pixel);
-        break;
-
-    case FramebufferRegs::ColorFormat::RGB565:
-        Color::EncodeRGB565(color, dst_pixel);
-        break;
-
-    case FramebufferRegs::ColorFormat::RGBA4:
-        Color::EncodeRGBA4(color, dst_pixel);
-        break;
-
-    default:
-        LOG_CRITICAL(Render_Software, "Unknown framebuffer color format %x",
-                     framebuffer.color_format.Value());
-        UNIMPLEMENTED();
-    }
+void InvalidateRenderTargets() {
+    targets_valid = false;
 }
 
-const Math::Vec4<u8> GetPixel(int x, int y) {
-    const auto& framebuffer = g_state.regs.framebuffer.framebuffer;
-    const PAddr addr = framebuffer.GetColorBufferPhysicalAddress();
-
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    u32 bytes_per_pixel =
-        GPU::Regs::BytesPerPixel(GPU::Regs::PixelFormat(framebuffer.color_format.Value()));
-    u32 src_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) +
-                     coarse_y * framebuffer.width * bytes_per_pixel;
-    u8* src_pixel = Memory::GetPhysicalPointer(addr) + src_offset;
-
-    switch (framebuffer.color_format) {
-    case FramebufferRegs::ColorFormat::RGBA8:
-        return Color::DecodeRGBA8(src_pixel);
-
-    case FramebufferRegs::ColorFormat::RGB8:
-        return Color::DecodeRGB8(src_pixel);
-
-    case FramebufferRegs::ColorFormat::RGB5A1:
-        return Color::DecodeRGB5A1(src_pixel);
+static FramebufferRegs::ColorFormat GetColorFormat() {
+    return g_state.regs.framebuffer.framebuffer.color_format;
+}
 
-    case FramebufferRegs::ColorFormat::RGB565:
-        return Color::DecodeRGB565(src_pixel);
+static FramebufferRegs::DepthFormat GetDepthFormat() {
+    return g_state.regs.framebuffer.framebuffer.depth_format;
+}
 
-    case FramebufferRegs::ColorFormat::RGBA4:
-        return Color::DecodeRGBA4(src_pixel);
+// Handlers of the formats which aren't implemented, reporting every access like the format
+// specific ones would perform it.
 
-    default:
-        LOG_CRITICAL(Render_Software, "Unknown framebuffer color format %x",
-                     framebuffer.color_format.Value());
-        UNIMPLEMENTED();
-    }
+static void EncodeUnknownColor(const Math::Vec4<u8>& color, u8* bytes) {
+    LOG_CRITICAL(Render_Software, "Unknown framebuffer color format %x",
+                 static_cast<u32>(GetColorFormat()));
+    UNIMPLEMENTED();
+}
 
+static const Math::Vec4<u8> DecodeUnknownColor(const u8* bytes) {
+    LOG_CRITICAL(Render_Software, "Unknown framebuffer color format %x",
+                 static_cast<u32>(GetColorFormat()));
+    UNIMPLEMENTED();
     return {0, 0, 0, 0};
 }
 
-u32 GetDepth(int x, int y) {
-    const auto& framebuffer = g_state.regs.framebuffer.framebuffer;
-    const PAddr addr = framebuffer.GetDepthBufferPhysicalAddress();
-    u8* depth_buffer = Memory::GetPhysicalPointer(addr);
-
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    u32 bytes_per_pixel = FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
-    u32 stride = framebuffer.width * bytes_per_pixel;
-
-    u32 src_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
-    u8* src_pixel = depth_buffer + src_offset;
-
-    switch (framebuffer.depth_format) {
-    case FramebufferRegs::DepthFormat::D16:
-        return Color::DecodeD16(src_pixel);
-    case FramebufferRegs::DepthFormat::D24:
-        return Color::DecodeD24(src_pixel);
-    case FramebufferRegs::DepthFormat::D24S8:
-        return Color::DecodeD24S8(src_pixel).x;
-    default:
-        LOG_CRITICAL(HW_GPU, "Unimplemented depth format %u", framebuffer.depth_format);
-        UNIMPLEMENTED();
-        return 0;
-    }
+static void EncodeUnknownDepth(u32 depth, u8* bytes) {
+    LOG_CRITICAL(HW_GPU, "Unimplemented depth format %u", static_cast<u32>(GetDepthFormat()));
+    UNIMPLEMENTED();
 }
 
-u8 GetStencil(int x, int y) {
-    const auto& framebuffer = g_state.regs.framebuffer.framebuffer;
-    const PAddr addr = framebuffer.GetDepthBufferPhysicalAddress();
-    u8* depth_buffer = Memory::GetPhysicalPointer(addr);
+static u32 DecodeUnknownDepth(const u8* bytes) {
+    LOG_CRITICAL(HW_GPU, "Unimplemented depth format %u", static_cast<u32>(GetDepthFormat()));
+    UNIMPLEMENTED();
+    return 0;
+}
 
-    y = framebuffer.height - y;
+static void EncodeNoStencil(u8 stencil, u8* bytes) {
+    // Nothing to do
+}
 
-    const u32 coarse_y = y & ~7;
-    u32 bytes_per_pixel = Pica::FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
-    u32 stride = framebuffer.width * bytes_per_pixel;
+static u8 DecodeNoStencil(const u8* bytes) {
+    LOG_WARNING(HW_GPU,
+                "GetStencil called for function which doesn't have a stencil component (format %u)",
+                static_cast<u32>(GetDepthFormat()));
+    return 0;
+}
 
-    u32 src_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
-    u8* src_pixel = depth_buffer + src_offset;
+static u32 DecodeD24S8Depth(const u8* bytes) {
+    return Color::DecodeD24S8(bytes).x;
+}
 
-    switch (framebuffer.depth_format) {
-    case FramebufferRegs::DepthFormat::D24S8:
-        return Color::DecodeD24S8(src_pixel).y;
+static u8 DecodeD24S8Stencil(const u8* bytes) {
+    return static_cast<u8>(Color::DecodeD24S8(bytes).y);
+}
 
-    default:
-        LOG_WARNING(
-            HW_GPU,
-            "GetStencil called for function which doesn't have a stencil component (format %u)",
-            framebuffer.depth_format);
-        return 0;
+static void SetupAddressing(RenderTargetAddressing& target, PAddr addr,
+                            const FramebufferRegs::FramebufferConfig& framebuffer,
+                            u32 bytes_per_pixel) {
+    target.base = Memory::GetPhysicalPointer(addr);
+    // NOTE: The framebuffer height register contains the actual FB height minus one.
+    target.height = framebuffer.height;
+    for (u32 i = 0; i < 8; ++i) {
+        target.x_offsets[i] = VideoCore::MortonInterleave(i, 0) * bytes_per_pixel;
+        target.y_offsets[i] = VideoCore::MortonInterleave(0, i) * bytes_per_pixel;
     }
+    target.coarse_x_stride = 8 * bytes_per_pixel;
+    target.coarse_y_stride = framebuffer.width * bytes_per_pixel;
 }
 
-void SetDepth(int x, int y, u32 value) {
-    const auto& framebuffer = g_state.regs.framebuffer.framebuffer;
-    const PAddr addr = framebuffer.GetDepthBufferPhysicalAddress();
-    u8* depth_buffer = Memory::GetPhysicalPointer(addr);
-
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    u32 bytes_per_pixel = FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
-    u32 stride = framebuffer.width * bytes_per_pixel;
+static void SetupColorTarget(ColorTarget& target,
+                             const FramebufferRegs::FramebufferConfig& framebuffer) {
+    using ColorFormat = FramebufferRegs::ColorFormat;
 
-    u32 dst_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
-    u8* dst_pixel = depth_buffer + dst_offset;
-
-    switch (framebuffer.depth_format) {
-    case FramebufferRegs::DepthFormat::D16:
-        Color::EncodeD16(value, dst_pixel);
+    target.encode = EncodeUnknownColor;
+    target.decode = DecodeUnknownColor;
+    switch (framebuffer.color_format) {
+    case ColorFormat::RGBA8:
+        target.encode = Color::EncodeRGBA8;
+        target.decode = Color::DecodeRGBA8;
         break;
-
-    case FramebufferRegs::DepthFormat::D24:
-        Color::EncodeD24(value, dst_pixel);
+    case ColorFormat::RGB8:
+        target.encode = Color::EncodeRGB8;
+        target.decode = Color::DecodeRGB8;
         break;
-
-    case FramebufferRegs::DepthFormat::D24S8:
-        Color::EncodeD24X8(value, dst_pixel);
+    case ColorFormat::RGB5A1:
+        target.encode = Color::EncodeRGB5A1;
+        target.decode = Color::DecodeRGB5A1;
         break;
-
-    default:
-        LOG_CRITICAL(HW_GPU, "Unimplemented depth format %u", framebuffer.depth_format);
-        UNIMPLEMENTED();
+    case ColorFormat::RGB565:
+        target.encode = Color::EncodeRGB565;
+        target.decode = Color::DecodeRGB565;
+        break;
+    case ColorFormat::RGBA4:
+        target.encode = Color::EncodeRGBA4;
+        target.decode = Color::DecodeRGBA4;
         break;
+    default:
+        // Every access reports the format, and the address is never used
+        SetupAddressing(target, framebuffer.GetColorBufferPhysicalAddress(), framebuffer, 0);
+        return;
     }
-}
 
-void SetStencil(int x, int y, u8 value) {
-    const auto& framebuffer = g_state.regs.framebuffer.framebuffer;
-    const PAddr addr = framebuffer.GetDepthBufferPhysicalAddress();
-    u8* depth_buffer = Memory::GetPhysicalPointer(addr);
-
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    u32 bytes_per_pixel = Pica::FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
-    u32 stride = framebuffer.width * bytes_per_pixel;
+    const u32 bytes_per_pixel =
+        GPU::Regs::BytesPerPixel(GPU::Regs::PixelFormat(framebuffer.color_format.Value()));
+    SetupAddressing(target, framebuffer.GetColorBufferPhysicalAddress(), framebuffer,
+                    bytes_per_pixel);
+}
 
-    u32 dst_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
-    u8* dst_pixel = depth_buffer + dst_offset;
+static void SetupDepthTarget(DepthTarget& target,
+                             const FramebufferRegs::FramebufferConfig& framebuffer) {
+    using DepthFormat = FramebufferRegs::DepthFormat;
 
+    target.encode_stencil = EncodeNoStencil;
+    target.decode_stencil = DecodeNoStencil;
     switch (framebuffer.depth_format) {
-    case Pica::FramebufferRegs::DepthFormat::D16:
-    case Pica::FramebufferRegs::DepthFormat::D24:
-        // Nothing to do
+    case DepthFormat::D16:
+        target.encode_depth = Color::EncodeD16;
+        target.decode_depth = Color::DecodeD16;
         break;
-
-    case Pica::FramebufferRegs::DepthFormat::D24S8:
-        Color::EncodeX24S8(value, dst_pixel);
+    case DepthFormat::D24:
+        target.encode_depth = Color::EncodeD24;
+        target.decode_depth = Color::DecodeD24;
         break;
-
-    default:
-        LOG_CRITICAL(HW_GPU, "Unimplemented depth format %u", framebuffer.depth_format);
-        UNIMPLEMENTED();
+    case DepthFormat::D24S8:
+        target.encode_depth = Color::EncodeD24X8;
+        target.decode_depth = DecodeD24S8Depth;
+        target.encode_stencil = Color::EncodeX24S8;
+        target.decode_stencil = DecodeD24S8Stencil;
         break;
+    default:
+        target.encode_depth = EncodeUnknownDepth;
+        target.decode_depth = DecodeUnknownDepth;
+        target.encode_stencil = [](u8 stencil, u8* bytes) { EncodeUnknownDepth(0, bytes); };
+        SetupAddressing(target, framebuffer.GetDepthBufferPhysicalAddress(), framebuffer, 0);
+        return;
+    }
+
+    const u32 bytes_per_pixel = FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
+    SetupAddressing(target, framebuffer.GetDepthBufferPhysicalAddress(), framebuffer,
+                    bytes_per_pixel);
+}
+
+const RenderTargets& GetRenderTargets(const FramebufferRegs::FramebufferConfig& framebuffer) {
+    if (!targets_valid) {
+        SetupColorTarget(cached_targets.color, framebuffer);
+        SetupDepthTarget(cached_targets.depth, framebuffer);
+        targets_valid = true;
     }
+    return cached_targets;
 }
 
 u8 PerformStencilAction(FramebufferRegs::StencilAction action, u8 old_stencil, u8 ref) {
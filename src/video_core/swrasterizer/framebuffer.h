@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/regs_framebuffer.h"
@@ -11,12 +12,79 @@
 namespace Pica {
 namespace Rasterizer {
 
-void DrawPixel(int x, int y, const Math::Vec4<u8>& color);
-const Math::Vec4<u8> GetPixel(int x, int y);
-u32 GetDepth(int x, int y);
-u8 GetStencil(int x, int y);
-void SetDepth(int x, int y, u32 value);
-void SetStencil(int x, int y, u8 value);
+/**
+ * Addressing of a render target in memory, resolved from the framebuffer registers. Pixels are
+ * stored in 8x8 Morton tiles, with rows of tiles from the bottom of the buffer to its top.
+ */
+struct RenderTargetAddressing {
+    u8* base;
+    u32 height;                   ///< Framebuffer height minus one, as stored in the register
+    std::array<u32, 8> x_offsets; ///< Morton offset of each column within a tile, in bytes
+    std::array<u32, 8> y_offsets; ///< Morton offset of each row within a tile, in bytes
+    u32 coarse_x_stride;          ///< Bytes per column, for the first column of a tile
+    u32 coarse_y_stride;          ///< Bytes per row, for the first row of a row of tiles
+
+    u8* GetPixelPointer(int x, int y) const {
+        // Similarly to textures, the render framebuffer is laid out from bottom to top, too.
+        const u32 column = x;
+        const u32 row = height - y;
+        return base + x_offsets[column & 7] + y_offsets[row & 7] + (column & ~7) * coarse_x_stride +
+               (row & ~7) * coarse_y_stride;
+    }
+};
+
+/// Color buffer of the current draw, with the encoding functions of its format.
+struct ColorTarget : RenderTargetAddressing {
+    void (*encode)(const Math::Vec4<u8>& color, u8* bytes);
+    const Math::Vec4<u8> (*decode)(const u8* bytes);
+
+    void DrawPixel(int x, int y, const Math::Vec4<u8>& color) const {
+        encode(color, GetPixelPointer(x, y));
+    }
+
+    Math::Vec4<u8> GetPixel(int x, int y) const {
+        return decode(GetPixelPointer(x, y));
+    }
+};
+
+/// Depth and stencil buffer of the current draw, with the encoding functions of its format.
+struct DepthTarget : RenderTargetAddressing {
+    void (*encode_depth)(u32 depth, u8* bytes);
+    u32 (*decode_depth)(const u8* bytes);
+    void (*encode_stencil)(u8 stencil, u8* bytes);
+    u8 (*decode_stencil)(const u8* bytes);
+
+    u32 GetDepth(int x, int y) const {
+        return decode_depth(GetPixelPointer(x, y));
+    }
+
+    void SetDepth(int x, int y, u32 value) const {
+        encode_depth(value, GetPixelPointer(x, y));
+    }
+
+    u8 GetStencil(int x, int y) const {
+        return decode_stencil(GetPixelPointer(x, y));
+    }
+
+    void SetStencil(int x, int y, u8 value) const {
+        encode_stencil(value, GetPixelPointer(x, y));
+    }
+};
+
+struct RenderTargets {
+    ColorTarget color;
+    DepthTarget depth;
+};
+
+/**
+ * Returns the render targets described by the framebuffer registers. They are resolved again
+ * after InvalidateRenderTargets is called.
+ */
+const RenderTargets& GetRenderTargets(const FramebufferRegs::FramebufferConfig& framebuffer);
+
+/// Marks the framebuffer registers as modified, resolving the render targets on their next use.
+void InvalidateRenderTargets();
+
 u8 PerformStencilAction(FramebufferRegs::StencilAction action, u8 old_stencil, u8 ref);
 
 Math::Vec4<u8> EvaluateBlendEquation(const Math::Vec4<u8>& src, const Math::Vec4<u8>& srcfactor,
@@ -2,48 +2,178 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <bitset>
 #include "common/math_util.h"
 #include "video_core/swrasterizer/lighting.h"
 
 namespace Pica {
 
-static float LookupLightingLut(const Pica::State::Lighting& lighting, size_t lut_index, u8 index,
-                               float delta) {
-    ASSERT_MSG(lut_index < lighting.luts.size(), "Out of range lut");
-    ASSERT_MSG(index < lighting.luts[lut_index].size(), "Out of range index");
+namespace {
 
-    const auto& lut = lighting.luts[lut_index][index];
+LightingSetup cached_setup;
+bool setup_valid = false;
+std::bitset<LightingRegs::NumLightingSampler> lut_valid;
 
-    float lut_value = lut.ToFloat();
-    float lut_diff = lut.DiffToFloat();
+} // Anonymous namespace
 
-    return lut_value + lut_diff * delta;
+void InvalidateLightingSetup() {
+    setup_valid = false;
+}
+
+void InvalidateLightingLut(size_t lut_index) {
+    ASSERT_MSG(lut_index < lut_valid.size(), "Out of range lut");
+    lut_valid.reset(lut_index);
+    setup_valid = false;
+}
+
+/// Returns the expanded table of a LUT, expanding it first if its contents changed.
+static const LightingSetup::LutTable* ExpandLut(const State::Lighting& lighting_state,
+                                                size_t lut_index) {
+    ASSERT_MSG(lut_index < lighting_state.luts.size(), "Out of range lut");
+
+    LightingSetup::LutTable& table = cached_setup.luts[lut_index];
+    if (!lut_valid.test(lut_index)) {
+        const auto& lut = lighting_state.luts[lut_index];
+        for (size_t i = 0; i < lut.size(); ++i) {
+            table[i] = {lut[i].ToFloat(), lut[i].DiffToFloat()};
+        }
+        lut_valid.set(lut_index);
+    }
+    return &table;
+}
+
+static LightingSetup::LutSampler MakeSampler(const LightingRegs& lighting,
+                                             const State::Lighting& lighting_state,
+                                             LightingRegs::LightingSampler sampler, bool enable,
+                                             u32 disable_abs, LightingRegs::LightingLutInput input,
+                                             LightingRegs::LightingScale scale) {
+    LightingSetup::LutSampler result;
+    result.enable =
+        enable && LightingRegs::IsLightingSamplerSupported(lighting.config0.config, sampler);
+    result.abs_input = disable_abs == 0;
+    result.input = input;
+    result.scale = lighting.lut_scale.GetScale(scale);
+    result.table = nullptr;
+    if (result.enable && sampler != LightingRegs::LightingSampler::SpotlightAttenuation) {
+        result.table = ExpandLut(lighting_state, static_cast<size_t>(sampler));
+    }
+    return result;
+}
+
+const LightingSetup& GetLightingSetup(const LightingRegs& lighting,
+                                      const State::Lighting& lighting_state) {
+    if (setup_valid) {
+        return cached_setup;
+    }
+
+    using Sampler = LightingRegs::LightingSampler;
+    LightingSetup& setup = cached_setup;
+
+    setup.config = lighting.config0.config;
+    setup.bump_mode = lighting.config0.bump_mode;
+    setup.bump_selector = lighting.config0.bump_selector;
+    setup.bump_renorm = lighting.config0.disable_bump_renorm == 0;
+    setup.clamp_highlights = lighting.config0.clamp_highlights != 0;
+    using FresnelSelector = LightingRegs::LightingFresnelSelector;
+    const FresnelSelector fresnel_selector = lighting.config0.fresnel_selector;
+    setup.fresnel_primary_alpha = fresnel_selector == FresnelSelector::PrimaryAlpha ||
+                                  fresnel_selector == FresnelSelector::Both;
+    setup.fresnel_secondary_alpha = fresnel_selector == FresnelSelector::SecondaryAlpha ||
+                                    fresnel_selector == FresnelSelector::Both;
+    setup.global_ambient = lighting.global_ambient.ToVec3f();
+
+    // The spotlight sampler is always "enabled"; whether it applies is decided per light
+    setup.d0 = MakeSampler(lighting, lighting_state, Sampler::Distribution0,
+                           lighting.config1.disable_lut_d0 == 0, lighting.abs_lut_input.disable_d0,
+                           lighting.lut_input.d0, lighting.lut_scale.d0);
+    setup.d1 = MakeSampler(lighting, lighting_state, Sampler::Distribution1,
+                           lighting.config1.disable_lut_d1 == 0, lighting.abs_lut_input.disable_d1,
+                           lighting.lut_input.d1, lighting.lut_scale.d1);
+    setup.sp = MakeSampler(lighting, lighting_state, Sampler::SpotlightAttenuation, true,
+                           lighting.abs_lut_input.disable_sp, lighting.lut_input.sp,
+                           lighting.lut_scale.sp);
+    setup.fr = MakeSampler(lighting, lighting_state, Sampler::Fresnel,
+                           lighting.config1.disable_lut_fr == 0, lighting.abs_lut_input.disable_fr,
+                           lighting.lut_input.fr, lighting.lut_scale.fr);
+    setup.rr = MakeSampler(lighting, lighting_state, Sampler::ReflectRed,
+                           lighting.config1.disable_lut_rr == 0, lighting.abs_lut_input.disable_rr,
+                           lighting.lut_input.rr, lighting.lut_scale.rr);
+    setup.rg = MakeSampler(lighting, lighting_state, Sampler::ReflectGreen,
+                           lighting.config1.disable_lut_rg == 0, lighting.abs_lut_input.disable_rg,
+                           lighting.lut_input.rg, lighting.lut_scale.rg);
+    setup.rb = MakeSampler(lighting, lighting_state, Sampler::ReflectBlue,
+                           lighting.config1.disable_lut_rb == 0, lighting.abs_lut_input.disable_rb,
+                           lighting.lut_input.rb, lighting.lut_scale.rb);
+
+    setup.num_lights = lighting.max_light_index + 1;
+    for (unsigned light_index = 0; light_index < setup.num_lights; ++light_index) {
+        const unsigned num = lighting.light_enable.GetNum(light_index);
+        const auto& light_config = lighting.light[num];
+        LightingSetup::Light& light = setup.lights[light_index];
+
+        light.position = {float16::FromRaw(light_config.x).ToFloat32(),
+                          float16::FromRaw(light_config.y).ToFloat32(),
+                          float16::FromRaw(light_config.z).ToFloat32()};
+        light.spot_direction = Math::Vec3<s32>{light_config.spot_x.Value(),
+                                               light_config.spot_y.Value(),
+                                               light_config.spot_z.Value()}
+                                   .Cast<float>() /
+                               2047.0f;
+        light.specular_0 = light_config.specular_0.ToVec3f();
+        light.specular_1 = light_config.specular_1.ToVec3f();
+        light.diffuse = light_config.diffuse.ToVec3f();
+        light.ambient = light_config.ambient.ToVec3f();
+        light.directional = light_config.config.directional != 0;
+        light.two_sided_diffuse = light_config.config.two_sided_diffuse != 0;
+        light.geometric_factor_0 = light_config.config.geometric_factor_0 != 0;
+        light.geometric_factor_1 = light_config.config.geometric_factor_1 != 0;
+
+        light.dist_atten_scale = float20::FromRaw(light_config.dist_atten_scale).ToFloat32();
+        light.dist_atten_bias = float20::FromRaw(light_config.dist_atten_bias).ToFloat32();
+        light.dist_atten_lut = nullptr;
+        if (!lighting.IsDistAttenDisabled(num)) {
+            const auto lut = LightingRegs::DistanceAttenuationSampler(num);
+            light.dist_atten_lut = ExpandLut(lighting_state, static_cast<size_t>(lut));
+        }
+
+        light.spot_atten_lut = nullptr;
+        if (!lighting.IsSpotAttenDisabled(num) && setup.sp.enable) {
+            const auto lut = LightingRegs::SpotlightAttenuationSampler(num);
+            light.spot_atten_lut = ExpandLut(lighting_state, static_cast<size_t>(lut));
+        }
+    }
+
+    setup_valid = true;
+    return setup;
+}
+
+static float LookupLightingLut(const LightingSetup::LutTable& lut, u8 index, float delta) {
+    return lut[index][0] + lut[index][1] * delta;
 }
 
 std::tuple<Math::Vec4<u8>, Math::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::State::Lighting& lighting_state,
-    const Math::Quaternion<float>& normquat, const Math::Vec3<float>& view,
-    const Math::Vec4<u8> (&texture_color)[4]) {
+    const LightingSetup& setup, const Math::Quaternion<float>& normquat,
+    const Math::Vec3<float>& view, const Math::Vec4<u8> (&texture_color)[4]) {
 
     Math::Vec3<float> surface_normal;
     Math::Vec3<float> surface_tangent;
 
-    if (lighting.config0.bump_mode != LightingRegs::LightingBumpMode::None) {
+    if (setup.bump_mode != LightingRegs::LightingBumpMode::None) {
         Math::Vec3<float> perturbation =
-            texture_color[lighting.config0.bump_selector].xyz().Cast<float>() / 127.5f -
+            texture_color[setup.bump_selector].xyz().Cast<float>() / 127.5f -
             Math::MakeVec(1.0f, 1.0f, 1.0f);
-        if (lighting.config0.bump_mode == LightingRegs::LightingBumpMode::NormalMap) {
-            if (!lighting.config0.disable_bump_renorm) {
+        if (setup.bump_mode == LightingRegs::LightingBumpMode::NormalMap) {
+            if (setup.bump_renorm) {
                 const float z_square = 1 - perturbation.xy().Length2();
                 perturbation.z = std::sqrt(std::max(z_square, 0.0f));
             }
             surface_normal = perturbation;
             surface_tangent = Math::MakeVec(1.0f, 0.0f, 0.0f);
-        } else if (lighting.config0.bump_mode == LightingRegs::LightingBumpMode::TangentMap) {
+        } else if (setup.bump_mode == LightingRegs::LightingBumpMode::TangentMap) {
             surface_normal = Math::MakeVec(0.0f, 0.0f, 1.0f);
             surface_tangent = perturbation;
         } else {
-            LOG_ERROR(HW_GPU, "Unknown bump mode %u", lighting.config0.bump_mode.Value());
+            LOG_ERROR(HW_GPU, "Unknown bump mode %u", static_cast<u32>(setup.bump_mode));
         }
     } else {
         surface_normal = Math::MakeVec(0.0f, 0.0f, 1.0f);
@@ -54,57 +184,50 @@ std::tuple<Math::Vec4<u8>, Math::Vec4<u8>> ComputeFragmentsColors(
     auto normal = Math::QuaternionRotate(normquat, surface_normal);
     auto tangent = Math::QuaternionRotate(normquat, surface_tangent);
 
+    const Math::Vec3<float> norm_view = view.Normalized();
+
     Math::Vec4<float> diffuse_sum = {0.0f, 0.0f, 0.0f, 1.0f};
     Math::Vec4<float> specular_sum = {0.0f, 0.0f, 0.0f, 1.0f};
 
-    for (unsigned light_index = 0; light_index <= lighting.max_light_index; ++light_index) {
-        unsigned num = lighting.light_enable.GetNum(light_index);
-        const auto& light_config = lighting.light[num];
+    for (unsigned light_index = 0; light_index < setup.num_lights; ++light_index) {
+        const LightingSetup::Light& light = setup.lights[light_index];
 
         Math::Vec3<float> refl_value = {};
-        Math::Vec3<float> position = {float16::FromRaw(light_config.x).ToFloat32(),
-                                      float16::FromRaw(light_config.y).ToFloat32(),
-                                      float16::FromRaw(light_config.z).ToFloat32()};
         Math::Vec3<float> light_vector;
 
-        if (light_config.config.directional)
-            light_vector = position;
+        if (light.directional)
+            light_vector = light.position;
         else
-            light_vector = position + view;
+            light_vector = light.position + view;
 
         light_vector.Normalize();
 
-        Math::Vec3<float> norm_view = view.Normalized();
-        Math::Vec3<float> half_vector = norm_view + light_vector;
+        const Math::Vec3<float> half_vector = norm_view + light_vector;
+        const Math::Vec3<float> norm_half_vector = half_vector.Normalized();
 
         float dist_atten = 1.0f;
-        if (!lighting.IsDistAttenDisabled(num)) {
-            auto distance = (-view - position).Length();
-            float scale = Pica::float20::FromRaw(light_config.dist_atten_scale).ToFloat32();
-            float bias = Pica::float20::FromRaw(light_config.dist_atten_bias).ToFloat32();
-            size_t lut =
-                static_cast<size_t>(LightingRegs::LightingSampler::DistanceAttenuation) + num;
-
-            float sample_loc = MathUtil::Clamp(scale * distance + bias, 0.0f, 1.0f);
+        if (light.dist_atten_lut) {
+            auto distance = (-view - light.position).Length();
+            float sample_loc = MathUtil::Clamp(
+                light.dist_atten_scale * distance + light.dist_atten_bias, 0.0f, 1.0f);
 
             u8 lutindex =
                 static_cast<u8>(MathUtil::Clamp(std::floor(sample_loc * 256.0f), 0.0f, 255.0f));
             float delta = sample_loc * 256 - lutindex;
-            dist_atten = LookupLightingLut(lighting_state, lut, lutindex, delta);
+            dist_atten = LookupLightingLut(*light.dist_atten_lut, lutindex, delta);
         }
 
-        auto GetLutValue = [&](LightingRegs::LightingLutInput input, bool abs,
-                               LightingRegs::LightingScale scale_enum,
-                               LightingRegs::LightingSampler sampler) {
+        auto GetLutValue = [&](const LightingSetup::LutSampler& sampler,
+                               const LightingSetup::LutTable& table) {
             float result = 0.0f;
 
-            switch (input) {
+            switch (sampler.input) {
             case LightingRegs::LightingLutInput::NH:
-                result = Math::Dot(normal, half_vector.Normalized());
+                result = Math::Dot(normal, norm_half_vector);
                 break;
 
             case LightingRegs::LightingLutInput::VH:
-                result = Math::Dot(norm_view, half_vector.Normalized());
+                result = Math::Dot(norm_view, norm_half_vector);
                 break;
 
             case LightingRegs::LightingLutInput::NV:
@@ -115,15 +238,12 @@ std::tuple<Math::Vec4<u8>, Math::Vec4<u8>> ComputeFragmentsColors(
                 result = Math::Dot(light_vector, normal);
                 break;
 
-            case LightingRegs::LightingLutInput::SP: {
-                Math::Vec3<s32> spot_dir{light_config.spot_x.Value(), light_config.spot_y.Value(),
-                                         light_config.spot_z.Value()};
-                result = Math::Dot(light_vector, spot_dir.Cast<float>() / 2047.0f);
+            case LightingRegs::LightingLutInput::SP:
+                result = Math::Dot(light_vector, light.spot_direction);
                 break;
-            }
+
             case LightingRegs::LightingLutInput::CP:
-                if (lighting.config0.config == LightingRegs::LightingConfig::Config7) {
-                    const Math::Vec3<float> norm_half_vector = half_vector.Normalized();
+                if (setup.config == LightingRegs::LightingConfig::Config7) {
                     const Math::Vec3<float> half_vector_proj =
                         norm_half_vector - normal * Math::Dot(normal, norm_half_vector);
                     result = Math::Dot(half_vector_proj, tangent);
@@ -132,7 +252,8 @@ std::tuple<Math::Vec4<u8>, Math::Vec4<u8>> ComputeFragmentsColors(
                 }
                 break;
             default:
-                LOG_CRITICAL(HW_GPU, "Unknown lighting LUT input %u\n", static_cast<u32>(input));
+                LOG_CRITICAL(HW_GPU, "Unknown lighting LUT input %u\n",
+                             static_cast<u32>(sampler.input));
                 UNIMPLEMENTED();
                 result = 0.0f;
             }
@@ -140,8 +261,8 @@ std::tuple<Math::Vec4<u8>, Math::Vec4<u8>> ComputeFragmentsColors(
             u8 index;
             float delta;
 
-            if (abs) {
-                if (light_config.config.two_sided_diffuse)
+            if (sampler.abs_input) {
+                if (light.two_sided_diffuse)
                     result = std::abs(result);
                 else
                     result = std::max(result, 0.0f);
@@ -156,100 +277,64 @@ std::tuple<Math::Vec4<u8>, Math::Vec4<u8>> ComputeFragmentsColors(
                 index = static_cast<u8>(signed_index);
             }
 
-            float scale = lighting.lut_scale.GetScale(scale_enum);
-            return scale *
-                   LookupLightingLut(lighting_state, static_cast<size_t>(sampler), index, delta);
+            return sampler.scale * LookupLightingLut(table, index, delta);
         };
 
         // If enabled, compute spot light attenuation value
         float spot_atten = 1.0f;
-        if (!lighting.IsSpotAttenDisabled(num) &&
-            LightingRegs::IsLightingSamplerSupported(
-                lighting.config0.config, LightingRegs::LightingSampler::SpotlightAttenuation)) {
-            auto lut = LightingRegs::SpotlightAttenuationSampler(num);
-            spot_atten = GetLutValue(lighting.lut_input.sp, lighting.abs_lut_input.disable_sp == 0,
-                                     lighting.lut_scale.sp, lut);
+        if (light.spot_atten_lut) {
+            spot_atten = GetLutValue(setup.sp, *light.spot_atten_lut);
         }
 
         // Specular 0 component
         float d0_lut_value = 1.0f;
-        if (lighting.config1.disable_lut_d0 == 0 &&
-            LightingRegs::IsLightingSamplerSupported(
-                lighting.config0.config, LightingRegs::LightingSampler::Distribution0)) {
-            d0_lut_value =
-                GetLutValue(lighting.lut_input.d0, lighting.abs_lut_input.disable_d0 == 0,
-                            lighting.lut_scale.d0, LightingRegs::LightingSampler::Distribution0);
+        if (setup.d0.enable) {
+            d0_lut_value = GetLutValue(setup.d0, *setup.d0.table);
         }
 
-        Math::Vec3<float> specular_0 = d0_lut_value * light_config.specular_0.ToVec3f();
+        Math::Vec3<float> specular_0 = d0_lut_value * light.specular_0;
 
         // If enabled, lookup ReflectRed value, otherwise, 1.0 is used
-        if (lighting.config1.disable_lut_rr == 0 &&
-            LightingRegs::IsLightingSamplerSupported(lighting.config0.config,
-                                                     LightingRegs::LightingSampler::ReflectRed)) {
-            refl_value.x =
-                GetLutValue(lighting.lut_input.rr, lighting.abs_lut_input.disable_rr == 0,
-                            lighting.lut_scale.rr, LightingRegs::LightingSampler::ReflectRed);
+        if (setup.rr.enable) {
+            refl_value.x = GetLutValue(setup.rr, *setup.rr.table);
         } else {
             refl_value.x = 1.0f;
         }
 
         // If enabled, lookup ReflectGreen value, otherwise, ReflectRed value is used
-        if (lighting.config1.disable_lut_rg == 0 &&
-            LightingRegs::IsLightingSamplerSupported(lighting.config0.config,
-                                                     LightingRegs::LightingSampler::ReflectGreen)) {
-            refl_value.y =
-                GetLutValue(lighting.lut_input.rg, lighting.abs_lut_input.disable_rg == 0,
-                            lighting.lut_scale.rg, LightingRegs::LightingSampler::ReflectGreen);
+        if (setup.rg.enable) {
+            refl_value.y = GetLutValue(setup.rg, *setup.rg.table);
         } else {
             refl_value.y = refl_value.x;
         }
 
         // If enabled, lookup ReflectBlue value, otherwise, ReflectRed value is used
-        if (lighting.config1.disable_lut_rb == 0 &&
-            LightingRegs::IsLightingSamplerSupported(lighting.config0.config,
-                                                     LightingRegs::LightingSampler::ReflectBlue)) {
-            refl_value.z =
-                GetLutValue(lighting.lut_input.rb, lighting.abs_lut_input.disable_rb == 0,
-                            lighting.lut_scale.rb, LightingRegs::LightingSampler::ReflectBlue);
+        if (setup.rb.enable) {
+            refl_value.z = GetLutValue(setup.rb, *setup.rb.table);
         } else {
             refl_value.z = refl_value.x;
         }
 
         // Specular 1 component
         float d1_lut_value = 1.0f;
-        if (lighting.config1.disable_lut_d1 == 0 &&
-            LightingRegs::IsLightingSamplerSupported(
-                lighting.config0.config, LightingRegs::LightingSampler::Distribution1)) {
-            d1_lut_value =
-                GetLutValue(lighting.lut_input.d1, lighting.abs_lut_input.disable_d1 == 0,
-                            lighting.lut_scale.d1, LightingRegs::LightingSampler::Distribution1);
+        if (setup.d1.enable) {
+            d1_lut_value = GetLutValue(setup.d1, *setup.d1.table);
         }
 
-        Math::Vec3<float> specular_1 =
-            d1_lut_value * refl_value * light_config.specular_1.ToVec3f();
+        Math::Vec3<float> specular_1 = d1_lut_value * refl_value * light.specular_1;
 
         // Fresnel
         // Note: only the last entry in the light slots applies the Fresnel factor
-        if (light_index == lighting.max_light_index && lighting.config1.disable_lut_fr == 0 &&
-            LightingRegs::IsLightingSamplerSupported(lighting.config0.config,
-                                                     LightingRegs::LightingSampler::Fresnel)) {
-
-            float lut_value =
-                GetLutValue(lighting.lut_input.fr, lighting.abs_lut_input.disable_fr == 0,
-                            lighting.lut_scale.fr, LightingRegs::LightingSampler::Fresnel);
+        if (light_index == setup.num_lights - 1 && setup.fr.enable) {
+            float lut_value = GetLutValue(setup.fr, *setup.fr.table);
 
             // Enabled for diffuse lighting alpha component
-            if (lighting.config0.fresnel_selector ==
-                    LightingRegs::LightingFresnelSelector::PrimaryAlpha ||
-                lighting.config0.fresnel_selector == LightingRegs::LightingFresnelSelector::Both) {
+            if (setup.fresnel_primary_alpha) {
                 diffuse_sum.a() = lut_value;
             }
 
             // Enabled for the specular lighting alpha component
-            if (lighting.config0.fresnel_selector ==
-                    LightingRegs::LightingFresnelSelector::SecondaryAlpha ||
-                lighting.config0.fresnel_selector == LightingRegs::LightingFresnelSelector::Both) {
+            if (setup.fresnel_secondary_alpha) {
                 specular_sum.a() = lut_value;
             }
         }
@@ -259,38 +344,37 @@ std::tuple<Math::Vec4<u8>, Math::Vec4<u8>> ComputeFragmentsColors(
         // Calculate clamp highlights before applying the two-sided diffuse configuration to the dot
         // product.
         float clamp_highlights = 1.0f;
-        if (lighting.config0.clamp_highlights) {
+        if (setup.clamp_highlights) {
             if (dot_product <= 0.0f)
                 clamp_highlights = 0.0f;
             else
                 clamp_highlights = 1.0f;
         }
 
-        if (light_config.config.two_sided_diffuse)
+        if (light.two_sided_diffuse)
             dot_product = std::abs(dot_product);
         else
             dot_product = std::max(dot_product, 0.0f);
 
-        if (light_config.config.geometric_factor_0 || light_config.config.geometric_factor_1) {
+        if (light.geometric_factor_0 || light.geometric_factor_1) {
             float geo_factor = half_vector.Length2();
             geo_factor = geo_factor == 0.0f ? 0.0f : std::min(dot_product / geo_factor, 1.0f);
-            if (light_config.config.geometric_factor_0) {
+            if (light.geometric_factor_0) {
                 specular_0 *= geo_factor;
             }
-            if (light_config.config.geometric_factor_1) {
+            if (light.geometric_factor_1) {
                 specular_1 *= geo_factor;
             }
         }
 
-        auto diffuse =
-            light_config.diffuse.ToVec3f() * dot_product + light_config.ambient.ToVec3f();
+        auto diffuse = light.diffuse * dot_product + light.ambient;
         diffuse_sum += Math::MakeVec(diffuse * dist_atten * spot_atten, 0.0f);
 
         specular_sum += Math::MakeVec(
             (specular_0 + specular_1) * clamp_highlights * dist_atten * spot_atten, 0.0f);
     }
 
-    diffuse_sum += Math::MakeVec(lighting.global_ambient.ToVec3f(), 0.0f);
+    diffuse_sum += Math::MakeVec(setup.global_ambient, 0.0f);
 
     auto diffuse = Math::MakeVec<float>(MathUtil::Clamp(diffuse_sum.x, 0.0f, 1.0f) * 255,
                                         MathUtil::Clamp(diffuse_sum.y, 0.0f, 1.0f) * 255,
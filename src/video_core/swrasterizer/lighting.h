@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <tuple>
 #include "common/quaternion.h"
 #include "common/vector_math.h"
@@ -11,9 +12,75 @@
 
 namespace Pica {
 
+/**
+ * Fragment lighting state preprocessed for the software rasterizer. Light parameters are decoded
+ * to floats, and the LUTs used by the current configuration are expanded into flat tables, so
+ * that shading a fragment only needs table loads and multiply-adds. Samplers which are disabled
+ * or not supported by the lighting configuration are resolved here as well.
+ */
+struct LightingSetup {
+    /// Value and difference to the next entry of each LUT entry
+    using LutTable = std::array<std::array<float, 2>, 256>;
+
+    struct LutSampler {
+        bool enable;
+        bool abs_input;
+        LightingRegs::LightingLutInput input;
+        float scale;
+        const LutTable* table; ///< Unused for the spotlight sampler, whose table is per light
+    };
+
+    struct Light {
+        Math::Vec3<float> position;
+        Math::Vec3<float> spot_direction;
+        Math::Vec3<float> specular_0;
+        Math::Vec3<float> specular_1;
+        Math::Vec3<float> diffuse;
+        Math::Vec3<float> ambient;
+        bool directional;
+        bool two_sided_diffuse;
+        bool geometric_factor_0;
+        bool geometric_factor_1;
+        float dist_atten_scale;
+        float dist_atten_bias;
+        const LutTable* dist_atten_lut; ///< nullptr if distance attenuation is disabled
+        const LutTable* spot_atten_lut; ///< nullptr if spotlight attenuation is disabled
+    };
+
+    std::array<Light, 8> lights;
+    unsigned num_lights;
+
+    LutSampler d0, d1, sp, fr, rr, rg, rb;
+
+    LightingRegs::LightingConfig config;
+    LightingRegs::LightingBumpMode bump_mode;
+    unsigned bump_selector;
+    bool bump_renorm;
+    bool clamp_highlights;
+    bool fresnel_primary_alpha;
+    bool fresnel_secondary_alpha;
+    Math::Vec3<float> global_ambient;
+
+    /// Expanded LUTs, indexed by LightingRegs::LightingSampler
+    std::array<LutTable, LightingRegs::NumLightingSampler> luts;
+};
+
+/**
+ * Returns the lighting state preprocessed for the given registers and LUTs. The previous result
+ * is reused until the lighting registers or LUTs change, see InvalidateLightingSetup and
+ * InvalidateLightingLut.
+ */
+const LightingSetup& GetLightingSetup(const LightingRegs& lighting,
+                                      const State::Lighting& lighting_state);
+
+/// Marks the lighting registers as modified, rebuilding the setup on its next use.
+void InvalidateLightingSetup();
+
+/// Marks the contents of a lighting LUT as modified, expanding it again on its next use.
+void InvalidateLightingLut(size_t lut_index);
+
 std::tuple<Math::Vec4<u8>, Math::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::State::Lighting& lighting_state,
-    const Math::Quaternion<float>& normquat, const Math::Vec3<float>& view,
-    const Math::Vec4<u8> (&texture_color)[4]);
+    const LightingSetup& setup, const Math::Quaternion<float>& normquat,
+    const Math::Vec3<float>& view, const Math::Vec4<u8> (&texture_color)[4]);
 
 } // namespace Pica
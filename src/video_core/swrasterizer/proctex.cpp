@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 #include "common/math_util.h"
 #include "video_core/swrasterizer/proctex.h"
 
@@ -14,15 +17,36 @@ using ProcTexClamp = TexturingRegs::ProcTexClamp;
 using ProcTexShift = TexturingRegs::ProcTexShift;
 using ProcTexCombiner = TexturingRegs::ProcTexCombiner;
 using ProcTexFilter = TexturingRegs::ProcTexFilter;
+using Axis = ProcTexSetup::Axis;
 
-static float LookupLUT(const std::array<State::ProcTex::ValueEntry, 128>& lut, float coord) {
+namespace {
+
+/// Size of the registers from proctex to proctex_lut_offset, which configure the texture
+constexpr size_t PROCTEX_REGS_SIZE = offsetof(TexturingRegs, proctex_lut_offset) + sizeof(u32) -
+                                     offsetof(TexturingRegs, proctex);
+
+ProcTexSetup cached_setup;
+bool setup_valid = false;
+bool setup_built = false;
+
+// Registers and LUTs the cached setup was built from
+std::array<u8, PROCTEX_REGS_SIZE> cached_regs;
+State::ProcTex cached_state;
+
+} // Anonymous namespace
+
+void InvalidateProcTexSetup() {
+    setup_valid = false;
+}
+
+static float LookupLUT(const ProcTexSetup::LutTable& lut, float coord) {
     // For NoiseLUT/ColorMap/AlphaMap, coord=0.0 is lut[0], coord=127.0/128.0 is lut[127] and
     // coord=1.0 is lut[127]+lut_diff[127]. For other indices, the result is interpolated using
     // value entries and difference entries.
     coord *= 128;
     const int index_int = std::min(static_cast<int>(coord), 127);
     const float frac = coord - index_int;
-    return lut[index_int].ToFloat() + frac * lut[index_int].DiffToFloat();
+    return lut[index_int][0] + frac * lut[index_int][1];
 }
 
 // These function are used to generate random noise for procedural texture. Their results are
@@ -46,13 +70,9 @@ static float NoiseRand2D(unsigned int x, unsigned int y) {
     return -1.0f + v2 * 2.0f / 15.0f;
 }
 
-static float NoiseCoef(float u, float v, TexturingRegs regs, State::ProcTex state) {
-    const float freq_u = float16::FromRaw(regs.proctex_noise_frequency.u).ToFloat32();
-    const float freq_v = float16::FromRaw(regs.proctex_noise_frequency.v).ToFloat32();
-    const float phase_u = float16::FromRaw(regs.proctex_noise_u.phase).ToFloat32();
-    const float phase_v = float16::FromRaw(regs.proctex_noise_v.phase).ToFloat32();
-    const float x = 9 * freq_u * std::abs(u + phase_u);
-    const float y = 9 * freq_v * std::abs(v + phase_v);
+static float NoiseCoef(float u, float v, const ProcTexSetup& setup) {
+    const float x = 9 * setup.noise_freq_u * std::abs(u + setup.noise_phase_u);
+    const float y = 9 * setup.noise_freq_v * std::abs(v + setup.noise_phase_v);
     const int x_int = static_cast<int>(x);
     const int y_int = static_cast<int>(y);
     const float x_frac = x - x_int;
@@ -62,8 +82,8 @@ static float NoiseCoef(float u, float v, TexturingRegs regs, State::ProcTex stat
     const float g1 = NoiseRand2D(x_int + 1, y_int) * (x_frac + y_frac - 1);
     const float g2 = NoiseRand2D(x_int, y_int + 1) * (x_frac + y_frac - 1);
     const float g3 = NoiseRand2D(x_int + 1, y_int + 1) * (x_frac + y_frac - 2);
-    const float x_noise = LookupLUT(state.noise_table, x_frac);
-    const float y_noise = LookupLUT(state.noise_table, y_frac);
+    const float x_noise = LookupLUT(setup.noise_table, x_frac);
+    const float y_noise = LookupLUT(setup.noise_table, y_frac);
     return Math::BilinearInterp(g0, g1, g2, g3, x_noise, y_noise);
 }
 
@@ -113,8 +133,8 @@ static void ClampCoord(float& coord, ProcTexClamp mode) {
     }
 }
 
-float CombineAndMap(float u, float v, ProcTexCombiner combiner,
-                    const std::array<State::ProcTex::ValueEntry, 128>& map_table) {
+static float CombineAndMap(float u, float v, ProcTexCombiner combiner,
+                           const ProcTexSetup::LutTable& map_table) {
     float f;
     switch (combiner) {
     case ProcTexCombiner::U:
@@ -155,19 +175,255 @@ float CombineAndMap(float u, float v, ProcTexCombiner combiner,
     return LookupLUT(map_table, f);
 }
 
-Math::Vec4<u8> ProcTex(float u, float v, TexturingRegs regs, State::ProcTex state) {
+/// Returns the fractional color LUT index of a mapped coordinate.
+static float GetColorIndex(const ProcTexSetup& setup, float lut_coord) {
+    // For the color lut, coord=0.0 is lut[offset] and coord=1.0 is lut[offset+width-1]
+    return setup.lut_offset + (lut_coord * (setup.lut_width - 1));
+}
+
+static bool IsNearestFilter(ProcTexFilter filter) {
+    return filter == ProcTexFilter::Nearest || filter == ProcTexFilter::NearestMipmapLinear ||
+           filter == ProcTexFilter::NearestMipmapNearest;
+}
+
+/// Looks up the final color of the given clamped coordinates.
+static Math::Vec4<u8> MapColor(const ProcTexSetup& setup, float u, float v) {
+    const float lut_coord = CombineAndMap(u, v, setup.color_combiner, setup.color_map_table);
+
+    // Look up the color
+    const float index = GetColorIndex(setup, lut_coord);
+    // TODO(wwylele): implement mipmap
+    switch (setup.filter) {
+    case ProcTexFilter::Linear:
+    case ProcTexFilter::LinearMipmapLinear:
+    case ProcTexFilter::LinearMipmapNearest: {
+        const int index_int = static_cast<int>(index);
+        const float frac = index - index_int;
+        return (setup.color_value_table[index_int] + frac * setup.color_diff_table[index_int])
+            .Cast<u8>();
+    }
+    case ProcTexFilter::Nearest:
+    case ProcTexFilter::NearestMipmapLinear:
+    case ProcTexFilter::NearestMipmapNearest:
+        return setup.color_table[static_cast<int>(std::round(index))];
+    }
+    return {};
+}
+
+/// Looks up the final alpha of the given clamped coordinates, in separate alpha mode.
+static u8 MapAlpha(const ProcTexSetup& setup, float u, float v) {
+    // Note: in separate alpha mode, the alpha channel skips the color LUT look up stage. It
+    // uses the output of CombineAndMap directly instead.
+    const float final_alpha = CombineAndMap(u, v, setup.alpha_combiner, setup.alpha_map_table);
+    return static_cast<u8>(final_alpha * 255);
+}
+
+/// Returns the only coordinate a combiner depends on, if any.
+static Axis GetCombinerAxis(ProcTexCombiner combiner) {
+    switch (combiner) {
+    case ProcTexCombiner::U:
+    case ProcTexCombiner::U2:
+        return Axis::U;
+    case ProcTexCombiner::V:
+    case ProcTexCombiner::V2:
+        return Axis::V;
+    default:
+        return Axis::Both;
+    }
+}
+
+/// Whether a coordinate only depends on its own input, or is also shifted based on the other one.
+static bool IsUnshifted(const ProcTexSetup& setup, Axis axis) {
+    return (axis == Axis::U ? setup.u_shift : setup.v_shift) == ProcTexShift::None;
+}
+
+/// Returns the combined coordinate of a combiner that only depends on the given coordinate.
+static float CombineSingle(float coord, ProcTexCombiner combiner) {
+    return combiner == ProcTexCombiner::U2 || combiner == ProcTexCombiner::V2 ? coord * coord
+                                                                              : coord;
+}
+
+/// Returns the entry of a map LUT that LookupLUT interpolates for a combined coordinate.
+static int GetMapEntry(float f) {
+    return std::min(static_cast<int>(f * 128), 127);
+}
+
+/**
+ * Returns whether the color is the same for every coordinate from lo to hi. Between these, the
+ * combined coordinate, the map LUT lookup and the color LUT index are all monotonic, so the color
+ * can only vary if they cross a map LUT entry, a color LUT entry, or if the ends differ.
+ */
+static bool IsColorConstant(const ProcTexSetup& setup, float lo, float hi) {
+    const float f_lo = CombineSingle(lo, setup.color_combiner);
+    const float f_hi = CombineSingle(hi, setup.color_combiner);
+    if (GetMapEntry(f_lo) != GetMapEntry(f_hi)) {
+        return false;
+    }
+
+    const float index_lo = GetColorIndex(setup, LookupLUT(setup.color_map_table, f_lo));
+    const float index_hi = GetColorIndex(setup, LookupLUT(setup.color_map_table, f_hi));
+    const bool same_entry = IsNearestFilter(setup.filter)
+                                ? std::round(index_lo) == std::round(index_hi)
+                                : static_cast<int>(index_lo) == static_cast<int>(index_hi);
+    const Math::Vec4<u8> color_lo = MapColor(setup, lo, lo);
+    const Math::Vec4<u8> color_hi = MapColor(setup, hi, hi);
+    return same_entry && color_lo.r() == color_hi.r() && color_lo.g() == color_hi.g() &&
+           color_lo.b() == color_hi.b() && color_lo.a() == color_hi.a();
+}
+
+/// Returns whether the separate alpha is the same for every coordinate from lo to hi.
+static bool IsAlphaConstant(const ProcTexSetup& setup, float lo, float hi) {
+    return GetMapEntry(CombineSingle(lo, setup.alpha_combiner)) ==
+               GetMapEntry(CombineSingle(hi, setup.alpha_combiner)) &&
+           MapAlpha(setup, lo, lo) == MapAlpha(setup, hi, hi);
+}
+
+/// Returns the last coordinate covered by baked entry i.
+static float GetBakedRangeEnd(unsigned i) {
+    constexpr unsigned resolution = ProcTexSetup::BakeResolution;
+    return i == resolution ? 1.0f : std::nextafter(static_cast<float>(i + 1) / resolution, 0.0f);
+}
+
+static void BakeTables(ProcTexSetup& setup) {
+    setup.color_axis = GetCombinerAxis(setup.color_combiner);
+    setup.alpha_axis = GetCombinerAxis(setup.alpha_combiner);
+    setup.baked = !setup.noise_enable && setup.color_axis != Axis::Both &&
+                  IsUnshifted(setup, setup.color_axis) &&
+                  (!setup.separate_alpha ||
+                   (setup.alpha_axis != Axis::Both && IsUnshifted(setup, setup.alpha_axis)));
+    if (!setup.baked) {
+        return;
+    }
+
+    // Entry i covers the coordinates from i / BakeResolution up to, but excluding, the next
+    // entry, and the last entry covers 1.0 alone. It is only used if the result is the same over
+    // its whole range. The combiners ignore the other coordinate, so the same value can be passed
+    // for both.
+    constexpr unsigned resolution = ProcTexSetup::BakeResolution;
+    setup.baked_color.resize(resolution + 1);
+    setup.baked_color_exact.resize(resolution + 1);
+    for (unsigned i = 0; i <= resolution; ++i) {
+        const float lo = static_cast<float>(i) / resolution;
+        const float hi = GetBakedRangeEnd(i);
+        setup.baked_color[i] = MapColor(setup, lo, lo);
+        setup.baked_color_exact[i] = IsColorConstant(setup, lo, hi);
+    }
+
+    if (setup.separate_alpha) {
+        setup.baked_alpha.resize(resolution + 1);
+        setup.baked_alpha_exact.resize(resolution + 1);
+        for (unsigned i = 0; i <= resolution; ++i) {
+            const float lo = static_cast<float>(i) / resolution;
+            const float hi = GetBakedRangeEnd(i);
+            setup.baked_alpha[i] = MapAlpha(setup, lo, lo);
+            setup.baked_alpha_exact[i] = IsAlphaConstant(setup, lo, hi);
+        }
+    }
+}
+
+static void ExpandLut(ProcTexSetup::LutTable& table,
+                      const std::array<State::ProcTex::ValueEntry, 128>& lut) {
+    for (size_t i = 0; i < lut.size(); ++i) {
+        table[i] = {lut[i].ToFloat(), lut[i].DiffToFloat()};
+    }
+}
+
+static void BuildSetup(ProcTexSetup& setup, const TexturingRegs& regs,
+                       const State::ProcTex& state) {
+    setup.u_clamp = regs.proctex.u_clamp;
+    setup.v_clamp = regs.proctex.v_clamp;
+    setup.u_shift = regs.proctex.u_shift;
+    setup.v_shift = regs.proctex.v_shift;
+    setup.color_combiner = regs.proctex.color_combiner;
+    setup.alpha_combiner = regs.proctex.alpha_combiner;
+    setup.separate_alpha = regs.proctex.separate_alpha != 0;
+
+    setup.noise_enable = regs.proctex.noise_enable != 0;
+    setup.noise_freq_u = float16::FromRaw(regs.proctex_noise_frequency.u).ToFloat32();
+    setup.noise_freq_v = float16::FromRaw(regs.proctex_noise_frequency.v).ToFloat32();
+    setup.noise_phase_u = float16::FromRaw(regs.proctex_noise_u.phase).ToFloat32();
+    setup.noise_phase_v = float16::FromRaw(regs.proctex_noise_v.phase).ToFloat32();
+    setup.noise_amplitude_u = static_cast<float>(regs.proctex_noise_u.amplitude);
+    setup.noise_amplitude_v = static_cast<float>(regs.proctex_noise_v.amplitude);
+
+    setup.filter = regs.proctex_lut.filter;
+    setup.lut_offset = regs.proctex_lut_offset;
+    setup.lut_width = regs.proctex_lut.width;
+
+    ExpandLut(setup.noise_table, state.noise_table);
+    ExpandLut(setup.color_map_table, state.color_map_table);
+    ExpandLut(setup.alpha_map_table, state.alpha_map_table);
+    for (size_t i = 0; i < state.color_table.size(); ++i) {
+        setup.color_table[i] = state.color_table[i].ToVector();
+        setup.color_value_table[i] = setup.color_table[i].Cast<float>();
+        setup.color_diff_table[i] = state.color_diff_table[i].ToVector().Cast<float>();
+    }
+
+    BakeTables(setup);
+}
+
+const ProcTexSetup& GetProcTexSetup(const TexturingRegs& regs, const State::ProcTex& state) {
+    if (setup_valid) {
+        return cached_setup;
+    }
+
+    // Games often rewrite the registers and LUTs with the same values before each draw, so check
+    // whether anything changed before building the setup, and possibly baking the texture, again
+    const u8* regs_begin = reinterpret_cast<const u8*>(&regs.proctex);
+    if (!setup_built || std::memcmp(cached_regs.data(), regs_begin, PROCTEX_REGS_SIZE) != 0 ||
+        std::memcmp(&cached_state, &state, sizeof(state)) != 0) {
+        std::memcpy(cached_regs.data(), regs_begin, PROCTEX_REGS_SIZE);
+        std::memcpy(&cached_state, &state, sizeof(state));
+        BuildSetup(cached_setup, regs, state);
+        setup_built = true;
+    }
+
+    setup_valid = true;
+    return cached_setup;
+}
+
+/// Returns the baked table entry covering a clamped coordinate, or -1 if there is none.
+static int GetBakedIndex(float coord) {
+    // Scaling by a power of two is exact, so this matches the ranges the entries were baked for.
+    // The clamp modes let NaN through, which is left to the unbaked path.
+    const float scaled = coord * ProcTexSetup::BakeResolution;
+    if (!(scaled >= 0.0f && scaled <= ProcTexSetup::BakeResolution)) {
+        return -1;
+    }
+    return static_cast<int>(scaled);
+}
+
+Math::Vec4<u8> ProcTex(const ProcTexSetup& setup, float u, float v) {
     u = std::abs(u);
     v = std::abs(v);
 
+    if (setup.baked) {
+        // Without noise and shift, the general path below reduces to clamping and mapping, which
+        // is also what entries that aren't constant over their range fall back to
+        ClampCoord(u, setup.u_clamp);
+        ClampCoord(v, setup.v_clamp);
+        const int color_index = GetBakedIndex(setup.color_axis == Axis::U ? u : v);
+        Math::Vec4<u8> color = color_index >= 0 && setup.baked_color_exact[color_index]
+                                   ? setup.baked_color[color_index]
+                                   : MapColor(setup, u, v);
+        if (setup.separate_alpha) {
+            const int alpha_index = GetBakedIndex(setup.alpha_axis == Axis::U ? u : v);
+            color.a() = alpha_index >= 0 && setup.baked_alpha_exact[alpha_index]
+                            ? setup.baked_alpha[alpha_index]
+                            : MapAlpha(setup, u, v);
+        }
+        return color;
+    }
+
     // Get shift offset before noise generation
-    const float u_shift = GetShiftOffset(v, regs.proctex.u_shift, regs.proctex.u_clamp);
-    const float v_shift = GetShiftOffset(u, regs.proctex.v_shift, regs.proctex.v_clamp);
+    const float u_shift = GetShiftOffset(v, setup.u_shift, setup.u_clamp);
+    const float v_shift = GetShiftOffset(u, setup.v_shift, setup.v_clamp);
 
     // Generate noise
-    if (regs.proctex.noise_enable) {
-        float noise = NoiseCoef(u, v, regs, state);
-        u += noise * regs.proctex_noise_u.amplitude / 4095.0f;
-        v += noise * regs.proctex_noise_v.amplitude / 4095.0f;
+    if (setup.noise_enable) {
+        float noise = NoiseCoef(u, v, setup);
+        u += noise * setup.noise_amplitude_u / 4095.0f;
+        v += noise * setup.noise_amplitude_v / 4095.0f;
         u = std::abs(u);
         v = std::abs(v);
     }
@@ -177,46 +433,15 @@ Math::Vec4<u8> ProcTex(float u, float v, TexturingRegs regs, State::ProcTex stat
     v += v_shift;
 
     // Clamp
-    ClampCoord(u, regs.proctex.u_clamp);
-    ClampCoord(v, regs.proctex.v_clamp);
+    ClampCoord(u, setup.u_clamp);
+    ClampCoord(v, setup.v_clamp);
 
     // Combine and map
-    const float lut_coord = CombineAndMap(u, v, regs.proctex.color_combiner, state.color_map_table);
-
-    // Look up the color
-    // For the color lut, coord=0.0 is lut[offset] and coord=1.0 is lut[offset+width-1]
-    const u32 offset = regs.proctex_lut_offset;
-    const u32 width = regs.proctex_lut.width;
-    const float index = offset + (lut_coord * (width - 1));
-    Math::Vec4<u8> final_color;
-    // TODO(wwylele): implement mipmap
-    switch (regs.proctex_lut.filter) {
-    case ProcTexFilter::Linear:
-    case ProcTexFilter::LinearMipmapLinear:
-    case ProcTexFilter::LinearMipmapNearest: {
-        const int index_int = static_cast<int>(index);
-        const float frac = index - index_int;
-        const auto color_value = state.color_table[index_int].ToVector().Cast<float>();
-        const auto color_diff = state.color_diff_table[index_int].ToVector().Cast<float>();
-        final_color = (color_value + frac * color_diff).Cast<u8>();
-        break;
-    }
-    case ProcTexFilter::Nearest:
-    case ProcTexFilter::NearestMipmapLinear:
-    case ProcTexFilter::NearestMipmapNearest:
-        final_color = state.color_table[static_cast<int>(std::round(index))].ToVector();
-        break;
-    }
-
-    if (regs.proctex.separate_alpha) {
-        // Note: in separate alpha mode, the alpha channel skips the color LUT look up stage. It
-        // uses the output of CombineAndMap directly instead.
-        const float final_alpha =
-            CombineAndMap(u, v, regs.proctex.alpha_combiner, state.alpha_map_table);
-        return Math::MakeVec<u8>(final_color.rgb(), static_cast<u8>(final_alpha * 255));
-    } else {
-        return final_color;
+    Math::Vec4<u8> color = MapColor(setup, u, v);
+    if (setup.separate_alpha) {
+        color.a() = MapAlpha(setup, u, v);
     }
+    return color;
 }
 
 } // namespace Rasterizer
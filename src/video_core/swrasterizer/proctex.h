@@ -2,6 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#pragma once
+
+#include <array>
+#include <vector>
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/pica_state.h"
@@ -9,8 +13,73 @@
 namespace Pica {
 namespace Rasterizer {
 
+/**
+ * Procedural texture state preprocessed for the software rasterizer. The registers are decoded and
+ * the LUTs are expanded to floats once, instead of for every sampled fragment.
+ *
+ * When the color (and separate alpha) only depend on one coordinate each, and that coordinate is
+ * neither shifted nor perturbed by noise, the whole texture is baked into tables indexed by the
+ * clamped coordinate. Sampling a range of coordinates over which the result is constant is then a
+ * single lookup, and other ranges are evaluated as usual, so the result is always unchanged.
+ */
+struct ProcTexSetup {
+    /// Value and difference to the next entry of each LUT entry
+    using LutTable = std::array<std::array<float, 2>, 128>;
+
+    /// Number of intervals of the [0, 1] coordinate range covered by the baked tables
+    static constexpr unsigned BakeResolution = 4096;
+
+    enum class Axis { Both, U, V };
+
+    TexturingRegs::ProcTexClamp u_clamp;
+    TexturingRegs::ProcTexClamp v_clamp;
+    TexturingRegs::ProcTexShift u_shift;
+    TexturingRegs::ProcTexShift v_shift;
+    TexturingRegs::ProcTexCombiner color_combiner;
+    TexturingRegs::ProcTexCombiner alpha_combiner;
+    bool separate_alpha;
+
+    bool noise_enable;
+    float noise_freq_u;
+    float noise_freq_v;
+    float noise_phase_u;
+    float noise_phase_v;
+    float noise_amplitude_u;
+    float noise_amplitude_v;
+
+    TexturingRegs::ProcTexFilter filter;
+    u32 lut_offset;
+    u32 lut_width;
+
+    LutTable noise_table;
+    LutTable color_map_table;
+    LutTable alpha_map_table;
+    std::array<Math::Vec4<u8>, 256> color_table;
+    std::array<Math::Vec4<float>, 256> color_value_table;
+    std::array<Math::Vec4<float>, 256> color_diff_table;
+
+    bool baked;
+    Axis color_axis; ///< Coordinate the baked color depends on
+    Axis alpha_axis; ///< Coordinate the baked alpha depends on, if separate_alpha is set
+    std::vector<Math::Vec4<u8>> baked_color;
+    std::vector<u8> baked_alpha;
+    /// Whether the baked entries hold for every coordinate in their range
+    std::vector<u8> baked_color_exact;
+    std::vector<u8> baked_alpha_exact;
+};
+
+/**
+ * Returns the procedural texture state preprocessed for the given registers and LUTs. The previous
+ * result is reused until InvalidateProcTexSetup is called, and after that as well if the registers
+ * and LUTs turn out to be unchanged.
+ */
+const ProcTexSetup& GetProcTexSetup(const TexturingRegs& regs, const State::ProcTex& state);
+
+/// Marks the procedural texture registers or LUTs as modified, checking them on the next use.
+void InvalidateProcTexSetup();
+
 /// Generates procedural texture color for the given coordinates
-Math::Vec4<u8> ProcTex(float u, float v, TexturingRegs regs, State::ProcTex state);
+Math::Vec4<u8> ProcTex(const ProcTexSetup& setup, float u, float v);
 
 } // namespace Rasterizer
 } // namespace Pica
@@ -214,6 +214,20 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
     auto textures = regs.texturing.GetTextures();
     auto tev_stages = regs.texturing.GetTevStages();
 
+    const LightingSetup* lighting_setup = nullptr;
+    if (!regs.lighting.disable) {
+        lighting_setup = &GetLightingSetup(regs.lighting, g_state.lighting);
+    }
+
+    const RenderTargets& render_targets = GetRenderTargets(regs.framebuffer.framebuffer);
+    const ColorTarget& color_target = render_targets.color;
+    const DepthTarget& depth_target = render_targets.depth;
+
+    const ProcTexSetup* proctex_setup = nullptr;
+    if (regs.texturing.main_config.texture3_enable) {
+        proctex_setup = &GetProcTexSetup(regs.texturing, g_state.proctex);
+    }
+
     bool stencil_action_enable =
         g_state.regs.framebuffer.output_merger.stencil_test.enable &&
         g_state.regs.framebuffer.framebuffer.depth_format == FramebufferRegs::DepthFormat::D24S8;
@@ -401,8 +415,8 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
             // sample procedural texture
             if (regs.texturing.main_config.texture3_enable) {
                 const auto& proctex_uv = uv[regs.texturing.main_config.texture3_coordinates];
-                texture_color[3] = ProcTex(proctex_uv.u().ToFloat32(), proctex_uv.v().ToFloat32(),
-                                           g_state.regs.texturing, g_state.proctex);
+                texture_color[3] = ProcTex(*proctex_setup, proctex_uv.u().ToFloat32(),
+                                           proctex_uv.v().ToFloat32());
             }
 
             // Texture environment - consists of 6 stages of color and alpha combining.
@@ -437,8 +451,8 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
                     GetInterpolatedAttribute(v0.view.y, v1.view.y, v2.view.y).ToFloat32(),
                     GetInterpolatedAttribute(v0.view.z, v1.view.z, v2.view.z).ToFloat32(),
                 };
-                std::tie(primary_fragment_color, secondary_fragment_color) = ComputeFragmentsColors(
-                    g_state.regs.lighting, g_state.lighting, normquat, view, texture_color);
+                std::tie(primary_fragment_color, secondary_fragment_color) =
+                    ComputeFragmentsColors(*lighting_setup, normquat, view, texture_color);
             }
 
             for (unsigned tev_stage_index = 0; tev_stage_index < tev_stages.size();
@@ -617,17 +631,18 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
 
             u8 old_stencil = 0;
 
-            auto UpdateStencil = [stencil_test, x, y,
-                                  &old_stencil](Pica::FramebufferRegs::StencilAction action) {
+            auto UpdateStencil = [stencil_test, x, y, &old_stencil,
+                                  &depth_target](Pica::FramebufferRegs::StencilAction action) {
                 u8 new_stencil =
                     PerformStencilAction(action, old_stencil, stencil_test.reference_value);
                 if (g_state.regs.framebuffer.framebuffer.allow_depth_stencil_write != 0)
-                    SetStencil(x >> 4, y >> 4, (new_stencil & stencil_test.write_mask) |
-                                                   (old_stencil & ~stencil_test.write_mask));
+                    depth_target.SetStencil(x >> 4, y >> 4,
+                                            (new_stencil & stencil_test.write_mask) |
+                                                (old_stencil & ~stencil_test.write_mask));
             };
 
             if (stencil_action_enable) {
-                old_stencil = GetStencil(x >> 4, y >> 4);
+                old_stencil = depth_target.GetStencil(x >> 4, y >> 4);
                 u8 dest = old_stencil & stencil_test.input_mask;
                 u8 ref = stencil_test.reference_value & stencil_test.input_mask;
 
@@ -678,7 +693,7 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
             u32 z = (u32)(depth * ((1 << num_bits) - 1));
 
             if (output_merger.depth_test_enable) {
-                u32 ref_z = GetDepth(x >> 4, y >> 4);
+                u32 ref_z = depth_target.GetDepth(x >> 4, y >> 4);
 
                 bool pass = false;
 
@@ -726,14 +741,14 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
             if (regs.framebuffer.framebuffer.allow_depth_stencil_write != 0 &&
                 output_merger.depth_write_enable) {
 
-                SetDepth(x >> 4, y >> 4, z);
+                depth_target.SetDepth(x >> 4, y >> 4, z);
             }
 
             // The stencil depth_pass action is executed even if depth testing is disabled
             if (stencil_action_enable)
                 UpdateStencil(stencil_test.action_depth_pass);
 
-            auto dest = GetPixel(x >> 4, y >> 4);
+            auto dest = color_target.GetPixel(x >> 4, y >> 4);
             Math::Vec4<u8> blend_output = combiner_output;
 
             if (output_merger.alphablend_enable) {
@@ -839,7 +854,7 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
             };
 
             if (regs.framebuffer.framebuffer.allow_color_write != 0)
-                DrawPixel(x >> 4, y >> 4, result);
+                color_target.DrawPixel(x >> 4, y >> 4, result);
         }
     }
 }
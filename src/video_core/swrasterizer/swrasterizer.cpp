@@ -2,14 +2,57 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "video_core/pica_state.h"
+#include "video_core/regs.h"
 #include "video_core/swrasterizer/clipper.h"
+#include "video_core/swrasterizer/framebuffer.h"
+#include "video_core/swrasterizer/lighting.h"
+#include "video_core/swrasterizer/proctex.h"
 #include "video_core/swrasterizer/swrasterizer.h"
 
 namespace VideoCore {
 
+SWRasterizer::SWRasterizer() {
+    // The registers may have changed while another rasterizer was active
+    Pica::InvalidateLightingSetup();
+    for (size_t lut = 0; lut < Pica::LightingRegs::NumLightingSampler; ++lut) {
+        Pica::InvalidateLightingLut(lut);
+    }
+    Pica::Rasterizer::InvalidateProcTexSetup();
+    Pica::Rasterizer::InvalidateRenderTargets();
+}
+
 void SWRasterizer::AddTriangle(const Pica::Shader::OutputVertex& v0,
                                const Pica::Shader::OutputVertex& v1,
                                const Pica::Shader::OutputVertex& v2) {
     Pica::Clipper::ProcessTriangle(v0, v1, v2);
 }
+
+void SWRasterizer::NotifyPicaRegisterChanged(u32 id) {
+    constexpr u32 lighting_begin = PICA_REG_INDEX(lighting);
+    constexpr u32 lighting_end = lighting_begin + sizeof(Pica::LightingRegs) / sizeof(u32);
+    constexpr u32 lut_data_begin = PICA_REG_INDEX_WORKAROUND(lighting.lut_data[0], 0x1c8);
+    constexpr u32 lut_data_end = PICA_REG_INDEX_WORKAROUND(lighting.lut_data[7], 0x1cf) + 1;
+    constexpr u32 framebuffer_begin = PICA_REG_INDEX(framebuffer.framebuffer);
+    constexpr u32 framebuffer_end =
+        framebuffer_begin + sizeof(Pica::FramebufferRegs::FramebufferConfig) / sizeof(u32);
+    constexpr u32 proctex_begin = PICA_REG_INDEX(texturing.proctex);
+    constexpr u32 proctex_end = PICA_REG_INDEX_WORKAROUND(texturing.proctex_lut_data[7], 0xb7) + 1;
+
+    // Keep the preprocessed fragment lighting state in sync with its registers and LUTs
+    if (id >= lut_data_begin && id < lut_data_end) {
+        const u32 lut = Pica::g_state.regs.lighting.lut_config.type;
+        if (lut < Pica::LightingRegs::NumLightingSampler) {
+            Pica::InvalidateLightingLut(lut);
+        }
+    } else if (id >= lighting_begin && id < lighting_end) {
+        Pica::InvalidateLightingSetup();
+    } else if (id >= proctex_begin && id < proctex_end) {
+        // The procedural texture setup is checked against the registers and LUTs on its next use
+        Pica::Rasterizer::InvalidateProcTexSetup();
+    } else if (id >= framebuffer_begin && id < framebuffer_end) {
+        // Buffer addresses, dimensions or formats
+        Pica::Rasterizer::InvalidateRenderTargets();
+    }
+}
 }
@@ -1,5 +1,4 @@
-#include <memory>
-#include <boost/range/algorithm/fill.hpp>
+#include <cstring>
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_field.h"
@@ -16,17 +15,51 @@
 
 namespace Pica {
 
+/**
+ * Loads an attribute of N components of type T. Instantiated for every format/size combination
+ * so that the per-component format switch is resolved when the loader is set up.
+ */
+template <typename T, unsigned N>
+static void LoadAttribute(const u8* source, Math::Vec4<float24>& attribute) {
+    T data[N];
+    std::memcpy(data, source, sizeof(data));
+    for (unsigned comp = 0; comp < N; ++comp) {
+        attribute[comp] = float24::FromFloat32(static_cast<float>(data[comp]));
+    }
+
+    // Default attribute values set if array elements have < 4 components. This
+    // is *not* carried over from the default attribute settings even if they're
+    // enabled for this attribute.
+    for (unsigned comp = N; comp < 4; ++comp) {
+        attribute[comp] = comp == 3 ? float24::FromFloat32(1.0f) : float24::FromFloat32(0.0f);
+    }
+}
+
+template <typename T>
+static std::array<void (*)(const u8*, Math::Vec4<float24>&), 4> LoadFuncs() {
+    return {{&LoadAttribute<T, 1>, &LoadAttribute<T, 2>, &LoadAttribute<T, 3>,
+             &LoadAttribute<T, 4>}};
+}
+
 void VertexLoader::Setup(const PipelineRegs& regs) {
     ASSERT_MSG(!is_setup, "VertexLoader is not intended to be setup more than once.");
 
+    // Indexed by PipelineRegs::VertexAttributeFormat, then by number of elements minus 1
+    static const std::array<std::array<AttributeLoadFunc, 4>, 4> load_funcs = {{
+        LoadFuncs<s8>(), LoadFuncs<u8>(), LoadFuncs<s16>(), LoadFuncs<float>(),
+    }};
+
     const auto& attribute_config = regs.vertex_attributes;
     num_total_attributes = attribute_config.GetNumTotalAttributes();
 
-    boost::fill(vertex_attribute_sources, 0xdeadbeef);
+    std::memcpy(layout.data(), reinterpret_cast<const u8*>(&attribute_config) + sizeof(u32),
+                sizeof(layout));
 
-    for (int i = 0; i < 16; i++) {
-        vertex_attribute_is_default[i] = attribute_config.IsDefaultAttribute(i);
-    }
+    // Loader and offset each attribute is read from. If several loaders reference the same
+    // attribute, the last one wins.
+    std::array<int, 12> attribute_loaders;
+    std::array<u32, 12> attribute_offsets;
+    attribute_loaders.fill(-1);
 
     // Setup attribute data from loaders
     for (int loader = 0; loader < 12; ++loader) {
@@ -47,13 +80,8 @@ void VertexLoader::Setup(const PipelineRegs& regs) {
             if (attribute_index < 12) {
                 offset = Common::AlignUp(offset,
                                          attribute_config.GetElementSizeInBytes(attribute_index));
-                vertex_attribute_sources[attribute_index] = loader_config.data_offset + offset;
-                vertex_attribute_strides[attribute_index] =
-                    static_cast<u32>(loader_config.byte_count);
-                vertex_attribute_formats[attribute_index] =
-                    attribute_config.GetFormat(attribute_index);
-                vertex_attribute_elements[attribute_index] =
-                    attribute_config.GetNumElements(attribute_index);
+                attribute_loaders[attribute_index] = loader;
+                attribute_offsets[attribute_index] = offset;
                 offset += attribute_config.GetStride(attribute_index);
             } else if (attribute_index < 16) {
                 // Attribute ids 12, 13, 14 and 15 signify 4, 8, 12 and 16-byte paddings,
@@ -67,94 +95,90 @@ void VertexLoader::Setup(const PipelineRegs& regs) {
         }
     }
 
+    // Group the attributes by the loader they are read from
+    for (int loader = 0; loader < 12; ++loader) {
+        const auto& loader_config = attribute_config.attribute_loaders[loader];
+        BufferFetch& buffer = buffers[num_buffers];
+        buffer.data_offset = loader_config.data_offset;
+        buffer.stride = static_cast<u32>(loader_config.byte_count);
+        buffer.num_attributes = 0;
+
+        for (int i = 0; i < num_total_attributes && i < 12; ++i) {
+            if (attribute_loaders[i] != loader)
+                continue;
+
+            const auto format = attribute_config.GetFormat(i);
+            const u32 elements = attribute_config.GetNumElements(i);
+            AttributeFetch& fetch = buffer.attributes[buffer.num_attributes++];
+            fetch.index = i;
+            fetch.offset = attribute_offsets[i];
+            fetch.size = elements * attribute_config.GetElementSizeInBytes(i);
+            fetch.load = load_funcs[static_cast<u32>(format)][elements - 1];
+        }
+
+        if (buffer.num_attributes != 0)
+            ++num_buffers;
+    }
+
+    for (int i = 0; i < num_total_attributes; ++i) {
+        if ((i >= 12 || attribute_loaders[i] == -1) && attribute_config.IsDefaultAttribute(i))
+            default_attributes[num_default_attributes++] = i;
+    }
+
     is_setup = true;
 }
 
+bool VertexLoader::MatchesLayout(const PipelineRegs& regs) const {
+    return is_setup &&
+           std::memcmp(layout.data(),
+                       reinterpret_cast<const u8*>(&regs.vertex_attributes) + sizeof(u32),
+                       sizeof(layout)) == 0;
+}
+
 void VertexLoader::LoadVertex(u32 base_address, int index, int vertex,
                               Shader::AttributeBuffer& input,
                               DebugUtils::MemoryAccessTracker& memory_accesses) {
     ASSERT_MSG(is_setup, "A VertexLoader needs to be setup before loading vertices.");
 
-    for (int i = 0; i < num_total_attributes; ++i) {
-        if (vertex_attribute_elements[i] != 0) {
-            // Load per-vertex data from the loader arrays
-            u32 source_addr =
-                base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
-
-            if (g_debug_context && Pica::g_debug_context->recorder) {
-                memory_accesses.AddAccess(
-                    source_addr,
-                    vertex_attribute_elements[i] *
-                        ((vertex_attribute_formats[i] == PipelineRegs::VertexAttributeFormat::FLOAT)
-                             ? 4
-                             : (vertex_attribute_formats[i] ==
-                                PipelineRegs::VertexAttributeFormat::SHORT)
-                                   ? 2
-                                   : 1));
-            }
+    const bool track_accesses = g_debug_context && Pica::g_debug_context->recorder;
 
-            switch (vertex_attribute_formats[i]) {
-            case PipelineRegs::VertexAttributeFormat::BYTE: {
-                const s8* srcdata =
-                    reinterpret_cast<const s8*>(Memory::GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::UBYTE: {
-                const u8* srcdata =
-                    reinterpret_cast<const u8*>(Memory::GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::SHORT: {
-                const s16* srcdata =
-                    reinterpret_cast<const s16*>(Memory::GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::FLOAT: {
-                const float* srcdata =
-                    reinterpret_cast<const float*>(Memory::GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            }
+    for (int b = 0; b < num_buffers; ++b) {
+        const BufferFetch& buffer = buffers[b];
 
-            // Default attribute values set if array elements have < 4 components. This
-            // is *not* carried over from the default attribute settings even if they're
-            // enabled for this attribute.
-            for (unsigned int comp = vertex_attribute_elements[i]; comp < 4; ++comp) {
-                input.attr[i][comp] =
-                    comp == 3 ? float24::FromFloat32(1.0f) : float24::FromFloat32(0.0f);
-            }
+        // Load per-vertex data from the loader arrays
+        const u32 vertex_addr = base_address + buffer.data_offset + buffer.stride * vertex;
+        const u8* vertex_data = Memory::GetPhysicalPointer(vertex_addr);
+
+        for (int a = 0; a < buffer.num_attributes; ++a) {
+            const AttributeFetch& fetch = buffer.attributes[a];
+
+            if (track_accesses)
+                memory_accesses.AddAccess(vertex_addr + fetch.offset, fetch.size);
 
-            LOG_TRACE(HW_GPU, "Loaded %d components of attribute %x for vertex %x (index %x) from "
+            fetch.load(vertex_data + fetch.offset, input.attr[fetch.index]);
+
+            LOG_TRACE(HW_GPU, "Loaded attribute %x for vertex %x (index %x) from "
                               "0x%08x + 0x%08x + 0x%04x: %f %f %f %f",
-                      vertex_attribute_elements[i], i, vertex, index, base_address,
-                      vertex_attribute_sources[i], vertex_attribute_strides[i] * vertex,
-                      input.attr[i][0].ToFloat32(), input.attr[i][1].ToFloat32(),
-                      input.attr[i][2].ToFloat32(), input.attr[i][3].ToFloat32());
-        } else if (vertex_attribute_is_default[i]) {
-            // Load the default attribute if we're configured to do so
-            input.attr[i] = g_state.input_default_attributes.attr[i];
-            LOG_TRACE(HW_GPU,
-                      "Loaded default attribute %x for vertex %x (index %x): (%f, %f, %f, %f)", i,
-                      vertex, index, input.attr[i][0].ToFloat32(), input.attr[i][1].ToFloat32(),
-                      input.attr[i][2].ToFloat32(), input.attr[i][3].ToFloat32());
-        } else {
-            // TODO(yuriks): In this case, no data gets loaded and the vertex
-            // remains with the last value it had. This isn't currently maintained
-            // as global state, however, and so won't work in Citra yet.
+                      fetch.index, vertex, index, base_address, buffer.data_offset + fetch.offset,
+                      buffer.stride * vertex, input.attr[fetch.index][0].ToFloat32(),
+                      input.attr[fetch.index][1].ToFloat32(),
+                      input.attr[fetch.index][2].ToFloat32(),
+                      input.attr[fetch.index][3].ToFloat32());
         }
     }
+
+    // Load the default attribute if we're configured to do so
+    for (int d = 0; d < num_default_attributes; ++d) {
+        const u32 i = default_attributes[d];
+        input.attr[i] = g_state.input_default_attributes.attr[i];
+        LOG_TRACE(HW_GPU,
+                  "Loaded default attribute %x for vertex %x (index %x): (%f, %f, %f, %f)", i,
+                  vertex, index, input.attr[i][0].ToFloat32(), input.attr[i][1].ToFloat32(),
+                  input.attr[i][2].ToFloat32(), input.attr[i][3].ToFloat32());
+    }
+
+    // TODO(yuriks): Attributes that are neither loaded nor default keep the last value they had.
+    // This isn't currently maintained as global state, however, and so won't work in Citra yet.
 }
 
 } // namespace Pica
@@ -2,6 +2,8 @@
 
 #include <array>
 #include "common/common_types.h"
+#include "common/vector_math.h"
+#include "video_core/pica_types.h"
 #include "video_core/regs_pipeline.h"
 
 namespace Pica {
@@ -25,16 +27,40 @@ public:
     void LoadVertex(u32 base_address, int index, int vertex, Shader::AttributeBuffer& input,
                     DebugUtils::MemoryAccessTracker& memory_accesses);
 
+    /// Returns whether this loader was set up for the vertex attribute layout found in `regs`
+    bool MatchesLayout(const PipelineRegs& regs) const;
+
     int GetNumTotalAttributes() const {
         return num_total_attributes;
     }
 
 private:
-    std::array<u32, 16> vertex_attribute_sources;
-    std::array<u32, 16> vertex_attribute_strides{};
-    std::array<PipelineRegs::VertexAttributeFormat, 16> vertex_attribute_formats;
-    std::array<u32, 16> vertex_attribute_elements{};
-    std::array<bool, 16> vertex_attribute_is_default;
+    /// Converts the components of one attribute and stores them into an input register
+    using AttributeLoadFunc = void (*)(const u8* source, Math::Vec4<float24>& attribute);
+
+    struct AttributeFetch {
+        u32 index;  ///< Input register the attribute is stored to
+        u32 offset; ///< Offset of the attribute data from the start of the vertex in the buffer
+        u32 size;   ///< Number of bytes read for the attribute
+        AttributeLoadFunc load;
+    };
+
+    /// Attributes read from the same loader buffer, resolved with a single pointer lookup
+    struct BufferFetch {
+        u32 data_offset;
+        u32 stride;
+        int num_attributes = 0;
+        std::array<AttributeFetch, 12> attributes;
+    };
+
+    /// Vertex attribute registers except the base address, which does not affect the layout
+    using Layout = std::array<u32, sizeof(PipelineRegs::vertex_attributes) / sizeof(u32) - 1>;
+
+    std::array<BufferFetch, 12> buffers;
+    int num_buffers = 0;
+    std::array<u32, 16> default_attributes;
+    int num_default_attributes = 0;
+    Layout layout;
     int num_total_attributes = 0;
     bool is_setup = false;
 };
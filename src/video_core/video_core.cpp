@@ -4,8 +4,10 @@
 
 #include <memory>
 #include "common/logging/log.h"
+#include "core/settings.h"
 #include "video_core/pica.h"
 #include "video_core/renderer_base.h"
+#include "video_core/renderer_null/renderer_null.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
 #include "video_core/video_core.h"
 
@@ -27,7 +29,11 @@ bool Init(EmuWindow* emu_window) {
     Pica::Init();
 
     g_emu_window = emu_window;
-    g_renderer = std::make_unique<RendererOpenGL>();
+    if (Settings::values.use_null_renderer) {
+        g_renderer = std::make_unique<RendererNull>(Settings::values.skip_rasterization);
+    } else {
+        g_renderer = std::make_unique<RendererOpenGL>();
+    }
     g_renderer->SetWindow(g_emu_window);
     if (g_renderer->Init()) {
         LOG_DEBUG(Render, "initialized OK");